@@ -1,16 +1,26 @@
-#include "ClientLogic.h"
+#include "clientlogic.h"
+#include "../common/monotonicclock.h"
 
-ClientLogic::ClientLogic(const QString &host, quint16 port, QObject *parent)
+ClientLogic::ClientLogic(const QString &host, quint16 port,
+                         MessageCodec::Encoding preferredEncoding, QObject *parent)
     : QObject(parent), m_host(host), m_port(port), m_client(nullptr),
-    m_isStarted(false) {
+    m_isStarted(false), m_preferredEncoding(preferredEncoding),
+    m_encoding(MessageCodec::Encoding::Json) {
 
     // Инициализация таймеров
     m_reconnectTimer    = new QTimer(this);
+    m_registrationTimer = new QTimer(this);
     m_dataSendTimer     = new QTimer(this);
+    m_probeTimer        = new QTimer(this);
+    m_reconnectTimer->setSingleShot(true);
+    m_registrationTimer->setSingleShot(true);
 
-    // Создаем сокет
-    QTcpSocket *socket = new QTcpSocket();
-    m_client = new TcpClient(socket, this);
+    // Создаем сокет: агенты на хосте сервера обходят стек TCP/IP
+    if (m_host == Protocol::Local::HOST) {
+        m_client = new LocalClient(new QLocalSocket(), this);
+    } else {
+        m_client = new TcpClient(new QTcpSocket(), this);
+    }
 
     // Подключаем сигналы от клиента
     setupClientConnections();
@@ -18,8 +28,12 @@ ClientLogic::ClientLogic(const QString &host, quint16 port, QObject *parent)
     // Подключение таймеров к слотам
     connect(m_reconnectTimer, &QTimer::timeout, this,
             &ClientLogic::connectToServer);
+    connect(m_registrationTimer, &QTimer::timeout, this,
+            &ClientLogic::handleRegistrationTimeout);
     connect(m_dataSendTimer, &QTimer::timeout, this,
             &ClientLogic::sendPeriodicData);
+    connect(m_probeTimer, &QTimer::timeout, this,
+            &ClientLogic::sendProbe);
 }
 
 ClientLogic::~ClientLogic() {}
@@ -36,11 +50,34 @@ void ClientLogic::connectToServer() {
         qInfo() << QString(Protocol::LogMessages::CONNECTION_ATTEMPT)
         .arg(m_host)
             .arg(m_port);
+        ++m_connectAttempts;
         // Запускаем подключение
         m_client->connectToHost(m_host, m_port);
     }
 }
 
+void ClientLogic::handleRegistrationTimeout() {
+    qWarning() << Protocol::LogMessages::REGISTRATION_TIMEOUT;
+    // Разрыв вызовет handleClientDisconnected и переподключение с паузой
+    m_client->disconnect();
+    scheduleReconnect();
+}
+
+void ClientLogic::scheduleReconnect() {
+    m_registrationTimer->stop();
+    // Ошибка и разрыв приходят по одной неудачной попытке вместе
+    if (m_reconnectTimer->isActive())
+        return;
+
+    const qint64 delay = m_backoff.nextDelayMs(*QRandomGenerator::global());
+    qInfo().noquote() << QString(Protocol::LogMessages::RECONNECT_SCHEDULED)
+                             .arg(delay)
+                             .arg(m_backoff.failures())
+                             .arg(m_connectAttempts)
+                             .arg(m_busyReplies);
+    m_reconnectTimer->start(int(delay));
+}
+
 void ClientLogic::setupClientConnections() {
     connect(m_client, &IClient::connected, this, &ClientLogic::handleClientConnected);
     connect(m_client, &IClient::disconnected, this, &ClientLogic::handleClientDisconnected);
@@ -51,21 +88,17 @@ void ClientLogic::setupClientConnections() {
 void ClientLogic::handleClientConnected() {
     qInfo() << Protocol::LogMessages::CONNECTED_SUCCESS;
     sendRegistrationRequest(); // Отправляем запрос на регистрацию
-    // Запускаем таймер для перерегестрации через 5 секунд
-    if (!m_reconnectTimer->isActive()) {
-        m_reconnectTimer->start(Protocol::Constants::RECONNECT_TIMEOUT);
-    }
+    // Без подтверждения соединение разрывается и попытка считается неудачной
+    m_registrationTimer->start(Protocol::Constants::REGISTRATION_TIMEOUT);
 }
 
 void ClientLogic::handleClientDisconnected() {
     qWarning() << Protocol::LogMessages::DISCONNECTED;
     m_dataSendTimer->stop();
+    m_probeTimer->stop();
     m_isStarted = false;
 
-    // Запускаем таймер для переподключения через 5 секунд
-    if (!m_reconnectTimer->isActive()) {
-        m_reconnectTimer->start(Protocol::Constants::RECONNECT_TIMEOUT);
-    }
+    scheduleReconnect();
 }
 
 void ClientLogic::handleClientError(const QString &error) {
@@ -74,62 +107,117 @@ void ClientLogic::handleClientError(const QString &error) {
 }
 
 void ClientLogic::handleDataReceived(const QByteArray &data) {
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
-    if (error.error != QJsonParseError::NoError) {
-        qWarning() << Protocol::LogMessages::INVALID_JSON << error.errorString();
+    QCborMap message;
+    QString errorString;
+    if (!MessageCodec::decode(data, message, &errorString)) {
+        qWarning() << Protocol::LogMessages::INVALID_MESSAGE << errorString;
         return;
     }
 
-    if (doc.isObject()) {
-        QJsonObject json = doc.object();
-        // Обработка подтверждения регистрации
-        if (json[Protocol::Keys::TYPE].toString() ==
-            Protocol::MessageType::CONFIRMATION) {
-            m_client->setId(json[Protocol::Keys::ID].toString());
-            m_reconnectTimer->stop();
-            qInfo() << Protocol::LogMessages::CONNECTION_CONFIRMED << m_client->id();
-            qInfo() << Protocol::LogMessages::WAITING_START;
+    const QString messageType = message.value(Protocol::Keys::TYPE).toString();
+    // Обработка подтверждения регистрации
+    if (messageType == Protocol::MessageType::CONFIRMATION) {
+        m_encoding = applyConfirmation(m_client, message);
+        m_registrationTimer->stop();
+        m_backoff.reset();
+        qInfo() << Protocol::LogMessages::CONNECTION_CONFIRMED << m_client->id()
+                << MessageCodec::encodingName(m_encoding);
+        qInfo() << Protocol::LogMessages::WAITING_START;
+
+        // Темп, заданный прежним подключением, больше не действует
+        m_sendIntervalMs = 0;
+        m_sampleRatio = 1.0;
+
+        // Старый сервер не присылает своего времени и не отвечает на Probe
+        m_clockSync.reset();
+        if (message.contains(Protocol::Keys::SERVER_TIME)) {
+            sendProbe();
+            m_probeTimer->start(Protocol::Timing::PROBE_INTERVAL_MS);
         }
-        // Обработка команд от сервера
-        else if (json.contains(Protocol::Keys::COMMAND)) {
-            QString command = json[Protocol::Keys::COMMAND].toString();
-            if (command == Protocol::Commands::START && !m_isStarted) {
-                qInfo() << Protocol::LogMessages::START_RECEIVED;
-                m_isStarted = true;
-                sendPeriodicData(); // Начинаем отправку немедленно
-            } else if (command == Protocol::Commands::STOP) {
-                qInfo() << Protocol::LogMessages::STOP_RECEIVED;
-                m_isStarted = false;
-                m_dataSendTimer->stop();
-            }
+    }
+    // Сервер перегружен и закроет соединение: следующая попытка не раньше указанной паузы
+    else if (messageType == Protocol::MessageType::BUSY) {
+        const qint64 retryAfter = message.value(Protocol::Keys::RETRY_AFTER).toInteger();
+        ++m_busyReplies;
+        m_backoff.setRetryAfter(retryAfter);
+        qWarning().noquote() << QString(Protocol::LogMessages::SERVER_BUSY).arg(retryAfter);
+    }
+    // Сервер перегружен: телеметрия уходит реже, но не прекращается
+    else if (messageType == Protocol::MessageType::FLOW_CONTROL) {
+        m_sendIntervalMs = int(qBound<qint64>(0, message.value(Protocol::Keys::SEND_INTERVAL).toInteger(),
+                                              Protocol::FlowControl::MAX_SEND_INTERVAL_MS));
+        m_sampleRatio = qBound(Protocol::FlowControl::MIN_SAMPLE_RATIO,
+                               message.value(Protocol::Keys::SAMPLE_RATIO).toDouble(1.0), 1.0);
+        qInfo().noquote() << QString(Protocol::LogMessages::FLOW_CONTROL)
+                                 .arg(m_sendIntervalMs)
+                                 .arg(m_sampleRatio);
+    }
+    // Ответ на замер задержки
+    else if (messageType == Protocol::MessageType::PROBE) {
+        m_clockSync.handleReply(message, MonotonicClock::nowNs());
+    }
+    // Обработка команд от сервера
+    else if (message.contains(Protocol::Keys::COMMAND)) {
+        QString command = message.value(Protocol::Keys::COMMAND).toString();
+        if (command == Protocol::Commands::START && !m_isStarted) {
+            qInfo() << Protocol::LogMessages::START_RECEIVED;
+            m_isStarted = true;
+            sendPeriodicData(); // Начинаем отправку немедленно
+        } else if (command == Protocol::Commands::STOP) {
+            qInfo() << Protocol::LogMessages::STOP_RECEIVED;
+            m_isStarted = false;
+            m_dataSendTimer->stop();
         }
-        // Обработка конфигурации
-        else if (json[Protocol::Keys::TYPE].toString() ==
-                 Protocol::MessageType::CONFIGURATION) {
-            if (json.contains(Protocol::Keys::PAYLOAD)) {
-                QJsonObject payload = json[Protocol::Keys::PAYLOAD].toObject();
-                m_config.loadFromJson(payload);
-                qInfo() << Protocol::LogMessages::CONFIG_RECEIVED;
-                qInfo() << Protocol::Keys::MAX_CPU_TEMP + ":" << m_config.maxCpuTemp;
-                qInfo() << Protocol::Keys::MAX_CPU_USAGE + ":" << m_config.maxCpuUsage;
-                qInfo() << Protocol::Keys::MAX_MEMORY_USAGE + ":" << m_config.maxMemoryUsage;
-                qInfo() << Protocol::Keys::MAX_BAND_WIDTH + ":" << m_config.maxBandWidth;
-                qInfo() << Protocol::Keys::MAX_LATENCY + ":" << m_config.maxLatency;
-                qInfo() << Protocol::Keys::MAX_PACKET_LOSS + ":" << m_config.maxPacketLoss;
-            }
+    }
+    // Обработка конфигурации
+    else if (messageType == Protocol::MessageType::CONFIGURATION) {
+        if (message.contains(Protocol::Keys::PAYLOAD)) {
+            m_config.loadFromJson(message.value(Protocol::Keys::PAYLOAD).toMap().toJsonObject());
+            qInfo() << Protocol::LogMessages::CONFIG_RECEIVED;
+            qInfo() << Protocol::Keys::MAX_CPU_TEMP + ":" << m_config.maxCpuTemp;
+            qInfo() << Protocol::Keys::MAX_CPU_USAGE + ":" << m_config.maxCpuUsage;
+            qInfo() << Protocol::Keys::MAX_MEMORY_USAGE + ":" << m_config.maxMemoryUsage;
+            qInfo() << Protocol::Keys::MAX_BAND_WIDTH + ":" << m_config.maxBandWidth;
+            qInfo() << Protocol::Keys::MAX_LATENCY + ":" << m_config.maxLatency;
+            qInfo() << Protocol::Keys::MAX_PACKET_LOSS + ":" << m_config.maxPacketLoss;
         }
     }
 }
 
-void ClientLogic::sendRegistrationRequest() {
+QJsonObject ClientLogic::registrationRequest(const ClientConfiguration &config,
+                                             MessageCodec::Encoding preferredEncoding) {
     QJsonObject data;
     data[Protocol::Keys::ID] = Protocol::Constants::CLIENT_ID; // Запрашиваемый ID
     data[Protocol::Keys::TYPE] = Protocol::MessageType::REGISTRATION;
 
     // Добавляем текущую конфигурацию
-    data[Protocol::Keys::PAYLOAD] = m_config.toJson();
-    sendJson(data);
+    data[Protocol::Keys::PAYLOAD] = config.toJson();
+    // Запрашиваем кадрирование сообщений префиксом длины и предпочитаемый формат
+    data[Protocol::Keys::FRAMING] = Protocol::Framing::LENGTH_PREFIXED;
+    data[Protocol::Keys::ENCODING] = MessageCodec::encodingName(preferredEncoding);
+    return data;
+}
+
+MessageCodec::Encoding ClientLogic::applyConfirmation(IClient *client, const QCborMap &message) {
+    // Сервер без поддержки кадрирования отвечает без подтверждения режима
+    if (message.value(Protocol::Keys::FRAMING).toString() != Protocol::Framing::LENGTH_PREFIXED) {
+        client->setFramingMode(IClient::FramingMode::Raw);
+    }
+    client->setId(message.value(Protocol::Keys::ID).toString());
+    // Формат сообщений переключается, только если сервер его подтвердил
+    return message.value(Protocol::Keys::ENCODING).toString() == Protocol::Encoding::CBOR
+               ? MessageCodec::Encoding::Cbor
+               : MessageCodec::Encoding::Json;
+}
+
+void ClientLogic::sendRegistrationRequest() {
+    // Регистрация всегда уходит в JSON, формат меняется после подтверждения
+    m_encoding = MessageCodec::Encoding::Json;
+    sendJson(registrationRequest(m_config, m_preferredEncoding));
+
+    // Регистрация ушла без префикса; ответ сервера уже разбираем как поток кадров.
+    // Ответ старого сервера (JSON без префикса) MessageFramer распознает сам.
+    m_client->setFramingMode(IClient::FramingMode::LengthPrefixed);
 }
 
 void ClientLogic::sendPeriodicData() {
@@ -138,40 +226,45 @@ void ClientLogic::sendPeriodicData() {
         return;
     }
 
-    // Циклически меняем тип отправляемых данных
-    static int dataType = 0;
-    dataType == 2 ? dataType = 0 : dataType++;
-
+    // Циклически меняем тип отправляемых данных (у каждого клиента свой цикл)
     QJsonObject data;
-    switch (dataType) {
+    switch (m_dataType) {
     case 0:
-        data = generateNetworkMetrics();
+        data = generateNetworkMetrics(*QRandomGenerator::global());
         break;
     case 1:
-        data = generateDeviceStatus();
+        data = generateDeviceStatus(*QRandomGenerator::global());
         break;
     case 2:
-        data = generateLog();
+        data = generateLog(*QRandomGenerator::global());
         break;
     }
+    m_dataType = (m_dataType + 1) % Protocol::Constants::DATA_TYPES_COUNT;
 
     data[Protocol::Keys::ID] =
         m_client->id(); // Добавляем наш ID в каждое сообщение
 
     // Проверяем пороговые значения и изменяем severity если нужно
-    checkThresholds(data);
+    const bool critical = checkThresholds(data);
 
-    sendJson(data);
+    // Под нагрузкой сервера пропускаем часть обычных сообщений; о превышениях сообщаем всегда
+    if (critical || m_sampleRatio >= 1.0 || QRandomGenerator::global()->generateDouble() < m_sampleRatio) {
+        m_clockSync.stamp(data, ++m_sequence, MonotonicClock::nowNs());
+        sendJson(data);
+    }
 
-    // Устанавливаем случайную задержку для следующей отправки
+    // Устанавливаем случайную задержку для следующей отправки, не меньше заданной сервером
     int delay = QRandomGenerator::global()->bounded(Protocol::Constants::MIN_DELAY, Protocol::Constants::MAX_DELAY);
-    m_dataSendTimer->start(delay);
+    m_dataSendTimer->start(qMax(delay, m_sendIntervalMs));
+}
+
+void ClientLogic::sendProbe() {
+    sendJson(ClockSync::probeRequest(MonotonicClock::nowNs()));
 }
 
 void ClientLogic::sendJson(const QJsonObject &json) {
     if (m_client && m_client->isConnected()) {
-        QJsonDocument doc(json);
-        m_client->sendData(doc.toJson(QJsonDocument::Compact));
+        m_client->sendData(MessageCodec::encode(json, m_encoding));
     }
 }
 
@@ -214,7 +307,7 @@ bool ClientLogic::checkThresholds(QJsonObject &data) {
 void ClientLogic::checkNetworkMetrics(const QJsonObject &payload, QStringList &criticalMessages) {
     // Проверяем пропускную способность
     if (payload.contains(Protocol::Keys::BAND_WIDTH)) {
-        double bandWidth = payload[Protocol::Keys::BAND_WIDTH].toString().toDouble();
+        double bandWidth = payload[Protocol::Keys::BAND_WIDTH].toDouble();
         if (bandWidth > m_config.maxBandWidth) {
             criticalMessages.append(QString("%1: %2 > %3")
                                         .arg(Protocol::Keys::BAND_WIDTH)
@@ -225,7 +318,7 @@ void ClientLogic::checkNetworkMetrics(const QJsonObject &payload, QStringList &c
 
     // Проверяем задержку
     if (payload.contains(Protocol::Keys::LATENCY)) {
-        double latency = payload[Protocol::Keys::LATENCY].toString().toDouble();
+        double latency = payload[Protocol::Keys::LATENCY].toDouble();
         if (latency > m_config.maxLatency) {
             criticalMessages.append(QString("%1: %2 > %3")
                                         .arg(Protocol::Keys::LATENCY)
@@ -236,7 +329,7 @@ void ClientLogic::checkNetworkMetrics(const QJsonObject &payload, QStringList &c
 
     // Проверяем потерю пакетов
     if (payload.contains(Protocol::Keys::PACKET_LOSS)) {
-        double packetLoss = payload[Protocol::Keys::PACKET_LOSS].toString().toDouble();
+        double packetLoss = payload[Protocol::Keys::PACKET_LOSS].toDouble();
         if (packetLoss > m_config.maxPacketLoss) {
             criticalMessages.append(QString("%1: %2 > %3")
                                         .arg(Protocol::Keys::PACKET_LOSS)
@@ -283,30 +376,31 @@ void ClientLogic::checkDeviceStatus(const QJsonObject &payload, QStringList &cri
 
 // --- Методы генерации данных ---
 
-QJsonObject ClientLogic::generateNetworkMetrics() {
+QJsonObject ClientLogic::generateNetworkMetrics(QRandomGenerator &random) {
     QJsonObject metrics;
     metrics[Protocol::Keys::TYPE] = Protocol::MessageType::NETWORK_METRICS;
     QJsonObject payload;
-    payload[Protocol::Keys::BAND_WIDTH] = QString::number(QRandomGenerator::global()->generateDouble() * 1200, 'f', 2);
-    payload[Protocol::Keys::LATENCY] = QString::number(QRandomGenerator::global()->generateDouble() * 150, 'f', 2);
-    payload[Protocol::Keys::PACKET_LOSS] = QString::number(QRandomGenerator::global()->bounded(0, 8) / 100.0, 'f', 2);
+    // Числа передаются числами, а не строками: так компактнее в CBOR и не требуется разбор на сервере
+    payload[Protocol::Keys::BAND_WIDTH] = qRound(random.generateDouble() * 120000) / 100.0;
+    payload[Protocol::Keys::LATENCY] = qRound(random.generateDouble() * 15000) / 100.0;
+    payload[Protocol::Keys::PACKET_LOSS] = random.bounded(0, 8) / 100.0;
     metrics[Protocol::Keys::PAYLOAD] = payload;
     return metrics;
 }
 
-QJsonObject ClientLogic::generateDeviceStatus() {
+QJsonObject ClientLogic::generateDeviceStatus(QRandomGenerator &random) {
     QJsonObject status;
     status[Protocol::Keys::TYPE] = Protocol::MessageType::DEVICE_STATUS;
     QJsonObject payload;
-    payload[Protocol::Keys::UP_TIME]        = QRandomGenerator::global()->bounded(1, 100000);
-    payload[Protocol::Keys::CPU_USAGE]      = QRandomGenerator::global()->bounded(5, 100);
-    payload[Protocol::Keys::MEMORY_USAGE]   = QRandomGenerator::global()->bounded(10, 100);
-    payload[Protocol::Keys::CPU_TEMP]       = QRandomGenerator::global()->bounded(10, 95);
+    payload[Protocol::Keys::UP_TIME]        = random.bounded(1, 100000);
+    payload[Protocol::Keys::CPU_USAGE]      = random.bounded(5, 100);
+    payload[Protocol::Keys::MEMORY_USAGE]   = random.bounded(10, 100);
+    payload[Protocol::Keys::CPU_TEMP]       = random.bounded(10, 95);
     status[Protocol::Keys::PAYLOAD]         = payload;
     return status;
 }
 
-QJsonObject ClientLogic::generateLog() {
+QJsonObject ClientLogic::generateLog(QRandomGenerator &random, int junkLength) {
     QJsonObject log;
     log[Protocol::Keys::TYPE] = Protocol::MessageType::LOG;
 
@@ -321,14 +415,15 @@ QJsonObject ClientLogic::generateLog() {
 
     // Генерация содержимого
     QString junk;
-    for (int i = 0; i < Protocol::Constants::JUNK_LENGTH; ++i) {
-        int index = QRandomGenerator::global()->bounded(Protocol::Constants::JUNK_CHARS.length());
+    junk.reserve(junkLength);
+    for (int i = 0; i < junkLength; ++i) {
+        int index = random.bounded(Protocol::Constants::JUNK_CHARS.length());
         junk.append(Protocol::Constants::JUNK_CHARS.at(index));
     }
 
     payload[Protocol::Keys::JUNK]       = junk;
-    payload[Protocol::Keys::SEVERITY]   = severities.at(QRandomGenerator::global()->bounded(severities.size()));
-    payload[Protocol::Keys::MESSAGE]    = messages.at(QRandomGenerator::global()->bounded(messages.size()));
+    payload[Protocol::Keys::SEVERITY]   = severities.at(random.bounded(severities.size()));
+    payload[Protocol::Keys::MESSAGE]    = messages.at(random.bounded(messages.size()));
     log[Protocol::Keys::PAYLOAD]        = payload;
     return log;
 }
@@ -13,9 +13,13 @@
 #include <QTcpSocket>
 #include <QTimer>
 
+#include "../common/messagecodec.h" // Сериализация сообщений (JSON/CBOR)
 #include "../common/protocol.h"  // Общий протокол обмена данными
+#include "../common/localclient.h" // Клиент локального сокета
 #include "../common/tcpclient.h" // Интерфейс клиента
 #include "clientprotocol.h"      // Внутренний протокол клиента
+#include "clocksync.h"           // Оценка смещения часов сервера
+#include "reconnectbackoff.h"    // Паузы переподключения
 
 /**
  * @struct ClientConfiguration
@@ -61,9 +65,13 @@ struct ClientConfiguration {
  * @class ClientLogic
  * @brief Основной класс, управляющий поведением клиента.
  *
- * Отвечает за подключение к серверу, автоматическое переподключение,
+ * Отвечает за подключение к серверу, переподключение с растущими случайными паузами,
  * отправку регистрационных данных, периодическую отправку телеметрии,
  * обработку команд и конфигураций от сервера.
+ *
+ * Темп телеметрии ограничивает сервер сообщением FlowControl: интервал
+ * между сообщениями не меньше заданного, а из обычных сообщений
+ * отправляется заданная доля (сообщения о превышении порогов — всегда).
  */
 class ClientLogic : public QObject {
     Q_OBJECT
@@ -71,11 +79,14 @@ class ClientLogic : public QObject {
 public:
     /**
      * @brief Конструктор класса.
-     * @param host Адрес сервера.
+     * @param host Адрес сервера (Protocol::Local::HOST — подключение через локальный сокет).
      * @param port Порт сервера.
+     * @param preferredEncoding Формат сообщений, запрашиваемый при регистрации.
      * @param parent Родительский объект QObject.
      */
-    explicit ClientLogic(const QString &host, quint16 port, QObject *parent = nullptr);
+    explicit ClientLogic(const QString &host, quint16 port,
+                         MessageCodec::Encoding preferredEncoding = MessageCodec::Encoding::Cbor,
+                         QObject *parent = nullptr);
     /**
      * @brief Деструктор.
      */
@@ -86,6 +97,36 @@ public:
      */
     void start();
 
+    // --- Построение сообщений (используются также генератором нагрузки) ---
+    /**
+     * @brief Формирует запрос на регистрацию.
+     * @param config Конфигурация клиента, передаваемая серверу.
+     * @param preferredEncoding Формат, запрашиваемый для последующих сообщений.
+     */
+    static QJsonObject registrationRequest(const ClientConfiguration &config,
+                                           MessageCodec::Encoding preferredEncoding);
+    /**
+     * @brief Применяет подтверждение регистрации к клиенту (кадрирование и ID).
+     * @param client Клиент, получивший подтверждение.
+     * @param message Декодированное подтверждение.
+     * @return Формат сообщений, подтвержденный сервером.
+     */
+    static MessageCodec::Encoding applyConfirmation(IClient *client, const QCborMap &message);
+    /**
+     * @brief Генерирует JSON-объект с метриками сети.
+     */
+    static QJsonObject generateNetworkMetrics(QRandomGenerator &random);
+    /**
+     * @brief Генерирует JSON-объект со статусом устройства.
+     */
+    static QJsonObject generateDeviceStatus(QRandomGenerator &random);
+    /**
+     * @brief Генерирует JSON-объект с лог-сообщением.
+     * @param junkLength Длина "мусорного" поля, задающая размер сообщения.
+     */
+    static QJsonObject generateLog(QRandomGenerator &random,
+                                   int junkLength = Protocol::Constants::JUNK_LENGTH);
+
 private slots:
     // --- Слоты для обработки сигналов от IClient ---
     /**
@@ -112,18 +153,30 @@ private slots:
      * @brief Выполняет попытку подключения к серверу (вызывается по таймеру).
      */
     void connectToServer();
+    /**
+     * @brief Разрывает соединение, если регистрация не подтверждена вовремя.
+     */
+    void handleRegistrationTimeout();
     /**
      * @brief Отправляет периодические данные на сервер (вызывается по таймеру).
      */
     void sendPeriodicData();
+    /**
+     * @brief Отправляет Probe для уточнения смещения часов сервера (вызывается по таймеру).
+     */
+    void sendProbe();
 
 private:
+    /**
+     * @brief Планирует переподключение с паузой ReconnectBackoff (повторные вызовы игнорируются).
+     */
+    void scheduleReconnect();
     /**
      * @brief Отправляет на сервер запрос на регистрацию.
      */
     void sendRegistrationRequest();
     /**
-     * @brief Отправляет JSON-объект на сервер.
+     * @brief Отправляет сообщение на сервер в согласованном формате.
      * @param json Объект для отправки.
      */
     void sendJson(const QJsonObject &json);
@@ -132,20 +185,6 @@ private:
      */
     void setupClientConnections();
 
-    // --- Методы для генерации случайных данных ---
-    /**
-     * @brief Генерирует JSON-объект с метриками сети.
-     */
-    QJsonObject generateNetworkMetrics();
-    /**
-     * @brief Генерирует JSON-объект со статусом устройства.
-     */
-    QJsonObject generateDeviceStatus();
-    /**
-     * @brief Генерирует JSON-объект с лог-сообщением.
-     */
-    QJsonObject generateLog();
-
     // --- Методы для проверки пороговых значений ---
     /**
      * @brief Проверяет данные на превышение пороговых значений из конфигурации.
@@ -171,10 +210,23 @@ private:
     quint16 m_port;         ///< Порт сервера.
     IClient *m_client;      ///< Указатель на интерфейс клиента.
 
-    QTimer *m_reconnectTimer; ///< Таймер для попыток переподключения.
+    QTimer *m_reconnectTimer; ///< Таймер паузы перед переподключением (однократный).
+    QTimer *m_registrationTimer; ///< Таймер ожидания подтверждения регистрации (однократный).
     QTimer *m_dataSendTimer;  ///< Таймер для периодической отправки данных.
+    QTimer *m_probeTimer;     ///< Таймер для периодических замеров Probe.
 
     bool m_isStarted;       ///< Флаг, разрешающий отправку данных (управляется командами с сервера).
+    int m_dataType = 0;     ///< Тип следующего сообщения (циклически по DATA_TYPES_COUNT).
+    quint64 m_sequence = 0; ///< Номер последнего отправленного сообщения (не сбрасывается при переподключении).
+    ClockSync m_clockSync;  ///< Смещение часов сервера для отметок времени отправки.
+    ReconnectBackoff m_backoff; ///< Паузы между попытками подключения.
+    quint64 m_connectAttempts = 0; ///< Всего попыток подключения.
+    quint64 m_busyReplies = 0;     ///< Всего отказов сервера (Busy).
+    int m_sendIntervalMs = 0;      ///< Наименьший интервал отправки телеметрии от сервера (мс, сбрасывается при подтверждении).
+    double m_sampleRatio = 1.0;    ///< Доля отправляемых обычных сообщений от сервера (сбрасывается при подтверждении).
+
+    MessageCodec::Encoding m_preferredEncoding; ///< Формат, запрашиваемый при регистрации.
+    MessageCodec::Encoding m_encoding;          ///< Формат, подтвержденный сервером.
 
     ClientConfiguration m_config; ///< Текущая конфигурация клиента.
 };
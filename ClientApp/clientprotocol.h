@@ -25,29 +25,6 @@ const QString MAX_MEMORY_USAGE  = "maxMemoryUsage";
 const QString MAX_BAND_WIDTH    = "maxBandWidth";
 const QString MAX_LATENCY       = "maxLatency";
 const QString MAX_PACKET_LOSS   = "maxPacketLoss";
-
-// --- Ключи телеметрии ---
-const QString BAND_WIDTH    = "bandWidth";
-const QString LATENCY       = "latency";
-const QString PACKET_LOSS   = "packetLoss";
-const QString UP_TIME       = "upTime";
-const QString CPU_USAGE     = "cpuUsage";
-const QString MEMORY_USAGE  = "memoryUsage";
-const QString CPU_TEMP      = "cpuTemp";
-const QString JUNK          = "junk";
-const QString SEVERITY      = "severity";
-const QString MESSAGE       = "message";
-}
-
-/**
- * @namespace Severity
- * @brief Уровни критичности для лог-сообщений.
- */
-namespace Severity {
-const QString INFO      = "INFO";
-const QString WARN      = "WARN";
-const QString ERROR     = "ERROR";
-const QString CRITICAL  = "CRITICAL";
 }
 
 /**
@@ -77,7 +54,11 @@ const QString CONFIG_RECEIVED       = "[CONFIG] New configuration received from
 const QString CONFIG_PARAM          = "[CONFIG]";
 const QString DISCONNECTED          = "[ERROR] Connection to server lost.";
 const QString SOCKET_ERROR          = "[ERROR] Socket error:";
-const QString INVALID_JSON          = "[ERROR] Invalid JSON from server:";
+const QString INVALID_MESSAGE       = "[ERROR] Invalid message from server:";
+const QString RECONNECT_SCHEDULED   = "[INFO] Reconnecting in %1 ms (failed attempts in a row: %2, total attempts: %3, busy replies: %4).";
+const QString SERVER_BUSY           = "[WARN] Server is busy, retry after %1 ms.";
+const QString FLOW_CONTROL          = "[FLOW] Server set send interval %1 ms, sample ratio %2.";
+const QString REGISTRATION_TIMEOUT  = "[ERROR] No registration confirmation, reconnecting.";
 }
 
 /**
@@ -87,7 +68,9 @@ const QString INVALID_JSON          = "[ERROR] Invalid JSON from server:";
 namespace Constants {
 const QString CLIENT_ID     = "Client";         ///< Базовый ID, запрашиваемый при регистрации
 const int DATA_TYPES_COUNT  = 3;                ///< Количество типов данных для циклического переключения
-const int RECONNECT_TIMEOUT = 5000;             ///< Таймаут переподключения (мс)
+const int REGISTRATION_TIMEOUT = 5000;          ///< Ожидание подтверждения регистрации (мс)
+const int RECONNECT_BASE_MS = 500;              ///< Наименьшая пауза перед переподключением (мс)
+const int RECONNECT_CAP_MS  = 30000;            ///< Наибольшая пауза перед переподключением (мс)
 const int MIN_DELAY         = 100;              ///< Минимальная задержка отправки данных (мс)
 const int MAX_DELAY         = 1000;             ///< Максимальная задержка отправки данных (мс)
 const int JUNK_LENGTH       = 200;              ///< Длина "мусорных" данных в логах
@@ -0,0 +1,43 @@
+#include "clocksync.h"
+
+QJsonObject ClockSync::probeRequest(qint64 nowNs) {
+    QJsonObject probe;
+    probe[Protocol::Keys::TYPE] = Protocol::MessageType::PROBE;
+    probe[Protocol::Keys::SENT_AT] = nowNs / 1000;
+    return probe;
+}
+
+qint64 ClockSync::handleReply(const QCborMap &message, qint64 nowNs) {
+    const qint64 sentUs = message.value(Protocol::Keys::SENT_AT).toInteger();
+    const qint64 serverUs = message.value(Protocol::Keys::SERVER_TIME).toInteger();
+    const qint64 nowUs = nowNs / 1000;
+    if (sentUs <= 0 || serverUs <= 0 || sentUs > nowUs)
+        return -1;
+
+    Sample &sample = m_samples[m_next];
+    sample.rttUs = nowUs - sentUs;
+    // Сервер ответил в середине оборота по его часам
+    sample.offsetUs = serverUs - (sentUs + nowUs) / 2;
+    m_next = (m_next + 1) % int(m_samples.size());
+    m_count = qMin(m_count + 1, int(m_samples.size()));
+
+    const Sample *best = &m_samples[0];
+    for (int i = 1; i < m_count; ++i) {
+        if (m_samples[i].rttUs < best->rttUs)
+            best = &m_samples[i];
+    }
+    m_offsetUs = best->offsetUs;
+    return (nowUs - sentUs) * 1000;
+}
+
+void ClockSync::stamp(QJsonObject &message, quint64 sequence, qint64 localNs) const {
+    message[Protocol::Keys::SEQUENCE] = qint64(sequence);
+    if (isSynchronized())
+        message[Protocol::Keys::SENT_AT] = localNs / 1000 + m_offsetUs;
+}
+
+void ClockSync::reset() {
+    m_count = 0;
+    m_next = 0;
+    m_offsetUs = 0;
+}
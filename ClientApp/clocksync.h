@@ -0,0 +1,76 @@
+/**
+ * @file clocksync.h
+ * @brief Определяет класс ClockSync — оценку смещения часов клиента относительно сервера.
+ */
+#ifndef CLOCKSYNC_H
+#define CLOCKSYNC_H
+
+#include <QCborMap>
+#include <QJsonObject>
+
+#include <array>
+
+#include "../common/protocol.h"
+
+/**
+ * @class ClockSync
+ * @brief Оценивает смещение монотонных часов сервера по обмену Probe и ставит отметки в сообщения.
+ *
+ * Каждый ответ на Probe дает время оборота и смещение в предположении, что
+ * путь туда и обратно занимает одинаковое время. Из последних
+ * Protocol::Timing::PROBE_HISTORY замеров берется смещение с наименьшим
+ * временем оборота: у него меньше всего вклад очередей. Пока не получен ни
+ * один ответ, время отправки в сообщения не добавляется.
+ */
+class ClockSync {
+public:
+    /**
+     * @brief Формирует запрос Probe с временем отправки по часам клиента.
+     * @param nowNs Текущее время (MonotonicClock).
+     */
+    static QJsonObject probeRequest(qint64 nowNs);
+
+    /**
+     * @brief Учитывает ответ сервера на Probe.
+     * @param message Декодированный ответ.
+     * @param nowNs Время получения ответа (MonotonicClock).
+     * @return Время оборота (нс) или -1, если ответ некорректен.
+     */
+    qint64 handleReply(const QCborMap &message, qint64 nowNs);
+
+    /**
+     * @brief Добавляет в сообщение номер и время отправки в часах сервера.
+     * @param message Сообщение телеметрии.
+     * @param sequence Номер сообщения.
+     * @param localNs Время отправки по часам клиента (MonotonicClock).
+     */
+    void stamp(QJsonObject &message, quint64 sequence, qint64 localNs) const;
+
+    /**
+     * @brief Возвращает true, если смещение уже оценено.
+     */
+    bool isSynchronized() const { return m_count > 0; }
+    /**
+     * @brief Сбрасывает замеры (при переподключении сервер может смениться).
+     */
+    void reset();
+
+private:
+    /**
+     * @struct Sample
+     * @brief Один замер: время оборота и смещение часов (мкс).
+     */
+    struct Sample {
+        qint64 rttUs = 0;
+        qint64 offsetUs = 0;
+    };
+
+    /// @brief Последние замеры (кольцо).
+    std::array<Sample, Protocol::Timing::PROBE_HISTORY> m_samples{};
+    int m_count = 0;
+    int m_next = 0;
+    /// @brief Смещение часов сервера относительно часов клиента (мкс).
+    qint64 m_offsetUs = 0;
+};
+
+#endif // CLOCKSYNC_H
@@ -0,0 +1,219 @@
+#include "loadgenerator.h"
+#include "../common/monotonicclock.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <utility>
+
+namespace {
+/// @brief Признак получения SIGINT/SIGTERM (обработчик сигнала только выставляет флаг).
+std::atomic<bool> s_interrupted{false};
+
+void handleInterrupt(int) { s_interrupted.store(true); }
+
+/// @brief Возвращает перцентиль отсортированной выборки в миллисекундах.
+double percentileMs(const QList<qint64> &sorted, double percentile) {
+    if (sorted.isEmpty())
+        return 0.0;
+    const qsizetype index = qMin(sorted.size() - 1, qsizetype(percentile / 100.0 * sorted.size()));
+    return sorted.at(index) / 1e6;
+}
+}
+
+LoadGenerator::LoadGenerator(const LoadProfile &profile, QObject *parent)
+    : QObject(parent), m_profile(profile), m_progressTimer(new QTimer(this)),
+    m_interruptTimer(new QTimer(this)) {
+    if (m_profile.threads <= 0)
+        m_profile.threads = QThread::idealThreadCount();
+    m_profile.threads = qBound(1, m_profile.threads, qMax(1, m_profile.clients));
+
+    connect(m_progressTimer, &QTimer::timeout, this, &LoadGenerator::reportProgress);
+    connect(m_interruptTimer, &QTimer::timeout, this, [this] {
+        if (s_interrupted.load())
+            stop();
+    });
+}
+
+LoadGenerator::~LoadGenerator() { stop(); }
+
+void LoadGenerator::start() {
+    qInfo().noquote() << QString("[LOAD] Target %1:%2, %3").arg(m_profile.host).arg(m_profile.port).arg(m_profile.describe());
+
+    // Небольшой запас, чтобы все потоки успели запуститься до первого подключения
+    m_startNs = MonotonicClock::nowNs() + 100 * 1000000;
+    m_lastProgressNs = m_startNs;
+
+    QList<QList<qint64>> offsets(m_profile.threads);
+    for (int i = 0; i < m_profile.clients; ++i) {
+        offsets[i % m_profile.threads].append(m_profile.connectOffsetNs(i));
+    }
+
+    for (int t = 0; t < m_profile.threads; ++t) {
+        QThread *thread = new QThread(this);
+        thread->setObjectName(QString("Load-%1").arg(t));
+
+        LoadWorker *worker = new LoadWorker(m_profile, offsets.at(t), m_startNs);
+        worker->moveToThread(thread);
+        connect(thread, &QThread::started, worker, &LoadWorker::start);
+        connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+
+        m_threads.append(thread);
+        m_workers.append(worker);
+        thread->start();
+    }
+
+    std::signal(SIGINT, handleInterrupt);
+    std::signal(SIGTERM, handleInterrupt);
+    m_interruptTimer->start(INTERRUPT_POLL_MS);
+    m_progressTimer->start(PROGRESS_INTERVAL_MS);
+
+    if (m_profile.durationSec > 0) {
+        QTimer::singleShot(qint64(m_profile.durationSec) * 1000 + 100, this, &LoadGenerator::stop);
+    }
+    if (m_profile.rampUpSec > 0) {
+        QTimer::singleShot(qint64(m_profile.rampUpSec) * 1000 + 100, this, [this] {
+            m_rampEndNs = MonotonicClock::nowNs();
+            m_rampEndSent = sentMessages();
+        });
+    }
+}
+
+quint64 LoadGenerator::sentMessages() const {
+    quint64 sent = 0;
+    for (const LoadWorker *worker : m_workers) {
+        sent += worker->sentMessages();
+    }
+    return sent;
+}
+
+void LoadGenerator::reportProgress() {
+    const qint64 nowNs = MonotonicClock::nowNs();
+    const quint64 sent = sentMessages();
+    int ready = 0;
+    for (const LoadWorker *worker : std::as_const(m_workers)) {
+        ready += worker->readyClients();
+    }
+
+    const double intervalSec = (nowNs - m_lastProgressNs) / 1e9;
+    qInfo().noquote() << QString("[LOAD] t=%1 s, clients ready %2/%3, rate %4 msg/s, sent %5")
+                             .arg((nowNs - m_startNs) / 1e9, 0, 'f', 1)
+                             .arg(ready)
+                             .arg(m_profile.clients)
+                             .arg(intervalSec > 0 ? (sent - m_lastProgressSent) / intervalSec : 0.0, 0, 'f', 0)
+                             .arg(sent);
+    m_lastProgressNs = nowNs;
+    m_lastProgressSent = sent;
+}
+
+void LoadGenerator::stop() {
+    if (m_stopped || m_workers.isEmpty())
+        return;
+    m_stopped = true;
+    m_progressTimer->stop();
+    m_interruptTimer->stop();
+
+    const qint64 elapsedNs = MonotonicClock::nowNs() - m_startNs;
+    const quint64 sent = sentMessages();
+    LoadStats total;
+    for (int t = 0; t < m_workers.size(); ++t) {
+        LoadWorker *worker = m_workers.at(t);
+        QMetaObject::invokeMethod(worker, &LoadWorker::stop, Qt::BlockingQueuedConnection);
+        total.merge(worker->stats());
+        m_threads.at(t)->quit();
+        m_threads.at(t)->wait();
+    }
+    m_workers.clear();
+    qDeleteAll(m_threads);
+    m_threads.clear();
+
+    // Темп после разгона считается по счетчику на момент окончания разгона
+    if (m_rampEndNs > 0 && elapsedNs > m_rampEndNs - m_startNs) {
+        const double steadySec = (m_startNs + elapsedNs - m_rampEndNs) / 1e9;
+        qInfo().noquote() << QString("[LOAD] Rate after ramp-up: %1 msg/s")
+                                 .arg((sent - m_rampEndSent) / steadySec, 0, 'f', 0);
+    }
+    printReport(total, elapsedNs);
+    emit finished();
+}
+
+void LoadGenerator::printReport(const LoadStats &stats, qint64 elapsedNs) const {
+    const double seconds = qMax(1e-9, elapsedNs / 1e9);
+    QList<qint64> connectTimes = stats.connectTimesNs;
+    std::sort(connectTimes.begin(), connectTimes.end());
+
+    qInfo().noquote() << QString("[LOAD] Duration %1 s, threads %2, clients %3")
+                             .arg(seconds, 0, 'f', 1)
+                             .arg(m_profile.threads)
+                             .arg(m_profile.clients);
+    qInfo().noquote() << QString("[LOAD] Target rate %1 msg/s, achieved %2 msg/s, %3 MB/s")
+                             .arg(m_profile.rate, 0, 'f', 0)
+                             .arg(stats.messagesSent / seconds, 0, 'f', 0)
+                             .arg(stats.bytesSent / seconds / (1024.0 * 1024.0), 0, 'f', 2);
+    qInfo().noquote() << QString("[LOAD] Messages sent %1, bytes %2")
+                             .arg(stats.messagesSent)
+                             .arg(stats.bytesSent);
+    qInfo().noquote() << QString("[LOAD] Connect time, ms (%1 connections): p50 %2, p90 %3, p99 %4, max %5")
+                             .arg(connectTimes.size())
+                             .arg(percentileMs(connectTimes, 50), 0, 'f', 2)
+                             .arg(percentileMs(connectTimes, 90), 0, 'f', 2)
+                             .arg(percentileMs(connectTimes, 99), 0, 'f', 2)
+                             .arg(connectTimes.isEmpty() ? 0.0 : connectTimes.last() / 1e6, 0, 'f', 2);
+    qInfo().noquote() << QString("[LOAD] Schedule lag: max %1 ms, late sends (> %2 ms) %3")
+                             .arg(stats.maxLagNs / 1e6, 0, 'f', 2)
+                             .arg(LoadWorker::LATE_THRESHOLD_NS / 1000000)
+                             .arg(stats.lateSends);
+    qInfo().noquote() << QString("[LOAD] Errors: connect attempts %1, connect errors %2, disconnects %3, "
+                                 "socket errors %4, dropped messages %5, busy replies %6, max backoff %7 ms")
+                             .arg(stats.connectAttempts)
+                             .arg(stats.connectErrors)
+                             .arg(stats.disconnects)
+                             .arg(stats.socketErrors)
+                             .arg(stats.droppedMessages)
+                             .arg(stats.busyReplies)
+                             .arg(stats.maxBackoffMs);
+    printRttReport(stats);
+}
+
+void LoadGenerator::printRttReport(const LoadStats &stats) const {
+    if (stats.probeReplies == 0) {
+        qInfo().noquote() << QString("[LOAD] RTT: no probe replies (probes sent %1)").arg(stats.probesSent);
+        return;
+    }
+
+    QList<qint64> rtt = stats.rttSamplesNs;
+    std::sort(rtt.begin(), rtt.end());
+    qInfo().noquote() << QString("[LOAD] RTT, ms (%1 replies to %2 probes): p50 %3, p90 %4, p99 %5, p99.9 %6, max %7")
+                             .arg(stats.probeReplies)
+                             .arg(stats.probesSent)
+                             .arg(percentileMs(rtt, 50), 0, 'f', 3)
+                             .arg(percentileMs(rtt, 90), 0, 'f', 3)
+                             .arg(percentileMs(rtt, 99), 0, 'f', 3)
+                             .arg(percentileMs(rtt, 99.9), 0, 'f', 3)
+                             .arg(stats.maxRttNs / 1e6, 0, 'f', 3);
+
+    // Выводятся корзины от первой до последней непустой
+    int first = 0;
+    int last = LoadStats::RTT_BUCKETS - 1;
+    while (stats.rttHistogram[first] == 0)
+        ++first;
+    while (stats.rttHistogram[last] == 0)
+        --last;
+    const quint64 peak = *std::max_element(stats.rttHistogram.cbegin(), stats.rttHistogram.cend());
+
+    qInfo().noquote() << "[LOAD] RTT histogram:";
+    for (int i = first; i <= last; ++i) {
+        const quint64 count = stats.rttHistogram[i];
+        const double boundMs = LoadStats::RTT_BUCKET_BASE_US * double(qint64(1) << i) / 1000.0;
+        const QString label = i == LoadStats::RTT_BUCKETS - 1
+                                  ? QString(">= %1 ms").arg(boundMs / 2, 0, 'f', 0)
+                                  : QString("< %1 ms").arg(boundMs, 0, 'g', 4);
+        qInfo().noquote() << QString("[LOAD]   %1 %2 %3% %4")
+                                 .arg(label, -12)
+                                 .arg(count, 10)
+                                 .arg(100.0 * count / stats.probeReplies, 6, 'f', 2)
+                                 .arg(QString(int(RTT_BAR_WIDTH * count / peak), QChar('#')));
+    }
+}
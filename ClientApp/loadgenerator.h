@@ -0,0 +1,103 @@
+/**
+ * @file loadgenerator.h
+ * @brief Определяет класс LoadGenerator — режим нагрузочного тестирования сервера.
+ */
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <QList>
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+
+#include "loadprofile.h"
+#include "loadworker.h"
+
+/**
+ * @class LoadGenerator
+ * @brief Распределяет клиентов по потокам LoadWorker, выводит прогресс и итоговый отчет.
+ *
+ * Клиенты раздаются потокам по кругу; график подключения (разгон) и время
+ * старта общие для всех потоков. Каждые PROGRESS_INTERVAL_MS выводится
+ * текущий темп; по истечении длительности или по Ctrl+C потоки
+ * останавливаются и выводится отчет: достигнутый темп (за весь прогон и
+ * после разгона), перцентили времени подключения, счетчики ошибок и
+ * перцентили с гистограммой времени оборота Probe.
+ */
+class LoadGenerator : public QObject {
+    Q_OBJECT
+
+public:
+    /// @brief Интервал вывода прогресса (мс).
+    static constexpr int PROGRESS_INTERVAL_MS = 5000;
+    /// @brief Интервал проверки сигнала прерывания (мс).
+    static constexpr int INTERRUPT_POLL_MS = 200;
+    /// @brief Наибольшая длина полосы гистограммы времени оборота (символов).
+    static constexpr int RTT_BAR_WIDTH = 40;
+
+    /**
+     * @brief Конструктор класса LoadGenerator.
+     * @param profile Параметры нагрузки.
+     * @param parent Родительский объект QObject.
+     */
+    explicit LoadGenerator(const LoadProfile &profile, QObject *parent = nullptr);
+    ~LoadGenerator();
+
+    /**
+     * @brief Запускает потоки и клиентов.
+     */
+    void start();
+
+signals:
+    /**
+     * @brief Сигнал о завершении прогона (отчет уже выведен).
+     */
+    void finished();
+
+private slots:
+    /**
+     * @brief Выводит текущий темп и количество зарегистрированных клиентов.
+     */
+    void reportProgress();
+    /**
+     * @brief Останавливает потоки, собирает статистику и выводит отчет.
+     */
+    void stop();
+
+private:
+    /**
+     * @brief Возвращает суммарное количество отправленных сообщений.
+     */
+    quint64 sentMessages() const;
+    /**
+     * @brief Выводит итоговый отчет.
+     */
+    void printReport(const LoadStats &stats, qint64 elapsedNs) const;
+    /**
+     * @brief Выводит перцентили и гистограмму времени оборота Probe.
+     */
+    void printRttReport(const LoadStats &stats) const;
+
+    /// @brief Параметры нагрузки.
+    LoadProfile m_profile;
+    /// @brief Потоки генератора.
+    QList<QThread *> m_threads;
+    /// @brief Объекты, обслуживающие клиентов в потоках.
+    QList<LoadWorker *> m_workers;
+
+    QTimer *m_progressTimer;
+    QTimer *m_interruptTimer;
+
+    /// @brief Время старта.
+    qint64 m_startNs = 0;
+    /// @brief Время и счетчик предыдущего вывода прогресса.
+    qint64 m_lastProgressNs = 0;
+    quint64 m_lastProgressSent = 0;
+    /// @brief Время окончания разгона и количество сообщений к этому моменту (-1 — не наступило).
+    qint64 m_rampEndNs = -1;
+    quint64 m_rampEndSent = 0;
+    /// @brief Признак завершенного прогона.
+    bool m_stopped = false;
+};
+
+#endif // LOADGENERATOR_H
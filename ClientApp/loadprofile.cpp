@@ -0,0 +1,70 @@
+#include "loadprofile.h"
+
+#include <QStringList>
+
+namespace {
+/// @brief Названия типов сообщений в аргументе --mix (в порядке LoadProfile::mix).
+const QStringList MIX_NAMES = {"network", "device", "log"};
+}
+
+bool LoadProfile::parseMix(const QString &text) {
+    std::array<int, MESSAGE_KINDS> weights = {0, 0, 0};
+    const QStringList parts = text.split(',', Qt::SkipEmptyParts);
+    for (const QString &part : parts) {
+        const QStringList pair = part.split(':');
+        const int kind = MIX_NAMES.indexOf(pair.first().trimmed());
+        bool ok = pair.size() == 2 && kind >= 0;
+        const int weight = ok ? pair.last().toInt(&ok) : 0;
+        if (!ok || weight < 0)
+            return false;
+        weights[kind] = weight;
+    }
+
+    if (weights[0] + weights[1] + weights[2] <= 0)
+        return false;
+    mix = weights;
+    return true;
+}
+
+bool LoadProfile::parsePayload(const QString &text) {
+    const QStringList bounds = text.split('-');
+    bool okMin = false;
+    bool okMax = bounds.size() == 1;
+    const int min = bounds.first().toInt(&okMin);
+    const int max = bounds.size() == 2 ? bounds.last().toInt(&okMax) : min;
+    if (!okMin || !okMax || bounds.size() > 2 || min < 0 || max < min)
+        return false;
+    payloadMin = min;
+    payloadMax = max;
+    return true;
+}
+
+qint64 LoadProfile::connectOffsetNs(int index) const {
+    if (rampUpSec <= 0 || clients <= 1)
+        return 0;
+    const qint64 rampNs = qint64(rampUpSec) * 1000000000;
+    if (rampSteps <= 0)
+        return rampNs * index / clients;
+
+    // Ступени одинакового размера; последняя начинается в конце разгона
+    const int step = int(qint64(index) * rampSteps / clients);
+    return rampSteps == 1 ? 0 : rampNs * step / (rampSteps - 1);
+}
+
+QString LoadProfile::describe() const {
+    return QString("clients=%1 threads=%2 rate=%3 msg/s arrival=%4 mix=%5:%6:%7 "
+                   "payload=%8-%9 ramp=%10s/%11 duration=%12s probe=%13ms")
+        .arg(clients)
+        .arg(threads)
+        .arg(rate)
+        .arg(arrival == Arrival::Poisson ? "poisson" : "uniform")
+        .arg(mix[0])
+        .arg(mix[1])
+        .arg(mix[2])
+        .arg(payloadMin)
+        .arg(payloadMax)
+        .arg(rampUpSec)
+        .arg(rampSteps > 0 ? QString("%1 steps").arg(rampSteps) : QString("linear"))
+        .arg(durationSec)
+        .arg(probeIntervalMs);
+}
@@ -0,0 +1,67 @@
+/**
+ * @file loadprofile.h
+ * @brief Определяет структуру LoadProfile — параметры режима генератора нагрузки.
+ */
+#ifndef LOADPROFILE_H
+#define LOADPROFILE_H
+
+#include <QString>
+
+#include <array>
+
+#include "../common/messagecodec.h"
+#include "clientprotocol.h"
+
+/**
+ * @struct LoadProfile
+ * @brief Параметры нагрузки: клиенты, темп, смесь сообщений и график разгона.
+ */
+struct LoadProfile {
+    /**
+     * @enum Arrival
+     * @brief Распределение интервалов между сообщениями одного клиента.
+     */
+    enum class Arrival {
+        Uniform,    ///< Равные интервалы
+        Poisson     ///< Экспоненциальные интервалы (пуассоновский поток)
+    };
+
+    /// @brief Количество типов сообщений в смеси (метрики сети, статус устройства, лог).
+    static constexpr int MESSAGE_KINDS = Protocol::Constants::DATA_TYPES_COUNT;
+
+    QString host;                                       ///< Адрес сервера
+    quint16 port = 0;                                   ///< Порт сервера
+    MessageCodec::Encoding encoding = MessageCodec::Encoding::Cbor; ///< Запрашиваемый формат
+    int clients = 100;                                  ///< Количество клиентов
+    int threads = 0;                                    ///< Количество потоков (0 — по числу ядер)
+    double rate = 1000.0;                               ///< Суммарный темп (сообщений в секунду)
+    Arrival arrival = Arrival::Uniform;                 ///< Распределение интервалов
+    std::array<int, MESSAGE_KINDS> mix = {1, 1, 1};     ///< Веса типов сообщений
+    int payloadMin = Protocol::Constants::JUNK_LENGTH;  ///< Минимальный размер поля junk в логах
+    int payloadMax = Protocol::Constants::JUNK_LENGTH;  ///< Максимальный размер поля junk в логах
+    int rampUpSec = 0;                                  ///< Длительность разгона (с)
+    int rampSteps = 0;                                  ///< Количество ступеней разгона (0 — линейно)
+    int durationSec = 0;                                ///< Длительность работы (0 — до Ctrl+C)
+    int probeIntervalMs = 1000;                         ///< Период Probe каждого клиента (мс, 0 — без замеров)
+
+    /**
+     * @brief Разбирает смесь сообщений вида "network:5,device:3,log:2".
+     * @return true, если строка корректна и сумма весов больше нуля.
+     */
+    bool parseMix(const QString &text);
+    /**
+     * @brief Разбирает размер поля junk: "N" или "MIN-MAX".
+     */
+    bool parsePayload(const QString &text);
+    /**
+     * @brief Возвращает смещение начала подключения клиента от старта по графику разгона.
+     * @param index Порядковый номер клиента.
+     */
+    qint64 connectOffsetNs(int index) const;
+    /**
+     * @brief Возвращает текстовое описание профиля для вывода при запуске.
+     */
+    QString describe() const;
+};
+
+#endif // LOADPROFILE_H
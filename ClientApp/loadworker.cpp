@@ -0,0 +1,301 @@
+#include "loadworker.h"
+#include "../common/localclient.h"
+#include "../common/monotonicclock.h"
+#include "../common/protocol.h"
+#include "../common/tcpclient.h"
+
+#include <QCborMap>
+#include <QLocalSocket>
+#include <QTcpSocket>
+
+#include <cmath>
+
+void LoadStats::addRtt(qint64 rttNs, QRandomGenerator &random) {
+    ++probeReplies;
+    maxRttNs = qMax(maxRttNs, rttNs);
+
+    const quint64 units = quint64(rttNs / 1000 / RTT_BUCKET_BASE_US);
+    const int bucket = units == 0 ? 0 : qMin(RTT_BUCKETS - 1, 64 - qCountLeadingZeroBits(units));
+    ++rttHistogram[bucket];
+
+    // Reservoir sampling: каждый замер попадает в выборку с равной вероятностью
+    if (rttSamplesNs.size() < RTT_SAMPLE_LIMIT) {
+        rttSamplesNs.append(rttNs);
+    } else {
+        const quint64 slot = random.bounded(quint64(probeReplies));
+        if (slot < quint64(RTT_SAMPLE_LIMIT))
+            rttSamplesNs[qsizetype(slot)] = rttNs;
+    }
+}
+
+void LoadStats::merge(const LoadStats &other) {
+    messagesSent += other.messagesSent;
+    bytesSent += other.bytesSent;
+    connectAttempts += other.connectAttempts;
+    connectErrors += other.connectErrors;
+    disconnects += other.disconnects;
+    socketErrors += other.socketErrors;
+    droppedMessages += other.droppedMessages;
+    busyReplies += other.busyReplies;
+    maxBackoffMs = qMax(maxBackoffMs, other.maxBackoffMs);
+    lateSends += other.lateSends;
+    maxLagNs = qMax(maxLagNs, other.maxLagNs);
+    connectTimesNs.append(other.connectTimesNs);
+    probesSent += other.probesSent;
+    probeReplies += other.probeReplies;
+    maxRttNs = qMax(maxRttNs, other.maxRttNs);
+    for (int i = 0; i < RTT_BUCKETS; ++i) {
+        rttHistogram[i] += other.rttHistogram[i];
+    }
+    rttSamplesNs.append(other.rttSamplesNs);
+}
+
+LoadWorker::LoadWorker(const LoadProfile &profile, const QList<qint64> &connectOffsetsNs,
+                       qint64 startNs, QObject *parent)
+    : QObject(parent), m_profile(profile), m_connectOffsetsNs(connectOffsetsNs),
+    m_startNs(startNs), m_wheel(startNs), m_random(QRandomGenerator::global()->generate()) {
+    // Каждый клиент отправляет свою долю суммарного темпа
+    m_meanIntervalNs = qMax<qint64>(1, qint64(1e9 * m_profile.clients / m_profile.rate));
+}
+
+LoadWorker::~LoadWorker() {}
+
+void LoadWorker::start() {
+    const bool local = m_profile.host == Protocol::Local::HOST;
+    m_connections.resize(m_connectOffsetsNs.size());
+
+    for (int i = 0; i < m_connections.size(); ++i) {
+        IClient *client = local ? static_cast<IClient *>(new LocalClient(new QLocalSocket(), this))
+                                : static_cast<IClient *>(new TcpClient(new QTcpSocket(), this));
+        m_connections[i].client = client;
+
+        connect(client, &IClient::connected, this, [this, i] { handleConnected(i); });
+        connect(client, &IClient::disconnected, this, [this, i] { handleDisconnected(i); });
+        connect(client, &IClient::dataReceived, this,
+                [this, i](const QByteArray &data) { handleDataReceived(i, data); });
+        connect(client, &IClient::errorOccurred, this, [this, i] { handleError(i); });
+
+        scheduleAt(i, m_startNs + m_connectOffsetsNs.at(i));
+    }
+
+    m_tickTimer = new QTimer(this);
+    m_tickTimer->setTimerType(Qt::PreciseTimer);
+    m_tickTimer->setInterval(int(TimerWheel::TICK_NS / 1000000));
+    connect(m_tickTimer, &QTimer::timeout, this, &LoadWorker::handleTick);
+    m_tickTimer->start();
+}
+
+void LoadWorker::stop() {
+    m_stopped = true;
+    if (m_tickTimer)
+        m_tickTimer->stop();
+
+    for (Connection &connection : m_connections) {
+        if (!connection.client)
+            continue;
+        m_stats.droppedMessages += connection.client->droppedMessages();
+        connection.client->blockSignals(true);
+        connection.client->disconnect();
+    }
+}
+
+void LoadWorker::handleTick() {
+    const qint64 nowNs = MonotonicClock::nowNs();
+    m_wheel.advance(nowNs, [this, nowNs](int index, qint64 dueNs) { handleDue(index, dueNs, nowNs); });
+}
+
+void LoadWorker::scheduleAt(int index, qint64 dueNs) {
+    m_connections[index].wheelDueNs = dueNs;
+    m_wheel.schedule(index, dueNs);
+}
+
+void LoadWorker::handleDue(int index, qint64 dueNs, qint64 nowNs) {
+    Connection &connection = m_connections[index];
+    // Срок мог быть заменен (переподключение, новый цикл отправки)
+    if (m_stopped || dueNs != connection.wheelDueNs)
+        return;
+    connection.wheelDueNs = -1;
+
+    switch (connection.state) {
+    case State::Idle:
+        connectClient(index, nowNs);
+        break;
+    case State::Sending:
+        sendDue(index, nowNs);
+        break;
+    case State::Connecting:
+    case State::Registering:
+        break;
+    }
+}
+
+void LoadWorker::connectClient(int index, qint64 nowNs) {
+    Connection &connection = m_connections[index];
+    connection.state = State::Connecting;
+    connection.connectStartedNs = nowNs;
+    ++m_stats.connectAttempts;
+    connection.client->connectToHost(m_profile.host, m_profile.port);
+}
+
+void LoadWorker::sendDue(int index, qint64 nowNs) {
+    Connection &connection = m_connections[index];
+    if (connection.nextProbeNs >= 0 && connection.nextProbeNs <= nowNs) {
+        sendProbe(connection, nowNs);
+        if (connection.state != State::Sending)
+            return;
+    }
+
+    // Все сообщения, плановое время которых прошло, уходят сразу: отставание не снижает темп
+    while (connection.nextSendNs <= nowNs) {
+        const qint64 lagNs = nowNs - connection.nextSendNs;
+        if (lagNs > LATE_THRESHOLD_NS)
+            ++m_stats.lateSends;
+        m_stats.maxLagNs = qMax(m_stats.maxLagNs, lagNs);
+
+        const QByteArray message = buildMessage(connection, connection.nextSendNs);
+        connection.client->sendData(message);
+        ++m_stats.messagesSent;
+        m_stats.bytesSent += quint64(message.size());
+        m_sentMessages.fetch_add(1, std::memory_order_relaxed);
+
+        connection.nextSendNs += nextIntervalNs();
+        // Отправка могла разорвать соединение (политика Disconnect)
+        if (connection.state != State::Sending)
+            return;
+    }
+    scheduleAt(index, connection.nextSendNs);
+}
+
+void LoadWorker::sendProbe(Connection &connection, qint64 nowNs) {
+    ++m_stats.probesSent;
+    connection.nextProbeNs = nowNs + qint64(m_profile.probeIntervalMs) * 1000000;
+    connection.client->sendData(MessageCodec::encode(ClockSync::probeRequest(nowNs), connection.encoding));
+}
+
+QByteArray LoadWorker::buildMessage(Connection &connection, qint64 plannedNs) {
+    const auto &mix = m_profile.mix;
+    int pick = int(m_random.bounded(quint32(mix[0] + mix[1] + mix[2])));
+    int kind = 0;
+    while (pick >= mix[kind]) {
+        pick -= mix[kind];
+        ++kind;
+    }
+
+    QJsonObject data;
+    switch (kind) {
+    case 0:
+        data = ClientLogic::generateNetworkMetrics(m_random);
+        break;
+    case 1:
+        data = ClientLogic::generateDeviceStatus(m_random);
+        break;
+    default:
+        data = ClientLogic::generateLog(
+            m_random, m_profile.payloadMin + int(m_random.bounded(quint32(m_profile.payloadMax - m_profile.payloadMin + 1))));
+        break;
+    }
+    data[Protocol::Keys::ID] = connection.client->id();
+    connection.clock.stamp(data, ++connection.sequence, plannedNs);
+    return MessageCodec::encode(data, connection.encoding);
+}
+
+qint64 LoadWorker::nextIntervalNs() {
+    if (m_profile.arrival == LoadProfile::Arrival::Uniform)
+        return m_meanIntervalNs;
+    // Экспоненциальный интервал с тем же средним; 1 - U не бывает нулем
+    return qMax<qint64>(1, qint64(-std::log(1.0 - m_random.generateDouble()) * m_meanIntervalNs));
+}
+
+void LoadWorker::scheduleReconnect(int index, qint64 nowNs) {
+    Connection &connection = m_connections[index];
+    if (connection.state == State::Idle)
+        return;
+    if (connection.state == State::Sending)
+        m_readyClients.fetch_sub(1, std::memory_order_relaxed);
+
+    connection.state = State::Idle;
+    const qint64 delayMs = connection.backoff.nextDelayMs(m_random);
+    m_stats.maxBackoffMs = qMax(m_stats.maxBackoffMs, delayMs);
+    scheduleAt(index, nowNs + delayMs * 1000000);
+}
+
+void LoadWorker::handleConnected(int index) {
+    Connection &connection = m_connections[index];
+    connection.state = State::Registering;
+
+    // Регистрация всегда уходит в JSON, формат меняется после подтверждения
+    connection.encoding = MessageCodec::Encoding::Json;
+    connection.client->sendData(MessageCodec::encode(
+        ClientLogic::registrationRequest(m_config, m_profile.encoding), MessageCodec::Encoding::Json));
+    connection.client->setFramingMode(IClient::FramingMode::LengthPrefixed);
+}
+
+void LoadWorker::handleDisconnected(int index) {
+    Connection &connection = m_connections[index];
+    if (connection.state == State::Sending) {
+        ++m_stats.disconnects;
+    } else if (connection.state != State::Idle) {
+        ++m_stats.connectErrors;
+    }
+    scheduleReconnect(index, MonotonicClock::nowNs());
+}
+
+void LoadWorker::handleDataReceived(int index, const QByteArray &data) {
+    Connection &connection = m_connections[index];
+    if (connection.state != State::Registering && connection.state != State::Sending)
+        return;
+
+    QCborMap message;
+    if (!MessageCodec::decode(data, message))
+        return;
+
+    const qint64 nowNs = MonotonicClock::nowNs();
+    const QString messageType = message.value(Protocol::Keys::TYPE).toString();
+    if (messageType == Protocol::MessageType::PROBE) {
+        const qint64 rttNs = connection.clock.handleReply(message, nowNs);
+        if (rttNs >= 0)
+            m_stats.addRtt(rttNs, m_random);
+        return;
+    }
+    if (messageType == Protocol::MessageType::BUSY) {
+        // Сервер закроет соединение; переподключение не раньше указанной паузы
+        ++m_stats.busyReplies;
+        connection.backoff.setRetryAfter(message.value(Protocol::Keys::RETRY_AFTER).toInteger());
+        return;
+    }
+    if (connection.state != State::Registering || messageType != Protocol::MessageType::CONFIRMATION)
+        return;
+
+    connection.encoding = ClientLogic::applyConfirmation(connection.client, message);
+    connection.backoff.reset();
+    connection.state = State::Sending;
+    m_stats.connectTimesNs.append(nowNs - connection.connectStartedNs);
+    m_readyClients.fetch_add(1, std::memory_order_relaxed);
+
+    // Первый Probe сразу: до ответа сообщения уходят без времени отправки
+    connection.clock.reset();
+    connection.nextProbeNs = -1;
+    if (m_profile.probeIntervalMs > 0 && message.contains(Protocol::Keys::SERVER_TIME)) {
+        sendProbe(connection, nowNs);
+        if (connection.state != State::Sending)
+            return;
+    }
+
+    // Случайная фаза, чтобы клиенты, подключившиеся одновременно, не отправляли пачкой
+    connection.nextSendNs = nowNs + qint64(m_random.generateDouble() * m_meanIntervalNs);
+    scheduleAt(index, connection.nextSendNs);
+}
+
+void LoadWorker::handleError(int index) {
+    ++m_stats.socketErrors;
+
+    // Неудачное подключение не всегда сопровождается сигналом disconnected
+    Connection &connection = m_connections[index];
+    if (connection.state != State::Idle && !connection.client->isConnected()) {
+        if (connection.state != State::Sending)
+            ++m_stats.connectErrors;
+        else
+            ++m_stats.disconnects;
+        scheduleReconnect(index, MonotonicClock::nowNs());
+    }
+}
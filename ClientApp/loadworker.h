@@ -0,0 +1,242 @@
+/**
+ * @file loadworker.h
+ * @brief Определяет класс LoadWorker — клиенты генератора нагрузки, обслуживаемые одним потоком.
+ */
+#ifndef LOADWORKER_H
+#define LOADWORKER_H
+
+#include <QList>
+#include <QObject>
+#include <QRandomGenerator>
+#include <QTimer>
+
+#include <array>
+#include <atomic>
+
+#include "../common/iclient.h"
+#include "../common/messagecodec.h"
+#include "clientlogic.h"
+#include "clocksync.h"
+#include "reconnectbackoff.h"
+#include "loadprofile.h"
+#include "timerwheel.h"
+
+/**
+ * @struct LoadStats
+ * @brief Счетчики генератора нагрузки (одного потока или суммарные).
+ */
+struct LoadStats {
+    /// @brief Количество корзин гистограммы времени оборота: корзина i — меньше RTT_BUCKET_BASE_US × 2^i.
+    static constexpr int RTT_BUCKETS = 16;
+    /// @brief Граница первой корзины гистограммы времени оборота (мкс).
+    static constexpr qint64 RTT_BUCKET_BASE_US = 125;
+    /// @brief Наибольшее количество хранимых замеров оборота на поток (для перцентилей).
+    static constexpr int RTT_SAMPLE_LIMIT = 100000;
+
+    quint64 messagesSent = 0;       ///< Отправлено сообщений телеметрии
+    quint64 bytesSent = 0;          ///< Отправлено байт (без регистрации)
+    quint64 connectAttempts = 0;    ///< Попыток подключения
+    quint64 connectErrors = 0;      ///< Ошибок до подтверждения регистрации
+    quint64 disconnects = 0;        ///< Разрывов после подтверждения регистрации
+    quint64 socketErrors = 0;       ///< Ошибок сокета
+    quint64 droppedMessages = 0;    ///< Сообщений, отброшенных очередью отправки
+    quint64 busyReplies = 0;        ///< Отказов сервера (Busy)
+    qint64 maxBackoffMs = 0;        ///< Наибольшая пауза перед переподключением
+    quint64 lateSends = 0;          ///< Сообщений, ушедших позже плана больше чем на LATE_THRESHOLD_NS
+    qint64 maxLagNs = 0;            ///< Наибольшее отставание от плана
+    QList<qint64> connectTimesNs;   ///< Время от начала подключения до подтверждения регистрации
+    quint64 probesSent = 0;         ///< Отправлено Probe
+    quint64 probeReplies = 0;       ///< Получено ответов на Probe
+    qint64 maxRttNs = 0;            ///< Наибольшее время оборота Probe
+    std::array<quint64, RTT_BUCKETS> rttHistogram{}; ///< Гистограмма времени оборота (все ответы)
+    QList<qint64> rttSamplesNs;     ///< Равномерная выборка времени оборота (не больше RTT_SAMPLE_LIMIT)
+
+    /**
+     * @brief Учитывает время оборота Probe.
+     * @param rttNs Время оборота.
+     * @param random Генератор для равномерной выборки при переполнении.
+     */
+    void addRtt(qint64 rttNs, QRandomGenerator &random);
+    /**
+     * @brief Добавляет счетчики другого потока.
+     */
+    void merge(const LoadStats &other);
+};
+
+/**
+ * @class LoadWorker
+ * @brief Группа клиентов генератора нагрузки в одном потоке.
+ *
+ * Все клиенты потока обслуживаются одним колесом таймеров и одним QTimer:
+ * подключения по графику разгона, переподключения (с растущими случайными
+ * паузами, чтобы после перезапуска сервера клиенты не возвращались разом)
+ * и отправка сообщений.
+ * Отправка открытая: время каждого сообщения планируется от предыдущего
+ * планового, а не от фактического времени отправки, поэтому задержки
+ * сервера или потока не снижают нагрузку (нет coordinated omission),
+ * а отставание от плана учитывается в статистике.
+ *
+ * Если сервер поддерживает Probe, каждый клиент раз в probeIntervalMs
+ * отправляет его вместе с очередным сообщением; время оборота попадает
+ * в статистику, а оценка смещения часов — в отметки времени сообщений.
+ */
+class LoadWorker : public QObject {
+    Q_OBJECT
+
+public:
+    /// @brief Отставание от плана, после которого отправка считается опоздавшей.
+    static constexpr qint64 LATE_THRESHOLD_NS = 5 * TimerWheel::TICK_NS;
+
+    /**
+     * @brief Конструктор класса LoadWorker.
+     * @param profile Параметры нагрузки.
+     * @param connectOffsetsNs Смещения начала подключения клиентов этого потока от startNs.
+     * @param startNs Общее для всех потоков время старта (MonotonicClock).
+     * @param parent Родительский объект QObject.
+     */
+    LoadWorker(const LoadProfile &profile, const QList<qint64> &connectOffsetsNs,
+               qint64 startNs, QObject *parent = nullptr);
+    ~LoadWorker();
+
+    /**
+     * @brief Возвращает количество отправленных сообщений. Потокобезопасен.
+     */
+    quint64 sentMessages() const { return m_sentMessages.load(std::memory_order_relaxed); }
+    /**
+     * @brief Возвращает количество клиентов, прошедших регистрацию. Потокобезопасен.
+     */
+    int readyClients() const { return m_readyClients.load(std::memory_order_relaxed); }
+    /**
+     * @brief Возвращает статистику; вызывается после stop().
+     */
+    const LoadStats &stats() const { return m_stats; }
+
+public slots:
+    /**
+     * @brief Создает клиентов и запускает таймер колеса (в потоке объекта).
+     */
+    void start();
+    /**
+     * @brief Останавливает отправку и отключает клиентов.
+     */
+    void stop();
+
+private:
+    /**
+     * @enum State
+     * @brief Состояние клиента генератора.
+     */
+    enum class State {
+        Idle,           ///< Ожидает подключения по графику разгона или переподключения
+        Connecting,     ///< Выполняется подключение
+        Registering,    ///< Отправлен запрос регистрации
+        Sending         ///< Регистрация подтверждена, идет отправка
+    };
+
+    /**
+     * @struct Connection
+     * @brief Клиент генератора и его расписание.
+     */
+    struct Connection {
+        IClient *client = nullptr;                                  ///< Клиент
+        State state = State::Idle;                                  ///< Состояние
+        MessageCodec::Encoding encoding = MessageCodec::Encoding::Json; ///< Подтвержденный формат
+        qint64 connectStartedNs = 0;                                ///< Начало подключения
+        qint64 nextSendNs = 0;                                      ///< Плановое время следующего сообщения
+        qint64 wheelDueNs = -1;                                     ///< Срок действующей записи колеса (остальные устарели)
+        qint64 nextProbeNs = -1;                                    ///< Время следующего Probe (-1 — без замеров)
+        quint64 sequence = 0;                                       ///< Номер последнего сообщения
+        ClockSync clock;                                            ///< Смещение часов сервера
+        ReconnectBackoff backoff;                                   ///< Паузы переподключения
+    };
+
+    /**
+     * @brief Обрабатывает тик таймера: вызывает наступившие сроки колеса.
+     */
+    void handleTick();
+    /**
+     * @brief Обрабатывает наступивший срок клиента.
+     * @param index Индекс клиента.
+     * @param dueNs Срок записи колеса; устаревшие записи пропускаются.
+     * @param nowNs Текущее время.
+     */
+    void handleDue(int index, qint64 dueNs, qint64 nowNs);
+    /**
+     * @brief Ставит срок клиента в колесо, заменяя предыдущий.
+     */
+    void scheduleAt(int index, qint64 dueNs);
+    /**
+     * @brief Начинает подключение клиента.
+     */
+    void connectClient(int index, qint64 nowNs);
+    /**
+     * @brief Отправляет все сообщения клиента, плановое время которых наступило.
+     */
+    void sendDue(int index, qint64 nowNs);
+    /**
+     * @brief Отправляет Probe и планирует следующий.
+     */
+    void sendProbe(Connection &connection, qint64 nowNs);
+    /**
+     * @brief Формирует очередное сообщение по заданной смеси типов.
+     * @param connection Клиент (номер сообщения увеличивается).
+     * @param plannedNs Плановое время отправки: отставание генератора входит в задержку на сервере.
+     */
+    QByteArray buildMessage(Connection &connection, qint64 plannedNs);
+    /**
+     * @brief Возвращает интервал до следующего сообщения клиента (в наносекундах).
+     */
+    qint64 nextIntervalNs();
+    /**
+     * @brief Переводит клиента в ожидание и планирует переподключение с паузой ReconnectBackoff.
+     */
+    void scheduleReconnect(int index, qint64 nowNs);
+
+    /**
+     * @brief Отправляет запрос регистрации после подключения.
+     */
+    void handleConnected(int index);
+    /**
+     * @brief Учитывает разрыв соединения и планирует переподключение.
+     */
+    void handleDisconnected(int index);
+    /**
+     * @brief Обрабатывает подтверждение регистрации, Busy и ответы на Probe; прочие сообщения игнорируются.
+     */
+    void handleDataReceived(int index, const QByteArray &data);
+    /**
+     * @brief Учитывает ошибку сокета.
+     */
+    void handleError(int index);
+
+    /// @brief Параметры нагрузки.
+    LoadProfile m_profile;
+    /// @brief Смещения начала подключения клиентов.
+    QList<qint64> m_connectOffsetsNs;
+    /// @brief Время старта.
+    qint64 m_startNs;
+    /// @brief Средний интервал между сообщениями одного клиента.
+    qint64 m_meanIntervalNs;
+
+    /// @brief Колесо сроков клиентов (id — индекс в m_connections).
+    TimerWheel m_wheel;
+    /// @brief Таймер, продвигающий колесо.
+    QTimer *m_tickTimer = nullptr;
+    /// @brief Клиенты потока.
+    QList<Connection> m_connections;
+    /// @brief Генератор случайных чисел потока (глобальный генератор защищен мьютексом).
+    QRandomGenerator m_random;
+    /// @brief Конфигурация, передаваемая при регистрации.
+    ClientConfiguration m_config;
+    /// @brief Признак остановки.
+    bool m_stopped = false;
+
+    /// @brief Статистика потока.
+    LoadStats m_stats;
+    /// @brief Счетчик отправленных сообщений для вывода прогресса.
+    std::atomic<quint64> m_sentMessages{0};
+    /// @brief Количество зарегистрированных клиентов для вывода прогресса.
+    std::atomic<int> m_readyClients{0};
+};
+
+#endif // LOADWORKER_H
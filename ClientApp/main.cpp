@@ -5,6 +5,7 @@
 #include <iostream>
 
 #include "clientlogic.h"
+#include "loadgenerator.h"
 
 int main(int argc, char *argv[]) {
     QCoreApplication a(argc, argv);
@@ -13,6 +14,10 @@ int main(int argc, char *argv[]) {
     QString host = "127.0.0.1";
     quint16 port = 12345;
     int clientCount = 3;
+    MessageCodec::Encoding encoding = MessageCodec::Encoding::Cbor;
+    // Режим генератора нагрузки
+    bool loadMode = false;
+    LoadProfile profile;
 
     // Обработка аргументов командной строки
     QStringList args = a.arguments();
@@ -29,19 +34,72 @@ int main(int argc, char *argv[]) {
             if (ok) {
                 clientCount = count;
             }
+        } else if (arg == "--local") {
+            host = Protocol::Local::HOST;
+        } else if (arg.startsWith("--encoding=")) {
+            QString name = arg.mid(QString("--encoding=").length());
+            if (name == Protocol::Encoding::JSON) {
+                encoding = MessageCodec::Encoding::Json;
+            } else if (name == Protocol::Encoding::CBOR) {
+                encoding = MessageCodec::Encoding::Cbor;
+            }
+        } else if (arg == "--load") {
+            loadMode = true;
+        } else if (arg.startsWith("--rate=")) {
+            bool ok;
+            double rate = arg.mid(QString("--rate=").length()).toDouble(&ok);
+            if (ok && rate > 0) {
+                profile.rate = rate;
+            }
+        } else if (arg.startsWith("--threads=")) {
+            profile.threads = arg.mid(QString("--threads=").length()).toInt();
+        } else if (arg.startsWith("--mix=")) {
+            if (!profile.parseMix(arg.mid(QString("--mix=").length()))) {
+                qWarning() << "Invalid --mix, expected e.g. network:5,device:3,log:2";
+            }
+        } else if (arg.startsWith("--payload=")) {
+            if (!profile.parsePayload(arg.mid(QString("--payload=").length()))) {
+                qWarning() << "Invalid --payload, expected N or MIN-MAX";
+            }
+        } else if (arg.startsWith("--arrival=")) {
+            profile.arrival = arg.mid(QString("--arrival=").length()) == "poisson"
+                                  ? LoadProfile::Arrival::Poisson
+                                  : LoadProfile::Arrival::Uniform;
+        } else if (arg.startsWith("--ramp-up=")) {
+            profile.rampUpSec = qMax(0, arg.mid(QString("--ramp-up=").length()).toInt());
+        } else if (arg.startsWith("--ramp-steps=")) {
+            profile.rampSteps = qMax(0, arg.mid(QString("--ramp-steps=").length()).toInt());
+        } else if (arg.startsWith("--duration=")) {
+            profile.durationSec = qMax(0, arg.mid(QString("--duration=").length()).toInt());
+        } else if (arg.startsWith("--probe-interval=")) {
+            profile.probeIntervalMs = qMax(0, arg.mid(QString("--probe-interval=").length()).toInt());
         }
     }
 
+    if (loadMode) {
+        profile.host = host;
+        profile.port = port;
+        profile.encoding = encoding;
+        profile.clients = qMax(1, clientCount);
+
+        LoadGenerator *generator = new LoadGenerator(profile, &a);
+        QObject::connect(generator, &LoadGenerator::finished, &a, &QCoreApplication::quit,
+                         Qt::QueuedConnection);
+        generator->start();
+        return a.exec();
+    }
+
     // Вывод информации о запуске
-    qDebug() << QString("Start %1 clients to (%2:%3).")
+    qDebug() << QString("Start %1 clients to (%2:%3), encoding: %4.")
                     .arg(clientCount)
                     .arg(host)
-                    .arg(port);
+                    .arg(port)
+                    .arg(MessageCodec::encodingName(encoding));
 
     // Создание и запуск клиентов
     QList<ClientLogic *> clients;
     for (int i = 0; i < clientCount; ++i) {
-        clients.append(new ClientLogic(host, port, &a));
+        clients.append(new ClientLogic(host, port, encoding, &a));
         clients.last()->start();
     }
 
@@ -0,0 +1,30 @@
+#include "reconnectbackoff.h"
+
+ReconnectBackoff::ReconnectBackoff(qint64 baseMs, qint64 capMs)
+    : m_baseMs(qMax<qint64>(1, baseMs)), m_capMs(qMax(m_baseMs, capMs)), m_previousMs(m_baseMs) {}
+
+qint64 ReconnectBackoff::nextDelayMs(QRandomGenerator &random) {
+    ++m_failures;
+
+    // Случайно между базовой и утроенной предыдущей паузой
+    const qint64 upper = qMin(m_capMs, qMax(m_baseMs, m_previousMs * 3));
+    qint64 delay = m_baseMs + qint64(random.bounded(quint64(upper - m_baseMs + 1)));
+
+    if (m_retryAfterMs > 0) {
+        // Пауза сервера — нижняя граница; разброс сверху, чтобы отклоненные вместе не вернулись вместе
+        delay = qMax(delay, m_retryAfterMs + qint64(random.bounded(quint64(m_retryAfterMs / 2 + 1))));
+        m_retryAfterMs = 0;
+    }
+    m_previousMs = delay;
+    return delay;
+}
+
+void ReconnectBackoff::setRetryAfter(qint64 retryAfterMs) {
+    m_retryAfterMs = qMax<qint64>(0, retryAfterMs);
+}
+
+void ReconnectBackoff::reset() {
+    m_previousMs = m_baseMs;
+    m_retryAfterMs = 0;
+    m_failures = 0;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file reconnectbackoff.h
+ * @brief Определяет класс ReconnectBackoff — паузы переподключения с экспоненциальным ростом и разбросом.
+ */
+#ifndef RECONNECTBACKOFF_H
+#define RECONNECTBACKOFF_H
+
+#include <QRandomGenerator>
+
+#include "clientprotocol.h"
+
+/**
+ * @class ReconnectBackoff
+ * @brief Паузы между попытками подключения по схеме decorrelated jitter.
+ *
+ * Очередная пауза выбирается случайно между базовой и утроенной предыдущей
+ * и ограничивается сверху, поэтому клиенты, потерявшие сервер одновременно,
+ * расходятся во времени уже после первой попытки, а не повторяют ее
+ * синхронно. Пауза, которую сервер передал в Busy, служит нижней границей
+ * следующей попытки. Успешная регистрация сбрасывает рост пауз.
+ */
+class ReconnectBackoff {
+public:
+    /**
+     * @brief Конструктор класса ReconnectBackoff.
+     * @param baseMs Наименьшая пауза (мс).
+     * @param capMs Наибольшая пауза без указания сервера (мс).
+     */
+    explicit ReconnectBackoff(qint64 baseMs = Protocol::Constants::RECONNECT_BASE_MS,
+                              qint64 capMs = Protocol::Constants::RECONNECT_CAP_MS);
+
+    /**
+     * @brief Возвращает паузу перед следующей попыткой и учитывает попытку.
+     * @param random Генератор случайных чисел потока.
+     */
+    qint64 nextDelayMs(QRandomGenerator &random);
+    /**
+     * @brief Запоминает паузу, рекомендованную сервером в Busy.
+     * @param retryAfterMs Пауза (мс).
+     */
+    void setRetryAfter(qint64 retryAfterMs);
+    /**
+     * @brief Сбрасывает рост пауз после успешной регистрации.
+     */
+    void reset();
+
+    /**
+     * @brief Возвращает количество неудачных попыток подряд.
+     */
+    int failures() const { return m_failures; }
+
+private:
+    qint64 m_baseMs;
+    qint64 m_capMs;
+    /// @brief Предыдущая пауза.
+    qint64 m_previousMs;
+    /// @brief Пауза из последнего Busy (0 — не было).
+    qint64 m_retryAfterMs = 0;
+    /// @brief Неудачных попыток подряд.
+    int m_failures = 0;
+};
+
+#endif // RECONNECTBACKOFF_H
@@ -0,0 +1,36 @@
+#include "timerwheel.h"
+
+#include <utility>
+
+TimerWheel::TimerWheel(qint64 startNs) : m_startNs(startNs) {}
+
+void TimerWheel::schedule(int id, qint64 dueNs) {
+    const qint64 tick = qMax(tickOf(dueNs), m_currentTick + 1);
+    m_slots[tick & (SLOT_COUNT - 1)].append(Entry{id, dueNs});
+    ++m_size;
+}
+
+void TimerWheel::advance(qint64 nowNs, const Handler &handler) {
+    const qint64 nowTick = tickOf(nowNs);
+    // При отставании больше оборота достаточно обойти каждую ячейку один раз
+    const qint64 lastTick = qMin(nowTick, m_currentTick + SLOT_COUNT);
+
+    while (m_currentTick < lastTick) {
+        ++m_currentTick;
+        QList<Entry> &slot = m_slots[m_currentTick & (SLOT_COUNT - 1)];
+        if (slot.isEmpty())
+            continue;
+
+        // Обработчик может добавить сроки в эту же ячейку (через оборот), поэтому забираем ее целиком
+        const QList<Entry> entries = std::exchange(slot, {});
+        for (const Entry &entry : entries) {
+            if (tickOf(entry.dueNs) > nowTick) {
+                slot.append(entry);
+                continue;
+            }
+            --m_size;
+            handler(entry.id, entry.dueNs);
+        }
+    }
+    m_currentTick = nowTick;
+}
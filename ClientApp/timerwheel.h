@@ -0,0 +1,88 @@
+/**
+ * @file timerwheel.h
+ * @brief Определяет класс TimerWheel — колесо таймеров для множества клиентов одного потока.
+ */
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <QList>
+#include <QtGlobal>
+
+#include <functional>
+
+/**
+ * @class TimerWheel
+ * @brief Колесо таймеров с шагом TICK_NS и SLOT_COUNT ячейками.
+ *
+ * Заменяет отдельный QTimer на каждого клиента: все сроки потока хранятся в
+ * ячейках колеса по номеру тика, а один таймер потока вызывает advance().
+ * Постановка срока — O(1); за тик просматривается одна ячейка. Сроки дальше
+ * одного оборота колеса остаются в своей ячейке и пропускаются, пока не
+ * наступят.
+ */
+class TimerWheel {
+public:
+    /// @brief Длительность тика (в наносекундах).
+    static constexpr qint64 TICK_NS = 1000000;
+    /// @brief Количество ячеек (степень двойки; один оборот — около секунды).
+    static constexpr int SLOT_COUNT = 1024;
+
+    /**
+     * @brief Обработчик наступившего срока.
+     * @param id Идентификатор, переданный в schedule().
+     * @param dueNs Запланированный срок.
+     */
+    using Handler = std::function<void(int id, qint64 dueNs)>;
+
+    /**
+     * @brief Конструктор класса TimerWheel.
+     * @param startNs Время, с которого отсчитываются тики (MonotonicClock).
+     */
+    explicit TimerWheel(qint64 startNs = 0);
+
+    /**
+     * @brief Планирует вызов обработчика для id не раньше dueNs.
+     *
+     * Срок в прошлом или в текущем тике переносится на следующий тик.
+     */
+    void schedule(int id, qint64 dueNs);
+    /**
+     * @brief Вызывает обработчик для всех наступивших сроков.
+     *
+     * Обработчик может планировать новые сроки. Если поток отстал больше чем
+     * на оборот колеса, каждая ячейка просматривается один раз.
+     * @param nowNs Текущее время.
+     * @param handler Обработчик.
+     */
+    void advance(qint64 nowNs, const Handler &handler);
+    /**
+     * @brief Возвращает количество запланированных сроков.
+     */
+    int size() const { return m_size; }
+
+private:
+    /**
+     * @struct Entry
+     * @brief Запланированный срок.
+     */
+    struct Entry {
+        int id;         ///< Идентификатор
+        qint64 dueNs;   ///< Срок
+    };
+
+    /**
+     * @brief Возвращает номер тика для момента времени.
+     */
+    qint64 tickOf(qint64 ns) const { return (ns - m_startNs) / TICK_NS; }
+
+    /// @brief Начало отсчета тиков.
+    qint64 m_startNs;
+    /// @brief Последний обработанный тик.
+    qint64 m_currentTick = 0;
+    /// @brief Количество запланированных сроков.
+    int m_size = 0;
+    /// @brief Ячейки колеса.
+    QList<Entry> m_slots[SLOT_COUNT];
+};
+
+#endif // TIMERWHEEL_H
@@ -26,7 +26,7 @@ public:
      * @enum ServerType
      * @brief Типы поддерживаемых серверов.
      */
-    enum class ServerType { TCP, UDP, MODBUS_TCP, MODBUS_RTU };
+    enum class ServerType { TCP, UDP, MODBUS_TCP, MODBUS_RTU, LOCAL };
     Q_ENUM(ServerType)
 
     /**
@@ -44,6 +44,8 @@ public:
             return "MODBUS TCP";
         case ServerType::MODBUS_RTU:
             return "MODBUS RTU";
+        case ServerType::LOCAL:
+            return "LOCAL";
         default:
             return "Неизвестно";
         }
@@ -107,6 +109,65 @@ public:
             return "Неизвестно";
         }
     }
+
+    /**
+     * @enum LogLevel
+     * @brief Уровни важности сообщений лога.
+     */
+    enum class LogLevel { Debug, Info, Warning, Error };
+    Q_ENUM(LogLevel)
+
+    /**
+     * @brief Преобразует LogLevel в строку.
+     * @param level Уровень сообщения.
+     * @return Строковое представление уровня.
+     */
+    Q_INVOKABLE static QString logLevelToString(LogLevel level) {
+        switch (level) {
+        case LogLevel::Debug:
+            return "DEBUG";
+        case LogLevel::Info:
+            return "INFO";
+        case LogLevel::Warning:
+            return "WARN";
+        case LogLevel::Error:
+            return "ERROR";
+        default:
+            return "Неизвестно";
+        }
+    }
+
+    /**
+     * @enum LogCategory
+     * @brief Категории (источники) сообщений лога.
+     */
+    enum class LogCategory {
+        Server,  // Запуск и остановка серверов
+        Network, // Подключения и обмен данными
+        Clients, // Регистрация и конфигурация клиентов
+        Data,    // Разбор и обработка сообщений
+    };
+    Q_ENUM(LogCategory)
+
+    /**
+     * @brief Преобразует LogCategory в строку.
+     * @param category Категория сообщения.
+     * @return Строковое представление категории.
+     */
+    Q_INVOKABLE static QString logCategoryToString(LogCategory category) {
+        switch (category) {
+        case LogCategory::Server:
+            return "server";
+        case LogCategory::Network:
+            return "network";
+        case LogCategory::Clients:
+            return "clients";
+        case LogCategory::Data:
+            return "data";
+        default:
+            return "Неизвестно";
+        }
+    }
 };
 
 #endif // APPENUMS_H
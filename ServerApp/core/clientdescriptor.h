@@ -0,0 +1,32 @@
+/**
+ * @file clientdescriptor.h
+ * @brief Выдача синтетических дескрипторов клиентам, у которых нет собственного сокета.
+ */
+#ifndef CLIENTDESCRIPTOR_H
+#define CLIENTDESCRIPTOR_H
+
+#include <QtGlobal>
+
+#include <atomic>
+
+/**
+ * @namespace ClientDescriptor
+ * @brief Синтетические дескрипторы для UDP-отправителей, опрашиваемых устройств и т.п.
+ *
+ * Дескриптор — ключ клиента в общем реестре DataProcessing, поэтому он не должен
+ * совпадать с дескрипторами сокетов TCP-клиентов.
+ */
+namespace ClientDescriptor {
+/// @brief Первый синтетический дескриптор (заведомо выше номеров сокетов).
+constexpr quintptr FIRST_SYNTHETIC = quintptr(1) << 24;
+
+/**
+ * @brief Возвращает новый дескриптор, уникальный в пределах процесса. Потокобезопасен.
+ */
+inline quintptr allocate() {
+    static std::atomic<quintptr> next{FIRST_SYNTHETIC};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+} // namespace ClientDescriptor
+
+#endif // CLIENTDESCRIPTOR_H
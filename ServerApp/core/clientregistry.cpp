@@ -0,0 +1,104 @@
+#include "clientregistry.h"
+
+ClientState *ClientRegistry::find(quintptr descriptor) {
+    auto it = m_states.find(descriptor);
+    return it != m_states.end() ? &it.value() : nullptr;
+}
+
+const ClientState *ClientRegistry::find(quintptr descriptor) const {
+    auto it = m_states.constFind(descriptor);
+    return it != m_states.constEnd() ? &it.value() : nullptr;
+}
+
+ClientState &ClientRegistry::insert(const ClientState &state) {
+    const quintptr descriptor = state.client ? state.client->descriptor() : 0;
+    take(descriptor);
+
+    ClientState &stored = m_states[descriptor];
+    stored = state;
+    m_statusIndex[stored.status].insert(descriptor);
+    return stored;
+}
+
+ClientState ClientRegistry::take(quintptr descriptor) {
+    auto it = m_states.find(descriptor);
+    if (it == m_states.end())
+        return ClientState();
+
+    ClientState state = it.value();
+    m_states.erase(it);
+    m_statusIndex[state.status].remove(descriptor);
+    releaseId(descriptor);
+    return state;
+}
+
+void ClientRegistry::clear() {
+    m_states.clear();
+    m_idIndex.clear();
+    m_assignedIds.clear();
+    m_statusIndex.clear();
+    m_suffixCounters.clear();
+}
+
+void ClientRegistry::setStatus(ClientState &state, AppEnums::ClientStatus status) {
+    if (state.status == status)
+        return;
+
+    const quintptr descriptor = state.client ? state.client->descriptor() : 0;
+    m_statusIndex[state.status].remove(descriptor);
+    state.status = status;
+    m_statusIndex[status].insert(descriptor);
+}
+
+QList<quintptr> ClientRegistry::descriptorsWithStatus(AppEnums::ClientStatus status) const {
+    const QSet<quintptr> bucket = m_statusIndex.value(status);
+    return QList<quintptr>(bucket.cbegin(), bucket.cend());
+}
+
+ClientState *ClientRegistry::findDisconnected(const QString &id) {
+    auto it = m_idIndex.constFind(id);
+    if (it == m_idIndex.constEnd())
+        return nullptr;
+
+    ClientState *state = find(it.value());
+    return state && state->status == AppEnums::DISCONNECTED ? state : nullptr;
+}
+
+QString ClientRegistry::uniqueId(const QString &requestedId) {
+    if (!m_idIndex.contains(requestedId))
+        return requestedId;
+
+    // Счетчик только растет, поэтому проверка обычно проходит с первой попытки.
+    // Цикл нужен, если клиент сам запросил ID вида "base_N"
+    int &suffix = m_suffixCounters[requestedId];
+    QString candidate;
+    do {
+        candidate = QString("%1_%2").arg(requestedId).arg(++suffix);
+    } while (m_idIndex.contains(candidate));
+    return candidate;
+}
+
+void ClientRegistry::assignId(ClientState &state, const QString &id) {
+    if (!state.client)
+        return;
+
+    const quintptr descriptor = state.client->descriptor();
+    releaseId(descriptor);
+
+    state.client->setId(id);
+    m_idIndex.insert(id, descriptor);
+    m_assignedIds.insert(descriptor, id);
+}
+
+void ClientRegistry::releaseId(quintptr descriptor) {
+    const QString id = m_assignedIds.take(descriptor);
+    if (id.isEmpty())
+        return;
+
+    auto it = m_idIndex.find(id);
+    if (it != m_idIndex.end() && it.value() == descriptor) {
+        // Счетчик суффиксов сохраняется: иначе после отключения владельца базового ID
+        // следующее совпадение перебирало бы "base_1", "base_2"... среди живых клиентов
+        m_idIndex.erase(it);
+    }
+}
@@ -0,0 +1,151 @@
+/**
+ * @file clientregistry.h
+ * @brief Определяет класс ClientRegistry — реестр состояний клиентов с индексами.
+ */
+#ifndef CLIENTREGISTRY_H
+#define CLIENTREGISTRY_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QVariantMap>
+
+#include "../common/iclient.h"
+#include "../common/messagecodec.h"
+#include "core/appenums.h"
+#include "core/iserver.h"
+#include "core/tokenbucket.h"
+
+/**
+ * @struct ClientState
+ * @brief Структура для хранения полного состояния клиента.
+ */
+struct ClientState {
+    IClient *client = nullptr; ///< Указатель на объект клиента.
+    IServer *server = nullptr; ///< Сервер, принявший подключение клиента.
+    AppEnums::ClientStatus status = AppEnums::DISCONNECTED; ///< Текущий статус клиента (изменяется через ClientRegistry::setStatus).
+    bool allowSending = false; ///< Флаг, разрешающий отправку команд клиенту.
+    QVariantMap configuration; ///< Конфигурация, связанная с клиентом.
+    MessageCodec::Encoding encoding = MessageCodec::Encoding::Json; ///< Согласованный формат сообщений.
+    qint64 queuedBytes = 0; ///< Объем очереди отправки, последний переданный в UI.
+    quint64 droppedMessages = 0; ///< Количество отброшенных сообщений, последнее переданное в UI.
+    TokenBucket rateLimiter; ///< Общий ограничитель темпа входящих сообщений (см. RateLimits::perClient).
+    quint64 rateLimited = 0; ///< Количество сообщений, отброшенных ограничителями темпа.
+    int reportedTokens = -1; ///< Уровень маркеров (в долях DataProcessing::RATE_REPORT_STEPS), последний переданный в UI.
+    quint64 reportedRateLimited = 0; ///< Количество отброшенных по темпу, последнее переданное в UI.
+    qint64 lastActivityNs = 0; ///< Время последнего входящего сообщения, подключения или отключения.
+    int flowLevel = 0; ///< Уровень темпа телеметрии, последний отправленный клиенту (см. FlowController).
+    quint64 flowRateLimited = 0; ///< Количество отброшенных по темпу на момент прошлой оценки нагрузки.
+};
+
+/**
+ * @class ClientRegistry
+ * @brief Реестр состояний клиентов с хешированными вторичными индексами.
+ *
+ * Основное хранилище — хеш-таблица по дескриптору. Дополнительно поддерживаются:
+ * - индекс зарегистрированных ID (ID → дескриптор);
+ * - корзины дескрипторов по статусу;
+ * - счетчики суффиксов для каждого базового ID.
+ *
+ * Поиск переподключающегося клиента, выдача уникального ID и выборка клиентов
+ * по статусу выполняются за O(1) (амортизированно), без перебора всех клиентов.
+ * Счетчик суффиксов удаляется вместе с освобожденным базовым ID, поэтому
+ * реестр не растет при постоянной смене клиентов.
+ */
+class ClientRegistry {
+public:
+    /**
+     * @brief Возвращает количество клиентов в реестре.
+     */
+    int size() const { return m_states.size(); }
+    /**
+     * @brief Проверяет наличие клиента с указанным дескриптором.
+     */
+    bool contains(quintptr descriptor) const { return m_states.contains(descriptor); }
+    /**
+     * @brief Возвращает состояние клиента по дескриптору.
+     * @return Указатель на состояние или nullptr, если клиент не найден.
+     */
+    ClientState *find(quintptr descriptor);
+    const ClientState *find(quintptr descriptor) const;
+
+    /**
+     * @brief Добавляет клиента в реестр (ключ — дескриптор клиента).
+     *
+     * Существующая запись с тем же дескриптором заменяется.
+     * @param state Начальное состояние клиента.
+     * @return Ссылка на сохраненное состояние.
+     */
+    ClientState &insert(const ClientState &state);
+    /**
+     * @brief Удаляет клиента из реестра и всех индексов.
+     * @param descriptor Дескриптор клиента.
+     * @return Удаленное состояние (пустое, если клиент не найден).
+     */
+    ClientState take(quintptr descriptor);
+    /**
+     * @brief Очищает реестр и все индексы.
+     */
+    void clear();
+
+    /**
+     * @brief Изменяет статус клиента с обновлением корзин статусов.
+     * @param state Состояние клиента, хранящееся в реестре.
+     * @param status Новый статус.
+     */
+    void setStatus(ClientState &state, AppEnums::ClientStatus status);
+    /**
+     * @brief Возвращает дескрипторы клиентов с указанным статусом.
+     */
+    QList<quintptr> descriptorsWithStatus(AppEnums::ClientStatus status) const;
+
+    /**
+     * @brief Ищет отключенного клиента с указанным ID.
+     * @param id ID клиента.
+     * @return Указатель на состояние или nullptr.
+     */
+    ClientState *findDisconnected(const QString &id);
+    /**
+     * @brief Подбирает свободный ID на основе запрошенного.
+     *
+     * Если запрошенный ID занят, добавляется суффикс "_N". Номер берется из
+     * счетчика базового ID, поэтому повторные регистрации с одним ID не
+     * перебирают уже выданные суффиксы.
+     * @param requestedId Запрошенный клиентом ID.
+     * @return Свободный ID.
+     */
+    QString uniqueId(const QString &requestedId);
+    /**
+     * @brief Назначает клиенту ID и заносит его в индекс.
+     *
+     * Предыдущий ID клиента, если он был назначен, освобождается.
+     * @param state Состояние клиента, хранящееся в реестре.
+     * @param id Новый ID.
+     */
+    void assignId(ClientState &state, const QString &id);
+
+    /**
+     * @brief Возвращает все состояния клиентов (для перебора).
+     */
+    const QHash<quintptr, ClientState> &states() const { return m_states; }
+
+private:
+    /**
+     * @brief Удаляет ID клиента из индекса, если он принадлежит этому клиенту.
+     */
+    void releaseId(quintptr descriptor);
+
+    /// @brief Состояния клиентов по дескриптору.
+    QHash<quintptr, ClientState> m_states;
+    /// @brief Индекс зарегистрированных ID: ID → дескриптор.
+    QHash<QString, quintptr> m_idIndex;
+    /// @brief Назначенный ID каждого зарегистрированного клиента: дескриптор → ID.
+    QHash<quintptr, QString> m_assignedIds;
+    /// @brief Корзины дескрипторов по статусу клиента.
+    QHash<int, QSet<quintptr>> m_statusIndex;
+    /// @brief Последний выданный суффикс для каждого базового ID.
+    QHash<QString, int> m_suffixCounters;
+};
+
+#endif // CLIENTREGISTRY_H
@@ -1,11 +1,56 @@
 #include "dataprocessing.h"
 #include "core/iserver.h"
 #include "core/appenums.h"
+#include "core/logger.h"
 #include "core/sharedkeys.h"
+#include "../common/monotonicclock.h"
 
-DataProcessing::DataProcessing(QObject *parent) : QObject(parent) {}
+#include <utility>
 
-DataProcessing::~DataProcessing() {}
+DataProcessing::DataProcessing(QObject *parent, int shardCount, const RateLimits &limits)
+    : QObject(parent), m_rateLimits(limits), m_expiryTimer(new QTimer(this)) {
+    m_expiryTimer->setInterval(IDLE_WHEEL_TICK_MS);
+    connect(m_expiryTimer, &QTimer::timeout, this, &DataProcessing::expireClients);
+
+    if (shardCount <= 0)
+        shardCount = QThread::idealThreadCount();
+    startShards(qBound(1, shardCount, MAX_PARSE_SHARDS));
+}
+
+DataProcessing::~DataProcessing() { stopShards(); }
+
+void DataProcessing::startShards(int count) {
+    for (int i = 0; i < count; ++i) {
+        QThread *thread = new QThread(this);
+        thread->setObjectName(QString("Parse-%1").arg(i));
+
+        ParseShard *shard = new ParseShard(m_rateLimits);
+        shard->moveToThread(thread);
+        connect(thread, &QThread::finished, shard, &QObject::deleteLater);
+        connect(shard, &ParseShard::registrationReceived, this, &DataProcessing::handleShardRegistration);
+        connect(shard, &ParseShard::configurationReceived, this, &DataProcessing::handleShardConfiguration);
+        connect(shard, &ParseShard::probeReceived, this, &DataProcessing::handleShardProbe);
+        connect(shard, &ParseShard::dataQueued, this, &DataProcessing::dataQueued);
+
+        m_shardThreads.append(thread);
+        m_shards.append(shard);
+        thread->start();
+    }
+}
+
+void DataProcessing::stopShards() {
+    for (QThread *thread : std::as_const(m_shardThreads)) {
+        thread->quit();
+        thread->wait();
+    }
+    qDeleteAll(m_shardThreads);
+    m_shardThreads.clear();
+    m_shards.clear();
+}
+
+ParseShard *DataProcessing::shardFor(quintptr descriptor) const {
+    return m_shards.at(int(qHash(descriptor) % uint(m_shards.size())));
+}
 
 void DataProcessing::addServer(IServer *server) {
     if (!server)
@@ -16,149 +61,256 @@ void DataProcessing::addServer(IServer *server) {
     connect(server, &IServer::dataReceived, this, &DataProcessing::handleDataReceived);
 }
 
+void DataProcessing::removeServer(IServer *server) {
+    if (!server)
+        return;
+
+    disconnect(server, nullptr, this, nullptr);
+
+    QList<quintptr> descriptors;
+    const QHash<quintptr, ClientState> &states = m_clients.states();
+    for (auto it = states.constBegin(); it != states.constEnd(); ++it) {
+        if (it.value().server == server)
+            descriptors.append(it.key());
+    }
+    for (quintptr descriptor : std::as_const(descriptors)) {
+        removeClient(descriptor);
+    }
+
+    if (!descriptors.isEmpty())
+        LOG_INFO(AppEnums::LogCategory::Clients,
+                 QString("Удалено %1 клиентов удаляемого сервера.").arg(descriptors.size()));
+}
+
 void DataProcessing::handleClientConnected(IClient *client) {
     if (!client)
         return;
 
     quintptr descriptor = client->descriptor();
+
+    // Дескриптор мог освободиться и достаться новому подключению, пока старый
+    // клиент числится отключенным
+    if (m_clients.contains(descriptor)) {
+        removeClient(descriptor);
+    }
+
     client->setId(QString::number(descriptor));
 
     ClientState state;
     state.client = client;
+    // Клиент может жить в потоке ввода-вывода, поэтому сервер не является его
+    // родителем и запоминается явно
+    state.server = qobject_cast<IServer *>(sender());
     state.status = AppEnums::AUTHORIZING;
     state.allowSending = false;
-
-    m_clients[descriptor] = state;
-
-    m_clientBatch.append(getClientDataMap(state));
-    emit logMessage(QString("Клиент %1 (%2:%3) ожидает авторизации.")
-                        .arg(client->id())
-                        .arg(client->address())
-                        .arg(client->port()));
+    state.rateLimiter = TokenBucket(m_rateLimits.perClient.ratePerSec, m_rateLimits.perClient.burst);
+    state.lastActivityNs = MonotonicClock::nowNs();
+
+    const ClientState &stored = m_clients.insert(state);
+    if (const qint64 timeoutNs = idleTimeoutNs(stored))
+        scheduleExpiry(descriptor, stored.lastActivityNs + timeoutNs);
+
+    m_clientBatch.append(getClientDataMap(stored));
+    LOG_INFO(AppEnums::LogCategory::Clients,
+             QString("Клиент %1 (%2:%3) ожидает авторизации.")
+                 .arg(client->id())
+                 .arg(client->address())
+                 .arg(client->port()));
 }
 
 void DataProcessing::handleClientDisconnected(IClient *client) {
     if (!client)
         return;
 
-    if (m_clients.contains(client->descriptor())) {
-        ClientState &state = m_clients[client->descriptor()];
+    ClientState *state = m_clients.find(client->descriptor());
+    if (state && state->client == client) {
         // Если клиент отключается до регистрации, его можно сразу удалить
-        if (state.status == AppEnums::AUTHORIZING) {
-            auto it = m_clients.find(client->descriptor());
-            if (it != m_clients.end()) {
-                removeClient(it.value());
-                m_clients.erase(it);
-            }
+        if (state->status == AppEnums::AUTHORIZING) {
+            removeClient(client->descriptor());
         } else {
-            state.status = AppEnums::DISCONNECTED;
-            state.allowSending = false;
-            m_clientBatch.append(getClientDataMap(state));
+            m_clients.setStatus(*state, AppEnums::DISCONNECTED);
+            state->allowSending = false;
+            state->lastActivityNs = MonotonicClock::nowNs();
+            scheduleExpiry(client->descriptor(),
+                           state->lastActivityNs + qint64(DISCONNECTED_TTL_MS) * 1000000);
+            m_clientBatch.append(getClientDataMap(*state));
         }
 
-        emit logMessage(QString("Клиент %1 (%2:%3) отключен.")
-                            .arg(client->id())
-                            .arg(client->address())
-                            .arg(client->port()));
+        LOG_INFO(AppEnums::LogCategory::Clients,
+                 QString("Клиент %1 (%2:%3) отключен.")
+                     .arg(client->id())
+                     .arg(client->address())
+                     .arg(client->port()));
     } else {
-        emit logMessage(QString("Получен сигнал отключения для незарегистрированного клиента."));
+        LOG_WARNING(AppEnums::LogCategory::Clients, QString("Получен сигнал отключения для незарегистрированного клиента."));
     }
 }
 
 void DataProcessing::removeDisconnectedClients() {
-    int count = 0;
-    auto it = m_clients.begin();
-
-    while (it != m_clients.end()) {
-        if (it.value().status == AppEnums::DISCONNECTED) {
-            removeClient(it.value());
-            it = m_clients.erase(it);
-            count++;
-        } else {
-            ++it;
-        }
+    const QList<quintptr> descriptors = m_clients.descriptorsWithStatus(AppEnums::DISCONNECTED);
+    for (quintptr descriptor : descriptors) {
+        removeClient(descriptor);
     }
 
-    if (count)
-        emit logMessage(QString("Удалено %1 неактивных клиентов.").arg(count));
+    if (!descriptors.isEmpty())
+        LOG_INFO(AppEnums::LogCategory::Clients, QString("Удалено %1 неактивных клиентов.").arg(descriptors.size()));
 }
 
-void DataProcessing::removeClient(ClientState &state) {
+void DataProcessing::removeClient(quintptr descriptor) {
+    ClientState state = m_clients.take(descriptor);
     IClient *client = state.client;
     if (!client) return;
 
-    m_usedClientIds.remove(client->id());
+    m_expiryWheel.cancel(descriptor);
+
     state.status = AppEnums::DELETED;
     m_clientBatch.append(getClientDataMap(state));
 
-    if (IServer *server = qobject_cast<IServer *>(client->parent())) {
-        server->removeClient(client);
+    ParseShard *shard = shardFor(descriptor);
+    QMetaObject::invokeMethod(shard, [shard, descriptor] { shard->forgetClient(descriptor); },
+                              Qt::QueuedConnection);
+
+    if (state.server) {
+        state.server->removeClient(client);
     }
 }
 
-void DataProcessing::registerClient(IClient *client, const QString &id, const QJsonObject &payload) {
+void DataProcessing::registerClient(IClient *client, const QCborMap &request) {
     if (!client) {
-        emit logMessage("Попытка зарегистрировать null-клиента.");
+        LOG_ERROR(AppEnums::LogCategory::Clients, "Попытка зарегистрировать null-клиента.");
         return;
     }
 
     quintptr descriptor = client->descriptor();
 
     if (!m_clients.contains(descriptor)) {
-        emit logMessage(QString("Попытка зарегистрировать клиент, который не проходил первичное подключение (дескриптор: %1).").arg(descriptor));
+        LOG_WARNING(AppEnums::LogCategory::Clients, QString("Попытка зарегистрировать клиент, который не проходил первичное подключение (дескриптор: %1).").arg(descriptor));
         return;
     }
 
+    const QString id = request.value(Protocol::Keys::ID).toString();
+    const QCborMap payload = request.value(Protocol::Keys::PAYLOAD).toMap();
     QString assignedId = id;
     bool allowSending = true;
 
     // Поиск клиента с таким же ID в состоянии DISCONNECTED
-    auto it = std::find_if(m_clients.begin(), m_clients.end(),
-                           [&](const auto &state) {
-                               return state.client && state.client->id() == id &&
-                                      state.status == AppEnums::DISCONNECTED;
-                           });
-
-    if (it != m_clients.end()) {
-        // Переподключение
-        ClientState oldState = it.value();
-        // Удаляем старого клиента
-        removeClient(oldState);
-        m_clients.erase(it);
-        allowSending = oldState.allowSending;
+    if (const ClientState *oldState = m_clients.findDisconnected(id)) {
+        // Переподключение: удаляем старого клиента, ID освобождается
+        allowSending = oldState->allowSending;
+        removeClient(oldState->client->descriptor());
     } else {
         // Новый клиент
-        int suffix = 0;
-        while (m_usedClientIds.contains(assignedId)) {
-            assignedId = QString("%1_%2").arg(id).arg(++suffix);
-        }
+        assignedId = m_clients.uniqueId(id);
     }
 
     // Регистрируем клиента
-    ClientState &state = m_clients[descriptor];
-    client->setId(assignedId);
-    state.client        = client;
-    state.status        = AppEnums::CONNECTED;
+    ClientState &state = *m_clients.find(descriptor);
+    m_clients.assignId(state, assignedId);
+    m_clients.setStatus(state, AppEnums::CONNECTED);
     state.allowSending  = allowSending;
     state.configuration = payload.toVariantMap();
-    m_usedClientIds.insert(assignedId);
 
     m_clientBatch.append(getClientDataMap(state));
 
-    emit logMessage(QString("Клиент %1 (%2:%3) успешно зарегистрирован с ID: %4")
-                        .arg(QString::number(descriptor)).arg(client->address()).arg(client->port()).arg(assignedId));
+    LOG_INFO(AppEnums::LogCategory::Clients,
+             QString("Клиент %1 (%2:%3) успешно зарегистрирован с ID: %4")
+                 .arg(QString::number(descriptor)).arg(client->address()).arg(client->port()).arg(assignedId));
 
 
     // Подтверждение регистрации
     QJsonObject jsonData;
     jsonData[Protocol::Keys::ID] = client->id();
     jsonData[Protocol::Keys::TYPE] = Protocol::MessageType::CONFIRMATION;
-    sendDataToClient(client, QJsonDocument(jsonData).toJson(QJsonDocument::Compact));
+
+    // Согласование кадрирования и формата: подтверждение уже уходит в новом режиме
+    state.encoding = MessageCodec::Encoding::Json;
+    if (request.value(Protocol::Keys::FRAMING).toString() == Protocol::Framing::LENGTH_PREFIXED) {
+        client->setFramingMode(IClient::FramingMode::LengthPrefixed);
+        jsonData[Protocol::Keys::FRAMING] = Protocol::Framing::LENGTH_PREFIXED;
+
+        if (request.value(Protocol::Keys::ENCODING).toString() == Protocol::Encoding::CBOR) {
+            state.encoding = MessageCodec::Encoding::Cbor;
+        }
+    }
+    jsonData[Protocol::Keys::ENCODING] = MessageCodec::encodingName(state.encoding);
+    // Время сервера в подтверждении сообщает клиенту, что Probe поддерживается
+    jsonData[Protocol::Keys::SERVER_TIME] = MonotonicClock::nowNs() / 1000;
+    sendMessageToClient(state, jsonData);
+
+    // Клиент сбрасывает темп при подтверждении: под нагрузкой он сразу получает текущий
+    state.flowLevel = m_flowLevel;
+    state.flowRateLimited = state.rateLimited;
+    if (state.flowLevel > 0)
+        sendFlowControl(state);
 }
 
 void DataProcessing::clearClients() {
     m_clients.clear();
-    m_usedClientIds.clear();
+    m_expiryWheel.clear();
+    m_expiryTimer->stop();
+}
+
+void DataProcessing::scheduleExpiry(quintptr descriptor, qint64 deadlineNs) {
+    m_expiryWheel.schedule(descriptor, deadlineNs);
+    if (!m_expiryTimer->isActive())
+        m_expiryTimer->start();
+}
+
+qint64 DataProcessing::idleTimeoutNs(const ClientState &state) const {
+    const int idleMs = state.server ? state.server->idleTimeoutMs() : 0;
+    if (idleMs <= 0)
+        return 0;
+    const int timeoutMs = state.status == AppEnums::AUTHORIZING ? qMin(idleMs, AUTHORIZATION_TIMEOUT_MS)
+                                                                : idleMs;
+    return qint64(timeoutMs) * 1000000;
+}
+
+void DataProcessing::expireClients() {
+    const qint64 nowNs = MonotonicClock::nowNs();
+    int evicted = 0;
+    for (quintptr descriptor : m_expiryWheel.advance(nowNs)) {
+        ClientState *state = m_clients.find(descriptor);
+        if (!state || !state->client)
+            continue;
+
+        if (state->status == AppEnums::DISCONNECTED) {
+            const qint64 expiresNs = state->lastActivityNs + qint64(DISCONNECTED_TTL_MS) * 1000000;
+            if (expiresNs > nowNs) {
+                scheduleExpiry(descriptor, expiresNs);
+            } else {
+                removeClient(descriptor);
+                ++evicted;
+            }
+            continue;
+        }
+
+        const qint64 timeoutNs = idleTimeoutNs(*state);
+        if (timeoutNs == 0)
+            continue;
+
+        // Срок пересчитывается от последнего сообщения: само сообщение колесо не трогает
+        const qint64 idleUntilNs = state->lastActivityNs + timeoutNs;
+        if (idleUntilNs > nowNs) {
+            scheduleExpiry(descriptor, idleUntilNs);
+            continue;
+        }
+
+        LOG_WARNING(AppEnums::LogCategory::Clients,
+                    QString("Клиент %1 (%2:%3) не присылал сообщений %4 с, соединение разрывается.")
+                        .arg(state->client->id())
+                        .arg(state->client->address())
+                        .arg(state->client->port())
+                        .arg((nowNs - state->lastActivityNs) / 1000000000));
+        state->client->disconnect();
+        // Обычно до этого срока клиент уже отключен; иначе отключение повторяется
+        scheduleExpiry(descriptor, nowNs + timeoutNs);
+    }
+
+    if (evicted > 0)
+        LOG_INFO(AppEnums::LogCategory::Clients,
+                 QString("Удалено %1 клиентов, отключенных дольше %2 с.").arg(evicted).arg(DISCONNECTED_TTL_MS / 1000));
+    if (m_expiryWheel.size() == 0)
+        m_expiryTimer->stop();
 }
 
 QList<QVariantMap> DataProcessing::takeClientUpdatesBatch() {
@@ -169,14 +321,40 @@ QList<QVariantMap> DataProcessing::takeClientUpdatesBatch() {
     return batch;
 }
 
-QList<QVariantMap> DataProcessing::takeDataBatch() {
-    QList<QVariantMap> batch;
+QList<TelemetryRecord> DataProcessing::takeDataBatch() {
+    QList<TelemetryRecord> batch;
     if (!m_dataBatch.isEmpty()) {
         batch.swap(m_dataBatch);
+        const qint64 flushedNs = MonotonicClock::nowNs();
+        for (TelemetryRecord &record : batch) {
+            record.stages.flushed = flushedNs;
+        }
+    }
+    m_dataBatchBytes = 0;
+
+    for (ParseShard *shard : std::as_const(m_shards)) {
+        if (shard->pendingCount() > 0)
+            batch.append(shard->takeDataBatch());
     }
     return batch;
 }
 
+int DataProcessing::pendingCount() const {
+    int count = int(m_dataBatch.size() + m_clientBatch.size());
+    for (const ParseShard *shard : m_shards) {
+        count += shard->pendingCount();
+    }
+    return count;
+}
+
+qsizetype DataProcessing::pendingBytes() const {
+    qsizetype bytes = m_dataBatchBytes;
+    for (const ParseShard *shard : m_shards) {
+        bytes += shard->pendingBytes();
+    }
+    return bytes;
+}
+
 QVariantMap DataProcessing::getClientDataMap(const ClientState &state) {
     QVariantMap clientData;
     clientData[Keys::ID]            = state.client->id();
@@ -186,95 +364,281 @@ QVariantMap DataProcessing::getClientDataMap(const ClientState &state) {
     clientData[Keys::STATUS]        = state.status;
     clientData[Keys::ALLOW_SENDING] = state.allowSending;
     clientData[Keys::CONFIGURATION] = state.configuration;
+    clientData[Keys::QUEUE_BYTES]   = state.queuedBytes;
+    clientData[Keys::DROPPED]       = state.droppedMessages;
+    if (!state.rateLimiter.isUnlimited()) {
+        clientData[Keys::RATE_TOKENS] = qint64(state.rateLimiter.tokens(MonotonicClock::nowNs()));
+        clientData[Keys::RATE_BURST]  = qint64(state.rateLimiter.burst());
+    }
+    clientData[Keys::RATE_LIMITED]  = state.rateLimited;
     return clientData;
 }
 
-void DataProcessing::handleDataReceived(IClient *client, const QByteArray &data) {
-    if (!client) return;
-    parseJsonData(client, data);
+void DataProcessing::refreshClientCounters() {
+    for (ParseShard *shard : std::as_const(m_shards)) {
+        const QHash<quintptr, quint64> rateLimited = shard->takeRateLimited();
+        for (auto it = rateLimited.constBegin(); it != rateLimited.constEnd(); ++it) {
+            if (ClientState *state = m_clients.find(it.key()))
+                countRateLimited(*state, it.value());
+        }
+    }
+
+    const qint64 nowNs = MonotonicClock::nowNs();
+    for (quintptr descriptor : m_clients.descriptorsWithStatus(AppEnums::CONNECTED)) {
+        ClientState *state = m_clients.find(descriptor);
+        if (!state || !state->client)
+            continue;
+
+        // Мелкие колебания очереди и уровня маркеров не отправляются в UI
+        const qint64 queuedBytes = state->client->queuedBytes();
+        const quint64 dropped = state->client->droppedMessages();
+        const int tokens = state->rateLimiter.isUnlimited()
+                               ? -1
+                               : int(state->rateLimiter.tokens(nowNs) * RATE_REPORT_STEPS /
+                                     state->rateLimiter.burst());
+        if (queuedBytes / QUEUE_REPORT_STEP_BYTES == state->queuedBytes / QUEUE_REPORT_STEP_BYTES &&
+            dropped == state->droppedMessages && tokens == state->reportedTokens &&
+            state->rateLimited == state->reportedRateLimited)
+            continue;
+
+        state->queuedBytes = queuedBytes;
+        state->droppedMessages = dropped;
+        state->reportedTokens = tokens;
+        state->reportedRateLimited = state->rateLimited;
+        m_clientBatch.append(getClientDataMap(*state));
+    }
+}
+
+int DataProcessing::ingestBacklog() const {
+    int backlog = 0;
+    for (const ParseShard *shard : m_shards) {
+        backlog += shard->backlog();
+    }
+    return backlog;
+}
+
+int DataProcessing::applyFlowControl(int level) {
+    m_flowLevel = level;
+    int notified = 0;
+    for (quintptr descriptor : m_clients.descriptorsWithStatus(AppEnums::CONNECTED)) {
+        ClientState *state = m_clients.find(descriptor);
+        if (!state || !state->client)
+            continue;
+
+        // Превышающий темп клиент замедляется сильнее остальных, затем возвращается к общему уровню
+        int clientLevel = level;
+        if (state->rateLimited > state->flowRateLimited)
+            clientLevel = qMin(qMax(level, state->flowLevel + 1), FlowController::MAX_LEVEL);
+        else if (state->flowLevel > level)
+            clientLevel = state->flowLevel - 1;
+        state->flowRateLimited = state->rateLimited;
+
+        if (clientLevel == state->flowLevel)
+            continue;
+        state->flowLevel = clientLevel;
+        sendFlowControl(*state);
+        ++notified;
+    }
+    return notified;
+}
+
+void DataProcessing::sendFlowControl(const ClientState &state) {
+    const FlowController::Target target = FlowController::targetForLevel(state.flowLevel);
+    QJsonObject message;
+    message[Protocol::Keys::TYPE] = Protocol::MessageType::FLOW_CONTROL;
+    message[Protocol::Keys::SEND_INTERVAL] = target.sendIntervalMs;
+    message[Protocol::Keys::SAMPLE_RATIO] = target.sampleRatio;
+    // Медленному клиенту достаточно последнего значения
+    sendMessageToClient(state, message, Protocol::MessageType::FLOW_CONTROL);
+}
+
+void DataProcessing::countRateLimited(ClientState &state, quint64 count) {
+    const quint64 before = state.rateLimited;
+    state.rateLimited += count;
+    LOG_SAMPLED(AppEnums::LogLevel::Warning, AppEnums::LogCategory::Clients, 1000,
+                QString("Клиент %1 превышает допустимый темп сообщений: отброшено %2")
+                    .arg(state.client->id())
+                    .arg(state.rateLimited));
+
+    const quint64 limit = m_rateLimits.disconnectAfter;
+    if (limit > 0 && before < limit && state.rateLimited >= limit) {
+        LOG_WARNING(AppEnums::LogCategory::Clients,
+                    QString("Клиент %1 отключен: отброшено %2 сообщений сверх допустимого темпа.")
+                        .arg(state.client->id())
+                        .arg(state.rateLimited));
+        state.client->disconnect();
+    }
 }
 
-void DataProcessing::parseJsonData(IClient *client, const QByteArray &data) {
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+void DataProcessing::handleDataReceived(IClient *client, const QByteArray &data, qint64 receivedAtNs) {
+    if (!client) return;
 
-    if (parseError.error != QJsonParseError::NoError) {
-        emit logMessage(QString("Ошибка парсинга JSON от клиента %1: %2").arg(client->id()).arg(parseError.errorString()));
+    // До регистрации сообщения разбираются здесь: регистрация изменяет общий реестр
+    const quintptr descriptor = client->descriptor();
+    ClientState *state = m_clients.find(descriptor);
+    if (state && state->client == client) {
+        // Отметка активности — единственная работа с таймаутами на каждое сообщение
+        state->lastActivityNs = receivedAtNs;
+        if (!state->rateLimiter.tryTake(receivedAtNs)) {
+            // Сообщение сверх темпа отбрасывается до разбора: проверка стоит нескольких арифметических операций
+            countRateLimited(*state, 1);
+            return;
+        }
+    }
+
+    if (!state || state->client != client || state->status == AppEnums::AUTHORIZING) {
+        parseMessage(client, data, receivedAtNs);
         return;
     }
-    if (!doc.isObject()) {
-        emit logMessage(QString("Получены некорректные данные от клиента %1.").arg(client->id()));
+
+    ParseShard *shard = shardFor(descriptor);
+    shard->messageQueued();
+    QMetaObject::invokeMethod(shard, [shard, client, descriptor, clientId = client->id(), data, receivedAtNs] {
+        shard->parse(client, descriptor, clientId, data, receivedAtNs);
+    }, Qt::QueuedConnection);
+}
+
+void DataProcessing::handleShardRegistration(IClient *client, quintptr descriptor,
+                                             const QCborMap &message) {
+    // Клиент мог быть удален, пока сообщение шло из шарда: указатель только сравнивается
+    const ClientState *state = m_clients.find(descriptor);
+    if (!state || state->client != client)
+        return;
+    registerClient(client, message);
+}
+
+void DataProcessing::handleShardProbe(IClient *client, quintptr descriptor,
+                                      qint64 clientSentAtUs, qint64 receivedAtNs) {
+    const ClientState *state = m_clients.find(descriptor);
+    if (!state || state->client != client)
+        return;
+    replyToProbe(*state, clientSentAtUs, receivedAtNs);
+}
+
+void DataProcessing::replyToProbe(const ClientState &state, qint64 clientSentAtUs,
+                                  qint64 receivedAtNs) {
+    QJsonObject reply;
+    reply[Protocol::Keys::TYPE] = Protocol::MessageType::PROBE;
+    reply[Protocol::Keys::SENT_AT] = clientSentAtUs;
+    // Середина между получением и ответом: время обработки делится между направлениями поровну
+    reply[Protocol::Keys::SERVER_TIME] = (receivedAtNs + MonotonicClock::nowNs()) / 2000;
+    sendMessageToClient(state, reply);
+}
+
+void DataProcessing::handleShardConfiguration(IClient *client, quintptr descriptor,
+                                              const QVariantMap &configuration) {
+    ClientState *state = m_clients.find(descriptor);
+    if (!state || state->client != client)
+        return;
+    applyClientConfiguration(*state, configuration);
+}
+
+void DataProcessing::applyClientConfiguration(ClientState &state, const QVariantMap &configuration) {
+    state.configuration = configuration;
+    m_clientBatch.append(getClientDataMap(state));
+    LOG_INFO(AppEnums::LogCategory::Clients, QString("Конфигурация клиента %1 обновлена клиентом.").arg(state.client->id()));
+}
+
+void DataProcessing::parseMessage(IClient *client, const QByteArray &data, qint64 receivedAtNs) {
+    const qint64 parseStartedNs = MonotonicClock::nowNs();
+    QCborMap message;
+    QString errorString;
+    if (!MessageCodec::decode(data, message, &errorString)) {
+        LOG_WARNING(AppEnums::LogCategory::Data, QString("Получены некорректные данные от клиента %1: %2").arg(client->id()).arg(errorString));
         return;
     }
 
-    QJsonObject json = doc.object();
-    QString messageType = json[Protocol::Keys::TYPE].toString();
-    QJsonObject payload = json[Protocol::Keys::PAYLOAD].toObject();
+    QString messageType = message.value(Protocol::Keys::TYPE).toString();
+    QCborMap payload = message.value(Protocol::Keys::PAYLOAD).toMap();
 
     if (messageType == Protocol::MessageType::REGISTRATION) {
-        QString requestedId = json[Keys::ID].toString();
-        registerClient(client, requestedId, payload);
-    } else if (m_clients.contains(client->descriptor())) {
-        ClientState &state = m_clients[client->descriptor()];
+        registerClient(client, message);
+    } else if (ClientState *clientState = m_clients.find(client->descriptor())) {
+        ClientState &state = *clientState;
+        if (messageType == Protocol::MessageType::PROBE) {
+            replyToProbe(state, message.value(Protocol::Keys::SENT_AT).toInteger(), receivedAtNs);
+            return;
+        }
         if (messageType == Protocol::MessageType::CONFIGURATION) {
-            state.configuration = payload.toVariantMap();
-            m_clientBatch.append(getClientDataMap(state));
-            emit logMessage(QString("Конфигурация клиента %1 обновлена клиентом.").arg(client->id()));
+            applyClientConfiguration(state, payload.toVariantMap());
         }
 
-        QVariantMap messageData;
-        messageData[Keys::TIME_STAMP] = QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
-        messageData[Keys::ID] = client->id();
-        messageData[Keys::TYPE] = messageType;
-        messageData[Keys::PAYLOAD] = payload.toVariantMap();
-        m_dataBatch.append(messageData);
+        TelemetryRecord record = TelemetryRecord::fromPayload(messageType, payload);
+        record.timestamp = QDateTime::currentMSecsSinceEpoch();
+        record.clientId = client->id();
+        record.readEnvelope(message);
+        record.stages.received = receivedAtNs;
+        record.stages.parseStarted = parseStartedNs;
+        record.stages.parsed = MonotonicClock::nowNs();
+        m_dataBatch.append(std::move(record));
+        m_dataBatchBytes += data.size();
+        emit dataQueued();
     } else {
-        emit logMessage(QString("Получены данные от незарегистрированного клиента %1 типа %2").arg(client->descriptor()).arg(messageType));
+        LOG_WARNING(AppEnums::LogCategory::Data, QString("Получены данные от незарегистрированного клиента %1 типа %2").arg(client->descriptor()).arg(messageType));
     }
 }
 
 void DataProcessing::routeDataToClient(const QVariantMap &data) {
     quintptr dc = data[Keys::DESCRIPTOR].toULongLong();
-    if (m_clients.contains(dc)) {
-        ClientState &state = m_clients[dc];
+    if (ClientState *clientState = m_clients.find(dc)) {
+        ClientState &state = *clientState;
 
         if (data[Keys::TYPE] == Keys::CONFIGURATION) {
             state.allowSending = data[Keys::ALLOW_SENDING].toBool();
             state.configuration = data[Keys::PAYLOAD].toMap();
             m_clientBatch.append(getClientDataMap(state));
-            emit logMessage(QString("Новая конфигурация отправлена клиенту %1, отправка команд: %2").arg(data[Keys::ID].toString()).arg(data[Keys::ALLOW_SENDING].toBool() ? "разрешена" : "запрещена"));
+            LOG_INFO(AppEnums::LogCategory::Clients, QString("Новая конфигурация отправлена клиенту %1, отправка команд: %2").arg(data[Keys::ID].toString()).arg(data[Keys::ALLOW_SENDING].toBool() ? "разрешена" : "запрещена"));
         }
 
-        QJsonDocument jsonDoc = QJsonDocument::fromVariant(data);
-        QByteArray byteArrayData = jsonDoc.toJson(QJsonDocument::Compact);
-        sendDataToClient(state.client, byteArrayData);
+        // Неотправленная конфигурация медленному клиенту заменяется новой; остальное не замещается
+        const bool isConfiguration = data[Keys::TYPE] == Keys::CONFIGURATION;
+        sendMessageToClient(state, QJsonObject::fromVariantMap(data),
+                            isConfiguration ? data[Keys::TYPE].toString() : QString());
     } else {
-        emit logMessage(QString("Не удалось сохранить конфигурацию: клиент %1 не найден.").arg(data[Keys::ID].toString()));
+        LOG_WARNING(AppEnums::LogCategory::Clients, QString("Не удалось сохранить конфигурацию: клиент %1 не найден.").arg(data[Keys::ID].toString()));
     }
 }
 
-void DataProcessing::sendDataToClient(IClient *client, const QByteArray &data) {
+void DataProcessing::sendDataToClient(IClient *client, const QByteArray &data,
+                                      const QString &coalesceKey) {
     if (!client) return;
-    if (IServer *server = qobject_cast<IServer *>(client->parent())) {
-        server->sendToClient(client, data);
+    const ClientState *state = m_clients.find(client->descriptor());
+    if (state && state->server) {
+        state->server->sendToClient(client, data, coalesceKey);
     } else {
-        emit logMessage("Не удалось найти сервер для отправки данных.");
+        LOG_ERROR(AppEnums::LogCategory::Network, "Не удалось найти сервер для отправки данных.");
     }
 }
 
+void DataProcessing::sendMessageToClient(const ClientState &state, const QJsonObject &message,
+                                         const QString &coalesceKey) {
+    if (!state.client || !state.server) return;
+    state.server->sendToClient(state.client, MessageCodec::encode(message, state.encoding),
+                               coalesceKey);
+}
+
 void DataProcessing::sendDataToAll(const QString &data) {
     int count = 0;
     QJsonObject jsonData;
     jsonData[Protocol::Keys::TYPE] = Protocol::MessageType::COMMAND;
     jsonData[Protocol::Keys::COMMAND] = data;
 
-    QByteArray byteArray = QJsonDocument(jsonData).toJson(QJsonDocument::Compact);
+    // Команда сериализуется один раз для каждого формата. Команды не замещаются:
+    // медленный клиент должен получить и START, и следующий за ним STOP
+    const QByteArray jsonBytes = MessageCodec::encode(jsonData, MessageCodec::Encoding::Json);
+    QByteArray cborBytes;
 
-    for (const auto &state : qAsConst(m_clients)) {
+    for (const auto &state : m_clients.states()) {
         if (state.allowSending && state.client && state.client->isConnected()) {
-            sendDataToClient(state.client, byteArray);
+            if (state.encoding == MessageCodec::Encoding::Cbor) {
+                if (cborBytes.isEmpty())
+                    cborBytes = MessageCodec::encode(jsonData, MessageCodec::Encoding::Cbor);
+                sendDataToClient(state.client, cborBytes);
+            } else {
+                sendDataToClient(state.client, jsonBytes);
+            }
             count++;
         }
     }
-    emit logMessage(QString("Команда \"%1\" отправлена %2 клиентам.").arg(data).arg(count));
+    LOG_INFO(AppEnums::LogCategory::Clients, QString("Команда \"%1\" отправлена %2 клиентам.").arg(data).arg(count));
 }
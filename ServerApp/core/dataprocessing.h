@@ -10,13 +10,21 @@
 #include <QJsonObject>
 #include <QJsonParseError>
 #include <QObject>
-#include <QSet>
+#include <QThread>
+#include <QTimer>
 #include <QVariantMap>
 
 #include "../common/iclient.h"
+#include "../common/messagecodec.h"
 #include "core/appenums.h"
+#include "core/clientregistry.h"
+#include "core/flowcontroller.h"
 #include "core/iserver.h"
+#include "core/parseshard.h"
+#include "core/ratelimits.h"
 #include "core/sharedkeys.h"
+#include "core/telemetry.h"
+#include "core/timingwheel.h"
 
 /**
  * @class DataProcessing
@@ -25,27 +33,64 @@
  * Этот класс управляет состояниями всех клиентов, обрабатывает входящие
  * сообщения, регистрирует клиентов, парсит JSON-данные и формирует
  * пакеты данных (batch) для отправки в UI-поток.
+ *
+ * Реестр клиентов, регистрация и отправка сообщений клиентам выполняются в
+ * потоке DataProcessing: уникальность ID и поиск переподключившегося клиента
+ * требуют общего реестра. Сообщения зарегистрированных клиентов разбираются
+ * в пуле потоков ParseShard (шард выбирается по хешу дескриптора), у каждого
+ * шарда свой пакет данных; takeDataBatch() объединяет пакеты всех шардов.
+ *
+ * Темп входящих сообщений ограничивается корзинами маркеров (RateLimits):
+ * общая корзина клиента проверяется в handleDataReceived до передачи
+ * сообщения в шард, поэтому поток одного клиента не занимает рабочий поток
+ * и шарды; корзины по типам проверяют шарды после декодирования. Сообщения
+ * сверх темпа отбрасываются и учитываются в ClientState::rateLimited; при
+ * заданном RateLimits::disconnectAfter клиент отключается.
+ *
+ * Сроки клиентов ведет одно колесо таймеров (TimingWheel) с шагом
+ * IDLE_WHEEL_TICK_MS. Каждое сообщение только обновляет
+ * ClientState::lastActivityNs; когда срок в колесе истекает, он
+ * пересчитывается от последней активности. Клиент, молчавший дольше
+ * IServer::idleTimeoutMs() (до регистрации — не дольше
+ * AUTHORIZATION_TIMEOUT_MS), отключается; полуоткрытое соединение TcpClient
+ * закрывает принудительно, если корректное закрытие не завершилось.
+ * Отключенные клиенты удаляются через DISCONNECTED_TTL_MS: до этого
+ * переподключение с тем же ID сохраняет настройки клиента.
+ *
+ * Темп телеметрии клиентов задает ServerWorker: по уровню FlowController
+ * applyFlowControl() отправляет FlowControl зарегистрированным клиентам,
+ * у которых изменился уровень. Клиент, сообщения которого отбрасывались
+ * ограничителями темпа с прошлой оценки, получает уровень на ступень выше
+ * своего прежнего; без новых отброшенных сообщений его уровень возвращается
+ * к общему по одной ступени за оценку.
  */
 class DataProcessing : public QObject {
     Q_OBJECT
 
-    /**
-     * @struct ClientState
-     * @brief Структура для хранения полного состояния клиента.
-     */
-    struct ClientState {
-        IClient *client = nullptr; ///< Указатель на объект клиента.
-        AppEnums::ClientStatus status = AppEnums::DISCONNECTED; ///< Текущий статус клиента.
-        bool allowSending = false; ///< Флаг, разрешающий отправку команд клиенту.
-        QVariantMap configuration; ///< Конфигурация, связанная с клиентом.
-    };
-
 public:
+    /// @brief Шаг изменения очереди отправки, при котором клиент обновляется в UI (в байтах).
+    static constexpr qint64 QUEUE_REPORT_STEP_BYTES = 16 * 1024;
+    /// @brief Максимальное количество потоков разбора.
+    static constexpr int MAX_PARSE_SHARDS = 8;
+    /// @brief Количество долей емкости корзины, при смене которых уровень маркеров обновляется в UI.
+    static constexpr int RATE_REPORT_STEPS = 10;
+    /// @brief Шаг колеса сроков клиентов (мс).
+    static constexpr int IDLE_WHEEL_TICK_MS = 500;
+    /// @brief Количество ячеек колеса сроков (оборот — 128 с).
+    static constexpr int IDLE_WHEEL_SLOTS = 256;
+    /// @brief Наибольшее время от подключения до регистрации (мс).
+    static constexpr int AUTHORIZATION_TIMEOUT_MS = 15000;
+    /// @brief Время хранения отключенного клиента (мс).
+    static constexpr int DISCONNECTED_TTL_MS = 300000;
+
     /**
      * @brief Конструктор класса DataProcessing.
      * @param parent Родительский объект QObject.
+     * @param shardCount Количество потоков разбора (0 — по числу ядер, не больше MAX_PARSE_SHARDS).
+     * @param limits Ограничения темпа входящих сообщений.
      */
-    explicit DataProcessing(QObject *parent = nullptr);
+    explicit DataProcessing(QObject *parent = nullptr, int shardCount = 0,
+                            const RateLimits &limits = RateLimits());
     /**
      * @brief Деструктор класса DataProcessing.
      */
@@ -56,6 +101,15 @@ public:
      * @param server Указатель на IServer.
      */
     void addServer(IServer *server);
+    /**
+     * @brief Отключает сервер от обработки и удаляет из реестра всех его клиентов.
+     *
+     * Вызывается перед удалением сервера: его клиенты удаляются вместе с ним
+     * без сигнала отключения, поэтому их состояния нельзя оставлять в реестре
+     * и колесе сроков.
+     * @param server Указатель на IServer.
+     */
+    void removeServer(IServer *server);
 
     /**
      * @brief Забирает накопленный пакет обновлений по клиентам.
@@ -63,10 +117,39 @@ public:
      */
     QList<QVariantMap> takeClientUpdatesBatch();
     /**
-     * @brief Забирает накопленный пакет входящих данных от клиентов.
-     * @return Список карт с данными.
+     * @brief Забирает накопленные пакеты входящих данных от клиентов (свой и всех шардов).
+     *
+     * Порядок записей сохраняется в пределах одного клиента.
+     * @return Список типизированных записей телеметрии.
+     */
+    QList<TelemetryRecord> takeDataBatch();
+    /**
+     * @brief Возвращает количество накопленных записей (включая шарды) и обновлений клиентов.
+     */
+    int pendingCount() const;
+    /**
+     * @brief Возвращает объем исходных сообщений, накопленных в пакетах данных (в байтах).
      */
-    QList<QVariantMap> takeDataBatch();
+    qsizetype pendingBytes() const;
+    /**
+     * @brief Возвращает количество потоков разбора.
+     */
+    int shardCount() const { return m_shards.size(); }
+    /**
+     * @brief Добавляет в пакет обновлений клиентов, у которых заметно изменилась очередь
+     * отправки, уровень маркеров или количество отброшенных по темпу сообщений.
+     */
+    void refreshClientCounters();
+    /**
+     * @brief Возвращает количество сообщений, переданных шардам и еще не разобранных.
+     */
+    int ingestBacklog() const;
+    /**
+     * @brief Задает общий уровень темпа телеметрии и отправляет FlowControl клиентам, у которых он изменился.
+     * @param level Уровень FlowController.
+     * @return Количество клиентов, получивших FlowControl.
+     */
+    int applyFlowControl(int level);
 
 public slots:
     /**
@@ -84,17 +167,14 @@ public slots:
      * @brief Отправляет данные конкретному клиенту.
      * @param client Указатель на клиента.
      * @param data Данные в виде QByteArray.
+     * @param coalesceKey Ключ замещения неотправленного сообщения.
      */
-    void sendDataToClient(IClient *client, const QByteArray &data);
+    void sendDataToClient(IClient *client, const QByteArray &data,
+                          const QString &coalesceKey = QString());
     /**
      * @brief Удаляет клиентов, помеченных как DISCONNECTED.
      */
     void removeDisconnectedClients();
-    /**
-     * @brief Удаляет клиента.
-     * @param state Указатель на состояние клиента.
-     */
-    void removeClient(ClientState &state);
     /**
      * @brief Очищает все списки клиентов.
      */
@@ -115,8 +195,35 @@ private slots:
      * @brief Обрабатывает получение данных от клиента.
      * @param client Клиент-отправитель.
      * @param data Полученные данные.
+     * @param receivedAtNs Время чтения данных из сокета.
+     */
+    void handleDataReceived(IClient *client, const QByteArray &data, qint64 receivedAtNs);
+    /**
+     * @brief Выполняет регистрацию, полученную шардом от уже зарегистрированного клиента.
+     * @param client Клиент (сверяется с реестром до использования).
+     * @param descriptor Дескриптор клиента.
+     * @param message Декодированное сообщение регистрации.
      */
-    void handleDataReceived(IClient *client, const QByteArray &data);
+    void handleShardRegistration(IClient *client, quintptr descriptor, const QCborMap &message);
+    /**
+     * @brief Сохраняет конфигурацию, полученную шардом от клиента.
+     * @param client Клиент (сверяется с реестром до использования).
+     * @param descriptor Дескриптор клиента.
+     * @param configuration Конфигурация клиента.
+     */
+    void handleShardConfiguration(IClient *client, quintptr descriptor, const QVariantMap &configuration);
+    /**
+     * @brief Отвечает на Probe, полученный шардом.
+     * @param client Клиент (сверяется с реестром до использования).
+     * @param descriptor Дескриптор клиента.
+     * @param clientSentAtUs Время отправки по часам клиента (возвращается без изменений).
+     * @param receivedAtNs Время чтения запроса из сокета.
+     */
+    void handleShardProbe(IClient *client, quintptr descriptor, qint64 clientSentAtUs, qint64 receivedAtNs);
+    /**
+     * @brief Обрабатывает истекшие сроки колеса: отключает молчащих и удаляет давно отключенных клиентов.
+     */
+    void expireClients();
 
 signals:
     /**
@@ -130,26 +237,82 @@ signals:
      */
     void dataReceived(const QVariantMap &data);
     /**
-     * @brief Сигнал для логирования сообщения.
-     * @param message Текст сообщения.
+     * @brief Сигнал о добавлении записи в пакет данных.
      */
-    void logMessage(const QString &message);
+    void dataQueued();
 
 private:
     /**
-     * @brief Парсит данные от клиента как JSON.
+     * @brief Создает и запускает потоки разбора.
+     */
+    void startShards(int count);
+    /**
+     * @brief Останавливает потоки разбора и дожидается их завершения.
+     */
+    void stopShards();
+    /**
+     * @brief Возвращает шард, разбирающий сообщения клиента с указанным дескриптором.
+     */
+    ParseShard *shardFor(quintptr descriptor) const;
+    /**
+     * @brief Назначает срок клиенту в колесе и запускает таймер колеса.
+     */
+    void scheduleExpiry(quintptr descriptor, qint64 deadlineNs);
+    /**
+     * @brief Возвращает допустимое время тишины клиента (нс, 0 — не отслеживается).
+     */
+    qint64 idleTimeoutNs(const ClientState &state) const;
+    /**
+     * @brief Учитывает отброшенные по темпу сообщения и при необходимости отключает клиента.
+     * @param state Состояние клиента.
+     * @param count Количество отброшенных сообщений.
+     */
+    void countRateLimited(ClientState &state, quint64 count);
+    /**
+     * @brief Сохраняет конфигурацию, присланную клиентом, и добавляет клиента в пакет обновлений.
+     */
+    void applyClientConfiguration(ClientState &state, const QVariantMap &configuration);
+    /**
+     * @brief Удаляет клиента из реестра и сервера, уведомляя UI.
+     * @param descriptor Дескриптор клиента.
+     */
+    void removeClient(quintptr descriptor);
+    /**
+     * @brief Разбирает сообщение клиента (JSON или CBOR).
      * @param client Клиент-отправитель.
-     * @param data Полученные данные.
+     * @param data Полученные данные одного сообщения.
+     * @param receivedAtNs Время чтения данных из сокета.
      */
-    void parseJsonData(IClient *client, const QByteArray &data);
+    void parseMessage(IClient *client, const QByteArray &data, qint64 receivedAtNs);
     /**
      * @brief Регистрирует клиента в системе.
+     *
+     * Если клиент запросил кадрирование сообщений, переключает соединение в режим
+     * LengthPrefixed, а при запросе CBOR (только вместе с кадрированием) — формат
+     * сообщений. Оба решения подтверждаются в ответе Confirmation.
      * @param client Указатель на клиента.
-     * @param id Запрашиваемый ID клиента.
-     * @param payload Полезная нагрузка из регистрационного сообщения.
+     * @param request Регистрационное сообщение (ID, полезная нагрузка, параметры соединения).
+     */
+    void registerClient(IClient *client, const QCborMap &request);
+    /**
+     * @brief Сериализует сообщение в согласованном с клиентом формате и отправляет его.
+     * @param state Состояние клиента-получателя.
+     * @param message Сообщение.
+     * @param coalesceKey Ключ замещения неотправленного сообщения.
+     */
+    void sendMessageToClient(const ClientState &state, const QJsonObject &message,
+                             const QString &coalesceKey = QString());
+    /**
+     * @brief Отправляет ответ на Probe со временем сервера (см. Protocol::Timing).
+     * @param state Состояние клиента.
+     * @param clientSentAtUs Время отправки по часам клиента.
+     * @param receivedAtNs Время чтения запроса из сокета.
      */
-    void registerClient(IClient *client, const QString &id,
-                        const QJsonObject &payload);
+    void replyToProbe(const ClientState &state, qint64 clientSentAtUs, qint64 receivedAtNs);
+    /**
+     * @brief Отправляет клиенту FlowControl с темпом для ClientState::flowLevel.
+     */
+    void sendFlowControl(const ClientState &state);
     /**
      * @brief Формирует QVariantMap с данными о состоянии клиента.
      * @param state Состояние клиента.
@@ -160,12 +323,25 @@ private:
     /// @brief Пакет для обновлений информации о клиентах.
     QList<QVariantMap> m_clientBatch;
     /// @brief Пакет для входящих данных от клиентов.
-    QList<QVariantMap> m_dataBatch;
+    QList<TelemetryRecord> m_dataBatch;
+    /// @brief Объем исходных сообщений в пакете данных.
+    qsizetype m_dataBatchBytes = 0;
+
+    /// @brief Реестр состояний клиентов с индексами по ID и статусу.
+    ClientRegistry m_clients;
+    /// @brief Ограничения темпа входящих сообщений.
+    RateLimits m_rateLimits;
+    /// @brief Сроки клиентов: тишина до отключения и хранение отключенных.
+    TimingWheel m_expiryWheel{qint64(IDLE_WHEEL_TICK_MS) * 1000000, IDLE_WHEEL_SLOTS};
+    /// @brief Таймер продвижения колеса (работает, пока в колесе есть сроки).
+    QTimer *m_expiryTimer;
+    /// @brief Общий уровень темпа телеметрии (задается applyFlowControl).
+    int m_flowLevel = 0;
 
-    /// @brief Хеш-таблица для хранения состояний клиентов по дескриптору.
-    QHash<quintptr, ClientState> m_clients;
-    /// @brief Множество для хранения уже используемых ID клиентов.
-    QSet<QString> m_usedClientIds;
+    /// @brief Потоки разбора.
+    QList<QThread *> m_shardThreads;
+    /// @brief Шарды разбора, по одному на поток.
+    QList<ParseShard *> m_shards;
 };
 
 #endif // DATAPROCESSING_H
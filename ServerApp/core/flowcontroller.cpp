@@ -0,0 +1,97 @@
+#include "flowcontroller.h"
+#include "../common/monotonicclock.h"
+#include "core/sharedkeys.h"
+
+#include <QThread>
+
+#if defined(Q_OS_WIN)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+namespace {
+/// @brief Возвращает процессорное время процесса (нс, -1 — недоступно).
+qint64 processCpuTimeNs() {
+#if defined(Q_OS_WIN)
+    FILETIME creationTime, exitTime, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernel, &user))
+        return -1;
+    // FILETIME считает интервалами по 100 нс
+    const auto toNs = [](const FILETIME &time) {
+        return ((qint64(time.dwHighDateTime) << 32) | time.dwLowDateTime) * 100;
+    };
+    return toNs(kernel) + toNs(user);
+#elif defined(Q_OS_UNIX)
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+    return (qint64(usage.ru_utime.tv_sec) + usage.ru_stime.tv_sec) * 1000000000 +
+           (qint64(usage.ru_utime.tv_usec) + usage.ru_stime.tv_usec) * 1000;
+#else
+    return -1;
+#endif
+}
+} // namespace
+
+int FlowController::update(int ingestBacklog, double cpuUsage) {
+    m_lastBacklog = ingestBacklog;
+    m_lastCpuUsage = cpuUsage;
+    m_lastPressure = qMax(double(ingestBacklog) / QUEUE_HIGH, cpuUsage / CPU_HIGH);
+
+    if (m_lastPressure > 1.0) {
+        // Одна ступень за оценку: следующая оценка видит результат предыдущей
+        m_level = qMin(m_level + 1, MAX_LEVEL);
+        m_calmEvaluations = 0;
+    } else if (m_lastPressure < RELAX_PRESSURE && m_level > 0) {
+        if (++m_calmEvaluations >= RELAX_EVALUATIONS) {
+            --m_level;
+            m_calmEvaluations = 0;
+        }
+    } else {
+        m_calmEvaluations = 0;
+    }
+    return m_level;
+}
+
+double FlowController::sampleCpuUsage() {
+    const qint64 cpuNs = processCpuTimeNs();
+    const qint64 nowNs = MonotonicClock::nowNs();
+    if (cpuNs < 0)
+        return 0.0;
+
+    double usage = 0.0;
+    if (m_lastCpuNs >= 0 && nowNs > m_lastSampleNs) {
+        usage = double(cpuNs - m_lastCpuNs) /
+                (double(nowNs - m_lastSampleNs) * qMax(1, QThread::idealThreadCount()));
+    }
+    m_lastCpuNs = cpuNs;
+    m_lastSampleNs = nowNs;
+    return qBound(0.0, usage, 1.0);
+}
+
+FlowController::Target FlowController::targetForLevel(int level) {
+    Target target;
+    if (level <= 0)
+        return target;
+
+    level = qMin(level, MAX_LEVEL);
+    target.sendIntervalMs = BASE_INTERVAL_MS << (qMin(level, INTERVAL_LEVELS) - 1);
+    if (level > INTERVAL_LEVELS)
+        target.sampleRatio = 1.0 / (1 << (level - INTERVAL_LEVELS));
+    return target;
+}
+
+QVariantMap FlowController::metrics() const {
+    const Target target = targetForLevel(m_level);
+    QVariantMap metrics;
+    metrics[Keys::FLOW_LEVEL]         = m_level;
+    metrics[Keys::FLOW_BACKLOG]       = m_lastBacklog;
+    metrics[Keys::FLOW_CPU_PERCENT]   = qRound(m_lastCpuUsage * 100);
+    metrics[Keys::FLOW_SEND_INTERVAL] = target.sendIntervalMs;
+    metrics[Keys::FLOW_SAMPLE_RATIO]  = target.sampleRatio;
+    return metrics;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file flowcontroller.h
+ * @brief Определяет класс FlowController — выбор темпа телеметрии клиентов по нагрузке сервера.
+ */
+#ifndef FLOWCONTROLLER_H
+#define FLOWCONTROLLER_H
+
+#include <QVariantMap>
+
+/**
+ * @class FlowController
+ * @brief Уровень ограничения темпа клиентов по глубине очереди приема и загрузке процессора.
+ *
+ * ServerWorker раз в EVALUATE_INTERVAL_MS передает в update() количество
+ * сообщений, ожидающих разбора в шардах, и загрузку процессора процессом
+ * сервера (sampleCpuUsage()). Давление — наибольшее из отношений этих
+ * величин к порогам QUEUE_HIGH и CPU_HIGH. При давлении выше 1 уровень
+ * растет на одну ступень за оценку, а снижается на одну ступень только
+ * после RELAX_EVALUATIONS оценок подряд с давлением ниже RELAX_PRESSURE,
+ * поэтому уровень не колеблется у порога.
+ *
+ * Уровень переводится в Target (см. Protocol::FlowControl): на ступенях
+ * 1..INTERVAL_LEVELS удваивается наименьший интервал отправки, на
+ * следующих вдвое уменьшается доля отправляемых сообщений.
+ */
+class FlowController {
+public:
+    /// @brief Период оценки нагрузки (в миллисекундах).
+    static constexpr int EVALUATE_INTERVAL_MS   = 1000;
+    /// @brief Количество сообщений в очереди разбора, при котором сервер перегружен.
+    static constexpr int QUEUE_HIGH             = 10000;
+    /// @brief Доля процессорного времени всех ядер, при которой сервер перегружен.
+    static constexpr double CPU_HIGH            = 0.85;
+    /// @brief Давление, ниже которого уровень может снижаться.
+    static constexpr double RELAX_PRESSURE      = 0.5;
+    /// @brief Количество оценок подряд с низким давлением до снижения уровня на ступень.
+    static constexpr int RELAX_EVALUATIONS      = 5;
+    /// @brief Наименьший интервал отправки на первой ступени (в миллисекундах).
+    static constexpr int BASE_INTERVAL_MS       = 250;
+    /// @brief Количество ступеней, на которых растет интервал (до 4 с).
+    static constexpr int INTERVAL_LEVELS        = 5;
+    /// @brief Наибольший уровень (доля отправляемых сообщений — 1/8).
+    static constexpr int MAX_LEVEL              = 8;
+
+    /**
+     * @struct Target
+     * @brief Темп телеметрии, передаваемый клиенту в FlowControl.
+     */
+    struct Target {
+        int sendIntervalMs = 0;    ///< Наименьший интервал между сообщениями (0 — без ограничения).
+        double sampleRatio = 1.0;  ///< Доля отправляемых сообщений.
+    };
+
+    /**
+     * @brief Пересчитывает уровень по очередной оценке нагрузки.
+     * @param ingestBacklog Количество сообщений, ожидающих разбора.
+     * @param cpuUsage Загрузка процессора процессом (доля от всех ядер).
+     * @return Новый уровень.
+     */
+    int update(int ingestBacklog, double cpuUsage);
+    /**
+     * @brief Возвращает загрузку процессора процессом с прошлого вызова (доля от всех ядер).
+     *
+     * Первый вызов и платформы без учета процессорного времени дают 0.
+     */
+    double sampleCpuUsage();
+
+    /**
+     * @brief Возвращает текущий уровень (0 — без ограничения).
+     */
+    int level() const { return m_level; }
+    /**
+     * @brief Возвращает метрики последней оценки для отображения в UI.
+     */
+    QVariantMap metrics() const;
+
+    /**
+     * @brief Возвращает темп телеметрии для уровня.
+     */
+    static Target targetForLevel(int level);
+
+private:
+    /// @brief Текущий уровень.
+    int m_level = 0;
+    /// @brief Количество оценок подряд с низким давлением.
+    int m_calmEvaluations = 0;
+
+    // --- Последняя оценка ---
+    int m_lastBacklog = 0;
+    double m_lastCpuUsage = 0.0;
+    double m_lastPressure = 0.0;
+
+    /// @brief Процессорное время процесса при прошлом замере (нс, -1 — замера не было).
+    qint64 m_lastCpuNs = -1;
+    /// @brief Время прошлого замера (MonotonicClock).
+    qint64 m_lastSampleNs = 0;
+};
+
+#endif // FLOWCONTROLLER_H
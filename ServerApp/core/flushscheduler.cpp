@@ -0,0 +1,86 @@
+#include "flushscheduler.h"
+#include "core/sharedkeys.h"
+
+#include <cmath>
+
+namespace {
+// Вес нового измерения в сглаженном времени применения пакета
+constexpr double UI_APPLY_SMOOTHING = 0.2;
+} // namespace
+
+bool FlushScheduler::shouldFlushEarly(int records, qsizetype bytes) const {
+    if (records < EARLY_FLUSH_RECORDS && bytes < EARLY_FLUSH_BYTES)
+        return false;
+    if (!canFlush())
+        return false;
+
+    // Даже при большом потоке не отправляем чаще, чем позволяет бюджет UI
+    return !m_sinceFlush.isValid() ||
+           m_sinceFlush.elapsed() >= qMax(MIN_INTERVAL_MS, uiBoundInterval());
+}
+
+bool FlushScheduler::canFlush() const {
+    if (m_acknowledged == m_sequence)
+        return true;
+    // Подтверждение могло потеряться (например, UI был пересоздан) — не ждем вечно
+    return m_sinceFlush.isValid() && m_sinceFlush.elapsed() >= MAX_INTERVAL_MS;
+}
+
+quint64 FlushScheduler::flushStarted(Reason reason, int records, qsizetype bytes) {
+    m_sinceFlush.start();
+    m_lastRecords = records;
+    m_lastBytes = bytes;
+
+    if (reason == Reason::Threshold) {
+        ++m_earlyFlushes;
+        m_lastDecision = "threshold";
+    } else {
+        ++m_timerFlushes;
+        m_lastDecision = "timer";
+    }
+    return ++m_sequence;
+}
+
+void FlushScheduler::flushDeferred() {
+    ++m_deferredFlushes;
+    m_interval = qMin(m_interval * 2, MAX_INTERVAL_MS);
+    m_lastDecision = "deferred";
+}
+
+void FlushScheduler::flushAcknowledged(quint64 sequence, qint64 applyTimeUs) {
+    if (sequence <= m_acknowledged)
+        return;
+
+    m_acknowledged = sequence;
+    if (sequence == m_sequence && m_sinceFlush.isValid()) {
+        m_lastRoundTripMs = m_sinceFlush.elapsed();
+    }
+
+    m_uiApplyUs = (m_uiApplyUs == 0.0)
+                      ? applyTimeUs
+                      : m_uiApplyUs + UI_APPLY_SMOOTHING * (applyTimeUs - m_uiApplyUs);
+
+    // После отсрочки интервал возвращается к целевому постепенно
+    const int target = qMax(TARGET_INTERVAL_MS,
+                            qMax(uiBoundInterval(), int(m_lastRoundTripMs)));
+    m_interval = (m_interval > target) ? qMax(target, (m_interval + target) / 2) : target;
+    m_interval = qBound(MIN_INTERVAL_MS, m_interval, MAX_INTERVAL_MS);
+}
+
+QVariantMap FlushScheduler::metrics() const {
+    QVariantMap metrics;
+    metrics[Keys::FLUSH_INTERVAL]       = m_interval;
+    metrics[Keys::FLUSH_TIMER_COUNT]    = m_timerFlushes;
+    metrics[Keys::FLUSH_EARLY_COUNT]    = m_earlyFlushes;
+    metrics[Keys::FLUSH_DEFERRED_COUNT] = m_deferredFlushes;
+    metrics[Keys::FLUSH_LAST_RECORDS]   = m_lastRecords;
+    metrics[Keys::FLUSH_LAST_BYTES]     = qint64(m_lastBytes);
+    metrics[Keys::FLUSH_UI_APPLY_US]    = qint64(m_uiApplyUs);
+    metrics[Keys::FLUSH_ROUND_TRIP_MS]  = m_lastRoundTripMs;
+    metrics[Keys::FLUSH_LAST_DECISION]  = m_lastDecision;
+    return metrics;
+}
+
+int FlushScheduler::uiBoundInterval() const {
+    return int(std::ceil(m_uiApplyUs * 100.0 / UI_BUDGET_PERCENT / 1000.0));
+}
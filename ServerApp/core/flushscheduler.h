@@ -0,0 +1,116 @@
+/**
+ * @file flushscheduler.h
+ * @brief Определяет класс FlushScheduler — планировщик отправки пакетов в UI-поток.
+ */
+#ifndef FLUSHSCHEDULER_H
+#define FLUSHSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QVariantMap>
+
+/**
+ * @class FlushScheduler
+ * @brief Адаптивный планировщик пакетной отправки данных из ServerWorker в UI.
+ *
+ * Решение об отправке принимается по трем величинам:
+ * - глубина очереди (количество накопленных записей и обновлений клиентов);
+ * - объем накопленных данных в байтах;
+ * - время применения пакета в UI-потоке, которое ServerViewModel сообщает обратно.
+ *
+ * При небольшой нагрузке пакеты уходят с интервалом TARGET_INTERVAL_MS, что
+ * ограничивает задержку отображения. При достижении порога по размеру пакет
+ * отправляется досрочно. Пока UI не подтвердил предыдущий пакет, новый не
+ * отправляется, а интервал удваивается; кроме того, интервал не опускается ниже
+ * значения, при котором обновление таблиц занимает больше UI_BUDGET_PERCENT
+ * времени UI-потока.
+ */
+class FlushScheduler {
+public:
+    /// @brief Минимальный интервал между отправками (в миллисекундах).
+    static constexpr int MIN_INTERVAL_MS        = 50;
+    /// @brief Интервал отправки при небольшой нагрузке (в миллисекундах).
+    static constexpr int TARGET_INTERVAL_MS     = 250;
+    /// @brief Максимальный интервал отправки (в миллисекундах).
+    static constexpr int MAX_INTERVAL_MS        = 2000;
+    /// @brief Количество записей в очереди, при котором пакет отправляется досрочно.
+    static constexpr int EARLY_FLUSH_RECORDS    = 2000;
+    /// @brief Объем данных в очереди, при котором пакет отправляется досрочно (в байтах).
+    static constexpr qsizetype EARLY_FLUSH_BYTES = 1024 * 1024;
+    /// @brief Допустимая доля времени UI-потока на применение пакетов (в процентах).
+    static constexpr int UI_BUDGET_PERCENT      = 25;
+
+    /**
+     * @enum Reason
+     * @brief Причина отправки пакета.
+     */
+    enum class Reason { Timer, Threshold };
+
+    /**
+     * @brief Проверяет, нужно ли отправить пакет досрочно.
+     * @param records Количество накопленных записей и обновлений.
+     * @param bytes Объем накопленных данных.
+     * @return true, если достигнут порог и UI готов принять пакет.
+     */
+    bool shouldFlushEarly(int records, qsizetype bytes) const;
+    /**
+     * @brief Проверяет, готов ли UI принять очередной пакет.
+     */
+    bool canFlush() const;
+    /**
+     * @brief Фиксирует отправку пакета.
+     * @param reason Причина отправки.
+     * @param records Количество записей в пакете.
+     * @param bytes Объем пакета.
+     * @return Порядковый номер пакета для подтверждения.
+     */
+    quint64 flushStarted(Reason reason, int records, qsizetype bytes);
+    /**
+     * @brief Фиксирует отложенную отправку (UI не успел обработать предыдущий пакет).
+     */
+    void flushDeferred();
+    /**
+     * @brief Фиксирует подтверждение пакета от UI и пересчитывает интервал.
+     * @param sequence Номер подтвержденного пакета.
+     * @param applyTimeUs Время применения пакета в UI-потоке (в микросекундах).
+     */
+    void flushAcknowledged(quint64 sequence, qint64 applyTimeUs);
+
+    /**
+     * @brief Возвращает текущий интервал отправки (в миллисекундах).
+     */
+    int interval() const { return m_interval; }
+    /**
+     * @brief Возвращает метрики планировщика для отображения в UI.
+     */
+    QVariantMap metrics() const;
+
+private:
+    /**
+     * @brief Возвращает минимальный интервал, укладывающийся в бюджет UI-потока.
+     */
+    int uiBoundInterval() const;
+
+    /// @brief Текущий интервал отправки.
+    int m_interval = TARGET_INTERVAL_MS;
+    /// @brief Номер последнего отправленного пакета.
+    quint64 m_sequence = 0;
+    /// @brief Номер последнего подтвержденного пакета.
+    quint64 m_acknowledged = 0;
+    /// @brief Время с момента последней отправки.
+    QElapsedTimer m_sinceFlush;
+    /// @brief Сглаженное время применения пакета в UI (в микросекундах).
+    double m_uiApplyUs = 0.0;
+    /// @brief Время от отправки до подтверждения последнего пакета (в миллисекундах).
+    qint64 m_lastRoundTripMs = 0;
+
+    // --- Метрики ---
+    quint64 m_timerFlushes = 0;
+    quint64 m_earlyFlushes = 0;
+    quint64 m_deferredFlushes = 0;
+    int m_lastRecords = 0;
+    qsizetype m_lastBytes = 0;
+    QString m_lastDecision;
+};
+
+#endif // FLUSHSCHEDULER_H
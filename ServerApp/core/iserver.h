@@ -40,6 +40,14 @@ public:
      * @return true, если сервер активен, иначе false.
      */
     virtual bool isListening() const = 0;
+    /**
+     * @brief Возвращает время без входящих сообщений, после которого DataProcessing отключает клиента.
+     *
+     * По умолчанию клиенты не отключаются: опрашиваемые устройства и
+     * UDP-отправители отслеживаются самими серверами.
+     * @return Время в миллисекундах (0 — не отключать).
+     */
+    virtual int idleTimeoutMs() const { return 0; }
 
 public slots:
     /**
@@ -56,8 +64,10 @@ public slots:
      * @brief Отправляет данные указанному клиенту.
      * @param client Указатель на клиента.
      * @param data Данные для отправки.
+     * @param coalesceKey Ключ замещения неотправленного сообщения (см. IClient::sendData).
      */
-    virtual void sendToClient(IClient *client, const QByteArray &data) = 0;
+    virtual void sendToClient(IClient *client, const QByteArray &data,
+                              const QString &coalesceKey = QString()) = 0;
     /**
      * @brief Удаляет клиента с сервера.
      * @param client Указатель на клиента, которого нужно удалить.
@@ -76,8 +86,9 @@ protected slots:
     /**
      * @brief Внутренний слот для обработки полученных данных.
      * @param data Полученные данные.
+     * @param receivedAtNs Время чтения данных из сокета.
      */
-    virtual void handleDataReceived(const QByteArray &data) = 0;
+    virtual void handleDataReceived(const QByteArray &data, qint64 receivedAtNs) = 0;
 
 signals:
     /**
@@ -94,13 +105,9 @@ signals:
      * @brief Сигнал, испускаемый при получении данных от клиента.
      * @param client Указатель на клиента-отправителя.
      * @param data Полученные данные.
+     * @param receivedAtNs Время чтения данных из сокета (MonotonicClock::nowNs()).
      */
-    void dataReceived(IClient *client, const QByteArray &data);
-    /**
-     * @brief Сигнал для отправки лог-сообщения.
-     * @param message Текст сообщения.
-     */
-    void logMessage(const QString &message);
+    void dataReceived(IClient *client, const QByteArray &data, qint64 receivedAtNs);
 };
 
 #endif // ISERVER_H
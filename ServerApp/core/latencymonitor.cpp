@@ -0,0 +1,242 @@
+#include "latencymonitor.h"
+#include "core/sharedkeys.h"
+
+#include <QVariantMap>
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <cmath>
+
+void LatencyHistogram::record(qint64 valueUs) {
+    if (valueUs < 0)
+        return;
+    const quint64 value = qMin(quint64(valueUs), MAX_VALUE_US);
+    ++m_buckets[bucketIndex(value)];
+    ++m_count;
+    m_max = qMax(m_max, value);
+}
+
+quint64 LatencyHistogram::valueAtPercentile(double percentile) const {
+    if (m_count == 0)
+        return 0;
+
+    const quint64 target = qMax<quint64>(1, quint64(std::ceil(percentile / 100.0 * m_count)));
+    quint64 cumulative = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        cumulative += m_buckets[i];
+        if (cumulative >= target)
+            return qMin(bucketUpperBound(i), m_max);
+    }
+    return m_max;
+}
+
+void LatencyHistogram::reset() {
+    m_buckets.fill(0);
+    m_count = 0;
+    m_max = 0;
+}
+
+int LatencyHistogram::bucketIndex(quint64 valueUs) {
+    if (valueUs < quint64(SUB_BUCKET_COUNT))
+        return int(valueUs);
+
+    // Номер старшего бита задает порядок, следующие 5 бит — корзину внутри порядка
+    const int msb = 63 - qCountLeadingZeroBits(valueUs);
+    const int shift = msb - 5;
+    const int subBucket = int(valueUs >> shift);
+    return SUB_BUCKET_COUNT + (shift - 1) * HALF_COUNT + (subBucket - HALF_COUNT);
+}
+
+quint64 LatencyHistogram::bucketUpperBound(int index) {
+    if (index < SUB_BUCKET_COUNT)
+        return quint64(index);
+
+    const int shift = (index - SUB_BUCKET_COUNT) / HALF_COUNT + 1;
+    const quint64 subBucket = (index - SUB_BUCKET_COUNT) % HALF_COUNT + HALF_COUNT;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+QString LatencyMonitor::stageName(Stage stage) {
+    switch (stage) {
+    case IoQueue:
+        return "Очередь ввода-вывода";
+    case Parse:
+        return "Разбор";
+    case BatchWait:
+        return "Ожидание пакета";
+    case Dispatch:
+        return "Доставка в UI";
+    case Apply:
+        return "Применение в модели";
+    case Total:
+        return "Итого";
+    case Network:
+        return "Сеть (от клиента)";
+    case EndToEnd:
+        return "От клиента до модели";
+    default:
+        return "Неизвестно";
+    }
+}
+
+void LatencyMonitor::recordBatch(const QList<TelemetryRecord> &records,
+                                 qint64 uiReceivedNs, qint64 appliedNs) {
+    const QString *lastType = nullptr;
+    StageHistograms *typeHistograms = nullptr;
+    const QString *lastClient = nullptr;
+    ClientWindow *window = nullptr;
+
+    for (const TelemetryRecord &record : records) {
+        const TelemetryRecord::StageTimes &t = record.stages;
+        if (t.received == 0)
+            continue;
+
+        // Пакеты обычно состоят из записей нескольких типов вперемешку,
+        // поэтому поиск в хеше выполняется только при смене типа
+        if (!lastType || *lastType != record.type) {
+            lastType = &record.type;
+            typeHistograms = &m_byType[record.type];
+        }
+
+        // Смещение часов клиента оценено с погрешностью, отрицательные задержки считаются нулевыми
+        const qint64 networkNs = qMax<qint64>(0, t.received - t.sent);
+        const qint64 endToEndNs = qMax<qint64>(0, appliedNs - t.sent);
+        const qint64 stageNs[StageCount] = {
+            t.parseStarted - t.received,
+            t.parsed - t.parseStarted,
+            t.flushed - t.parsed,
+            uiReceivedNs - t.flushed,
+            appliedNs - uiReceivedNs,
+            appliedNs - t.received,
+            networkNs,
+            endToEndNs,
+        };
+        // Без времени отправки (старые клиенты, Modbus) этапы от клиента не учитываются
+        const int stageCount = t.sent != 0 ? int(StageCount) : int(Network);
+        for (int stage = 0; stage < stageCount; ++stage) {
+            const qint64 valueUs = stageNs[stage] / 1000;
+            m_all[stage].record(valueUs);
+            (*typeHistograms)[stage].record(valueUs);
+        }
+
+        if (t.sent == 0 && record.sequence == 0)
+            continue;
+        if (!lastClient || *lastClient != record.clientId) {
+            lastClient = &record.clientId;
+            window = &m_byClient[record.clientId];
+            m_changedClients.insert(record.clientId);
+        }
+
+        // Номер меньше ожидаемого — клиент перезапущен, пропуском не считается
+        if (record.sequence > window->lastSequence + 1 && window->lastSequence != 0)
+            window->sequenceGaps += record.sequence - window->lastSequence - 1;
+        if (record.sequence != 0)
+            window->lastSequence = record.sequence;
+
+        if (t.sent != 0) {
+            window->ingestUs[window->next] = networkNs / 1000;
+            window->displayUs[window->next] = endToEndNs / 1000;
+            window->next = (window->next + 1) % CLIENT_WINDOW;
+            window->count = qMin(window->count + 1, CLIENT_WINDOW);
+        }
+    }
+}
+
+QVariantList LatencyMonitor::stats() const {
+    QVariantList rows;
+
+    auto appendRows = [&rows](const QString &type, const StageHistograms &histograms) {
+        for (int stage = 0; stage < StageCount; ++stage) {
+            const LatencyHistogram &histogram = histograms[stage];
+            QVariantMap row;
+            row[Keys::TYPE]          = type;
+            row[Keys::LATENCY_STAGE] = stageName(Stage(stage));
+            row[Keys::LATENCY_COUNT] = histogram.count();
+            row[Keys::LATENCY_P50]   = histogram.valueAtPercentile(50.0);
+            row[Keys::LATENCY_P90]   = histogram.valueAtPercentile(90.0);
+            row[Keys::LATENCY_P99]   = histogram.valueAtPercentile(99.0);
+            row[Keys::LATENCY_P999]  = histogram.valueAtPercentile(99.9);
+            row[Keys::LATENCY_MAX]   = histogram.max();
+            rows.append(row);
+        }
+    };
+
+    appendRows("Все", m_all);
+    QStringList types = m_byType.keys();
+    types.sort();
+    for (const QString &type : std::as_const(types)) {
+        appendRows(type, m_byType.constFind(type).value());
+    }
+    return rows;
+}
+
+QString LatencyMonitor::report() const {
+    QString text;
+    text += QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+                .arg(QString("Тип"), -16).arg(QString("Этап"), -22).arg(QString("Кол-во"), 10)
+                .arg(QString("p50"), 10).arg(QString("p90"), 10).arg(QString("p99"), 10)
+                .arg(QString("p99.9"), 10).arg(QString("max"), 10);
+
+    for (const QVariant &value : stats()) {
+        const QVariantMap row = value.toMap();
+        text += QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+                    .arg(row[Keys::TYPE].toString(), -16)
+                    .arg(row[Keys::LATENCY_STAGE].toString(), -22)
+                    .arg(row[Keys::LATENCY_COUNT].toULongLong(), 10)
+                    .arg(row[Keys::LATENCY_P50].toULongLong(), 10)
+                    .arg(row[Keys::LATENCY_P90].toULongLong(), 10)
+                    .arg(row[Keys::LATENCY_P99].toULongLong(), 10)
+                    .arg(row[Keys::LATENCY_P999].toULongLong(), 10)
+                    .arg(row[Keys::LATENCY_MAX].toULongLong(), 10);
+    }
+    text += "\nЗначения задержек в микросекундах.\n";
+    return text;
+}
+
+QHash<QString, ClientLatencyStats> LatencyMonitor::takeClientStats() {
+    QHash<QString, ClientLatencyStats> result;
+    result.reserve(m_changedClients.size());
+
+    // Окно небольшое, перцентили считаются частичной сортировкой копии
+    auto percentiles = [](const std::array<qint64, CLIENT_WINDOW> &values, int count,
+                          qint64 &p50, qint64 &p99, qint64 &max) {
+        std::array<qint64, CLIENT_WINDOW> sorted = values;
+        const auto end = sorted.begin() + count;
+        const auto at = [&sorted, end, count](double percentile) {
+            const auto nth = sorted.begin() + qMin(count - 1, int(percentile / 100.0 * count));
+            std::nth_element(sorted.begin(), nth, end);
+            return *nth;
+        };
+        p50 = at(50.0);
+        p99 = at(99.0);
+        max = *std::max_element(sorted.begin(), end);
+    };
+
+    for (const QString &clientId : std::as_const(m_changedClients)) {
+        const ClientWindow &window = m_byClient.constFind(clientId).value();
+        ClientLatencyStats stats;
+        stats.samples = window.count;
+        stats.sequenceGaps = window.sequenceGaps;
+        if (window.count > 0) {
+            percentiles(window.ingestUs, window.count, stats.ingestP50, stats.ingestP99, stats.ingestMax);
+            percentiles(window.displayUs, window.count, stats.displayP50, stats.displayP99, stats.displayMax);
+        }
+        result.insert(clientId, stats);
+    }
+    m_changedClients.clear();
+    return result;
+}
+
+void LatencyMonitor::forgetClient(const QString &clientId) {
+    m_byClient.remove(clientId);
+    m_changedClients.remove(clientId);
+}
+
+void LatencyMonitor::reset() {
+    for (LatencyHistogram &histogram : m_all) {
+        histogram.reset();
+    }
+    m_byType.clear();
+    m_byClient.clear();
+    m_changedClients.clear();
+}
@@ -0,0 +1,174 @@
+/**
+ * @file latencymonitor.h
+ * @brief Определяет гистограммы задержек и монитор задержек этапов конвейера приема.
+ */
+#ifndef LATENCYMONITOR_H
+#define LATENCYMONITOR_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QVariantList>
+
+#include <array>
+
+#include "core/telemetry.h"
+
+/**
+ * @class LatencyHistogram
+ * @brief Гистограмма задержек с логарифмически-линейными корзинами (в стиле HDR Histogram).
+ *
+ * Значения до 64 мкс хранятся точно, далее каждый интервал [2^n, 2^(n+1))
+ * делится на 32 равные корзины, что дает относительную погрешность не хуже ~3%.
+ * Запись значения — несколько целочисленных операций без выделения памяти.
+ */
+class LatencyHistogram {
+public:
+    /// @brief Количество точных корзин (и удвоенное число корзин на порядок).
+    static constexpr int SUB_BUCKET_COUNT = 64;
+    /// @brief Максимальное записываемое значение (мкс); большие значения усекаются.
+    static constexpr quint64 MAX_VALUE_US = (quint64(1) << 36) - 1;
+
+    /**
+     * @brief Записывает значение задержки.
+     * @param valueUs Задержка в микросекундах (отрицательные значения игнорируются).
+     */
+    void record(qint64 valueUs);
+    /**
+     * @brief Возвращает значение задержки для перцентиля.
+     * @param percentile Перцентиль (0–100).
+     * @return Верхняя граница корзины перцентиля (мкс).
+     */
+    quint64 valueAtPercentile(double percentile) const;
+
+    quint64 count() const { return m_count; }
+    quint64 max() const { return m_max; }
+    /**
+     * @brief Сбрасывает все накопленные значения.
+     */
+    void reset();
+
+private:
+    static constexpr int HALF_COUNT = SUB_BUCKET_COUNT / 2;
+    static constexpr int BUCKET_COUNT = SUB_BUCKET_COUNT + (36 - 6) * HALF_COUNT;
+
+    static int bucketIndex(quint64 valueUs);
+    static quint64 bucketUpperBound(int index);
+
+    std::array<quint64, BUCKET_COUNT> m_buckets{};
+    quint64 m_count = 0;
+    quint64 m_max = 0;
+};
+
+/**
+ * @struct ClientLatencyStats
+ * @brief Задержки доставки сообщений одного клиента по последним записям (мкс).
+ */
+struct ClientLatencyStats {
+    int samples = 0;            ///< Количество сообщений в окне (0 — клиент не передает время отправки)
+    qint64 ingestP50 = 0;       ///< От отправки до чтения из сокета: медиана
+    qint64 ingestP99 = 0;       ///< От отправки до чтения из сокета: 99-й перцентиль
+    qint64 ingestMax = 0;       ///< От отправки до чтения из сокета: максимум
+    qint64 displayP50 = 0;      ///< От отправки до применения в модели: медиана
+    qint64 displayP99 = 0;      ///< От отправки до применения в модели: 99-й перцентиль
+    qint64 displayMax = 0;      ///< От отправки до применения в модели: максимум
+    quint64 sequenceGaps = 0;   ///< Пропущено номеров сообщений
+};
+
+/**
+ * @class LatencyMonitor
+ * @brief Собирает задержки этапов конвейера приема по всем сообщениям, по типам и по клиентам.
+ *
+ * Этапы вычисляются из отметок TelemetryRecord::stages и времени получения
+ * и применения пакета в UI-потоке. Если клиент передал время отправки,
+ * дополнительно учитываются задержка сети и сквозная задержка до модели;
+ * по клиентам хранится окно последних CLIENT_WINDOW значений вместо
+ * гистограмм, чтобы память не росла с числом клиентов.
+ * Все методы вызываются из UI-потока.
+ */
+class LatencyMonitor {
+public:
+    /**
+     * @enum Stage
+     * @brief Этапы конвейера приема.
+     */
+    enum Stage {
+        IoQueue,    ///< Из потока ввода-вывода в рабочий поток
+        Parse,      ///< Разбор сообщения
+        BatchWait,  ///< Ожидание отправки пакета
+        Dispatch,   ///< Доставка пакета в UI-поток
+        Apply,      ///< Применение пакета в модели
+        Total,      ///< От чтения из сокета до появления в модели
+        Network,    ///< От отправки клиентом до чтения из сокета (сеть и очереди ОС)
+        EndToEnd,   ///< От отправки клиентом до появления в модели
+        StageCount
+    };
+
+    /// @brief Количество последних сообщений клиента, по которым считается его статистика.
+    static constexpr int CLIENT_WINDOW = 128;
+
+    /**
+     * @brief Возвращает название этапа для отображения.
+     */
+    static QString stageName(Stage stage);
+
+    /**
+     * @brief Записывает задержки этапов для пакета записей.
+     * @param records Записи пакета.
+     * @param uiReceivedNs Время получения пакета в UI-потоке.
+     * @param appliedNs Время окончания применения пакета в модели.
+     */
+    void recordBatch(const QList<TelemetryRecord> &records, qint64 uiReceivedNs, qint64 appliedNs);
+    /**
+     * @brief Возвращает статистику для QML: по строке на пару (тип сообщения, этап).
+     *
+     * Строки с типом "Все" агрегируют все сообщения. Ключи — Keys::TYPE и Keys::LATENCY_*.
+     */
+    QVariantList stats() const;
+    /**
+     * @brief Формирует текстовый отчет со статистикой.
+     */
+    QString report() const;
+    /**
+     * @brief Возвращает статистику клиентов, получивших сообщения после предыдущего вызова.
+     * @return Статистика по ID клиента.
+     */
+    QHash<QString, ClientLatencyStats> takeClientStats();
+    /**
+     * @brief Удаляет окно задержек клиента, удаленного из реестра.
+     * @param clientId ID клиента.
+     */
+    void forgetClient(const QString &clientId);
+    /**
+     * @brief Сбрасывает все гистограммы и окна клиентов.
+     */
+    void reset();
+
+private:
+    using StageHistograms = std::array<LatencyHistogram, StageCount>;
+
+    /**
+     * @struct ClientWindow
+     * @brief Кольцо последних задержек клиента и учет номеров сообщений.
+     */
+    struct ClientWindow {
+        std::array<qint64, CLIENT_WINDOW> ingestUs{};   ///< Отправка → чтение из сокета
+        std::array<qint64, CLIENT_WINDOW> displayUs{};  ///< Отправка → применение в модели
+        int count = 0;                                  ///< Заполнено значений
+        int next = 0;                                   ///< Позиция следующей записи
+        quint64 lastSequence = 0;                       ///< Последний принятый номер
+        quint64 sequenceGaps = 0;                       ///< Пропущено номеров
+    };
+
+    /// @brief Гистограммы по всем сообщениям.
+    StageHistograms m_all;
+    /// @brief Гистограммы по типам сообщений.
+    QHash<QString, StageHistograms> m_byType;
+    /// @brief Окна задержек по ID клиента.
+    QHash<QString, ClientWindow> m_byClient;
+    /// @brief Клиенты, получившие сообщения после последнего takeClientStats().
+    QSet<QString> m_changedClients;
+};
+
+#endif // LATENCYMONITOR_H
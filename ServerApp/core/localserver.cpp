@@ -0,0 +1,104 @@
+#include "localserver.h"
+#include "../common/protocol.h"
+#include "core/logger.h"
+
+LocalServer::LocalServer(const ServerSettings &settings, QObject *parent)
+    : IServer(parent), m_settings(settings), m_server(new QLocalServer(this)) {
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(m_server, &QLocalServer::newConnection, this, &LocalServer::handleNewConnection);
+}
+
+void LocalServer::startServer(quint16 port) {
+    if (m_server->isListening()) {
+        LOG_WARNING(AppEnums::LogCategory::Server, "Локальный сервер уже запущен.");
+        return;
+    }
+
+    const QString name = Protocol::Local::SERVER_NAME_PREFIX + QString::number(port);
+    // Файл сокета мог остаться после аварийного завершения
+    QLocalServer::removeServer(name);
+    if (!m_server->listen(name)) {
+        LOG_ERROR(AppEnums::LogCategory::Server,
+                  QString("Ошибка запуска локального сервера: %1").arg(m_server->errorString()));
+        return;
+    }
+
+    LOG_INFO(AppEnums::LogCategory::Server,
+             QString("Локальный сервер запущен: %1").arg(m_server->fullServerName()));
+}
+
+void LocalServer::stopServer() {
+    if (!m_server->isListening()) {
+        LOG_WARNING(AppEnums::LogCategory::Server, "Локальный сервер уже остановлен.");
+        return;
+    }
+
+    m_server->close();
+    for (LocalClient *client : std::as_const(m_clients)) {
+        client->disconnect();
+    }
+    m_clients.clear();
+
+    LOG_INFO(AppEnums::LogCategory::Server, "Локальный сервер остановлен.");
+}
+
+void LocalServer::handleNewConnection() {
+    while (m_server->hasPendingConnections()) {
+        QLocalSocket *socket = m_server->nextPendingConnection();
+        auto *client = new LocalClient(socket, this);
+        client->setSlowConsumerPolicy(m_settings.slowConsumerPolicy, m_settings.maxSendQueueBytes);
+
+        connect(client, &LocalClient::dataReceived, this, &LocalServer::handleDataReceived);
+        connect(client, &LocalClient::disconnected, this, &LocalServer::handleClientDisconnected);
+
+        m_clients.insert(client->descriptor(), client);
+        emit clientConnected(client);
+        LOG_INFO(AppEnums::LogCategory::Network,
+                 QString("Новый локальный клиент подключен: %1").arg(client->descriptor()));
+    }
+}
+
+void LocalServer::handleDataReceived(const QByteArray &data, qint64 receivedAtNs) {
+    auto *client = qobject_cast<LocalClient *>(sender());
+    if (!client) {
+        LOG_WARNING(AppEnums::LogCategory::Network, "Неизвестный отправитель сигнала.");
+        return;
+    }
+
+    emit dataReceived(client, data, receivedAtNs);
+    LOG_SAMPLED(AppEnums::LogLevel::Debug, AppEnums::LogCategory::Network, 100,
+                QString("Получены данные от локального клиента %1").arg(client->id()));
+}
+
+void LocalServer::handleClientDisconnected() {
+    auto *client = qobject_cast<LocalClient *>(sender());
+    if (client) {
+        emit clientDisconnected(client);
+        LOG_INFO(AppEnums::LogCategory::Network,
+                 QString("Локальный клиент отключен: %1").arg(client->id()));
+    } else {
+        LOG_WARNING(AppEnums::LogCategory::Network, "Невозможно определить отключившегося клиента.");
+    }
+}
+
+void LocalServer::removeClient(IClient *client) {
+    if (!client)
+        return;
+
+    // Дескриптор мог быть переиспользован новым подключением
+    auto it = m_clients.find(client->descriptor());
+    if (it != m_clients.end() && it.value() == client) {
+        m_clients.erase(it);
+    }
+    client->deleteLater();
+}
+
+void LocalServer::sendToClient(IClient *client, const QByteArray &data,
+                               const QString &coalesceKey) {
+    if (!client || !client->isConnected()) {
+        LOG_WARNING(AppEnums::LogCategory::Network, "Клиент не найден или не подключен.");
+        return;
+    }
+
+    client->sendData(data, coalesceKey);
+}
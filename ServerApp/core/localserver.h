@@ -0,0 +1,98 @@
+/**
+ * @file localserver.h
+ * @brief Определяет класс LocalServer, реализующий IServer для локального сокета.
+ */
+#ifndef LOCALSERVER_H
+#define LOCALSERVER_H
+
+#include <QHash>
+#include <QLocalServer>
+#include <QObject>
+
+#include "../common/localclient.h"
+#include "core/iserver.h"
+#include "core/serversettings.h"
+
+/**
+ * @class LocalServer
+ * @brief Реализация интерфейса IServer на QLocalServer для агентов на том же хосте.
+ *
+ * Слушает локальный сокет с именем Protocol::Local::SERVER_NAME_PREFIX + порт
+ * и создает для каждого подключения LocalClient. Регистрация, кадрирование и
+ * разбор сообщений те же, что для TCP. Сокеты обслуживаются в потоке сервера:
+ * локальные агенты немногочисленны, а системные вызовы локального сокета
+ * заметно дешевле, чем у TCP loopback.
+ */
+class LocalServer : public IServer {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Конструктор класса LocalServer.
+     * @param settings Параметры сервера (политика медленного получателя).
+     * @param parent Родительский объект QObject.
+     */
+    explicit LocalServer(const ServerSettings &settings = ServerSettings(),
+                         QObject *parent = nullptr);
+
+    /**
+     * @brief Возвращает количество подключенных клиентов.
+     */
+    int clientCount() const override { return m_clients.size(); }
+    /**
+     * @brief Проверяет, слушает ли сервер локальный сокет.
+     */
+    bool isListening() const override { return m_server->isListening(); }
+    /**
+     * @brief Возвращает ServerSettings::idleTimeoutMs.
+     */
+    int idleTimeoutMs() const override { return m_settings.idleTimeoutMs; }
+
+public slots:
+    /**
+     * @brief Начинает прослушивание локального сокета.
+     * @param port Номер, из которого строится имя сокета.
+     */
+    void startServer(quint16 port) override;
+    /**
+     * @brief Прекращает прослушивание и отключает всех клиентов.
+     */
+    void stopServer() override;
+
+    /**
+     * @brief Отправляет данные указанному клиенту.
+     */
+    void sendToClient(IClient *client, const QByteArray &data,
+                      const QString &coalesceKey = QString()) override;
+    /**
+     * @brief Удаляет клиента с сервера.
+     * @param client Указатель на клиента.
+     */
+    void removeClient(IClient *client) override;
+
+private slots:
+    /**
+     * @brief Создает клиентов для всех принятых подключений.
+     */
+    void handleNewConnection() override;
+    /**
+     * @brief Обрабатывает отключение клиента.
+     */
+    void handleClientDisconnected() override;
+    /**
+     * @brief Передает данные, полученные от клиента.
+     * @param data Полученные данные.
+     * @param receivedAtNs Время чтения данных из сокета.
+     */
+    void handleDataReceived(const QByteArray &data, qint64 receivedAtNs) override;
+
+private:
+    /// @brief Параметры сервера.
+    ServerSettings m_settings;
+    /// @brief Слушающий локальный сокет.
+    QLocalServer *m_server;
+    /// @brief Подключенные клиенты по дескрипторам.
+    QHash<quintptr, LocalClient *> m_clients;
+};
+
+#endif // LOCALSERVER_H
@@ -0,0 +1,183 @@
+#include "logger.h"
+#include "../common/monotonicclock.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+
+#include <utility>
+
+namespace {
+// Длина окна ограничения частоты (в миллисекундах)
+constexpr qint64 RATE_WINDOW_MS = 1000;
+} // namespace
+
+Logger &Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() {
+    for (auto &level : m_levels) {
+        level.store(int(AppEnums::LogLevel::Info), std::memory_order_relaxed);
+    }
+}
+
+Logger::~Logger() { shutdown(); }
+
+bool Logger::admit(AppEnums::LogLevel level, AppEnums::LogCategory category) {
+    if (!isEnabled(level, category))
+        return false;
+
+    const qint64 nowMs = MonotonicClock::nowNs() / 1000000;
+    quint64 suppressed = 0;
+    bool admitted = true;
+    {
+        QMutexLocker locker(&m_rateMutex);
+        RateWindow &window = m_rateWindows[int(category)];
+        if (nowMs - window.startMs >= RATE_WINDOW_MS) {
+            suppressed = window.suppressed;
+            window = RateWindow{nowMs, 0, 0};
+        }
+        if (window.count < RATE_LIMIT_PER_SECOND) {
+            ++window.count;
+        } else {
+            ++window.suppressed;
+            admitted = false;
+        }
+    }
+
+    // Сводка о пропущенных сообщениях выводится с открытием нового окна
+    if (suppressed > 0) {
+        write(AppEnums::LogLevel::Warning, category,
+              QString("Пропущено %1 сообщений (более %2 в секунду).")
+                  .arg(suppressed)
+                  .arg(RATE_LIMIT_PER_SECOND));
+    }
+    return admitted;
+}
+
+void Logger::write(AppEnums::LogLevel level, AppEnums::LogCategory category,
+                   const QString &message) {
+    const LogEntry entry{QDateTime::currentMSecsSinceEpoch(), level, category, message};
+
+    QMutexLocker locker(&m_queueMutex);
+    if (m_uiQueue.size() >= UI_TAIL_CAPACITY) {
+        m_uiQueue.removeFirst();
+    }
+    m_uiQueue.append(entry);
+
+    if (m_file) {
+        if (m_fileQueue.size() >= FILE_QUEUE_CAPACITY) {
+            m_fileQueue.removeFirst();
+        }
+        m_fileQueue.append(entry);
+    }
+}
+
+void Logger::setLevel(AppEnums::LogCategory category, AppEnums::LogLevel level) {
+    m_levels[int(category)].store(int(level), std::memory_order_relaxed);
+}
+
+void Logger::setLevel(AppEnums::LogLevel level) {
+    for (auto &categoryLevel : m_levels) {
+        categoryLevel.store(int(level), std::memory_order_relaxed);
+    }
+}
+
+AppEnums::LogLevel Logger::level(AppEnums::LogCategory category) const {
+    return AppEnums::LogLevel(m_levels[int(category)].load(std::memory_order_relaxed));
+}
+
+QList<LogEntry> Logger::takePending() {
+    QMutexLocker locker(&m_queueMutex);
+    return std::exchange(m_uiQueue, {});
+}
+
+bool Logger::setFileSink(const QString &filePath) {
+    shutdown();
+
+    // Слишком большой файл сохраняется с суффиксом .1, старая копия заменяется
+    if (QFileInfo(filePath).size() > MAX_FILE_SIZE) {
+        const QString backupPath = filePath + ".1";
+        QFile::remove(backupPath);
+        QFile::rename(filePath, backupPath);
+    }
+
+    auto *file = new QFile(filePath);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        delete file;
+        return false;
+    }
+
+    m_fileContext = new QObject();
+    file->setParent(m_fileContext);
+    m_fileTimer = new QTimer(m_fileContext);
+    m_fileTimer->setInterval(FILE_FLUSH_INTERVAL_MS);
+    QObject::connect(m_fileTimer, &QTimer::timeout, m_fileContext, [this] { flushFileQueue(); });
+
+    m_fileThread = new QThread();
+    m_fileThread->setObjectName("LogFile");
+    m_fileContext->moveToThread(m_fileThread);
+    QObject::connect(m_fileThread, &QThread::started, m_fileTimer,
+                     qOverload<>(&QTimer::start));
+
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_file = file;
+    }
+    m_fileThread->start();
+    return true;
+}
+
+void Logger::shutdown() {
+    if (!m_fileThread)
+        return;
+
+    // Останавливаем таймер в его потоке, затем дописываем остаток
+    QMetaObject::invokeMethod(m_fileTimer, &QTimer::stop, Qt::BlockingQueuedConnection);
+    m_fileThread->quit();
+    m_fileThread->wait();
+    flushFileQueue();
+
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_file = nullptr;
+        m_fileQueue.clear();
+    }
+    delete m_fileContext;
+    delete m_fileThread;
+    m_fileContext = nullptr;
+    m_fileTimer = nullptr;
+    m_fileThread = nullptr;
+}
+
+QString Logger::format(const LogEntry &entry) {
+    return QString("[%1] %2 [%3] %4")
+        .arg(QDateTime::fromMSecsSinceEpoch(entry.timestamp).toString("dd.MM.yy hh:mm:ss.zzz"),
+             AppEnums::logLevelToString(entry.level),
+             AppEnums::logCategoryToString(entry.category),
+             entry.message);
+}
+
+void Logger::flushFileQueue() {
+    QList<LogEntry> entries;
+    QFile *file = nullptr;
+    {
+        QMutexLocker locker(&m_queueMutex);
+        entries = std::exchange(m_fileQueue, {});
+        file = m_file;
+    }
+    if (!file || entries.isEmpty())
+        return;
+
+    QTextStream stream(file);
+    for (const LogEntry &entry : std::as_const(entries)) {
+        stream << format(entry) << '\n';
+    }
+    stream.flush();
+    file->flush();
+}
@@ -0,0 +1,183 @@
+/**
+ * @file logger.h
+ * @brief Определяет класс Logger — структурированный асинхронный журнал сервера.
+ */
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <QList>
+#include <QMetaType>
+#include <QMutex>
+#include <QString>
+
+#include <array>
+#include <atomic>
+
+#include "core/appenums.h"
+
+class QFile;
+class QThread;
+class QTimer;
+
+/**
+ * @struct LogEntry
+ * @brief Одна запись журнала.
+ */
+struct LogEntry {
+    /// @brief Время записи (миллисекунды от эпохи Unix).
+    qint64 timestamp = 0;
+    AppEnums::LogLevel level = AppEnums::LogLevel::Info;
+    AppEnums::LogCategory category = AppEnums::LogCategory::Server;
+    QString message;
+};
+
+Q_DECLARE_METATYPE(LogEntry)
+
+/**
+ * @class Logger
+ * @brief Потокобезопасный журнал с уровнями, категориями и ограничением частоты.
+ *
+ * Сообщения пишутся через макросы LOG_*, которые формируют текст только после
+ * проверки уровня, поэтому отфильтрованный вызов стоит одного атомарного чтения.
+ * Для каждой категории действует ограничение RATE_LIMIT_PER_SECOND сообщений в
+ * секунду; о пропущенных сообщениях в журнал попадает сводка.
+ *
+ * Записи накапливаются в ограниченной очереди для UI (takePending()) и, если
+ * задан файл, в очереди файлового приемника, который пишет на диск в отдельном
+ * потоке каждые FILE_FLUSH_INTERVAL_MS.
+ */
+class Logger {
+public:
+    /// @brief Количество категорий журнала.
+    static constexpr int CATEGORY_COUNT = int(AppEnums::LogCategory::Data) + 1;
+    /// @brief Максимальное количество сообщений одной категории в секунду.
+    static constexpr int RATE_LIMIT_PER_SECOND = 200;
+    /// @brief Емкость очереди записей для UI; при переполнении вытесняются старые.
+    static constexpr int UI_TAIL_CAPACITY = 1000;
+    /// @brief Емкость очереди файлового приемника.
+    static constexpr int FILE_QUEUE_CAPACITY = 50000;
+    /// @brief Интервал записи на диск (в миллисекундах).
+    static constexpr int FILE_FLUSH_INTERVAL_MS = 200;
+    /// @brief Размер файла, при превышении которого он переименовывается при открытии.
+    static constexpr qint64 MAX_FILE_SIZE = 10 * 1024 * 1024;
+
+    /**
+     * @brief Возвращает единственный экземпляр журнала.
+     */
+    static Logger &instance();
+
+    /**
+     * @brief Проверяет, проходит ли сообщение фильтр по уровню.
+     */
+    bool isEnabled(AppEnums::LogLevel level, AppEnums::LogCategory category) const {
+        return int(level) >= m_levels[int(category)].load(std::memory_order_relaxed);
+    }
+    /**
+     * @brief Проверяет уровень и ограничение частоты; вызывается до форматирования сообщения.
+     * @return true, если сообщение нужно записать.
+     */
+    bool admit(AppEnums::LogLevel level, AppEnums::LogCategory category);
+    /**
+     * @brief Добавляет запись в очереди приемников.
+     */
+    void write(AppEnums::LogLevel level, AppEnums::LogCategory category, const QString &message);
+
+    /**
+     * @brief Задает минимальный уровень для категории.
+     */
+    void setLevel(AppEnums::LogCategory category, AppEnums::LogLevel level);
+    /**
+     * @brief Задает минимальный уровень для всех категорий.
+     */
+    void setLevel(AppEnums::LogLevel level);
+    /**
+     * @brief Возвращает минимальный уровень категории.
+     */
+    AppEnums::LogLevel level(AppEnums::LogCategory category) const;
+
+    /**
+     * @brief Забирает записи, накопленные для UI с прошлого вызова.
+     */
+    QList<LogEntry> takePending();
+    /**
+     * @brief Включает запись журнала в файл.
+     * @param filePath Путь к файлу; запись ведется в конец файла.
+     * @return true, если файл открыт.
+     */
+    bool setFileSink(const QString &filePath);
+    /**
+     * @brief Останавливает файловый приемник, дописав накопленные записи.
+     */
+    void shutdown();
+
+    /**
+     * @brief Формирует строку записи для отображения и файла.
+     */
+    static QString format(const LogEntry &entry);
+
+private:
+    Logger();
+    ~Logger();
+    Logger(const Logger &) = delete;
+    Logger &operator=(const Logger &) = delete;
+
+    /**
+     * @brief Записывает очередь файлового приемника на диск.
+     */
+    void flushFileQueue();
+
+    /**
+     * @struct RateWindow
+     * @brief Счетчики ограничения частоты для категории в текущем окне.
+     */
+    struct RateWindow {
+        qint64 startMs = 0;
+        int count = 0;
+        quint64 suppressed = 0;
+    };
+
+    /// @brief Минимальный уровень по категориям.
+    std::array<std::atomic<int>, CATEGORY_COUNT> m_levels;
+    /// @brief Окна ограничения частоты по категориям (защищены m_rateMutex).
+    std::array<RateWindow, CATEGORY_COUNT> m_rateWindows;
+    QMutex m_rateMutex;
+
+    /// @brief Защищает очереди приемников.
+    QMutex m_queueMutex;
+    QList<LogEntry> m_uiQueue;
+    QList<LogEntry> m_fileQueue;
+
+    // Файловый приемник (объекты живут в m_fileThread)
+    QThread *m_fileThread = nullptr;
+    QObject *m_fileContext = nullptr;
+    QTimer *m_fileTimer = nullptr;
+    QFile *m_file = nullptr;
+};
+
+/**
+ * @brief Записывает сообщение, если оно проходит фильтр; текст вычисляется только в этом случае.
+ */
+#define LOG_MESSAGE(level, category, message)                                  \
+    do {                                                                       \
+        if (Logger::instance().admit(level, category))                         \
+            Logger::instance().write(level, category, message);                \
+    } while (false)
+
+#define LOG_DEBUG(category, message)   LOG_MESSAGE(AppEnums::LogLevel::Debug, category, message)
+#define LOG_INFO(category, message)    LOG_MESSAGE(AppEnums::LogLevel::Info, category, message)
+#define LOG_WARNING(category, message) LOG_MESSAGE(AppEnums::LogLevel::Warning, category, message)
+#define LOG_ERROR(category, message)   LOG_MESSAGE(AppEnums::LogLevel::Error, category, message)
+
+/**
+ * @brief Записывает каждое everyN-е сообщение из данного места вызова (для горячих путей).
+ */
+#define LOG_SAMPLED(level, category, everyN, message)                          \
+    do {                                                                       \
+        static std::atomic<quint32> logSampleCounter{0};                       \
+        if (Logger::instance().isEnabled(level, category) &&                   \
+            logSampleCounter.fetch_add(1, std::memory_order_relaxed) % (everyN) == 0 && \
+            Logger::instance().admit(level, category))                         \
+            Logger::instance().write(level, category, message);                \
+    } while (false)
+
+#endif // LOGGER_H
@@ -0,0 +1,95 @@
+#include "modbusdevice.h"
+#include "../common/messagecodec.h"
+#include "../common/monotonicclock.h"
+#include "../common/protocol.h"
+#include "core/clientdescriptor.h"
+
+#include <utility>
+
+ModbusDevice::ModbusDevice(const ModbusDeviceConfig &config, QObject *parent)
+    : IClient(parent), m_config(config), m_descriptor(ClientDescriptor::allocate()),
+    m_id(config.id) {}
+
+void ModbusDevice::setFramingMode(FramingMode mode) { Q_UNUSED(mode) }
+
+void ModbusDevice::sendData(const QByteArray &data) { Q_UNUSED(data) }
+
+void ModbusDevice::sendData(const QByteArray &data, const QString &coalesceKey) {
+    Q_UNUSED(data)
+    Q_UNUSED(coalesceKey)
+}
+
+void ModbusDevice::setSlowConsumerPolicy(SlowConsumerPolicy policy, qint64 maxQueuedBytes) {
+    Q_UNUSED(policy)
+    Q_UNUSED(maxQueuedBytes)
+}
+
+bool ModbusDevice::beginCycle() {
+    if (cycleActive()) {
+        // Устройство не успевает за периодом опроса: цикл не накладывается на предыдущий
+        ++m_skippedCycles;
+        return false;
+    }
+    m_blocksRemaining = m_config.blocks.size();
+    m_cycleValues = QJsonObject();
+    return true;
+}
+
+void ModbusDevice::completeBlock(int block, const char *pdu, qsizetype size, qint64 receivedAtNs) {
+    const ModbusReadBlock &readBlock = m_config.blocks.at(block);
+    QString error;
+    if (!ModbusRegisterMap::checkReadResponse(pdu, size, readBlock, &error)) {
+        failBlock(error, receivedAtNs);
+        return;
+    }
+
+    ModbusRegisterMap::decode(m_config, readBlock, pdu, m_cycleValues);
+    m_registersRead += readBlock.count;
+    finishBlock(receivedAtNs);
+}
+
+void ModbusDevice::failBlock(const QString &error, qint64 receivedAtNs) {
+    ++m_failedRequests;
+    emit errorOccurred(error);
+    finishBlock(receivedAtNs);
+}
+
+void ModbusDevice::abortCycle() {
+    m_blocksRemaining = 0;
+    m_cycleValues = QJsonObject();
+}
+
+void ModbusDevice::finishBlock(qint64 receivedAtNs) {
+    if (m_blocksRemaining == 0 || --m_blocksRemaining > 0)
+        return;
+    if (m_cycleValues.isEmpty() || !m_connected)
+        return;
+
+    QJsonObject message;
+    message[Protocol::Keys::TYPE] = Protocol::MessageType::REGISTERS;
+    message[Protocol::Keys::ID] = m_config.id;
+    message[Protocol::Keys::PAYLOAD] = std::exchange(m_cycleValues, QJsonObject());
+    emit dataReceived(MessageCodec::encode(message, MessageCodec::Encoding::Cbor), receivedAtNs);
+}
+
+void ModbusDevice::announceConnected() {
+    if (m_connected)
+        return;
+    m_connected = true;
+    emit connected();
+
+    // Устройство проходит ту же регистрацию, что и обычные клиенты
+    QJsonObject registration;
+    registration[Protocol::Keys::TYPE] = Protocol::MessageType::REGISTRATION;
+    registration[Protocol::Keys::ID] = m_config.id;
+    emit dataReceived(MessageCodec::encode(registration, MessageCodec::Encoding::Json),
+                      MonotonicClock::nowNs());
+}
+
+void ModbusDevice::announceDisconnected() {
+    abortCycle();
+    if (!m_connected)
+        return;
+    m_connected = false;
+    emit disconnected();
+}
@@ -0,0 +1,144 @@
+/**
+ * @file modbusdevice.h
+ * @brief Определяет класс ModbusDevice — общую часть опрашиваемых Modbus-устройств.
+ */
+#ifndef MODBUSDEVICE_H
+#define MODBUSDEVICE_H
+
+#include <QJsonObject>
+
+#include "../common/iclient.h"
+#include "core/modbusregistermap.h"
+
+/**
+ * @class ModbusDevice
+ * @brief Базовый класс опрашиваемого Modbus-устройства, общий для TCP и RTU.
+ *
+ * Для DataProcessing устройство выглядит как обычный клиент: при подключении
+ * оно передает сообщение Registration с ID устройства, а по завершении цикла
+ * опроса — одно сообщение Registers со всеми прочитанными значениями.
+ * Сообщения сервера (подтверждение, конфигурация, команды) устройству не
+ * передаются. В droppedMessages() учитываются запросы, завершившиеся ошибкой
+ * или таймаутом.
+ *
+ * Транспорт (наследник) отправляет запросы блоков цикла и сообщает о каждом
+ * ответе через completeBlock() или failBlock(); цикл завершается, когда
+ * получены ответы на все блоки.
+ */
+class ModbusDevice : public IClient {
+    Q_OBJECT
+
+public:
+    quintptr descriptor() const override { return m_descriptor; }
+    QString id() const override { return m_id; }
+    bool isConnected() const override { return m_connected; }
+    FramingMode framingMode() const override { return FramingMode::Raw; }
+
+    void setId(const QString &id) override { m_id = id; }
+    /**
+     * @brief Не используется: кадрирование определяется протоколом Modbus.
+     */
+    void setFramingMode(FramingMode mode) override;
+
+    /**
+     * @brief Не используется: сообщения сервера устройству не передаются.
+     */
+    void sendData(const QByteArray &data) override;
+    void sendData(const QByteArray &data, const QString &coalesceKey) override;
+    /**
+     * @brief Возвращает 0: собственной очереди отправки нет.
+     */
+    qint64 queuedBytes() const override { return 0; }
+    /**
+     * @brief Возвращает количество запросов, завершившихся ошибкой или таймаутом.
+     */
+    quint64 droppedMessages() const override { return m_failedRequests; }
+    /**
+     * @brief Не используется.
+     */
+    void setSlowConsumerPolicy(SlowConsumerPolicy policy, qint64 maxQueuedBytes) override;
+
+    /**
+     * @brief Возвращает параметры опроса.
+     */
+    const ModbusDeviceConfig &config() const { return m_config; }
+    /**
+     * @brief Возвращает количество прочитанных регистров (включая регистры в разрывах блоков).
+     */
+    quint64 registersRead() const { return m_registersRead; }
+    /**
+     * @brief Возвращает количество циклов, пропущенных из-за незавершенного предыдущего.
+     */
+    quint64 skippedCycles() const { return m_skippedCycles; }
+    /**
+     * @brief Проверяет, ожидаются ли еще ответы текущего цикла.
+     */
+    bool cycleActive() const { return m_blocksRemaining > 0; }
+
+    /**
+     * @brief Начинает новый цикл опроса.
+     * @return false, если предыдущий цикл не завершен (цикл пропускается).
+     */
+    bool beginCycle();
+    /**
+     * @brief Обрабатывает ответ на запрос блока.
+     * @param block Индекс блока.
+     * @param pdu Указатель на PDU ответа.
+     * @param size Размер PDU.
+     * @param receivedAtNs Время получения ответа.
+     */
+    void completeBlock(int block, const char *pdu, qsizetype size, qint64 receivedAtNs);
+    /**
+     * @brief Учитывает запрос, на который не получен корректный ответ.
+     * @param error Описание ошибки.
+     * @param receivedAtNs Время обнаружения ошибки.
+     */
+    void failBlock(const QString &error, qint64 receivedAtNs);
+    /**
+     * @brief Прерывает текущий цикл без передачи значений (например, при обрыве связи).
+     */
+    void abortCycle();
+
+protected:
+    /**
+     * @brief Конструктор класса ModbusDevice.
+     * @param config Параметры опроса и карта регистров.
+     * @param parent Родительский объект QObject.
+     */
+    explicit ModbusDevice(const ModbusDeviceConfig &config, QObject *parent = nullptr);
+
+    /**
+     * @brief Помечает устройство подключенным и передает сообщение регистрации.
+     */
+    void announceConnected();
+    /**
+     * @brief Помечает устройство отключенным и испускает disconnected().
+     */
+    void announceDisconnected();
+
+    /// @brief Параметры опроса.
+    ModbusDeviceConfig m_config;
+
+private:
+    /**
+     * @brief Учитывает завершение блока и передает значения, если цикл завершен.
+     */
+    void finishBlock(qint64 receivedAtNs);
+
+    /// @brief Синтетический дескриптор.
+    quintptr m_descriptor;
+    /// @brief Строковый идентификатор клиента.
+    QString m_id;
+    bool m_connected = false;
+
+    /// @brief Количество блоков текущего цикла, ответ на которые еще не обработан.
+    int m_blocksRemaining = 0;
+    /// @brief Значения, прочитанные в текущем цикле.
+    QJsonObject m_cycleValues;
+
+    quint64 m_registersRead = 0;
+    quint64 m_failedRequests = 0;
+    quint64 m_skippedCycles = 0;
+};
+
+#endif // MODBUSDEVICE_H
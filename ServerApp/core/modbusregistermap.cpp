@@ -0,0 +1,223 @@
+#include "modbusregistermap.h"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace {
+void setError(QString *error, const QString &message) {
+    if (error)
+        *error = message;
+}
+
+bool parseTable(const QString &name, ModbusRegister::Table &table) {
+    if (name.isEmpty() || name == "holding") {
+        table = ModbusRegister::Table::Holding;
+    } else if (name == "input") {
+        table = ModbusRegister::Table::Input;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseType(const QString &name, ModbusRegister::Type &type) {
+    if (name.isEmpty() || name == "uint16") {
+        type = ModbusRegister::Type::UInt16;
+    } else if (name == "int16") {
+        type = ModbusRegister::Type::Int16;
+    } else if (name == "uint32") {
+        type = ModbusRegister::Type::UInt32;
+    } else if (name == "int32") {
+        type = ModbusRegister::Type::Int32;
+    } else if (name == "float32") {
+        type = ModbusRegister::Type::Float32;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+quint8 functionCode(ModbusRegister::Table table) {
+    return table == ModbusRegister::Table::Input ? Modbus::READ_INPUT_REGISTERS
+                                                 : Modbus::READ_HOLDING_REGISTERS;
+}
+} // namespace
+
+bool ModbusRegisterMap::loadSection(const QString &path, const QString &section,
+                                    QJsonArray &devices, QString *error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError(error, QString("Не удалось открыть карту регистров %1: %2").arg(path, file.errorString()));
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        setError(error, QString("Ошибка разбора %1: %2").arg(path, parseError.errorString()));
+        return false;
+    }
+
+    const QJsonValue value = document.object().value(section);
+    if (!value.isArray()) {
+        setError(error, QString("В файле %1 нет секции \"%2\".").arg(path, section));
+        return false;
+    }
+    devices = value.toArray();
+    return true;
+}
+
+bool ModbusRegisterMap::parseDevice(const QJsonObject &json, ModbusDeviceConfig &config,
+                                    QString *error) {
+    config.id = json.value("id").toString();
+    if (config.id.isEmpty()) {
+        setError(error, "Не задан ID устройства.");
+        return false;
+    }
+
+    const int unitId = json.value("unitId").toInt(1);
+    if (unitId < 0 || unitId > 255) {
+        setError(error, QString("Устройство %1: недопустимый unitId %2.").arg(config.id).arg(unitId));
+        return false;
+    }
+    config.unitId = quint8(unitId);
+    config.pollIntervalMs = qMax(10, json.value("pollIntervalMs").toInt(config.pollIntervalMs));
+    config.maxGap = qBound(0, json.value("maxGap").toInt(config.maxGap), Modbus::MAX_READ_REGISTERS);
+
+    config.registers.clear();
+    const QJsonArray registers = json.value("registers").toArray();
+    for (const QJsonValue &value : registers) {
+        const QJsonObject item = value.toObject();
+        ModbusRegister reg;
+        reg.name = item.value("name").toString();
+        const int address = item.value("address").toInt(-1);
+        if (reg.name.isEmpty() || !parseTable(item.value("table").toString(), reg.table) ||
+            !parseType(item.value("type").toString(), reg.type) || address < 0 ||
+            address + reg.width() > 0x10000) {
+            setError(error, QString("Устройство %1: некорректное описание регистра %2.")
+                                .arg(config.id, QString::fromUtf8(QJsonDocument(item).toJson(QJsonDocument::Compact))));
+            return false;
+        }
+        reg.address = quint16(address);
+        reg.scale = item.value("scale").toDouble(1.0);
+        reg.swapWords = item.value("swapWords").toBool(false);
+        config.registers.append(reg);
+    }
+
+    if (config.registers.isEmpty()) {
+        setError(error, QString("Устройство %1: пустая карта регистров.").arg(config.id));
+        return false;
+    }
+    config.blocks = buildBlocks(config.registers, config.maxGap);
+    return true;
+}
+
+QList<ModbusReadBlock> ModbusRegisterMap::buildBlocks(const QList<ModbusRegister> &registers,
+                                                      int maxGap) {
+    QList<int> order(registers.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&registers](int a, int b) {
+        const ModbusRegister &left = registers.at(a);
+        const ModbusRegister &right = registers.at(b);
+        return left.table != right.table ? left.table < right.table : left.address < right.address;
+    });
+
+    QList<ModbusReadBlock> blocks;
+    for (int index : std::as_const(order)) {
+        const ModbusRegister &reg = registers.at(index);
+        const int end = reg.address + reg.width();
+
+        if (!blocks.isEmpty()) {
+            ModbusReadBlock &block = blocks.last();
+            const int blockEnd = block.start + block.count;
+            // Регистры в разрыве читаются впустую, но это дешевле отдельного запроса
+            if (block.table == reg.table && reg.address <= blockEnd + maxGap &&
+                end - block.start <= Modbus::MAX_READ_REGISTERS) {
+                block.count = quint16(qMax(blockEnd, end) - block.start);
+                block.registers.append(index);
+                continue;
+            }
+        }
+
+        ModbusReadBlock block;
+        block.table = reg.table;
+        block.start = reg.address;
+        block.count = quint16(reg.width());
+        block.registers.append(index);
+        blocks.append(block);
+    }
+    return blocks;
+}
+
+QByteArray ModbusRegisterMap::readRequest(const ModbusReadBlock &block) {
+    QByteArray pdu(5, Qt::Uninitialized);
+    pdu[0] = char(functionCode(block.table));
+    qToBigEndian<quint16>(block.start, pdu.data() + 1);
+    qToBigEndian<quint16>(block.count, pdu.data() + 3);
+    return pdu;
+}
+
+bool ModbusRegisterMap::checkReadResponse(const char *pdu, qsizetype size,
+                                          const ModbusReadBlock &block, QString *error) {
+    if (size < 2) {
+        setError(error, "Слишком короткий ответ.");
+        return false;
+    }
+
+    const quint8 function = quint8(pdu[0]);
+    if (function & Modbus::EXCEPTION_FLAG) {
+        setError(error, QString("Исключение Modbus %1 при чтении %2 регистров с адреса %3.")
+                            .arg(quint8(pdu[1])).arg(block.count).arg(block.start));
+        return false;
+    }
+    if (function != functionCode(block.table)) {
+        setError(error, QString("Неожиданный код функции %1 в ответе.").arg(function));
+        return false;
+    }
+    if (quint8(pdu[1]) != block.count * 2 || size < responseSize(block)) {
+        setError(error, QString("Ответ содержит %1 байт вместо %2.").arg(quint8(pdu[1])).arg(block.count * 2));
+        return false;
+    }
+    return true;
+}
+
+void ModbusRegisterMap::decode(const ModbusDeviceConfig &config, const ModbusReadBlock &block,
+                               const char *pdu, QJsonObject &values) {
+    const char *data = pdu + 2;
+    for (int index : block.registers) {
+        const ModbusRegister &reg = config.registers.at(index);
+        const char *word = data + (reg.address - block.start) * 2;
+        const quint16 first = qFromBigEndian<quint16>(word);
+
+        double value = 0.0;
+        switch (reg.type) {
+        case ModbusRegister::Type::UInt16:
+            value = first;
+            break;
+        case ModbusRegister::Type::Int16:
+            value = qint16(first);
+            break;
+        default: {
+            const quint16 second = qFromBigEndian<quint16>(word + 2);
+            const quint32 raw = reg.swapWords ? (quint32(second) << 16 | first)
+                                              : (quint32(first) << 16 | second);
+            if (reg.type == ModbusRegister::Type::UInt32) {
+                value = raw;
+            } else if (reg.type == ModbusRegister::Type::Int32) {
+                value = qint32(raw);
+            } else {
+                float real;
+                std::memcpy(&real, &raw, sizeof(real));
+                value = real;
+            }
+            break;
+        }
+        }
+        values.insert(reg.name, value * reg.scale);
+    }
+}
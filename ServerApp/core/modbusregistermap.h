@@ -0,0 +1,148 @@
+/**
+ * @file modbusregistermap.h
+ * @brief Определяет карту регистров Modbus-устройства, объединение диапазонов и разбор ответов.
+ */
+#ifndef MODBUSREGISTERMAP_H
+#define MODBUSREGISTERMAP_H
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+/**
+ * @namespace Modbus
+ * @brief Константы протокола Modbus, общие для TCP и RTU.
+ */
+namespace Modbus {
+constexpr quint8 READ_HOLDING_REGISTERS = 0x03;  ///< Чтение регистров хранения
+constexpr quint8 READ_INPUT_REGISTERS   = 0x04;  ///< Чтение входных регистров
+constexpr quint8 EXCEPTION_FLAG         = 0x80;  ///< Признак ответа-исключения в коде функции
+constexpr int MAX_READ_REGISTERS        = 125;   ///< Максимум регистров в одном запросе чтения
+constexpr quint16 DEFAULT_TCP_PORT      = 502;   ///< Стандартный порт Modbus TCP
+} // namespace Modbus
+
+/**
+ * @struct ModbusRegister
+ * @brief Одно значение, читаемое с устройства.
+ */
+struct ModbusRegister {
+    /**
+     * @enum Table
+     * @brief Таблица регистров.
+     */
+    enum class Table { Holding, Input };
+    /**
+     * @enum Type
+     * @brief Тип значения; 32-битные значения занимают два регистра.
+     */
+    enum class Type { UInt16, Int16, UInt32, Int32, Float32 };
+
+    QString name;                   ///< Имя значения в телеметрии
+    Table table = Table::Holding;   ///< Таблица регистров
+    quint16 address = 0;            ///< Адрес первого регистра
+    Type type = Type::UInt16;       ///< Тип значения
+    double scale = 1.0;             ///< Множитель для сырого значения
+    bool swapWords = false;         ///< Младшее слово 32-битного значения идет первым
+
+    /**
+     * @brief Возвращает количество регистров, занимаемых значением.
+     */
+    int width() const { return (type == Type::UInt16 || type == Type::Int16) ? 1 : 2; }
+};
+
+/**
+ * @struct ModbusReadBlock
+ * @brief Непрерывный диапазон регистров, читаемый одним запросом.
+ */
+struct ModbusReadBlock {
+    ModbusRegister::Table table = ModbusRegister::Table::Holding; ///< Таблица регистров
+    quint16 start = 0;              ///< Адрес первого регистра
+    quint16 count = 0;              ///< Количество регистров
+    QList<int> registers;           ///< Индексы значений карты, попадающих в диапазон
+};
+
+/**
+ * @struct ModbusDeviceConfig
+ * @brief Параметры опроса одного устройства, общие для TCP и RTU.
+ */
+struct ModbusDeviceConfig {
+    QString id;                     ///< ID устройства (используется как ID клиента)
+    quint8 unitId = 1;              ///< Адрес устройства (Unit ID / Slave ID)
+    int pollIntervalMs = 100;       ///< Период опроса (мс)
+    int maxGap = 8;                 ///< Допустимый разрыв между объединяемыми диапазонами (в регистрах)
+    QList<ModbusRegister> registers; ///< Карта регистров
+    QList<ModbusReadBlock> blocks;  ///< Запросы чтения, построенные по карте
+};
+
+/**
+ * @class ModbusRegisterMap
+ * @brief Загрузка карт регистров и кодирование/разбор PDU чтения регистров.
+ *
+ * Карта хранится в JSON-файле: секция с массивом устройств, у каждого —
+ * параметры опроса и массив регистров вида
+ * {"name": "temp", "table": "holding", "address": 100, "type": "int16", "scale": 0.1}.
+ * Соседние регистры одной таблицы объединяются в блоки до MAX_READ_REGISTERS
+ * регистров, если разрыв между ними не больше maxGap: лишние регистры в
+ * разрыве дешевле отдельного запроса.
+ */
+class ModbusRegisterMap {
+public:
+    /**
+     * @brief Читает массив устройств из секции JSON-файла.
+     * @param path Путь к файлу.
+     * @param section Имя секции ("tcp", "rtu").
+     * @param devices Выходной массив описаний устройств.
+     * @param error Текст ошибки (если не nullptr).
+     * @return true, если файл прочитан и секция найдена.
+     */
+    static bool loadSection(const QString &path, const QString &section,
+                            QJsonArray &devices, QString *error = nullptr);
+    /**
+     * @brief Разбирает общие параметры устройства и строит блоки чтения.
+     * @param json Описание устройства.
+     * @param config Выходные параметры.
+     * @param error Текст ошибки (если не nullptr).
+     * @return true, если описание корректно.
+     */
+    static bool parseDevice(const QJsonObject &json, ModbusDeviceConfig &config,
+                            QString *error = nullptr);
+    /**
+     * @brief Объединяет регистры карты в блоки чтения.
+     * @param registers Карта регистров.
+     * @param maxGap Допустимый разрыв между объединяемыми диапазонами.
+     * @return Блоки, упорядоченные по таблице и адресу.
+     */
+    static QList<ModbusReadBlock> buildBlocks(const QList<ModbusRegister> &registers, int maxGap);
+
+    /**
+     * @brief Формирует PDU запроса чтения блока.
+     */
+    static QByteArray readRequest(const ModbusReadBlock &block);
+    /**
+     * @brief Проверяет PDU ответа на чтение блока.
+     * @param pdu Указатель на PDU (код функции и данные).
+     * @param size Размер PDU.
+     * @param block Запрошенный блок.
+     * @param error Текст ошибки, в том числе код исключения (если не nullptr).
+     * @return true, если ответ содержит значения всех регистров блока.
+     */
+    static bool checkReadResponse(const char *pdu, qsizetype size, const ModbusReadBlock &block,
+                                  QString *error = nullptr);
+    /**
+     * @brief Декодирует значения блока из проверенного PDU ответа.
+     * @param config Устройство.
+     * @param block Блок.
+     * @param pdu Указатель на PDU ответа.
+     * @param values Объект, в который добавляются значения по именам.
+     */
+    static void decode(const ModbusDeviceConfig &config, const ModbusReadBlock &block,
+                       const char *pdu, QJsonObject &values);
+    /**
+     * @brief Возвращает количество байт PDU ответа на чтение блока.
+     */
+    static qsizetype responseSize(const ModbusReadBlock &block) { return 2 + block.count * 2; }
+};
+
+#endif // MODBUSREGISTERMAP_H
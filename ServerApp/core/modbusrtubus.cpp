@@ -0,0 +1,327 @@
+#include "modbusrtubus.h"
+#include "../common/monotonicclock.h"
+#include "core/logger.h"
+
+#include <QtEndian>
+
+#include <algorithm>
+
+namespace {
+
+void setError(QString *error, const QString &message) {
+    if (error)
+        *error = message;
+}
+
+/// @brief Переводит наносекунды в миллисекунды таймера с округлением вверх.
+int toTimerMs(qint64 ns) {
+    return int(qMax<qint64>(0, (ns + 999999) / 1000000));
+}
+
+} // namespace
+
+ModbusRtuBus::ModbusRtuBus(const Settings &settings, QObject *parent)
+    : QObject(parent), m_settings(settings), m_port(new QSerialPort(this)),
+    m_responseTimer(new QTimer(this)), m_gapTimer(new QTimer(this)),
+    m_pollTimer(new QTimer(this)), m_statsTimer(new QTimer(this)) {
+    // Символ: старт, данные, четность, стоп (полтора стоповых бита считаются за два)
+    const int parityBits = m_settings.parity == QSerialPort::NoParity ? 0 : 1;
+    const int stopBits = m_settings.stopBits == QSerialPort::OneStop ? 1 : 2;
+    const int bitsPerChar = 1 + int(m_settings.dataBits) + parityBits + stopBits;
+    m_charTimeNs = qint64(bitsPerChar) * 1000000000 / m_settings.baudRate;
+    m_interFrameNs = m_settings.baudRate > FIXED_GAP_BAUD_RATE ? FIXED_GAP_NS
+                                                               : m_charTimeNs * 7 / 2;
+
+    m_responseTimer->setSingleShot(true);
+    m_responseTimer->setTimerType(Qt::PreciseTimer);
+    m_gapTimer->setSingleShot(true);
+    m_gapTimer->setTimerType(Qt::PreciseTimer);
+    m_pollTimer->setSingleShot(true);
+    m_pollTimer->setTimerType(Qt::PreciseTimer);
+    m_statsTimer->setInterval(STATS_INTERVAL_MS);
+
+    connect(m_port, &QSerialPort::readyRead, this, &ModbusRtuBus::handleReadyRead);
+    connect(m_port, &QSerialPort::errorOccurred, this, [this](QSerialPort::SerialPortError error) {
+        if (error == QSerialPort::NoError)
+            return;
+        LOG_SAMPLED(AppEnums::LogLevel::Warning, AppEnums::LogCategory::Network, 50,
+                    QString("Шина %1: %2").arg(m_settings.portName, m_port->errorString()));
+    });
+    connect(m_responseTimer, &QTimer::timeout, this, &ModbusRtuBus::handleResponseTimeout);
+    connect(m_gapTimer, &QTimer::timeout, this, &ModbusRtuBus::sendNext);
+    connect(m_pollTimer, &QTimer::timeout, this, &ModbusRtuBus::pollDueDevices);
+    connect(m_statsTimer, &QTimer::timeout, this, &ModbusRtuBus::reportStats);
+}
+
+bool ModbusRtuBus::parseSettings(const QJsonObject &json, Settings &settings, QString *error) {
+    settings.portName = json.value("port").toString();
+    if (settings.portName.isEmpty()) {
+        setError(error, "Не задан последовательный порт.");
+        return false;
+    }
+
+    settings.baudRate = json.value("baudRate").toInt(settings.baudRate);
+    if (settings.baudRate <= 0) {
+        setError(error, QString("Некорректная скорость %1.").arg(settings.baudRate));
+        return false;
+    }
+
+    const int dataBits = json.value("dataBits").toInt(8);
+    if (dataBits < 5 || dataBits > 8) {
+        setError(error, QString("Некорректное количество бит данных %1.").arg(dataBits));
+        return false;
+    }
+    settings.dataBits = QSerialPort::DataBits(dataBits);
+
+    const QString parity = json.value("parity").toString("even");
+    if (parity == "none") {
+        settings.parity = QSerialPort::NoParity;
+    } else if (parity == "even") {
+        settings.parity = QSerialPort::EvenParity;
+    } else if (parity == "odd") {
+        settings.parity = QSerialPort::OddParity;
+    } else {
+        setError(error, QString("Неизвестная четность \"%1\".").arg(parity));
+        return false;
+    }
+
+    const int stopBits = json.value("stopBits").toInt(1);
+    if (stopBits != 1 && stopBits != 2) {
+        setError(error, QString("Некорректное количество стоповых бит %1.").arg(stopBits));
+        return false;
+    }
+    settings.stopBits = stopBits == 1 ? QSerialPort::OneStop : QSerialPort::TwoStop;
+
+    settings.responseTimeoutMs = qMax(1, json.value("responseTimeoutMs").toInt(settings.responseTimeoutMs));
+    return true;
+}
+
+quint16 ModbusRtuBus::crc16(const char *data, qsizetype size) {
+    quint16 crc = 0xFFFF;
+    for (qsizetype i = 0; i < size; ++i) {
+        crc ^= quint8(data[i]);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? quint16((crc >> 1) ^ 0xA001) : quint16(crc >> 1);
+        }
+    }
+    return crc;
+}
+
+void ModbusRtuBus::addDevice(ModbusRtuDevice *device) {
+    m_slaves.append(Slave{device, 0});
+}
+
+bool ModbusRtuBus::start(QString *error) {
+    m_port->setPortName(m_settings.portName);
+    m_port->setBaudRate(m_settings.baudRate);
+    m_port->setDataBits(m_settings.dataBits);
+    m_port->setParity(m_settings.parity);
+    m_port->setStopBits(m_settings.stopBits);
+    m_port->setFlowControl(QSerialPort::NoFlowControl);
+    if (!m_port->open(QIODevice::ReadWrite)) {
+        setError(error, m_port->errorString());
+        return false;
+    }
+
+    const qint64 nowNs = MonotonicClock::nowNs();
+    m_startedAtNs = nowNs;
+    m_statsStartNs = nowNs;
+    // Первый запрос уходит не раньше t3.5 после открытия порта
+    m_lastFrameEndNs = nowNs;
+    for (Slave &slave : m_slaves) {
+        slave.nextPollNs = nowNs;
+    }
+
+    m_statsTimer->start();
+    pollDueDevices();
+    return true;
+}
+
+void ModbusRtuBus::stop() {
+    m_responseTimer->stop();
+    m_gapTimer->stop();
+    m_pollTimer->stop();
+    m_statsTimer->stop();
+
+    if (m_port->isOpen()) {
+        const double busLoad = utilization();
+        m_port->close();
+        LOG_INFO(AppEnums::LogCategory::Network,
+                 QString("Шина %1 закрыта: средняя загрузка %2%.")
+                     .arg(m_settings.portName)
+                     .arg(100.0 * busLoad, 0, 'f', 1));
+    }
+
+    m_queue.clear();
+    m_slaves.clear();
+    m_current = Request();
+    m_awaitingResponse = false;
+    m_readBuffer.clear();
+}
+
+double ModbusRtuBus::utilization() const {
+    if (!m_port->isOpen())
+        return 0.0;
+    const qint64 elapsedNs = MonotonicClock::nowNs() - m_startedAtNs;
+    return elapsedNs > 0 ? double(m_totalBusyNs) / elapsedNs : 0.0;
+}
+
+void ModbusRtuBus::pollDueDevices() {
+    const qint64 nowNs = MonotonicClock::nowNs();
+    for (Slave &slave : m_slaves) {
+        if (slave.nextPollNs > nowNs)
+            continue;
+
+        const qint64 intervalNs = qint64(slave.device->config().pollIntervalMs) * 1000000;
+        slave.nextPollNs += intervalNs;
+        // Шина не успевает за периодом опроса: пропущенные сроки не наверстываются
+        if (slave.nextPollNs <= nowNs)
+            slave.nextPollNs = nowNs + intervalNs;
+
+        if (!slave.device->beginCycle())
+            continue;
+        const int blockCount = int(slave.device->config().blocks.size());
+        for (int block = 0; block < blockCount; ++block) {
+            m_queue.append(Request{slave.device, block});
+        }
+    }
+    sendNext();
+}
+
+void ModbusRtuBus::scheduleNextPoll() {
+    if (m_slaves.isEmpty())
+        return;
+
+    const auto next = std::min_element(m_slaves.cbegin(), m_slaves.cend(),
+                                       [](const Slave &a, const Slave &b) {
+                                           return a.nextPollNs < b.nextPollNs;
+                                       });
+    m_pollTimer->start(toTimerMs(next->nextPollNs - MonotonicClock::nowNs()));
+}
+
+void ModbusRtuBus::sendNext() {
+    if (m_awaitingResponse || !m_port->isOpen())
+        return;
+    if (m_queue.isEmpty()) {
+        scheduleNextPoll();
+        return;
+    }
+
+    // Ведомое устройство распознает конец кадра по паузе t3.5
+    const qint64 nowNs = MonotonicClock::nowNs();
+    const qint64 gapLeftNs = m_lastFrameEndNs + m_interFrameNs - nowNs;
+    if (gapLeftNs > 0) {
+        m_gapTimer->start(toTimerMs(gapLeftNs));
+        return;
+    }
+
+    m_current = m_queue.takeFirst();
+    const ModbusReadBlock &block = m_current.device->config().blocks.at(m_current.block);
+
+    QByteArray frame;
+    const QByteArray pdu = ModbusRegisterMap::readRequest(block);
+    frame.reserve(pdu.size() + 3);
+    frame.append(char(m_current.device->config().unitId));
+    frame.append(pdu);
+    char crc[2];
+    qToLittleEndian<quint16>(crc16(frame.constData(), frame.size()), crc);
+    frame.append(crc, 2);
+    m_port->write(frame);
+
+    m_readBuffer.clear();
+    m_awaitingResponse = true;
+    m_requestStartNs = nowNs;
+    ++m_requests;
+
+    // Адрес, PDU и CRC ответа передаются с той же скоростью, что и запрос
+    const qsizetype responseBytes = 1 + ModbusRegisterMap::responseSize(block) + 2;
+    const qint64 timeoutNs = transmitNs(frame.size() + responseBytes) +
+                             qint64(m_settings.responseTimeoutMs) * 1000000;
+    m_responseTimer->start(toTimerMs(timeoutNs));
+}
+
+qsizetype ModbusRtuBus::expectedResponseSize() const {
+    if (m_readBuffer.size() < 2)
+        return 0;
+    // Исключение: адрес, функция, код исключения, CRC
+    if (quint8(m_readBuffer.at(1)) & Modbus::EXCEPTION_FLAG)
+        return 5;
+    if (m_readBuffer.size() < 3)
+        return 0;
+    // Чтение регистров: адрес, функция, счетчик байт, данные, CRC
+    return 5 + quint8(m_readBuffer.at(2));
+}
+
+void ModbusRtuBus::handleReadyRead() {
+    const QByteArray data = m_port->readAll();
+    const qint64 nowNs = MonotonicClock::nowNs();
+    if (!m_awaitingResponse) {
+        // Запоздавший ответ: отбрасывается, но пауза отсчитывается от него
+        m_lastFrameEndNs = nowNs;
+        return;
+    }
+
+    m_readBuffer.append(data);
+    const qsizetype frameSize = expectedResponseSize();
+    if (frameSize == 0 || m_readBuffer.size() < frameSize)
+        return;
+
+    m_responseTimer->stop();
+    const Request request = m_current;
+    finishRequest(nowNs);
+
+    const char *frame = m_readBuffer.constData();
+    if (crc16(frame, frameSize - 2) != qFromLittleEndian<quint16>(frame + frameSize - 2)) {
+        request.device->handleFailure("Ошибка CRC в ответе.", nowNs);
+    } else if (quint8(frame[0]) != request.device->config().unitId) {
+        request.device->handleFailure(QString("Ответ от устройства %1 вместо ожидаемого.")
+                                          .arg(quint8(frame[0])), nowNs);
+    } else {
+        request.device->handleResponse(request.block, frame + 1, frameSize - 3, nowNs);
+    }
+    m_readBuffer.clear();
+
+    sendNext();
+}
+
+void ModbusRtuBus::handleResponseTimeout() {
+    const qint64 nowNs = MonotonicClock::nowNs();
+    const Request request = m_current;
+    finishRequest(nowNs);
+    ++m_timeouts;
+    m_readBuffer.clear();
+
+    request.device->handleFailure("Таймаут ответа устройства.", nowNs);
+    // Остальные запросы цикла к молчащему устройству тоже истекли бы по таймауту
+    const auto removed = m_queue.removeIf([&request](const Request &queued) {
+        return queued.device == request.device;
+    });
+    if (removed > 0)
+        request.device->abortCycle();
+
+    sendNext();
+}
+
+void ModbusRtuBus::finishRequest(qint64 nowNs) {
+    m_awaitingResponse = false;
+    const qint64 busyNs = nowNs - m_requestStartNs;
+    m_busyNs += busyNs;
+    m_totalBusyNs += busyNs;
+    m_lastFrameEndNs = nowNs;
+}
+
+void ModbusRtuBus::reportStats() {
+    const qint64 nowNs = MonotonicClock::nowNs();
+    const qint64 elapsedNs = nowNs - m_statsStartNs;
+    LOG_INFO(AppEnums::LogCategory::Network,
+             QString("Шина %1: загрузка %2%, запросов %3, без ответа %4.")
+                 .arg(m_settings.portName)
+                 .arg(elapsedNs > 0 ? 100.0 * m_busyNs / elapsedNs : 0.0, 0, 'f', 1)
+                 .arg(m_requests)
+                 .arg(m_timeouts));
+
+    m_statsStartNs = nowNs;
+    m_busyNs = 0;
+    m_requests = 0;
+    m_timeouts = 0;
+}
@@ -0,0 +1,211 @@
+/**
+ * @file modbusrtubus.h
+ * @brief Определяет класс ModbusRtuBus — ведущее устройство шины Modbus RTU на последовательном порту.
+ */
+#ifndef MODBUSRTUBUS_H
+#define MODBUSRTUBUS_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QSerialPort>
+#include <QTimer>
+
+#include "core/modbusrtudevice.h"
+
+/**
+ * @class ModbusRtuBus
+ * @brief Опрос ведомых устройств одной шины RTU с учетом времени передачи кадров.
+ *
+ * На шине в каждый момент выполняется один запрос. Время символа вычисляется
+ * из скорости и формата (старт, данные, четность, стоп), межкадровая пауза
+ * t3.5 — 3.5 символа (1.75 мс при скорости выше 19200 бод, как требует
+ * спецификация). Конец ответа определяется по его длине из поля счетчика
+ * байт, а не по паузе, поэтому следующий запрос уходит сразу после t3.5.
+ * Таймаут ответа — время передачи запроса и ожидаемого ответа плюс
+ * responseTimeoutMs на обработку в устройстве.
+ *
+ * Когда шина свободна, запросы всех блоков всех устройств, у которых подошел
+ * срок опроса, ставятся в очередь и выполняются подряд. Если устройство не
+ * ответило, остальные его запросы в этом цикле снимаются, чтобы не занимать
+ * шину таймаутами. Загрузка шины (доля времени от начала запроса до конца
+ * ответа) записывается в журнал каждые STATS_INTERVAL_MS и при остановке.
+ */
+class ModbusRtuBus : public QObject {
+    Q_OBJECT
+
+public:
+    /// @brief Интервал записи статистики шины в журнал (мс).
+    static constexpr int STATS_INTERVAL_MS = 10000;
+    /// @brief Скорость, начиная с которой пауза t3.5 фиксирована.
+    static constexpr qint32 FIXED_GAP_BAUD_RATE = 19200;
+    /// @brief Фиксированная пауза t3.5 для высоких скоростей (нс).
+    static constexpr qint64 FIXED_GAP_NS = 1750000;
+
+    /**
+     * @struct Settings
+     * @brief Параметры последовательного порта шины.
+     */
+    struct Settings {
+        QString portName;                                       ///< Имя порта или путь к устройству (pty)
+        qint32 baudRate = 19200;                                ///< Скорость (бод)
+        QSerialPort::DataBits dataBits = QSerialPort::Data8;    ///< Биты данных
+        QSerialPort::Parity parity = QSerialPort::EvenParity;   ///< Четность
+        QSerialPort::StopBits stopBits = QSerialPort::OneStop;  ///< Стоповые биты
+        int responseTimeoutMs = 100;                            ///< Время обработки запроса устройством (мс)
+    };
+
+    /**
+     * @brief Конструктор класса ModbusRtuBus.
+     * @param settings Параметры порта.
+     * @param parent Родительский объект QObject.
+     */
+    explicit ModbusRtuBus(const Settings &settings, QObject *parent = nullptr);
+
+    /**
+     * @brief Разбирает параметры порта из описания шины в карте регистров.
+     * @param json Описание шины.
+     * @param settings Выходные параметры.
+     * @param error Текст ошибки (если не nullptr).
+     * @return true, если описание корректно.
+     */
+    static bool parseSettings(const QJsonObject &json, Settings &settings, QString *error = nullptr);
+    /**
+     * @brief Вычисляет CRC-16 Modbus.
+     */
+    static quint16 crc16(const char *data, qsizetype size);
+
+    /**
+     * @brief Возвращает параметры порта.
+     */
+    const Settings &settings() const { return m_settings; }
+    /**
+     * @brief Возвращает время передачи одного символа (нс).
+     */
+    qint64 charTimeNs() const { return m_charTimeNs; }
+    /**
+     * @brief Возвращает межкадровую паузу t3.5 (нс).
+     */
+    qint64 interFrameNs() const { return m_interFrameNs; }
+    /**
+     * @brief Возвращает загрузку шины с момента запуска (доля времени, 0 — опрос не запущен).
+     */
+    double utilization() const;
+
+    /**
+     * @brief Добавляет устройство на шину (до вызова start()).
+     */
+    void addDevice(ModbusRtuDevice *device);
+    /**
+     * @brief Открывает порт и начинает опрос.
+     * @param error Текст ошибки (если не nullptr).
+     * @return true, если порт открыт.
+     */
+    bool start(QString *error = nullptr);
+    /**
+     * @brief Прекращает опрос, закрывает порт и забывает устройства.
+     */
+    void stop();
+
+private slots:
+    /**
+     * @brief Накапливает ответ и обрабатывает его, когда получен весь кадр.
+     */
+    void handleReadyRead();
+    /**
+     * @brief Учитывает запрос без ответа и переходит к следующему.
+     */
+    void handleResponseTimeout();
+    /**
+     * @brief Ставит в очередь запросы устройств, у которых подошел срок опроса.
+     */
+    void pollDueDevices();
+    /**
+     * @brief Записывает статистику шины за прошедший интервал.
+     */
+    void reportStats();
+
+private:
+    /**
+     * @struct Slave
+     * @brief Устройство шины и срок его следующего опроса.
+     */
+    struct Slave {
+        ModbusRtuDevice *device = nullptr;  ///< Устройство
+        qint64 nextPollNs = 0;              ///< Время следующего цикла (MonotonicClock)
+    };
+    /**
+     * @struct Request
+     * @brief Запрос чтения блока.
+     */
+    struct Request {
+        ModbusRtuDevice *device = nullptr;  ///< Устройство
+        int block = 0;                      ///< Индекс блока в карте устройства
+    };
+
+    /**
+     * @brief Отправляет следующий запрос очереди, выдержав паузу t3.5; при пустой очереди планирует опрос.
+     */
+    void sendNext();
+    /**
+     * @brief Запускает таймер до ближайшего срока опроса.
+     */
+    void scheduleNextPoll();
+    /**
+     * @brief Завершает текущий запрос и учитывает время занятости шины.
+     */
+    void finishRequest(qint64 nowNs);
+    /**
+     * @brief Возвращает время передачи заданного числа символов (нс).
+     */
+    qint64 transmitNs(qsizetype bytes) const { return bytes * m_charTimeNs; }
+    /**
+     * @brief Возвращает ожидаемую длину ответа по принятому началу кадра или 0, если данных мало.
+     */
+    qsizetype expectedResponseSize() const;
+
+    /// @brief Параметры порта.
+    Settings m_settings;
+    /// @brief Время передачи одного символа (нс).
+    qint64 m_charTimeNs = 0;
+    /// @brief Межкадровая пауза t3.5 (нс).
+    qint64 m_interFrameNs = 0;
+
+    QSerialPort *m_port;
+    QTimer *m_responseTimer;
+    QTimer *m_gapTimer;
+    QTimer *m_pollTimer;
+    QTimer *m_statsTimer;
+
+    /// @brief Устройства шины.
+    QList<Slave> m_slaves;
+    /// @brief Запросы, ожидающие отправки.
+    QList<Request> m_queue;
+    /// @brief Выполняемый запрос.
+    Request m_current;
+    /// @brief Ожидается ответ на m_current.
+    bool m_awaitingResponse = false;
+    /// @brief Принятая часть ответа.
+    QByteArray m_readBuffer;
+
+    /// @brief Время начала передачи текущего запроса.
+    qint64 m_requestStartNs = 0;
+    /// @brief Время последней активности на шине (конец ответа или таймаут).
+    qint64 m_lastFrameEndNs = 0;
+
+    /// @brief Начало интервала статистики.
+    qint64 m_statsStartNs = 0;
+    /// @brief Занятость шины за интервал статистики (нс).
+    qint64 m_busyNs = 0;
+    /// @brief Количество запросов за интервал статистики.
+    quint64 m_requests = 0;
+    /// @brief Количество запросов без ответа за интервал статистики.
+    quint64 m_timeouts = 0;
+    /// @brief Занятость шины с момента запуска (нс).
+    qint64 m_totalBusyNs = 0;
+    /// @brief Время запуска опроса.
+    qint64 m_startedAtNs = 0;
+};
+
+#endif // MODBUSRTUBUS_H
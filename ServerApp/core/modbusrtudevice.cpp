@@ -0,0 +1,40 @@
+#include "modbusrtudevice.h"
+
+ModbusRtuDevice::ModbusRtuDevice(const ModbusDeviceConfig &config, const QString &portName,
+                                 QObject *parent)
+    : ModbusDevice(config, parent), m_portName(portName) {}
+
+void ModbusRtuDevice::connectToHost(const QString &host, quint16 port) {
+    Q_UNUSED(host)
+    Q_UNUSED(port)
+}
+
+void ModbusRtuDevice::disconnect() {
+    m_consecutiveFailures = 0;
+    handleDisconnected();
+}
+
+void ModbusRtuDevice::handleResponse(int block, const char *pdu, qsizetype size,
+                                     qint64 receivedAtNs) {
+    m_consecutiveFailures = 0;
+    // Регистрация должна прийти в DataProcessing раньше значений
+    if (!isConnected())
+        handleConnected();
+    completeBlock(block, pdu, size, receivedAtNs);
+}
+
+void ModbusRtuDevice::handleFailure(const QString &error, qint64 receivedAtNs) {
+    failBlock(error, receivedAtNs);
+    if (++m_consecutiveFailures >= MAX_CONSECUTIVE_FAILURES && isConnected())
+        handleDisconnected();
+}
+
+void ModbusRtuDevice::handleConnected() {
+    announceConnected();
+}
+
+void ModbusRtuDevice::handleDisconnected() {
+    announceDisconnected();
+}
+
+void ModbusRtuDevice::handleReadyRead() {}
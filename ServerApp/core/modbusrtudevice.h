@@ -0,0 +1,89 @@
+/**
+ * @file modbusrtudevice.h
+ * @brief Определяет класс ModbusRtuDevice — ведомое устройство на шине Modbus RTU.
+ */
+#ifndef MODBUSRTUDEVICE_H
+#define MODBUSRTUDEVICE_H
+
+#include "core/modbusdevice.h"
+
+/**
+ * @class ModbusRtuDevice
+ * @brief Устройство, опрашиваемое по Modbus RTU через ModbusRtuBus.
+ *
+ * Собственного канала у устройства нет: запросы отправляет шина, которой
+ * принадлежит последовательный порт. Устройство считается подключенным после
+ * первого ответа и отключенным после MAX_CONSECUTIVE_FAILURES подряд
+ * запросов без ответа; опрос отключенного устройства продолжается.
+ */
+class ModbusRtuDevice : public ModbusDevice {
+    Q_OBJECT
+
+public:
+    /// @brief Количество запросов подряд без ответа, после которого устройство считается отключенным.
+    static constexpr int MAX_CONSECUTIVE_FAILURES = 5;
+
+    /**
+     * @brief Конструктор класса ModbusRtuDevice.
+     * @param config Параметры опроса и карта регистров.
+     * @param portName Имя последовательного порта шины.
+     * @param parent Родительский объект QObject.
+     */
+    ModbusRtuDevice(const ModbusDeviceConfig &config, const QString &portName,
+                    QObject *parent = nullptr);
+
+    /**
+     * @brief Возвращает имя последовательного порта шины.
+     */
+    QString address() const override { return m_portName; }
+    /**
+     * @brief Возвращает адрес устройства на шине (Slave ID).
+     */
+    quint16 port() const override { return m_config.unitId; }
+
+    /**
+     * @brief Не используется: устройство опрашивается шиной.
+     */
+    void connectToHost(const QString &host, quint16 port) override;
+    /**
+     * @brief Прерывает текущий цикл и помечает устройство отключенным.
+     */
+    void disconnect() override;
+
+    /**
+     * @brief Обрабатывает ответ устройства на запрос блока.
+     * @param block Индекс блока.
+     * @param pdu Указатель на PDU ответа.
+     * @param size Размер PDU.
+     * @param receivedAtNs Время получения ответа.
+     */
+    void handleResponse(int block, const char *pdu, qsizetype size, qint64 receivedAtNs);
+    /**
+     * @brief Учитывает запрос без корректного ответа (таймаут, ошибка CRC).
+     * @param error Описание ошибки.
+     * @param receivedAtNs Время обнаружения ошибки.
+     */
+    void handleFailure(const QString &error, qint64 receivedAtNs);
+
+private slots:
+    /**
+     * @brief Регистрирует устройство после первого ответа.
+     */
+    void handleConnected() override;
+    /**
+     * @brief Помечает устройство отключенным.
+     */
+    void handleDisconnected() override;
+    /**
+     * @brief Не используется: ответы читает шина.
+     */
+    void handleReadyRead() override;
+
+private:
+    /// @brief Имя последовательного порта шины.
+    QString m_portName;
+    /// @brief Количество запросов подряд без ответа.
+    int m_consecutiveFailures = 0;
+};
+
+#endif // MODBUSRTUDEVICE_H
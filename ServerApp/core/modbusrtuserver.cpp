@@ -0,0 +1,91 @@
+#include "modbusrtuserver.h"
+#include "core/logger.h"
+
+#include <utility>
+
+ModbusRtuServer::ModbusRtuServer(const ServerSettings &settings, QObject *parent)
+    : ModbusServer("Modbus RTU", parent), m_settings(settings) {}
+
+void ModbusRtuServer::startServer(quint16 port) {
+    Q_UNUSED(port)
+    if (m_running) {
+        LOG_WARNING(AppEnums::LogCategory::Server, "Опрос Modbus RTU уже запущен.");
+        return;
+    }
+
+    QJsonArray buses;
+    QString error;
+    if (!ModbusRegisterMap::loadSection(m_settings.modbusMapPath, "rtu", buses, &error)) {
+        LOG_ERROR(AppEnums::LogCategory::Server, QString("Ошибка запуска Modbus RTU: %1").arg(error));
+        return;
+    }
+
+    int deviceCount = 0;
+    int requestCount = 0;
+    for (const QJsonValue &busValue : std::as_const(buses)) {
+        const QJsonObject busJson = busValue.toObject();
+        ModbusRtuBus::Settings busSettings;
+        if (!ModbusRtuBus::parseSettings(busJson, busSettings, &error)) {
+            LOG_ERROR(AppEnums::LogCategory::Server,
+                      QString("Шина Modbus RTU пропущена: %1").arg(error));
+            continue;
+        }
+
+        auto *bus = new ModbusRtuBus(busSettings, this);
+        QList<ModbusRtuDevice *> busDevices;
+        int busRequestCount = 0;
+        const QJsonArray devices = busJson.value("devices").toArray();
+        for (const QJsonValue &value : devices) {
+            ModbusDeviceConfig config;
+            if (!ModbusRegisterMap::parseDevice(value.toObject(), config, &error)) {
+                LOG_ERROR(AppEnums::LogCategory::Server,
+                          QString("Устройство Modbus RTU на %1 пропущено: %2")
+                              .arg(busSettings.portName, error));
+                continue;
+            }
+            auto *device = new ModbusRtuDevice(config, busSettings.portName, this);
+            bus->addDevice(device);
+            busDevices.append(device);
+            busRequestCount += config.blocks.size();
+        }
+
+        if (!bus->start(&error)) {
+            LOG_ERROR(AppEnums::LogCategory::Server,
+                      QString("Не удалось открыть порт %1: %2").arg(busSettings.portName, error));
+            qDeleteAll(busDevices);
+            delete bus;
+            continue;
+        }
+
+        for (ModbusRtuDevice *device : std::as_const(busDevices)) {
+            addDevice(device);
+        }
+        deviceCount += busDevices.size();
+        requestCount += busRequestCount;
+        m_buses.append(bus);
+    }
+
+    m_running = true;
+    LOG_INFO(AppEnums::LogCategory::Server,
+             QString("Опрос Modbus RTU запущен: шин %1, устройств %2, запросов на цикл %3.")
+                 .arg(m_buses.size())
+                 .arg(deviceCount)
+                 .arg(requestCount));
+}
+
+void ModbusRtuServer::stopServer() {
+    if (!m_running) {
+        LOG_WARNING(AppEnums::LogCategory::Server, "Опрос Modbus RTU уже остановлен.");
+        return;
+    }
+    m_running = false;
+
+    // Шины перестают обращаться к устройствам до их отключения и удаления
+    const QList<ModbusRtuBus *> buses = std::exchange(m_buses, {});
+    for (ModbusRtuBus *bus : buses) {
+        bus->stop();
+        bus->deleteLater();
+    }
+    releaseDevices();
+    LOG_INFO(AppEnums::LogCategory::Server, "Опрос Modbus RTU остановлен.");
+}
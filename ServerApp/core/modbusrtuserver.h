@@ -0,0 +1,53 @@
+/**
+ * @file modbusrtuserver.h
+ * @brief Определяет класс ModbusRtuServer, реализующий IServer для опроса устройств Modbus RTU.
+ */
+#ifndef MODBUSRTUSERVER_H
+#define MODBUSRTUSERVER_H
+
+#include <QList>
+
+#include "core/modbusrtubus.h"
+#include "core/modbusserver.h"
+#include "core/serversettings.h"
+
+/**
+ * @class ModbusRtuServer
+ * @brief Реализация интерфейса IServer, опрашивающая устройства на шинах Modbus RTU.
+ *
+ * При запуске читается секция "rtu" карты регистров (ServerSettings::modbusMapPath):
+ * массив шин, у каждой — параметры последовательного порта и массив устройств.
+ * Для каждой шины создается ModbusRtuBus; шины опрашиваются независимо друг
+ * от друга в потоке сервера. Порт сервера не используется.
+ */
+class ModbusRtuServer : public ModbusServer {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Конструктор класса ModbusRtuServer.
+     * @param settings Параметры сервера (путь к карте регистров).
+     * @param parent Родительский объект QObject.
+     */
+    explicit ModbusRtuServer(const ServerSettings &settings = ServerSettings(),
+                             QObject *parent = nullptr);
+
+public slots:
+    /**
+     * @brief Загружает карту регистров, открывает порты и начинает опрос.
+     * @param port Не используется.
+     */
+    void startServer(quint16 port) override;
+    /**
+     * @brief Прекращает опрос и закрывает порты.
+     */
+    void stopServer() override;
+
+private:
+    /// @brief Параметры сервера.
+    ServerSettings m_settings;
+    /// @brief Открытые шины.
+    QList<ModbusRtuBus *> m_buses;
+};
+
+#endif // MODBUSRTUSERVER_H
@@ -0,0 +1,100 @@
+#include "modbusserver.h"
+#include "core/logger.h"
+
+#include <algorithm>
+#include <utility>
+
+ModbusServer::ModbusServer(const QString &protocolName, QObject *parent)
+    : IServer(parent), m_protocolName(protocolName) {}
+
+int ModbusServer::clientCount() const {
+    return int(std::count_if(m_devices.cbegin(), m_devices.cend(),
+                             [](const ModbusDevice *device) { return device->isConnected(); }));
+}
+
+void ModbusServer::addDevice(ModbusDevice *device) {
+    connect(device, &ModbusDevice::connected, this, &ModbusServer::handleNewConnection);
+    connect(device, &ModbusDevice::disconnected, this, &ModbusServer::handleClientDisconnected);
+    connect(device, &ModbusDevice::dataReceived, this, &ModbusServer::handleDataReceived);
+    connect(device, &ModbusDevice::errorOccurred, this, [device](const QString &message) {
+        LOG_SAMPLED(AppEnums::LogLevel::Warning, AppEnums::LogCategory::Network, 50,
+                    QString("Устройство %1 (%2:%3): %4")
+                        .arg(device->config().id, device->address())
+                        .arg(device->port())
+                        .arg(message));
+    });
+    m_devices.append(device);
+}
+
+void ModbusServer::releaseDevices() {
+    const QList<ModbusDevice *> devices = std::exchange(m_devices, {});
+    for (ModbusDevice *device : devices) {
+        LOG_INFO(AppEnums::LogCategory::Network,
+                 QString("Устройство %1: прочитано регистров %2, ошибок %3, пропущено циклов %4.")
+                     .arg(device->config().id)
+                     .arg(device->registersRead())
+                     .arg(device->droppedMessages())
+                     .arg(device->skippedCycles()));
+        device->disconnect();
+        if (!m_announced.contains(device)) {
+            device->deleteLater();
+        }
+    }
+}
+
+void ModbusServer::handleNewConnection() {
+    auto *device = qobject_cast<ModbusDevice *>(sender());
+    if (!device)
+        return;
+
+    // При переподключении DataProcessing сначала удаляет прежнюю запись через removeClient
+    emit clientConnected(device);
+    m_announced.insert(device);
+    LOG_INFO(AppEnums::LogCategory::Network,
+             QString("Подключено устройство %1 %2 (%3:%4).")
+                 .arg(m_protocolName, device->config().id, device->address())
+                 .arg(device->port()));
+}
+
+void ModbusServer::handleClientDisconnected() {
+    auto *device = qobject_cast<ModbusDevice *>(sender());
+    if (!device) {
+        LOG_WARNING(AppEnums::LogCategory::Network, "Невозможно определить отключившееся устройство.");
+        return;
+    }
+
+    emit clientDisconnected(device);
+    LOG_INFO(AppEnums::LogCategory::Network,
+             QString("Устройство %1 %2 отключено.").arg(m_protocolName, device->config().id));
+}
+
+void ModbusServer::handleDataReceived(const QByteArray &data, qint64 receivedAtNs) {
+    auto *device = qobject_cast<ModbusDevice *>(sender());
+    if (!device) {
+        LOG_WARNING(AppEnums::LogCategory::Network, "Неизвестный отправитель сигнала.");
+        return;
+    }
+
+    emit dataReceived(device, data, receivedAtNs);
+}
+
+void ModbusServer::removeClient(IClient *client) {
+    auto *device = qobject_cast<ModbusDevice *>(client);
+    if (!device)
+        return;
+
+    m_announced.remove(device);
+    // Пока опрос идет, устройство переподключается тем же объектом
+    if (!m_devices.contains(device)) {
+        device->deleteLater();
+    }
+}
+
+void ModbusServer::sendToClient(IClient *client, const QByteArray &data,
+                                const QString &coalesceKey) {
+    Q_UNUSED(data)
+    Q_UNUSED(coalesceKey)
+    LOG_DEBUG(AppEnums::LogCategory::Network,
+              QString("Сообщение для устройства Modbus %1 не отправлено: протокол не поддерживает команды.")
+                  .arg(client ? client->id() : QString()));
+}
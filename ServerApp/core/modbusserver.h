@@ -0,0 +1,97 @@
+/**
+ * @file modbusserver.h
+ * @brief Определяет класс ModbusServer — общую часть серверов, опрашивающих Modbus-устройства.
+ */
+#ifndef MODBUSSERVER_H
+#define MODBUSSERVER_H
+
+#include <QList>
+#include <QObject>
+#include <QSet>
+
+#include "core/iserver.h"
+#include "core/modbusdevice.h"
+
+/**
+ * @class ModbusServer
+ * @brief Базовый класс серверов Modbus TCP и Modbus RTU.
+ *
+ * Порт не прослушивается: наследник при запуске создает устройства по карте
+ * регистров и передает их в addDevice(). Объект устройства живет, пока идет
+ * опрос, и переживает переподключения; DataProcessing видит каждое
+ * подключение как новое (через clientConnected), а removeClient удаляет
+ * объект только после остановки опроса.
+ */
+class ModbusServer : public IServer {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Возвращает количество подключенных устройств.
+     */
+    int clientCount() const override;
+    /**
+     * @brief Проверяет, идет ли опрос.
+     */
+    bool isListening() const override { return m_running; }
+
+public slots:
+    /**
+     * @brief Не используется: сообщения сервера устройствам не передаются.
+     */
+    void sendToClient(IClient *client, const QByteArray &data,
+                      const QString &coalesceKey = QString()) override;
+    /**
+     * @brief Забывает устройство; объект удаляется, только если опрос остановлен.
+     * @param client Указатель на устройство.
+     */
+    void removeClient(IClient *client) override;
+
+protected slots:
+    /**
+     * @brief Сообщает о подключении устройства.
+     */
+    void handleNewConnection() override;
+    /**
+     * @brief Сообщает об отключении устройства.
+     */
+    void handleClientDisconnected() override;
+    /**
+     * @brief Передает сообщение устройства (регистрация или значения регистров).
+     * @param data Данные сообщения.
+     * @param receivedAtNs Время получения ответа устройства.
+     */
+    void handleDataReceived(const QByteArray &data, qint64 receivedAtNs) override;
+
+protected:
+    /**
+     * @brief Конструктор класса ModbusServer.
+     * @param protocolName Название протокола для журнала ("Modbus TCP", "Modbus RTU").
+     * @param parent Родительский объект QObject.
+     */
+    explicit ModbusServer(const QString &protocolName, QObject *parent = nullptr);
+
+    /**
+     * @brief Подключает сигналы устройства и добавляет его в список опрашиваемых.
+     */
+    void addDevice(ModbusDevice *device);
+    /**
+     * @brief Записывает статистику устройств, отключает их и очищает список.
+     *
+     * Устройства, известные DataProcessing, удаляются позже в removeClient.
+     */
+    void releaseDevices();
+
+    /// @brief Название протокола для журнала.
+    QString m_protocolName;
+    /// @brief Признак запущенного опроса.
+    bool m_running = false;
+    /// @brief Опрашиваемые устройства.
+    QList<ModbusDevice *> m_devices;
+
+private:
+    /// @brief Устройства, о которых известно DataProcessing (до вызова removeClient).
+    QSet<ModbusDevice *> m_announced;
+};
+
+#endif // MODBUSSERVER_H
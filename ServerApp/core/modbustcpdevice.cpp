@@ -0,0 +1,157 @@
+#include "modbustcpdevice.h"
+#include "../common/monotonicclock.h"
+
+#include <QtEndian>
+
+ModbusTcpDevice::ModbusTcpDevice(const ModbusDeviceConfig &config, const QString &host,
+                                 quint16 port, int maxPipeline, QObject *parent)
+    : ModbusDevice(config, parent), m_host(host), m_port(port),
+    m_maxPipeline(qMax(1, maxPipeline)), m_socket(new QTcpSocket(this)),
+    m_pollTimer(new QTimer(this)), m_reconnectTimer(new QTimer(this)) {
+    m_pollTimer->setInterval(m_config.pollIntervalMs);
+    m_reconnectTimer->setInterval(RECONNECT_INTERVAL_MS);
+    m_reconnectTimer->setSingleShot(true);
+
+    // Запросы небольшие и уходят пачкой, задержка Нейгла только мешает
+    m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+    connect(m_socket, &QTcpSocket::connected, this, &ModbusTcpDevice::handleConnected);
+    connect(m_socket, &QTcpSocket::disconnected, this, &ModbusTcpDevice::handleDisconnected);
+    connect(m_socket, &QTcpSocket::readyRead, this, &ModbusTcpDevice::handleReadyRead);
+    connect(m_socket, &QTcpSocket::errorOccurred, this, &ModbusTcpDevice::handleError);
+    connect(m_pollTimer, &QTimer::timeout, this, &ModbusTcpDevice::poll);
+    connect(m_reconnectTimer, &QTimer::timeout, this, &ModbusTcpDevice::start);
+}
+
+void ModbusTcpDevice::connectToHost(const QString &host, quint16 port) {
+    m_host = host;
+    m_port = port;
+    start();
+}
+
+void ModbusTcpDevice::start() {
+    m_running = true;
+    if (m_socket->state() == QAbstractSocket::UnconnectedState) {
+        m_socket->connectToHost(m_host, m_port);
+    }
+}
+
+void ModbusTcpDevice::disconnect() {
+    m_running = false;
+    m_reconnectTimer->stop();
+    m_pollTimer->stop();
+    m_socket->abort();
+}
+
+void ModbusTcpDevice::handleConnected() {
+    m_readBuffer.clear();
+    announceConnected();
+
+    m_pollTimer->start();
+    poll();
+}
+
+void ModbusTcpDevice::handleDisconnected() {
+    m_pollTimer->stop();
+    m_inFlight.clear();
+    m_readBuffer.clear();
+    announceDisconnected();
+
+    if (m_running)
+        m_reconnectTimer->start();
+}
+
+void ModbusTcpDevice::handleError(QAbstractSocket::SocketError socketError) {
+    Q_UNUSED(socketError)
+    emit errorOccurred(m_socket->errorString());
+
+    // Неудачное подключение не сопровождается сигналом disconnected
+    if (!isConnected() && m_running && m_socket->state() == QAbstractSocket::UnconnectedState) {
+        m_reconnectTimer->start();
+    }
+}
+
+void ModbusTcpDevice::poll() {
+    expireTransactions();
+
+    if (!beginCycle())
+        return;
+    m_nextBlock = 0;
+    sendPendingRequests();
+}
+
+void ModbusTcpDevice::sendPendingRequests() {
+    QByteArray requests;
+    const qint64 nowNs = MonotonicClock::nowNs();
+
+    while (cycleActive() && m_inFlight.size() < m_maxPipeline &&
+           m_nextBlock < m_config.blocks.size()) {
+        const QByteArray pdu = ModbusRegisterMap::readRequest(m_config.blocks.at(m_nextBlock));
+        const quint16 transactionId = m_nextTransactionId++;
+
+        char header[MBAP_HEADER_SIZE];
+        qToBigEndian<quint16>(transactionId, header);
+        qToBigEndian<quint16>(0, header + 2);
+        qToBigEndian<quint16>(quint16(pdu.size() + 1), header + 4);
+        header[6] = char(m_config.unitId);
+
+        requests.append(header, MBAP_HEADER_SIZE);
+        requests.append(pdu);
+        m_inFlight.insert(transactionId, Transaction{m_nextBlock, nowNs});
+        ++m_nextBlock;
+    }
+
+    if (!requests.isEmpty())
+        m_socket->write(requests);
+}
+
+void ModbusTcpDevice::handleReadyRead() {
+    m_readBuffer.append(m_socket->readAll());
+    const qint64 receivedAtNs = MonotonicClock::nowNs();
+
+    // Одно чтение может содержать несколько ответов или часть ответа
+    qsizetype offset = 0;
+    while (m_readBuffer.size() - offset >= MBAP_HEADER_SIZE) {
+        const char *frame = m_readBuffer.constData() + offset;
+        const quint16 transactionId = qFromBigEndian<quint16>(frame);
+        const quint16 protocolId = qFromBigEndian<quint16>(frame + 2);
+        const quint16 length = qFromBigEndian<quint16>(frame + 4);
+
+        if (protocolId != 0 || length < 2 || length > 254) {
+            emit errorOccurred("Некорректный заголовок MBAP, соединение разорвано.");
+            m_socket->abort();
+            return;
+        }
+        const qsizetype frameSize = 6 + length;
+        if (m_readBuffer.size() - offset < frameSize)
+            break;
+        offset += frameSize;
+
+        // Ответ на запрос, снятый по таймауту, уже не нужен
+        const auto it = m_inFlight.constFind(transactionId);
+        if (it == m_inFlight.constEnd())
+            continue;
+        const int block = it->block;
+        m_inFlight.erase(it);
+
+        completeBlock(block, frame + MBAP_HEADER_SIZE, length - 1, receivedAtNs);
+    }
+    m_readBuffer.remove(0, offset);
+
+    sendPendingRequests();
+}
+
+void ModbusTcpDevice::expireTransactions() {
+    const qint64 nowNs = MonotonicClock::nowNs();
+    const qint64 expiredBeforeNs = nowNs - qint64(REQUEST_TIMEOUT_MS) * 1000000;
+    for (auto it = m_inFlight.begin(); it != m_inFlight.end();) {
+        if (it->sentAtNs < expiredBeforeNs) {
+            it = m_inFlight.erase(it);
+            failBlock("Таймаут ответа устройства.", nowNs);
+        } else {
+            ++it;
+        }
+    }
+    // На освободившиеся места конвейера уходят оставшиеся запросы цикла
+    sendPendingRequests();
+}
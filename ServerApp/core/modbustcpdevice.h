@@ -0,0 +1,128 @@
+/**
+ * @file modbustcpdevice.h
+ * @brief Определяет класс ModbusTcpDevice — опрашиваемое Modbus TCP-устройство.
+ */
+#ifndef MODBUSTCPDEVICE_H
+#define MODBUSTCPDEVICE_H
+
+#include <QHash>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include "core/modbusdevice.h"
+
+/**
+ * @class ModbusTcpDevice
+ * @brief Устройство, опрашиваемое по Modbus TCP.
+ *
+ * Сервер сам подключается к устройству и с периодом pollIntervalMs читает
+ * блоки регистров карты. До maxPipeline запросов с разными Transaction ID
+ * отправляются не дожидаясь ответов, поэтому цикл опроса занимает примерно
+ * (число блоков / maxPipeline) сетевых задержек вместо числа блоков.
+ */
+class ModbusTcpDevice : public ModbusDevice {
+    Q_OBJECT
+
+public:
+    /// @brief Количество одновременно ожидающих ответа запросов по умолчанию.
+    static constexpr int DEFAULT_MAX_PIPELINE = 4;
+    /// @brief Время ожидания ответа на запрос (мс).
+    static constexpr int REQUEST_TIMEOUT_MS = 1000;
+    /// @brief Пауза перед повторным подключением (мс).
+    static constexpr int RECONNECT_INTERVAL_MS = 2000;
+    /// @brief Размер заголовка MBAP (Transaction ID, Protocol ID, длина, Unit ID).
+    static constexpr int MBAP_HEADER_SIZE = 7;
+
+    /**
+     * @brief Конструктор класса ModbusTcpDevice.
+     * @param config Параметры опроса и карта регистров.
+     * @param host Адрес устройства.
+     * @param port Порт устройства.
+     * @param maxPipeline Максимум одновременно ожидающих ответа запросов.
+     * @param parent Родительский объект QObject.
+     */
+    ModbusTcpDevice(const ModbusDeviceConfig &config, const QString &host, quint16 port,
+                    int maxPipeline = DEFAULT_MAX_PIPELINE, QObject *parent = nullptr);
+
+    QString address() const override { return m_host; }
+    quint16 port() const override { return m_port; }
+
+    /**
+     * @brief Задает адрес устройства и начинает опрос.
+     */
+    void connectToHost(const QString &host, quint16 port) override;
+    /**
+     * @brief Прекращает опрос и закрывает соединение.
+     */
+    void disconnect() override;
+
+    /**
+     * @brief Подключается к устройству и начинает опрос; при обрыве соединение восстанавливается.
+     */
+    void start();
+
+private slots:
+    /**
+     * @brief Регистрирует устройство и запускает таймер опроса.
+     */
+    void handleConnected() override;
+    /**
+     * @brief Сбрасывает незавершенный цикл и планирует переподключение.
+     */
+    void handleDisconnected() override;
+    /**
+     * @brief Разбирает ответы MBAP и отправляет следующие запросы.
+     */
+    void handleReadyRead() override;
+    /**
+     * @brief Обрабатывает ошибку сокета.
+     */
+    void handleError(QAbstractSocket::SocketError socketError);
+    /**
+     * @brief Начинает новый цикл опроса и снимает запросы с истекшим таймаутом.
+     */
+    void poll();
+
+private:
+    /**
+     * @struct Transaction
+     * @brief Запрос, ожидающий ответа.
+     */
+    struct Transaction {
+        int block = 0;              ///< Индекс блока в карте
+        qint64 sentAtNs = 0;        ///< Время отправки (MonotonicClock)
+    };
+
+    /**
+     * @brief Отправляет запросы цикла, пока не заполнен конвейер, одной записью в сокет.
+     */
+    void sendPendingRequests();
+    /**
+     * @brief Снимает запросы, ответ на которые не пришел за REQUEST_TIMEOUT_MS.
+     */
+    void expireTransactions();
+
+    /// @brief Адрес устройства.
+    QString m_host;
+    /// @brief Порт устройства.
+    quint16 m_port;
+    /// @brief Максимум одновременно ожидающих ответа запросов.
+    int m_maxPipeline;
+
+    QTcpSocket *m_socket;
+    QTimer *m_pollTimer;
+    QTimer *m_reconnectTimer;
+    /// @brief Опрос включен (соединение восстанавливается после обрыва).
+    bool m_running = false;
+
+    /// @brief Непрочитанная часть входящего потока.
+    QByteArray m_readBuffer;
+    /// @brief Следующий Transaction ID.
+    quint16 m_nextTransactionId = 0;
+    /// @brief Запросы, ожидающие ответа, по Transaction ID.
+    QHash<quint16, Transaction> m_inFlight;
+    /// @brief Индекс следующего блока текущего цикла.
+    int m_nextBlock = 0;
+};
+
+#endif // MODBUSTCPDEVICE_H
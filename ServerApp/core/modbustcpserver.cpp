@@ -0,0 +1,61 @@
+#include "modbustcpserver.h"
+#include "core/logger.h"
+
+#include <utility>
+
+ModbusTcpServer::ModbusTcpServer(const ServerSettings &settings, QObject *parent)
+    : ModbusServer("Modbus TCP", parent), m_settings(settings) {}
+
+void ModbusTcpServer::startServer(quint16 port) {
+    if (m_running) {
+        LOG_WARNING(AppEnums::LogCategory::Server, "Опрос Modbus TCP уже запущен.");
+        return;
+    }
+
+    QJsonArray devices;
+    QString error;
+    if (!ModbusRegisterMap::loadSection(m_settings.modbusMapPath, "tcp", devices, &error)) {
+        LOG_ERROR(AppEnums::LogCategory::Server, QString("Ошибка запуска Modbus TCP: %1").arg(error));
+        return;
+    }
+
+    int registerCount = 0;
+    int requestCount = 0;
+    for (const QJsonValue &value : std::as_const(devices)) {
+        const QJsonObject json = value.toObject();
+        ModbusDeviceConfig config;
+        const QString host = json.value("host").toString();
+        if (!ModbusRegisterMap::parseDevice(json, config, &error) || host.isEmpty()) {
+            LOG_ERROR(AppEnums::LogCategory::Server,
+                      QString("Устройство Modbus TCP пропущено: %1")
+                          .arg(host.isEmpty() ? "не задан адрес" : error));
+            continue;
+        }
+
+        const quint16 devicePort = quint16(json.value("port").toInt(port ? port : Modbus::DEFAULT_TCP_PORT));
+        const int maxPipeline = json.value("maxPipeline").toInt(ModbusTcpDevice::DEFAULT_MAX_PIPELINE);
+        auto *device = new ModbusTcpDevice(config, host, devicePort, maxPipeline, this);
+        addDevice(device);
+        registerCount += config.registers.size();
+        requestCount += config.blocks.size();
+        device->start();
+    }
+
+    m_running = true;
+    LOG_INFO(AppEnums::LogCategory::Server,
+             QString("Опрос Modbus TCP запущен: устройств %1, значений %2, запросов на цикл %3.")
+                 .arg(m_devices.size())
+                 .arg(registerCount)
+                 .arg(requestCount));
+}
+
+void ModbusTcpServer::stopServer() {
+    if (!m_running) {
+        LOG_WARNING(AppEnums::LogCategory::Server, "Опрос Modbus TCP уже остановлен.");
+        return;
+    }
+    m_running = false;
+
+    releaseDevices();
+    LOG_INFO(AppEnums::LogCategory::Server, "Опрос Modbus TCP остановлен.");
+}
@@ -0,0 +1,50 @@
+/**
+ * @file modbustcpserver.h
+ * @brief Определяет класс ModbusTcpServer, реализующий IServer для опроса устройств Modbus TCP.
+ */
+#ifndef MODBUSTCPSERVER_H
+#define MODBUSTCPSERVER_H
+
+#include "core/modbusserver.h"
+#include "core/modbustcpdevice.h"
+#include "core/serversettings.h"
+
+/**
+ * @class ModbusTcpServer
+ * @brief Реализация интерфейса IServer, опрашивающая устройства Modbus TCP.
+ *
+ * В отличие от TCP- и UDP-серверов, порт не прослушивается: при запуске
+ * читается секция "tcp" карты регистров (ServerSettings::modbusMapPath), и
+ * для каждого устройства создается ModbusTcpDevice, который сам подключается
+ * к нему. Порт сервера используется для устройств, у которых порт не указан.
+ * Все устройства опрашиваются параллельно в потоке сервера на асинхронных сокетах.
+ */
+class ModbusTcpServer : public ModbusServer {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Конструктор класса ModbusTcpServer.
+     * @param settings Параметры сервера (путь к карте регистров).
+     * @param parent Родительский объект QObject.
+     */
+    explicit ModbusTcpServer(const ServerSettings &settings = ServerSettings(),
+                             QObject *parent = nullptr);
+
+public slots:
+    /**
+     * @brief Загружает карту регистров и начинает опрос устройств.
+     * @param port Порт по умолчанию для устройств без явного порта.
+     */
+    void startServer(quint16 port) override;
+    /**
+     * @brief Прекращает опрос и отключается от всех устройств.
+     */
+    void stopServer() override;
+
+private:
+    /// @brief Параметры сервера.
+    ServerSettings m_settings;
+};
+
+#endif // MODBUSTCPSERVER_H
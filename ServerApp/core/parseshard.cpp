@@ -0,0 +1,115 @@
+#include "parseshard.h"
+#include "../common/messagecodec.h"
+#include "../common/monotonicclock.h"
+#include "../common/protocol.h"
+#include "core/logger.h"
+
+#include <QDateTime>
+#include <QMutexLocker>
+
+ParseShard::ParseShard(const RateLimits &limits, QObject *parent)
+    : QObject(parent), m_typeLimits(limits.perType) {}
+
+void ParseShard::parse(IClient *client, quintptr descriptor, const QString &clientId,
+                       const QByteArray &data, qint64 receivedAtNs) {
+    --m_backlog;
+    const qint64 parseStartedNs = MonotonicClock::nowNs();
+    QCborMap message;
+    QString errorString;
+    if (!MessageCodec::decode(data, message, &errorString)) {
+        LOG_WARNING(AppEnums::LogCategory::Data,
+                    QString("Получены некорректные данные от клиента %1: %2").arg(clientId, errorString));
+        return;
+    }
+
+    const QString messageType = message.value(Protocol::Keys::TYPE).toString();
+    if (!admit(client, descriptor, messageType, receivedAtNs))
+        return;
+
+    if (messageType == Protocol::MessageType::REGISTRATION) {
+        emit registrationReceived(client, descriptor, message);
+        return;
+    }
+
+    if (messageType == Protocol::MessageType::PROBE) {
+        emit probeReceived(client, descriptor, message.value(Protocol::Keys::SENT_AT).toInteger(),
+                           receivedAtNs);
+        return;
+    }
+
+    const QCborMap payload = message.value(Protocol::Keys::PAYLOAD).toMap();
+    if (messageType == Protocol::MessageType::CONFIGURATION) {
+        emit configurationReceived(client, descriptor, payload.toVariantMap());
+    }
+
+    TelemetryRecord record = TelemetryRecord::fromPayload(messageType, payload);
+    record.timestamp = QDateTime::currentMSecsSinceEpoch();
+    record.clientId = clientId;
+    record.readEnvelope(message);
+    record.stages.received = receivedAtNs;
+    record.stages.parseStarted = parseStartedNs;
+    record.stages.parsed = MonotonicClock::nowNs();
+
+    int count = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_dataBatch.append(std::move(record));
+        count = int(m_dataBatch.size());
+        m_pendingCount = count;
+        m_pendingBytes += data.size();
+    }
+
+    // Событие в рабочий поток на каждое сообщение обходилось бы дороже самого разбора
+    if (count == 1 || count % NOTIFY_STEP_RECORDS == 0)
+        emit dataQueued();
+}
+
+bool ParseShard::admit(IClient *client, quintptr descriptor, const QString &messageType,
+                       qint64 nowNs) {
+    // Телеметрия обычно не ограничивается по типу: ей хватает одного поиска в m_typeLimits
+    const auto limit = m_typeLimits.constFind(messageType);
+    if (limit == m_typeLimits.constEnd())
+        return true;
+
+    TypeLimiter &limiter = m_typeLimiters[descriptor];
+    if (limiter.client != client) {
+        limiter.client = client;
+        limiter.buckets.clear();
+    }
+    auto bucket = limiter.buckets.find(messageType);
+    if (bucket == limiter.buckets.end())
+        bucket = limiter.buckets.insert(messageType, TokenBucket(limit->ratePerSec, limit->burst));
+    if (bucket->tryTake(nowNs))
+        return true;
+
+    QMutexLocker locker(&m_mutex);
+    ++m_rateLimited[descriptor];
+    return false;
+}
+
+QHash<quintptr, quint64> ParseShard::takeRateLimited() {
+    QHash<quintptr, quint64> rateLimited;
+    QMutexLocker locker(&m_mutex);
+    rateLimited.swap(m_rateLimited);
+    return rateLimited;
+}
+
+void ParseShard::forgetClient(quintptr descriptor) {
+    m_typeLimiters.remove(descriptor);
+}
+
+QList<TelemetryRecord> ParseShard::takeDataBatch() {
+    QList<TelemetryRecord> batch;
+    {
+        QMutexLocker locker(&m_mutex);
+        batch.swap(m_dataBatch);
+        m_pendingCount = 0;
+        m_pendingBytes = 0;
+    }
+
+    const qint64 flushedNs = MonotonicClock::nowNs();
+    for (TelemetryRecord &record : batch) {
+        record.stages.flushed = flushedNs;
+    }
+    return batch;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file parseshard.h
+ * @brief Определяет класс ParseShard — поток разбора сообщений зарегистрированных клиентов.
+ */
+#ifndef PARSESHARD_H
+#define PARSESHARD_H
+
+#include <QCborMap>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QVariantMap>
+
+#include <atomic>
+
+#include "../common/iclient.h"
+#include "core/ratelimits.h"
+#include "core/telemetry.h"
+#include "core/tokenbucket.h"
+
+/**
+ * @class ParseShard
+ * @brief Разбор сообщений части клиентов в отдельном потоке с собственным пакетом данных.
+ *
+ * DataProcessing распределяет сообщения зарегистрированных клиентов между
+ * шардами по хешу дескриптора, так что сообщения одного клиента всегда
+ * разбираются одним шардом и сохраняют порядок. Шард декодирует сообщение,
+ * строит TelemetryRecord и добавляет его в свой пакет; ServerWorker забирает
+ * пакеты всех шардов при отправке в UI.
+ *
+ * Объект клиента в шарде не используется: указатель служит только меткой,
+ * которую DataProcessing сверяет со своим реестром, когда шард возвращает
+ * ему регистрацию, конфигурацию или Probe.
+ *
+ * Сразу после декодирования сообщение проверяется корзиной маркеров своего
+ * типа (RateLimits::perType); сообщения сверх темпа отбрасываются, а их
+ * количество по клиентам DataProcessing забирает через takeRateLimited().
+ */
+class ParseShard : public QObject {
+    Q_OBJECT
+
+public:
+    /// @brief Шаг количества записей, с которым шард повторно сообщает о пополнении пакета.
+    static constexpr int NOTIFY_STEP_RECORDS = 256;
+
+    /**
+     * @brief Конструктор класса ParseShard.
+     * @param limits Ограничения темпа (используются ограничения по типам сообщений).
+     * @param parent Родительский объект QObject.
+     */
+    explicit ParseShard(const RateLimits &limits = RateLimits(), QObject *parent = nullptr);
+
+    /**
+     * @brief Разбирает сообщение клиента. Вызывается в потоке шарда.
+     * @param client Метка клиента (не разыменовывается).
+     * @param descriptor Дескриптор клиента.
+     * @param clientId ID клиента на момент получения сообщения.
+     * @param data Данные одного сообщения.
+     * @param receivedAtNs Время чтения данных из сокета.
+     */
+    void parse(IClient *client, quintptr descriptor, const QString &clientId,
+               const QByteArray &data, qint64 receivedAtNs);
+
+    /**
+     * @brief Забирает накопленный пакет данных. Потокобезопасен.
+     */
+    QList<TelemetryRecord> takeDataBatch();
+    /**
+     * @brief Возвращает количество накопленных записей. Потокобезопасен.
+     */
+    int pendingCount() const { return m_pendingCount; }
+    /**
+     * @brief Возвращает объем исходных сообщений в пакете (в байтах). Потокобезопасен.
+     */
+    qsizetype pendingBytes() const { return m_pendingBytes; }
+    /**
+     * @brief Учитывает сообщение, переданное шарду на разбор. Потокобезопасен.
+     */
+    void messageQueued() { ++m_backlog; }
+    /**
+     * @brief Возвращает количество переданных шарду и еще не разобранных сообщений. Потокобезопасен.
+     */
+    int backlog() const { return m_backlog; }
+    /**
+     * @brief Забирает количество отброшенных по темпу сообщений по дескрипторам. Потокобезопасен.
+     */
+    QHash<quintptr, quint64> takeRateLimited();
+    /**
+     * @brief Удаляет корзины отключенного клиента. Вызывается в потоке шарда.
+     */
+    void forgetClient(quintptr descriptor);
+
+signals:
+    /**
+     * @brief Клиент повторно прислал регистрацию; она выполняется в DataProcessing.
+     */
+    void registrationReceived(IClient *client, quintptr descriptor, const QCborMap &message);
+    /**
+     * @brief Клиент прислал свою конфигурацию.
+     */
+    void configurationReceived(IClient *client, quintptr descriptor, const QVariantMap &configuration);
+    /**
+     * @brief Клиент прислал Probe; ответ отправляет DataProcessing.
+     */
+    void probeReceived(IClient *client, quintptr descriptor, qint64 clientSentAtUs, qint64 receivedAtNs);
+    /**
+     * @brief Пакет пополнился (первая запись после выборки и далее каждые NOTIFY_STEP_RECORDS).
+     */
+    void dataQueued();
+
+private:
+    /**
+     * @struct TypeLimiter
+     * @brief Корзины маркеров одного клиента по типам сообщений.
+     */
+    struct TypeLimiter {
+        IClient *client = nullptr; ///< Метка клиента: дескриптор мог достаться новому подключению.
+        QHash<QString, TokenBucket> buckets;
+    };
+
+    /**
+     * @brief Проверяет темп сообщений типа messageType у клиента.
+     * @return false, если сообщение нужно отбросить.
+     */
+    bool admit(IClient *client, quintptr descriptor, const QString &messageType, qint64 nowNs);
+
+    /// @brief Ограничения по типам сообщений.
+    const QHash<QString, RateLimits::Limit> m_typeLimits;
+    /// @brief Корзины клиентов, приславших сообщения ограниченных типов.
+    QHash<quintptr, TypeLimiter> m_typeLimiters;
+
+    /// @brief Защищает m_dataBatch и m_rateLimited.
+    QMutex m_mutex;
+    /// @brief Пакет входящих данных.
+    QList<TelemetryRecord> m_dataBatch;
+    std::atomic<int> m_pendingCount{0};
+    std::atomic<qsizetype> m_pendingBytes{0};
+    /// @brief Сообщения в очереди событий потока шарда.
+    std::atomic<int> m_backlog{0};
+    /// @brief Отброшенные по темпу сообщения с прошлой выборки: дескриптор → количество.
+    QHash<quintptr, quint64> m_rateLimited;
+};
+
+#endif // PARSESHARD_H
@@ -0,0 +1,43 @@
+/**
+ * @file ratelimits.h
+ * @brief Определяет структуру RateLimits с ограничениями темпа входящих сообщений.
+ */
+#ifndef RATELIMITS_H
+#define RATELIMITS_H
+
+#include <QHash>
+#include <QString>
+
+#include "../common/protocol.h"
+
+/**
+ * @struct RateLimits
+ * @brief Ограничения темпа сообщений одного клиента, применяемые DataProcessing.
+ *
+ * Общая корзина клиента проверяется в рабочем потоке до передачи сообщения в
+ * шард разбора, корзины по типам — в шарде сразу после декодирования.
+ * Сообщения сверх темпа отбрасываются и учитываются в счетчике клиента.
+ */
+struct RateLimits {
+    /**
+     * @struct Limit
+     * @brief Темп и емкость одной корзины маркеров.
+     */
+    struct Limit {
+        double ratePerSec = 0.0; ///< Сообщений в секунду (0 — без ограничения).
+        double burst = 1.0;      ///< Сообщений, принимаемых подряд после затишья.
+    };
+
+    /// @brief Общий темп сообщений одного клиента.
+    Limit perClient{5000.0, 10000.0};
+    /// @brief Темп сообщений отдельных типов (типы без записи не ограничиваются).
+    QHash<QString, Limit> perType{
+        {Protocol::MessageType::REGISTRATION, {1.0, 5.0}},
+        {Protocol::MessageType::CONFIGURATION, {2.0, 10.0}},
+        {Protocol::MessageType::PROBE, {20.0, 40.0}},
+    };
+    /// @brief Количество отброшенных сообщений, после которого клиент отключается (0 — не отключать).
+    quint64 disconnectAfter = 0;
+};
+
+#endif // RATELIMITS_H
@@ -6,7 +6,12 @@
 #define SERVERFACTORY_H
 
 #include "appenums.h"
+#include "localserver.h"
+#include "modbusrtuserver.h"
+#include "modbustcpserver.h"
+#include "serversettings.h"
 #include "tcpserver.h"
+#include "udpserver.h"
 
 /**
  * @class ServerFactory
@@ -20,16 +25,23 @@ public:
     /**
      * @brief Создает и возвращает экземпляр сервера нужного типа.
      * @param type Тип сервера (TCP, UDP и т.д.).
+     * @param settings Параметры создаваемого сервера.
      * @param parent Родительский объект QObject.
      * @return Указатель на созданный IServer или nullptr, если тип неизвестен.
      */
     static IServer *createServer(AppEnums::ServerType type,
+                                 const ServerSettings &settings = ServerSettings(),
                                  QObject *parent = nullptr) {
         if (type == AppEnums::ServerType::TCP) {
-            return new TcpServer(parent);
-        } else if (type == AppEnums::ServerType::UDP) { // Пример
-            // return new UdpServer(parent);
-            return nullptr;
+            return new TcpServer(settings, parent);
+        } else if (type == AppEnums::ServerType::UDP) {
+            return new UdpServer(settings, parent);
+        } else if (type == AppEnums::ServerType::MODBUS_TCP) {
+            return new ModbusTcpServer(settings, parent);
+        } else if (type == AppEnums::ServerType::MODBUS_RTU) {
+            return new ModbusRtuServer(settings, parent);
+        } else if (type == AppEnums::ServerType::LOCAL) {
+            return new LocalServer(settings, parent);
         }
         // ... и т.д.
         return nullptr; // Неизвестный тип
@@ -0,0 +1,50 @@
+/**
+ * @file serversettings.h
+ * @brief Определяет структуру ServerSettings с параметрами создаваемых серверов.
+ */
+#ifndef SERVERSETTINGS_H
+#define SERVERSETTINGS_H
+
+#include <QCoreApplication>
+#include <QString>
+#include <QThread>
+
+#include "../common/protocol.h"
+#include "../common/tcpclient.h"
+
+/**
+ * @struct ServerSettings
+ * @brief Параметры, передаваемые фабрикой серверов в конструктор сервера.
+ *
+ * Значения применяются к серверам, созданным после их изменения.
+ */
+struct ServerSettings {
+    /// @brief Максимально допустимое количество потоков ввода-вывода на сервер.
+    static constexpr int MAX_IO_THREADS = 64;
+
+    /// @brief Количество потоков ввода-вывода, между которыми распределяются сокеты.
+    int ioThreadCount = qBound(1, QThread::idealThreadCount(), MAX_IO_THREADS);
+    /// @brief Поведение при переполнении очереди отправки клиента.
+    IClient::SlowConsumerPolicy slowConsumerPolicy = IClient::SlowConsumerPolicy::Coalesce;
+    /// @brief Максимальный объем очереди отправки одного клиента (в байтах).
+    qint64 maxSendQueueBytes = TcpClient::DEFAULT_MAX_QUEUED_BYTES;
+    /// @brief Темп приема новых TCP-подключений (в секунду, 0 — без ограничения).
+    int acceptRatePerSec = 500;
+    /// @brief Количество подключений, принимаемых без задержки после затишья.
+    int acceptBurst = 100;
+    /// @brief Наибольшее число принятых подключений, ожидающих передачи в потоки ввода-вывода;
+    /// сверх него клиент получает Busy и отключается.
+    int maxPendingAccepts = 2000;
+    /// @brief Наибольшее число одновременных подключений к одному TCP-серверу (0 — без ограничения);
+    /// сверх него новые клиенты получают Busy и отключаются. Для UDP-сервера — наибольшее
+    /// число отправителей: датаграммы новых отправителей сверх него отбрасываются.
+    int maxConnections = 10000;
+    /// @brief Время без входящих сообщений, после которого клиент отключается (мс, 0 — не отключать).
+    int idleTimeoutMs = Protocol::Timing::IDLE_TIMEOUT_MS;
+    /// @brief Время без датаграмм, после которого UDP-отправитель считается отключенным (мс, 0 — не отключать).
+    int udpIdleTimeoutMs = 30000;
+    /// @brief Путь к JSON-файлу с картами регистров опрашиваемых Modbus-устройств.
+    QString modbusMapPath = QCoreApplication::applicationDirPath() + "/modbus.json";
+};
+
+#endif // SERVERSETTINGS_H
@@ -1,5 +1,7 @@
 #include "serverworker.h"
 
+#include <utility>
+
 ServerWorker::ServerWorker(QObject *parent)
     : QObject(parent), m_dataProcessing(nullptr) {
 
@@ -7,55 +9,145 @@ ServerWorker::ServerWorker(QObject *parent)
     m_dataProcessing = new DataProcessing(this);
 
     // Подключаем сигналы для передачи в UI поток
-    connect(m_dataProcessing, &DataProcessing::logMessage, this,
-            &ServerWorker::handleLogMessage);
+    connect(m_dataProcessing, &DataProcessing::dataQueued, this,
+            &ServerWorker::handleDataQueued);
 
     m_batchTimer = new QTimer(this);
     connect(m_batchTimer, &QTimer::timeout, this,
             &ServerWorker::handleBatchTimerTimeout);
+
+    m_flowTimer = new QTimer(this);
+    connect(m_flowTimer, &QTimer::timeout, this,
+            &ServerWorker::evaluateFlowControl);
 }
 
 ServerWorker::~ServerWorker() {}
 
 void ServerWorker::handleBatchTimerTimeout() {
-    if (m_dataProcessing) {
-        // Забираем пакет данных
-        QList<QVariantMap> dataBatch = m_dataProcessing->takeDataBatch();
-        if (!dataBatch.isEmpty()) {
-            emit dataBatchReady(dataBatch);
-        }
-
-        // Забираем пакет обновлений клиентов
-        QList<QVariantMap> clientBatch = m_dataProcessing->takeClientUpdatesBatch();
-        if (!clientBatch.isEmpty()) {
-            m_batchTimer->setInterval(BATCH_TIMEOUT_SLOW_MODE_MS);
-            emit clientBatchReady(clientBatch);
-        } else { // Если нагрузка большая, то уменьшаем частоту обновления
-            m_batchTimer->setInterval(BATCH_TIMEOUT_MS);
-        }
-
-        // Забираем логи
-        if (!m_logBatch.isEmpty()) {
-            emit logBatchReady(m_logBatch);
-            m_logBatch.clear();
-        }
-
-        // Обновляем статусы серверов
-        for (auto it = m_servers.constBegin(); it != m_servers.constEnd(); ++it) {
-            if (it.value()->isListening()) {
-                const auto &key = it.key();
-                emit serverStatusUpdate(key.first, key.second,
-                                        AppEnums::ServerStatus::RUNNING,
-                                        it.value()->clientCount());
-            }
-        }
-    }
-}
-
-void ServerWorker::handleLogMessage(const QString &message) {
-    QString timestamp =
-        QDateTime::currentDateTime().toString("dd.MM.yy hh:mm:ss");
-    m_logBatch.append(QString("[%1] %2\n").arg(timestamp).arg(message));
+    flushBatches(FlushScheduler::Reason::Timer);
+}
+
+void ServerWorker::handleDataQueued() {
+    if (m_flushScheduler.shouldFlushEarly(m_dataProcessing->pendingCount(),
+                                          m_dataProcessing->pendingBytes())) {
+        flushBatches(FlushScheduler::Reason::Threshold);
+    }
+}
+
+void ServerWorker::evaluateFlowControl() {
+    if (!m_dataProcessing)
+        return;
+
+    const int backlog = m_dataProcessing->ingestBacklog();
+    const double cpuUsage = m_flowController.sampleCpuUsage();
+    const int previous = m_flowController.level();
+    const int level = m_flowController.update(backlog, cpuUsage);
+    const int notified = m_dataProcessing->applyFlowControl(level);
+    if (level == previous)
+        return;
+
+    const FlowController::Target target = FlowController::targetForLevel(level);
+    const QString message = QString("Уровень темпа клиентов: %1 (очередь разбора %2, процессор %3%): "
+                                    "интервал %4 мс, доля %5, уведомлено клиентов: %6.")
+                                .arg(level)
+                                .arg(backlog)
+                                .arg(qRound(cpuUsage * 100))
+                                .arg(target.sendIntervalMs)
+                                .arg(target.sampleRatio)
+                                .arg(notified);
+    if (level > previous) {
+        LOG_WARNING(AppEnums::LogCategory::Server, message);
+    } else {
+        LOG_INFO(AppEnums::LogCategory::Server, message);
+    }
+}
+
+void ServerWorker::flushBatches(FlushScheduler::Reason reason) {
+    if (!m_dataProcessing)
+        return;
+
+    // UI еще применяет предыдущий пакет — копим дальше и реже проверяем
+    if (!m_flushScheduler.canFlush()) {
+        m_flushScheduler.flushDeferred();
+        m_batchTimer->start(m_flushScheduler.interval());
+        // Событий в UI-поток не посылаем: метрики отсрочки он прочитает со следующим пакетом
+        publishFlushMetrics();
+        return;
+    }
+
+    const int records = m_dataProcessing->pendingCount();
+    const qsizetype bytes = m_dataProcessing->pendingBytes();
+
+    // При переполнении отбрасываются самые старые записи пакета: таблица данных
+    // все равно показывает только последние строки
+    QList<TelemetryRecord> dataBatch = m_dataProcessing->takeDataBatch();
+    m_dataRing.pushLatest(dataBatch);
+
+    // Забираем пакет обновлений клиентов вместе с изменившимися очередями и лимитами
+    m_dataProcessing->refreshClientCounters();
+    m_clientBacklog.append(m_dataProcessing->takeClientUpdatesBatch());
+    pushClientUpdates();
+
+    // Журнал в UI тоже показывает последние записи
+    QList<LogEntry> logBatch = Logger::instance().takePending();
+    m_logRing.pushLatest(logBatch);
+
+    // Статусы серверов отправляются, только если изменилось количество подключений
+    for (auto it = m_servers.constBegin(); it != m_servers.constEnd(); ++it) {
+        if (!it.value()->isListening())
+            continue;
+        const int connections = it.value()->clientCount();
+        auto reported = m_reportedConnections.find(it.key());
+        if (reported != m_reportedConnections.end() && *reported == connections)
+            continue;
+        m_reportedConnections.insert(it.key(), connections);
+        emit serverStatusUpdate(it.key().first, it.key().second,
+                                AppEnums::ServerStatus::RUNNING, connections);
+    }
+
+    const quint64 sequence = m_flushScheduler.flushStarted(reason, records, bytes);
+    m_batchTimer->start(m_flushScheduler.interval());
+    publishFlushMetrics();
+    // Единственное событие в UI-поток за отправку: по нему UI забирает все буферы и метрики
+    emit batchFlushed(sequence);
+}
+
+void ServerWorker::pushClientUpdates() {
+    qsizetype pushed = 0;
+    while (pushed < m_clientBacklog.size() && m_clientRing.push(std::move(m_clientBacklog[pushed]))) {
+        ++pushed;
+    }
+    m_clientBacklog.remove(0, pushed);
+}
+
+QVariantMap ServerWorker::flushMetrics() const {
+    QVariantMap metrics = m_flushScheduler.metrics();
+    metrics[Keys::RING_DATA_DEPTH]      = m_dataRing.peakDepth();
+    metrics[Keys::RING_DATA_OVERFLOW]   = m_dataRing.overflowCount();
+    metrics[Keys::RING_CLIENT_DEPTH]    = m_clientRing.peakDepth();
+    metrics[Keys::RING_CLIENT_OVERFLOW] = m_clientRing.overflowCount();
+    metrics[Keys::RING_LOG_DEPTH]       = m_logRing.peakDepth();
+    metrics[Keys::RING_LOG_OVERFLOW]    = m_logRing.overflowCount();
+    metrics.insert(m_flowController.metrics());
+    return metrics;
+}
+
+void ServerWorker::publishFlushMetrics() {
+    QVariantMap metrics = flushMetrics();
+    QMutexLocker locker(&m_metricsMutex);
+    m_metricsSnapshot.swap(metrics);
+}
+
+QVariantMap ServerWorker::flushMetricsSnapshot() const {
+    QMutexLocker locker(&m_metricsMutex);
+    return m_metricsSnapshot;
+}
+
+void ServerWorker::handleUiBatchApplied(quint64 sequence, qint64 applyTimeUs) {
+    m_flushScheduler.flushAcknowledged(sequence, applyTimeUs);
+    if (m_batchTimer->isActive() && m_batchTimer->interval() != m_flushScheduler.interval()) {
+        m_batchTimer->setInterval(m_flushScheduler.interval());
+    }
 }
 
 void ServerWorker::startServer(AppEnums::ServerType type, quint16 port) {
@@ -63,15 +155,16 @@ void ServerWorker::startServer(AppEnums::ServerType type, quint16 port) {
 
     if (m_servers.contains(key)) {
         m_servers[key]->startServer(port);
-        handleLogMessage(QString("Сервер перезапущен (%1:%2).")
-                             .arg(AppEnums::typeToString(type))
-                             .arg(port));
+        LOG_INFO(AppEnums::LogCategory::Server,
+                 QString("Сервер перезапущен (%1:%2).")
+                     .arg(AppEnums::typeToString(type))
+                     .arg(port));
         return;
     }
 
-    IServer *server = ServerFactory::createServer(type);
+    IServer *server = ServerFactory::createServer(type, m_serverSettings);
     if (!server) {
-        handleLogMessage("Ошибка: не удалось создать сервер.");
+        LOG_ERROR(AppEnums::LogCategory::Server, "Не удалось создать сервер.");
         emit serverStatusUpdate(type, port, AppEnums::ServerStatus::ERROR, 0);
         return;
     }
@@ -80,12 +173,17 @@ void ServerWorker::startServer(AppEnums::ServerType type, quint16 port) {
     m_servers[key] = server;
 
     server->startServer(port);
-    handleLogMessage(QString("Сервер запущен (%1:%2).")
-                         .arg(AppEnums::typeToString(type))
-                         .arg(port));
+    LOG_INFO(AppEnums::LogCategory::Server,
+             QString("Сервер запущен (%1:%2).")
+                 .arg(AppEnums::typeToString(type))
+                 .arg(port));
     emit serverStatusUpdate(type, port, AppEnums::ServerStatus::RUNNING, 0);
+    m_reportedConnections.insert(key, 0);
     if (!m_batchTimer->isActive()) {
-        m_batchTimer->start(BATCH_TIMEOUT_MS);
+        m_batchTimer->start(m_flushScheduler.interval());
+    }
+    if (!m_flowTimer->isActive()) {
+        m_flowTimer->start(FlowController::EVALUATE_INTERVAL_MS);
     }
 }
 
@@ -96,8 +194,9 @@ void ServerWorker::stopServer(AppEnums::ServerType type, quint16 port) {
         IServer *server = m_servers[key];
         server->stopServer();
 
-        handleLogMessage(QString("Сервер на порту %1 остановлен.").arg(port));
+        LOG_INFO(AppEnums::LogCategory::Server, QString("Сервер на порту %1 остановлен.").arg(port));
         emit serverStatusUpdate(type, port, AppEnums::ServerStatus::STOPPED, 0);
+        m_reportedConnections.remove(key);
     }
 }
 
@@ -106,6 +205,9 @@ void ServerWorker::deleteServer(AppEnums::ServerType type, quint16 port) {
 
     if (m_servers.contains(key)) {
         IServer *server = m_servers.take(key);
+        m_reportedConnections.remove(key);
+        // Клиенты сервера удаляются вместе с ним без сигнала отключения
+        m_dataProcessing->removeServer(server);
         removeDisconnectedClients();
         server->deleteLater();
     }
@@ -134,3 +236,11 @@ void ServerWorker::clearClients() {
         m_dataProcessing->clearClients();
     }
 }
+
+void ServerWorker::setIoThreadCount(int count) {
+    m_serverSettings.ioThreadCount = qBound(1, count, ServerSettings::MAX_IO_THREADS);
+}
+
+void ServerWorker::setSlowConsumerPolicy(int policy) {
+    m_serverSettings.slowConsumerPolicy = IClient::SlowConsumerPolicy(policy);
+}
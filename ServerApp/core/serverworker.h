@@ -12,8 +12,13 @@
 #include <QTimer>
 
 #include "core/dataprocessing.h"
+#include "core/flowcontroller.h"
+#include "core/flushscheduler.h"
 #include "core/iserver.h"
+#include "core/logger.h"
 #include "core/serverfactory.h"
+#include "core/serversettings.h"
+#include "core/spscring.h"
 
 /**
  * @class ServerWorker
@@ -21,16 +26,30 @@
  *
  * Этот класс отвечает за создание, запуск, остановку и удаление серверов.
  * Он также управляет пакетной отправкой данных, логов и обновлений статусов клиентов в основной поток (UI).
+ *
+ * Пакеты передаются в UI через кольцевые буферы SpscRing (по одному на поток
+ * данных, обновлений клиентов и журнала): при отправке рабочий поток
+ * записывает элементы в буферы и испускает один сигнал batchFlushed, по
+ * которому UI забирает все буферы. Объем данных, ожидающих UI, ограничен
+ * емкостью буферов, а в очереди событий UI-потока не бывает больше одного
+ * события на отправку.
+ *
+ * Раз в FlowController::EVALUATE_INTERVAL_MS рабочий поток оценивает
+ * нагрузку (очередь разбора и загрузку процессора) и передает уровень
+ * FlowController в DataProcessing, который сообщает клиентам темп
+ * телеметрии (Protocol::FlowControl).
  */
 class ServerWorker : public QObject {
     Q_OBJECT
 
-    /// @brief Таймаут по умолчанию для таймера пакетной обработки (в миллисекундах).
-    static constexpr int BATCH_TIMEOUT_MS           = 500;
-    /// @brief Увеличенный таймаут для таймера при высокой нагрузке для снижения частоты обновлений.
-    static constexpr int BATCH_TIMEOUT_SLOW_MODE_MS = 2000;
-
 public:
+    /// @brief Емкость буфера записей телеметрии (таблица данных все равно хранит меньше).
+    static constexpr qsizetype DATA_RING_CAPACITY = 16384;
+    /// @brief Емкость буфера обновлений клиентов.
+    static constexpr qsizetype CLIENT_RING_CAPACITY = 4096;
+    /// @brief Емкость буфера записей журнала (Logger хранит для UI не больше UI_TAIL_CAPACITY).
+    static constexpr qsizetype LOG_RING_CAPACITY = 2048;
+
     /**
      * @brief Конструктор класса ServerWorker.
      * @param parent Родительский объект QObject.
@@ -47,6 +66,26 @@ public:
      */
     DataProcessing *dataProcessing() const { return m_dataProcessing; }
 
+    /**
+     * @brief Возвращает буфер записей телеметрии; UI-поток читает его по сигналу batchFlushed.
+     */
+    SpscRing<TelemetryRecord> &dataRing() { return m_dataRing; }
+    /**
+     * @brief Возвращает буфер обновлений клиентов; UI-поток читает его по сигналу batchFlushed.
+     */
+    SpscRing<QVariantMap> &clientRing() { return m_clientRing; }
+    /**
+     * @brief Возвращает буфер записей журнала; UI-поток читает его по сигналу batchFlushed.
+     */
+    SpscRing<LogEntry> &logRing() { return m_logRing; }
+    /**
+     * @brief Возвращает метрики планировщика, буферов и темпа на момент последней отправки.
+     *
+     * UI-поток читает их по сигналу batchFlushed: отдельного события с метриками нет.
+     * @return Карта метрик (ключи Keys::FLUSH_*, Keys::RING_* и Keys::FLOW_*).
+     */
+    QVariantMap flushMetricsSnapshot() const;
+
 public slots:
     /**
      * @brief Запускает сервер указанного типа на заданном порту.
@@ -84,6 +123,22 @@ public slots:
      * @brief Очищает список всех клиентов.
      */
     void clearClients();
+    /**
+     * @brief Задает количество потоков ввода-вывода для вновь создаваемых серверов.
+     * @param count Количество потоков.
+     */
+    void setIoThreadCount(int count);
+    /**
+     * @brief Задает политику для медленных получателей у вновь подключаемых клиентов.
+     * @param policy Значение IClient::SlowConsumerPolicy.
+     */
+    void setSlowConsumerPolicy(int policy);
+    /**
+     * @brief Принимает от UI подтверждение применения пакета.
+     * @param sequence Номер пакета (из сигнала batchFlushed).
+     * @param applyTimeUs Время применения пакета в UI-потоке (в микросекундах).
+     */
+    void handleUiBatchApplied(quint64 sequence, qint64 applyTimeUs);
 
 signals:
     // Сигналы для передачи в UI поток
@@ -105,43 +160,80 @@ signals:
     void serverStatusUpdate(AppEnums::ServerType type, quint16 port,
                             AppEnums::ServerStatus status, int connections);
     /**
-     * @brief Сигнал, передающий пакет обновлений по клиентам.
-     * @param clientBatch Список карт с данными клиентов.
+     * @brief Сигнал о завершении отправки пакета: данные, обновления клиентов и журнал записаны в буферы.
+     * @param sequence Номер пакета, который UI возвращает в handleUiBatchApplied.
      */
-    void clientBatchReady(const QList<QVariantMap> &clientBatch);
+    void batchFlushed(quint64 sequence);
+
+private slots:
+    /**
+     * @brief Слот, вызываемый по таймауту таймера для пакетной обработки.
+     * Собирает данные, обновления клиентов и логи и отправляет их в UI поток.
+     */
+    void handleBatchTimerTimeout();
     /**
-     * @brief Сигнал, передающий пакет полученных от клиентов данных.
-     * @param dataBatch Список карт с данными.
+     * @brief Слот, вызываемый при пополнении пакета данных.
+     * Отправляет пакет досрочно, если планировщик считает это нужным.
      */
-    void dataBatchReady(const QList<QVariantMap> &dataBatch);
+    void handleDataQueued();
     /**
-     * @brief Сигнал, передающий пакет логов.
-     * @param logBatch Список строк логов.
+     * @brief Слот, вызываемый по таймеру оценки нагрузки.
+     * Пересчитывает уровень FlowController и передает его клиентам.
      */
-    void logBatchReady(const QStringList &logBatch);
+    void evaluateFlowControl();
 
-private slots:
+private:
     /**
-     * @brief Слот для обработки лог-сообщений от других объектов.
-     * @param message Текст сообщения.
+     * @brief Отправляет накопленные пакеты в UI, если UI готов их принять.
+     * @param reason Причина отправки.
      */
-    void handleLogMessage(const QString &message);
+    void flushBatches(FlushScheduler::Reason reason);
     /**
-     * @brief Слот, вызываемый по таймауту таймера для пакетной обработки.
-     * Собирает данные, обновления клиентов и логи и отправляет их в UI поток.
+     * @brief Записывает накопленные обновления клиентов в буфер.
+     *
+     * Обновления клиентов не отбрасываются: не поместившиеся остаются до следующей отправки.
      */
-    void handleBatchTimerTimeout();
+    void pushClientUpdates();
+    /**
+     * @brief Возвращает метрики планировщика, дополненные глубиной и переполнениями буферов.
+     */
+    QVariantMap flushMetrics() const;
+    /**
+     * @brief Обновляет снимок метрик, который UI-поток читает через flushMetricsSnapshot().
+     */
+    void publishFlushMetrics();
 
-private:
     /// @brief Таймер для пакетной отправки данных.
     QTimer *m_batchTimer;
-    /// @brief Пакет для накопления сообщений лога.
-    QStringList m_logBatch;
+    /// @brief Планировщик отправки пакетов.
+    FlushScheduler m_flushScheduler;
+    /// @brief Таймер оценки нагрузки.
+    QTimer *m_flowTimer;
+    /// @brief Уровень темпа телеметрии клиентов.
+    FlowController m_flowController;
 
+    /// @brief Параметры, с которыми создаются новые серверы.
+    ServerSettings m_serverSettings;
     /// @brief Указатель на объект обработки данных.
     DataProcessing *m_dataProcessing;
     /// @brief Хеш-таблица для хранения активных серверов.
     QHash<QPair<AppEnums::ServerType, quint16>, IServer *> m_servers;
+    /// @brief Количество подключений, последним отправленное в UI для каждого сервера.
+    QHash<QPair<AppEnums::ServerType, quint16>, int> m_reportedConnections;
+
+    /// @brief Буфер записей телеметрии для UI.
+    SpscRing<TelemetryRecord> m_dataRing{DATA_RING_CAPACITY};
+    /// @brief Буфер обновлений клиентов для UI.
+    SpscRing<QVariantMap> m_clientRing{CLIENT_RING_CAPACITY};
+    /// @brief Буфер записей журнала для UI.
+    SpscRing<LogEntry> m_logRing{LOG_RING_CAPACITY};
+    /// @brief Обновления клиентов, не поместившиеся в буфер.
+    QList<QVariantMap> m_clientBacklog;
+
+    /// @brief Мьютекс снимка метрик (пишет рабочий поток, читает UI-поток).
+    mutable QMutex m_metricsMutex;
+    /// @brief Снимок метрик последней отправки или отсрочки.
+    QVariantMap m_metricsSnapshot;
 };
 
 #endif // SERVERWORKER_H
@@ -32,6 +32,50 @@ const QString PORT          = "port";
 const QString STATUS        = "status";
 const QString ALLOW_SENDING = "allowSending";
 const QString TIME_STAMP    = "timestamp";
+const QString QUEUE_BYTES   = "queueBytes";
+const QString DROPPED       = "droppedMessages";
+// Ограничение темпа входящих сообщений клиента
+const QString RATE_TOKENS   = "rateTokens";
+const QString RATE_BURST    = "rateBurst";
+const QString RATE_LIMITED  = "rateLimited";
+// Задержки доставки клиента (колонки таблицы клиентов, значения хранит модель)
+const QString INGEST_LATENCY    = "ingestLatency";
+const QString DISPLAY_LATENCY   = "displayLatency";
+
+// --- Метрики планировщика отправки пакетов ---
+const QString FLUSH_INTERVAL        = "flushInterval";
+const QString FLUSH_TIMER_COUNT     = "timerFlushes";
+const QString FLUSH_EARLY_COUNT     = "earlyFlushes";
+const QString FLUSH_DEFERRED_COUNT  = "deferredFlushes";
+const QString FLUSH_LAST_RECORDS    = "lastBatchRecords";
+const QString FLUSH_LAST_BYTES      = "lastBatchBytes";
+const QString FLUSH_UI_APPLY_US     = "uiApplyUs";
+const QString FLUSH_ROUND_TRIP_MS   = "uiRoundTripMs";
+const QString FLUSH_LAST_DECISION   = "lastDecision";
+
+// --- Буферы передачи в UI (наибольшая глубина и отброшенные элементы) ---
+const QString RING_DATA_DEPTH       = "dataRingDepth";
+const QString RING_DATA_OVERFLOW    = "dataRingOverflow";
+const QString RING_CLIENT_DEPTH     = "clientRingDepth";
+const QString RING_CLIENT_OVERFLOW  = "clientRingOverflow";
+const QString RING_LOG_DEPTH        = "logRingDepth";
+const QString RING_LOG_OVERFLOW     = "logRingOverflow";
+
+// --- Управление темпом клиентов (последняя оценка нагрузки) ---
+const QString FLOW_LEVEL            = "flowLevel";
+const QString FLOW_BACKLOG          = "flowBacklog";
+const QString FLOW_CPU_PERCENT      = "flowCpuPercent";
+const QString FLOW_SEND_INTERVAL    = "flowSendInterval";
+const QString FLOW_SAMPLE_RATIO     = "flowSampleRatio";
+
+// --- Статистика задержек по этапам ---
+const QString LATENCY_STAGE         = "stage";
+const QString LATENCY_COUNT         = "count";
+const QString LATENCY_P50           = "p50";
+const QString LATENCY_P90           = "p90";
+const QString LATENCY_P99           = "p99";
+const QString LATENCY_P999          = "p999";
+const QString LATENCY_MAX           = "max";
 } // namespace Keys
 
 #endif // SHAREDKEYS_H
@@ -0,0 +1,163 @@
+/**
+ * @file spscring.h
+ * @brief Определяет шаблон SpscRing — кольцевой буфер без блокировок для одного писателя и одного читателя.
+ */
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <QList>
+#include <QtGlobal>
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+/**
+ * @class SpscRing
+ * @brief Кольцевой буфер фиксированной емкости для передачи элементов между двумя потоками.
+ *
+ * push() вызывается только из потока-писателя, drain() — только из
+ * потока-читателя. Индексы записи и чтения лежат в разных строках кэша и
+ * публикуются с release/acquire, поэтому мьютексы не нужны. Емкость
+ * округляется вверх до степени двойки. Если буфер заполнен, элемент не
+ * записывается и учитывается в overflowCount(), так что память ограничена
+ * емкостью независимо от того, как быстро читатель разбирает буфер.
+ * pushLatest() записывает пакет так, что при нехватке места отбрасываются
+ * его самые старые элементы, а не новые.
+ */
+template <typename T>
+class SpscRing {
+public:
+    /**
+     * @brief Конструктор класса SpscRing.
+     * @param capacity Минимальная емкость (в элементах).
+     */
+    explicit SpscRing(qsizetype capacity) {
+        qsizetype size = 2;
+        while (size < capacity)
+            size <<= 1;
+        m_mask = quint64(size - 1);
+        m_slots.reset(new T[size]);
+    }
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    /**
+     * @brief Записывает элемент (поток-писатель).
+     * @return false, если буфер заполнен и элемент отброшен.
+     */
+    bool push(T &&value) {
+        const quint64 head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail > m_mask) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail > m_mask) {
+                m_overflows.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        m_slots[head & m_mask] = std::move(value);
+        m_head.store(head + 1, std::memory_order_release);
+        updatePeakDepth(head + 1);
+        return true;
+    }
+
+    /**
+     * @brief Записывает последние элементы пакета, поместившиеся в буфер (поток-писатель).
+     *
+     * Не поместившиеся элементы из начала пакета отбрасываются и учитываются
+     * в overflowCount(): читателю важнее свежие данные.
+     * @param values Пакет в порядке записи; записанные элементы перемещаются.
+     * @return Количество записанных элементов.
+     */
+    qsizetype pushLatest(QList<T> &values) {
+        const quint64 head = m_head.load(std::memory_order_relaxed);
+        m_cachedTail = m_tail.load(std::memory_order_acquire);
+        const qsizetype space = qsizetype(m_mask + 1 - (head - m_cachedTail));
+        const qsizetype skipped = qMax<qsizetype>(0, values.size() - space);
+        if (skipped > 0)
+            m_overflows.fetch_add(quint64(skipped), std::memory_order_relaxed);
+
+        quint64 index = head;
+        for (qsizetype i = skipped; i < values.size(); ++i) {
+            m_slots[index++ & m_mask] = std::move(values[i]);
+        }
+        m_head.store(index, std::memory_order_release);
+        updatePeakDepth(index);
+        return qsizetype(index - head);
+    }
+
+    /**
+     * @brief Забирает все записанные элементы (поток-читатель).
+     * @param out Список, в конец которого добавляются элементы.
+     * @return Количество забранных элементов.
+     */
+    qsizetype drain(QList<T> &out) {
+        const quint64 tail = m_tail.load(std::memory_order_relaxed);
+        const quint64 head = m_head.load(std::memory_order_acquire);
+        if (head == tail)
+            return 0;
+
+        out.reserve(out.size() + qsizetype(head - tail));
+        for (quint64 i = tail; i != head; ++i) {
+            // Слот освобождается сразу, чтобы не держать данные до следующей записи
+            out.append(std::exchange(m_slots[i & m_mask], T()));
+        }
+        m_tail.store(head, std::memory_order_release);
+        return qsizetype(head - tail);
+    }
+
+    /**
+     * @brief Возвращает емкость буфера.
+     */
+    qsizetype capacity() const { return qsizetype(m_mask + 1); }
+    /**
+     * @brief Возвращает текущее количество элементов (из любого потока, приблизительно).
+     */
+    qsizetype depth() const {
+        const quint64 tail = m_tail.load(std::memory_order_acquire);
+        return qsizetype(m_head.load(std::memory_order_acquire) - tail);
+    }
+    /**
+     * @brief Возвращает наибольшее количество элементов, замеченное писателем после записи.
+     */
+    qsizetype peakDepth() const { return qsizetype(m_peakDepth.load(std::memory_order_relaxed)); }
+    /**
+     * @brief Возвращает количество отброшенных из-за переполнения элементов.
+     */
+    quint64 overflowCount() const { return m_overflows.load(std::memory_order_relaxed); }
+
+private:
+    /// @brief Размер строки кэша для разнесения индексов писателя и читателя.
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    /**
+     * @brief Обновляет наибольшую глубину по текущему индексу чтения (поток-писатель).
+     *
+     * Кэшированный индекс чтения обновляется только при заполнении буфера,
+     * поэтому глубина считается по свежему индексу.
+     */
+    void updatePeakDepth(quint64 head) {
+        const quint64 depth = head - m_tail.load(std::memory_order_acquire);
+        if (depth > m_peakDepth.load(std::memory_order_relaxed))
+            m_peakDepth.store(depth, std::memory_order_relaxed);
+    }
+
+    /// @brief Слоты буфера.
+    std::unique_ptr<T[]> m_slots;
+    /// @brief Маска индекса (емкость - 1).
+    quint64 m_mask = 0;
+
+    /// @brief Индекс следующей записи (изменяет писатель).
+    alignas(CACHE_LINE_SIZE) std::atomic<quint64> m_head{0};
+    /// @brief Последний прочитанный писателем индекс чтения.
+    quint64 m_cachedTail = 0;
+    /// @brief Наибольшая замеченная глубина.
+    std::atomic<quint64> m_peakDepth{0};
+    /// @brief Количество отброшенных элементов.
+    std::atomic<quint64> m_overflows{0};
+
+    /// @brief Индекс следующего чтения (изменяет читатель).
+    alignas(CACHE_LINE_SIZE) std::atomic<quint64> m_tail{0};
+};
+
+#endif // SPSCRING_H
@@ -0,0 +1,39 @@
+#include "tcpioworker.h"
+
+#if defined(Q_OS_WIN)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#else
+#include <unistd.h>
+#endif
+
+TcpIoWorker::TcpIoWorker(QObject *parent)
+    : QObject(parent), m_connectionCount(0) {}
+
+TcpClient *TcpIoWorker::createClient(qintptr socketDescriptor) {
+    QTcpSocket *socket = new QTcpSocket();
+    if (!socket->setSocketDescriptor(socketDescriptor)) {
+        delete socket;
+        closeDescriptor(socketDescriptor);
+        --m_connectionCount;
+        return nullptr;
+    }
+
+    TcpClient *client = new TcpClient(socket, this);
+    client->setId(QString::number(client->descriptor()));
+
+    // Освобождаем место в потоке при разрыве соединения
+    connect(client, &TcpClient::disconnected, this,
+            [this] { --m_connectionCount; });
+    return client;
+}
+
+void TcpIoWorker::closeDescriptor(qintptr socketDescriptor) {
+#if defined(Q_OS_WIN)
+    ::closesocket(SOCKET(socketDescriptor));
+#else
+    ::close(int(socketDescriptor));
+#endif
+}
@@ -0,0 +1,67 @@
+/**
+ * @file tcpioworker.h
+ * @brief Определяет класс TcpIoWorker, обслуживающий сокеты в отдельном потоке ввода-вывода.
+ */
+#ifndef TCPIOWORKER_H
+#define TCPIOWORKER_H
+
+#include <QObject>
+
+#include <atomic>
+
+#include "../common/tcpclient.h"
+
+/**
+ * @class TcpIoWorker
+ * @brief Объект-владелец сокетов одного потока ввода-вывода.
+ *
+ * Создает TcpClient по дескриптору принятого подключения в своем потоке,
+ * так что чтение, сборка кадров и запись выполняются вне рабочего потока
+ * обработки данных. Ведет счетчик активных подключений для балансировки.
+ */
+class TcpIoWorker : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Конструктор класса TcpIoWorker.
+     * @param parent Родительский объект QObject.
+     */
+    explicit TcpIoWorker(QObject *parent = nullptr);
+
+    /**
+     * @brief Возвращает количество подключений, закрепленных за потоком.
+     * Потокобезопасен.
+     */
+    int connectionCount() const { return m_connectionCount; }
+    /**
+     * @brief Резервирует место под новое подключение до его фактического создания.
+     *
+     * Вызывается из потока сервера, чтобы серия одновременных подключений
+     * распределялась равномерно, а не попадала в один и тот же поток.
+     */
+    void reserveConnection() { ++m_connectionCount; }
+
+    /**
+     * @brief Создает клиента по дескриптору принятого сокета.
+     * Должен вызываться в потоке этого объекта.
+     * @param socketDescriptor Дескриптор сокета.
+     * @return Указатель на TcpClient или nullptr при ошибке.
+     */
+    TcpClient *createClient(qintptr socketDescriptor);
+
+    /**
+     * @brief Закрывает дескриптор принятого сокета, который не удалось передать QTcpSocket.
+     *
+     * QTcpSocket становится владельцем дескриптора только после успешного
+     * setSocketDescriptor; иначе дескриптор остается открытым.
+     * @param socketDescriptor Дескриптор сокета.
+     */
+    static void closeDescriptor(qintptr socketDescriptor);
+
+private:
+    /// @brief Количество активных (и зарезервированных) подключений.
+    std::atomic<int> m_connectionCount;
+};
+
+#endif // TCPIOWORKER_H
@@ -0,0 +1,62 @@
+/**
+ * @file tcplistener.h
+ * @brief Определяет класс TcpListener, принимающий входящие TCP-подключения в виде дескрипторов.
+ */
+#ifndef TCPLISTENER_H
+#define TCPLISTENER_H
+
+#include <QQueue>
+#include <QTcpServer>
+
+/**
+ * @class TcpListener
+ * @brief Слушающий сокет, который не создает QTcpSocket для принятых подключений.
+ *
+ * QTcpServer по умолчанию создает сокет в своем потоке. TcpListener вместо этого
+ * накапливает дескрипторы принятых подключений, чтобы TcpServer мог создать сокет
+ * в одном из потоков ввода-вывода.
+ */
+class TcpListener : public QTcpServer {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Конструктор класса TcpListener.
+     * @param parent Родительский объект QObject.
+     */
+    explicit TcpListener(QObject *parent = nullptr) : QTcpServer(parent) {}
+
+    /**
+     * @brief Проверяет, есть ли принятые, но еще не обработанные дескрипторы.
+     */
+    bool hasPendingDescriptors() const { return !m_pendingDescriptors.isEmpty(); }
+    /**
+     * @brief Возвращает количество принятых, но еще не обработанных дескрипторов.
+     */
+    qsizetype pendingDescriptorCount() const { return m_pendingDescriptors.size(); }
+    /**
+     * @brief Извлекает очередной дескриптор принятого подключения.
+     * @return Дескриптор сокета.
+     */
+    qintptr nextPendingDescriptor() { return m_pendingDescriptors.dequeue(); }
+    /**
+     * @brief Извлекает дескриптор последнего принятого подключения.
+     */
+    qintptr takeNewestDescriptor() { return m_pendingDescriptors.takeLast(); }
+
+protected:
+    /**
+     * @brief Сохраняет дескриптор нового подключения и уведомляет о нем сигналом newConnection.
+     * @param socketDescriptor Дескриптор принятого сокета.
+     */
+    void incomingConnection(qintptr socketDescriptor) override {
+        m_pendingDescriptors.enqueue(socketDescriptor);
+        emit newConnection();
+    }
+
+private:
+    /// @brief Очередь дескрипторов, ожидающих передачи в потоки ввода-вывода.
+    QQueue<qintptr> m_pendingDescriptors;
+};
+
+#endif // TCPLISTENER_H
@@ -1,95 +1,246 @@
 #include "tcpserver.h"
-#include "../Common/tcpclient.h"
+#include "../common/tcpclient.h"
+#include "../common/messagecodec.h"
+#include "../common/monotonicclock.h"
+#include "../common/protocol.h"
+#include "core/logger.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
 
-TcpServer::TcpServer(QObject *parent) : IServer(parent), m_tcpServer(nullptr) {}
+TcpServer::TcpServer(const ServerSettings &settings, QObject *parent)
+    : IServer(parent), m_settings(settings), m_tcpServer(nullptr),
+    m_acceptLimiter(settings.acceptRatePerSec, settings.acceptBurst),
+    m_acceptTimer(new QTimer(this)) {
+    m_acceptTimer->setSingleShot(true);
+    connect(m_acceptTimer, &QTimer::timeout, this, &TcpServer::handleNewConnection);
+}
 
-TcpServer::~TcpServer() {}
+TcpServer::~TcpServer() { stopIoThreads(); }
 
 int TcpServer::clientCount() const { return m_clients.size(); }
 
-bool TcpServer::isListening() const { return m_tcpServer->isListening(); }
+bool TcpServer::isListening() const {
+    return m_tcpServer && m_tcpServer->isListening();
+}
 
 void TcpServer::startServer(quint16 port) {
     if (m_tcpServer && m_tcpServer->isListening()) {
-        emit logMessage("Сервер уже запущен.");
+        LOG_WARNING(AppEnums::LogCategory::Server, "Сервер уже запущен.");
         return;
     }
 
     if (!m_tcpServer) {
-        m_tcpServer = new QTcpServer(this);
+        m_tcpServer = new TcpListener(this);
         connect(m_tcpServer, &QTcpServer::newConnection, this,
                 &TcpServer::handleNewConnection);
     }
 
     if (!m_tcpServer->listen(QHostAddress::Any, port)) {
-        emit logMessage(
-            QString("Ошибка запуска сервера: %1").arg(m_tcpServer->errorString()));
+        LOG_ERROR(AppEnums::LogCategory::Server,
+                  QString("Ошибка запуска сервера: %1").arg(m_tcpServer->errorString()));
         m_tcpServer->deleteLater();
         m_tcpServer = nullptr;
     } else {
-        emit logMessage(QString("Сервер запущен на порту %1").arg(port));
+        startIoThreads();
+        LOG_INFO(AppEnums::LogCategory::Server,
+                 QString("Сервер запущен на порту %1 (потоков ввода-вывода: %2)")
+                     .arg(port)
+                     .arg(m_ioWorkers.size()));
     }
 }
 
 void TcpServer::stopServer() {
     if (!m_tcpServer || !m_tcpServer->isListening()) {
-        emit logMessage("Сервер уже остановлен.");
+        LOG_WARNING(AppEnums::LogCategory::Server, "Сервер уже остановлен.");
         return;
     }
 
     m_tcpServer->close();
+    m_acceptTimer->stop();
+    while (m_tcpServer->hasPendingDescriptors()) {
+        rejectBusy(m_tcpServer->nextPendingDescriptor(), MIN_RETRY_AFTER_MS);
+    }
     for (TcpClient *client : m_clients) {
         client->disconnect();
     }
     m_clients.clear();
 
-    emit logMessage("Сервер остановлен.");
+    LOG_INFO(AppEnums::LogCategory::Server, "Сервер остановлен.");
+}
+
+void TcpServer::startIoThreads() {
+    if (!m_ioThreads.isEmpty())
+        return;
+
+    for (int i = 0; i < m_settings.ioThreadCount; ++i) {
+        QThread *thread = new QThread(this);
+        thread->setObjectName(QString("TcpIo-%1").arg(i));
+
+        TcpIoWorker *worker = new TcpIoWorker();
+        worker->moveToThread(thread);
+        connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+
+        m_ioThreads.append(thread);
+        m_ioWorkers.append(worker);
+        thread->start();
+    }
+}
+
+void TcpServer::stopIoThreads() {
+    for (QThread *thread : std::as_const(m_ioThreads)) {
+        thread->quit();
+        thread->wait();
+    }
+    qDeleteAll(m_ioThreads);
+    m_ioThreads.clear();
+    m_ioWorkers.clear();
+}
+
+TcpIoWorker *TcpServer::leastLoadedWorker() const {
+    TcpIoWorker *result = nullptr;
+    for (TcpIoWorker *worker : m_ioWorkers) {
+        if (!result || worker->connectionCount() < result->connectionCount()) {
+            result = worker;
+        }
+    }
+    return result;
 }
 
 void TcpServer::handleNewConnection() {
-    while (m_tcpServer->hasPendingConnections()) {
-        QTcpSocket *clientSocket = m_tcpServer->nextPendingConnection();
-        if (!clientSocket) {
-            continue;
+    if (!m_tcpServer)
+        return;
+
+    // Сверх очереди отклоняются самые новые подключения: ожидающие дольше сохраняют место
+    if (m_tcpServer->pendingDescriptorCount() > m_settings.maxPendingAccepts) {
+        const qint64 retryAfter = retryAfterMs();
+        const quint64 rejectedBefore = m_busyRejected;
+        while (m_tcpServer->pendingDescriptorCount() > m_settings.maxPendingAccepts) {
+            rejectBusy(m_tcpServer->takeNewestDescriptor(), retryAfter);
         }
+        LOG_SAMPLED(AppEnums::LogLevel::Warning, AppEnums::LogCategory::Network, 10,
+                    QString("Очередь приема переполнена: отклонено %1 подключений (всего %2), пауза %3 мс")
+                        .arg(m_busyRejected - rejectedBefore)
+                        .arg(m_busyRejected)
+                        .arg(retryAfter));
+    }
 
-        TcpClient *client = new TcpClient(clientSocket, this);
-        quintptr descriptor = client->descriptor();
-        client->setId(QString::number(descriptor));
+    // Место освободится только после чьего-то отключения: ожидающим сразу отвечаем Busy
+    if (isFull() && m_tcpServer->hasPendingDescriptors()) {
+        const quint64 rejectedBefore = m_fullRejected;
+        while (m_tcpServer->hasPendingDescriptors()) {
+            rejectBusy(m_tcpServer->nextPendingDescriptor(), FULL_RETRY_AFTER_MS);
+            ++m_fullRejected;
+        }
+        LOG_SAMPLED(AppEnums::LogLevel::Warning, AppEnums::LogCategory::Network, 10,
+                    QString("Достигнут предел подключений (%1): отклонено %2 подключений (всего %3)")
+                        .arg(m_settings.maxConnections)
+                        .arg(m_fullRejected - rejectedBefore)
+                        .arg(m_fullRejected));
+        return;
+    }
 
-        m_clients.insert(descriptor, client);
+    const qint64 nowNs = MonotonicClock::nowNs();
+    while (m_tcpServer->hasPendingDescriptors() && !isFull() && m_acceptLimiter.tryTake(nowNs)) {
+        dispatchDescriptor(m_tcpServer->nextPendingDescriptor());
+    }
+
+    // Остальные ждут в очереди, пока корзина не пополнится
+    if (m_tcpServer->hasPendingDescriptors() && !m_acceptTimer->isActive()) {
+        const qint64 waitNs = m_acceptLimiter.nsUntilAvailable(nowNs);
+        m_acceptTimer->start(int(qMax<qint64>(1, (waitNs + 999999) / 1000000)));
+    }
+}
+
+qint64 TcpServer::retryAfterMs() const {
+    if (m_acceptLimiter.isUnlimited())
+        return MIN_RETRY_AFTER_MS;
+    // Время, за которое разойдется текущая очередь, — раньше подключаться бессмысленно
+    const qint64 drainMs = qint64(1000.0 * m_tcpServer->pendingDescriptorCount() / m_acceptLimiter.rate());
+    return qBound(MIN_RETRY_AFTER_MS, MIN_RETRY_AFTER_MS + drainMs, MAX_RETRY_AFTER_MS);
+}
+
+bool TcpServer::isFull() const {
+    if (m_settings.maxConnections <= 0)
+        return false;
+    int connections = 0;
+    for (const TcpIoWorker *worker : m_ioWorkers) {
+        connections += worker->connectionCount();
+    }
+    return connections >= m_settings.maxConnections;
+}
+
+void TcpServer::rejectBusy(qintptr descriptor, qint64 retryAfterMs) {
+    ++m_busyRejected;
+
+    // Отказ обходится без TcpClient и потоков ввода-вывода. Сообщение уходит в JSON
+    // без префикса: клиент еще не согласовал формат, а такой ответ понимают все версии.
+    QTcpSocket *socket = new QTcpSocket(this);
+    if (!socket->setSocketDescriptor(descriptor)) {
+        TcpIoWorker::closeDescriptor(descriptor);
+        socket->deleteLater();
+        return;
+    }
+    connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+
+    QJsonObject busy;
+    busy[Protocol::Keys::TYPE] = Protocol::MessageType::BUSY;
+    busy[Protocol::Keys::RETRY_AFTER] = retryAfterMs;
+    socket->write(MessageCodec::encode(busy, MessageCodec::Encoding::Json));
+    socket->disconnectFromHost();
+}
+
+void TcpServer::dispatchDescriptor(qintptr descriptor) {
+    TcpIoWorker *worker = leastLoadedWorker();
+    worker->reserveConnection();
+
+    // Сокет создается в потоке ввода-вывода. Сигналы клиента подключаются там же,
+    // до возврата в цикл событий, поэтому первые данные не теряются, а
+    // attachClient гарантированно выполняется раньше их обработки.
+    QMetaObject::invokeMethod(worker, [this, worker, descriptor] {
+        TcpClient *client = worker->createClient(descriptor);
+        if (!client) {
+            return;
+        }
 
         connect(client, &TcpClient::dataReceived, this,
                 &TcpServer::handleDataReceived);
         connect(client, &TcpClient::disconnected, this,
                 &TcpServer::handleClientDisconnected);
 
-        emit clientConnected(client);
-        emit logMessage(QString("Новый клиент подключен: %1").arg(client->id()));
-    }
+        QMetaObject::invokeMethod(this, [this, client] { attachClient(client); },
+                                  Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
+
+void TcpServer::attachClient(TcpClient *client) {
+    client->setSlowConsumerPolicy(m_settings.slowConsumerPolicy, m_settings.maxSendQueueBytes);
+    m_clients.insert(client->descriptor(), client);
+
+    emit clientConnected(client);
+    LOG_INFO(AppEnums::LogCategory::Network, QString("Новый клиент подключен: %1").arg(client->id()));
 }
 
-void TcpServer::handleDataReceived(const QByteArray &data) {
+void TcpServer::handleDataReceived(const QByteArray &data, qint64 receivedAtNs) {
     TcpClient *client = qobject_cast<TcpClient *>(sender());
     if (!client) {
-        emit logMessage("Неизвестный отправитель сигнала.");
+        LOG_WARNING(AppEnums::LogCategory::Network, "Неизвестный отправитель сигнала.");
         return;
     }
 
-    emit dataReceived(client, data);
-    emit logMessage(QString("Получены данные от клиента %1").arg(client->id()));
+    emit dataReceived(client, data, receivedAtNs);
+    // Горячий путь: при выключенном DEBUG стоит одной проверки уровня
+    LOG_SAMPLED(AppEnums::LogLevel::Debug, AppEnums::LogCategory::Network, 100,
+                QString("Получены данные от клиента %1").arg(client->id()));
 }
 
 void TcpServer::handleClientDisconnected() {
     TcpClient *client = qobject_cast<TcpClient *>(sender());
     if (client) {
         emit clientDisconnected(client);
-        emit logMessage(QString("Клиент отключен: %1").arg(client->id()));
+        LOG_INFO(AppEnums::LogCategory::Network, QString("Клиент отключен: %1").arg(client->id()));
     } else {
-        emit logMessage("Невозможно определить отключившегося клиента.");
+        LOG_WARNING(AppEnums::LogCategory::Network, "Невозможно определить отключившегося клиента.");
     }
 }
 
@@ -99,19 +250,22 @@ void TcpServer::removeClient(IClient *client) {
 
     quintptr descriptor = client->descriptor();
 
-    if (m_clients.contains(descriptor)) {
-        m_clients.remove(descriptor);
-        client->deleteLater();
-        emit logMessage(
-            QString("Объект клиента %1 полностью удален.").arg(descriptor));
+    // Дескриптор мог быть переиспользован новым подключением
+    auto it = m_clients.find(descriptor);
+    if (it != m_clients.end() && it.value() == client) {
+        m_clients.erase(it);
     }
+    client->deleteLater();
+    LOG_DEBUG(AppEnums::LogCategory::Network,
+              QString("Объект клиента %1 полностью удален.").arg(descriptor));
 }
 
-void TcpServer::sendToClient(IClient *client, const QByteArray &data) {
+void TcpServer::sendToClient(IClient *client, const QByteArray &data,
+                             const QString &coalesceKey) {
     if (!client || !client->isConnected()) {
-        emit logMessage("Клиент не найден или не подключен.");
+        LOG_WARNING(AppEnums::LogCategory::Network, "Клиент не найден или не подключен.");
         return;
     }
 
-    client->sendData(data);
+    client->sendData(data, coalesceKey);
 }
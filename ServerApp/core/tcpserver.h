@@ -12,26 +12,49 @@
 #include <QObject>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
 
 #include "../common/tcpclient.h"
 #include "core/iserver.h"
+#include "core/serversettings.h"
+#include "core/tcpioworker.h"
+#include "core/tcplistener.h"
+#include "core/tokenbucket.h"
 
 /**
  * @class TcpServer
  * @brief Реализация интерфейса IServer для TCP-сервера.
  *
- * Управляет QTcpServer и обрабатывает TCP-подключения, создавая
- * для каждого из них объект TcpClient.
+ * Управляет слушающим сокетом и обрабатывает TCP-подключения, создавая
+ * для каждого из них объект TcpClient. Сокеты распределяются между пулом
+ * потоков ввода-вывода по наименьшему числу подключений, поэтому прием,
+ * чтение и сборка сообщений масштабируются по ядрам.
+ *
+ * Прием ограничен корзиной маркеров (ServerSettings::acceptRatePerSec):
+ * при массовом переподключении подключения сверх темпа ждут в очереди
+ * TcpListener, а сверх ServerSettings::maxPendingAccepts получают Busy
+ * с рекомендуемой паузой и отключаются, не доходя до потоков ввода-вывода.
+ * Так же отклоняются подключения сверх ServerSettings::maxConnections.
  */
 class TcpServer : public IServer {
     Q_OBJECT
 
 public:
+    /// @brief Наименьшая пауза, рекомендуемая клиенту в Busy (мс).
+    static constexpr qint64 MIN_RETRY_AFTER_MS = 1000;
+    /// @brief Наибольшая пауза, рекомендуемая клиенту в Busy (мс).
+    static constexpr qint64 MAX_RETRY_AFTER_MS = 60000;
+    /// @brief Пауза, рекомендуемая клиенту при достижении предела подключений (мс).
+    static constexpr qint64 FULL_RETRY_AFTER_MS = 10000;
+
     /**
      * @brief Конструктор класса TcpServer.
+     * @param settings Параметры сервера (количество потоков ввода-вывода).
      * @param parent Родительский объект QObject.
      */
-    explicit TcpServer(QObject *parent = nullptr);
+    explicit TcpServer(const ServerSettings &settings = ServerSettings(),
+                       QObject *parent = nullptr);
     /**
      * @brief Деструктор класса TcpServer.
      */
@@ -47,6 +70,10 @@ public:
      * @return true, если сервер активен, иначе false.
      */
     bool isListening() const override;
+    /**
+     * @brief Возвращает ServerSettings::idleTimeoutMs.
+     */
+    int idleTimeoutMs() const override { return m_settings.idleTimeoutMs; }
 
 public slots:
     /**
@@ -63,8 +90,10 @@ public slots:
      * @brief Отправляет данные указанному TCP-клиенту.
      * @param client Указатель на клиента (должен быть TcpClient).
      * @param data Данные для отправки.
+     * @param coalesceKey Ключ замещения неотправленного сообщения.
      */
-    void sendToClient(IClient *client, const QByteArray &data) override;
+    void sendToClient(IClient *client, const QByteArray &data,
+                      const QString &coalesceKey = QString()) override;
     /**
      * @brief Удаляет TCP-клиента с сервера.
      * @param client Указатель на клиента для удаления.
@@ -73,7 +102,7 @@ public slots:
 
 private slots:
     /**
-     * @brief Обрабатывает новое входящее TCP-подключение.
+     * @brief Передает принятые дескрипторы в наименее загруженные потоки ввода-вывода.
      */
     void handleNewConnection() override;
     /**
@@ -83,14 +112,67 @@ private slots:
     /**
      * @brief Обрабатывает данные, полученные от TCP-клиента.
      * @param data Полученные данные.
+     * @param receivedAtNs Время чтения данных из сокета.
      */
-    void handleDataReceived(const QByteArray &data) override;
+    void handleDataReceived(const QByteArray &data, qint64 receivedAtNs) override;
 
 private:
-    /// @brief Указатель на основной объект QTcpServer.
-    QTcpServer *m_tcpServer;
+    /**
+     * @brief Создает и запускает потоки ввода-вывода, если они еще не созданы.
+     */
+    void startIoThreads();
+    /**
+     * @brief Останавливает потоки ввода-вывода и дожидается их завершения.
+     */
+    void stopIoThreads();
+    /**
+     * @brief Возвращает поток ввода-вывода с наименьшим числом подключений.
+     */
+    TcpIoWorker *leastLoadedWorker() const;
+    /**
+     * @brief Регистрирует созданного в потоке ввода-вывода клиента на сервере.
+     * @param client Указатель на клиента.
+     */
+    void attachClient(TcpClient *client);
+    /**
+     * @brief Передает принятый дескриптор в наименее загруженный поток ввода-вывода.
+     */
+    void dispatchDescriptor(qintptr descriptor);
+    /**
+     * @brief Отправляет Busy без кадрирования и закрывает подключение.
+     * @param descriptor Дескриптор принятого сокета.
+     * @param retryAfterMs Рекомендуемая пауза перед переподключением.
+     */
+    void rejectBusy(qintptr descriptor, qint64 retryAfterMs);
+    /**
+     * @brief Оценивает паузу, за которую очередь приема успеет разойтись.
+     */
+    qint64 retryAfterMs() const;
+    /**
+     * @brief Возвращает true, если достигнут предел одновременных подключений.
+     *
+     * Учитываются и подключения, переданные в потоки ввода-вывода, но еще не созданные.
+     */
+    bool isFull() const;
+
+    /// @brief Параметры сервера.
+    ServerSettings m_settings;
+    /// @brief Указатель на слушающий сокет.
+    TcpListener *m_tcpServer;
+    /// @brief Потоки ввода-вывода.
+    QList<QThread *> m_ioThreads;
+    /// @brief Объекты-владельцы сокетов, по одному на поток ввода-вывода.
+    QList<TcpIoWorker *> m_ioWorkers;
     /// @brief Хеш-таблица для хранения подключенных клиентов по их дескрипторам.
     QHash<quintptr, TcpClient *> m_clients;
+    /// @brief Ограничитель темпа приема подключений.
+    TokenBucket m_acceptLimiter;
+    /// @brief Таймер возобновления приема, когда появятся маркеры.
+    QTimer *m_acceptTimer;
+    /// @brief Количество подключений, отклоненных сообщением Busy.
+    quint64 m_busyRejected = 0;
+    /// @brief Количество подключений, отклоненных из-за предела подключений.
+    quint64 m_fullRejected = 0;
 };
 
 #endif // TCPSERVER_H
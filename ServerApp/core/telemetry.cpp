@@ -0,0 +1,53 @@
+#include "telemetry.h"
+#include "../common/protocol.h"
+
+#include <QCborValue>
+#include <QStringList>
+
+namespace {
+// Старые клиенты передают числа строками
+double toNumber(const QCborValue &value) {
+    return value.isString() ? value.toString().toDouble() : value.toDouble();
+}
+} // namespace
+
+TelemetryRecord TelemetryRecord::fromPayload(const QString &type, const QCborMap &payload) {
+    TelemetryRecord record;
+    record.type = type;
+
+    if (type == Protocol::MessageType::NETWORK_METRICS) {
+        NetworkMetricsSample sample;
+        sample.bandWidth    = toNumber(payload.value(Protocol::Keys::BAND_WIDTH));
+        sample.latency      = toNumber(payload.value(Protocol::Keys::LATENCY));
+        sample.packetLoss   = toNumber(payload.value(Protocol::Keys::PACKET_LOSS));
+        record.payload = sample;
+    } else if (type == Protocol::MessageType::DEVICE_STATUS) {
+        DeviceStatusSample sample;
+        sample.upTime       = static_cast<qint64>(toNumber(payload.value(Protocol::Keys::UP_TIME)));
+        sample.cpuUsage     = toNumber(payload.value(Protocol::Keys::CPU_USAGE));
+        sample.memoryUsage  = toNumber(payload.value(Protocol::Keys::MEMORY_USAGE));
+        sample.cpuTemp      = toNumber(payload.value(Protocol::Keys::CPU_TEMP));
+        record.payload = sample;
+    } else if (type == Protocol::MessageType::LOG) {
+        LogRecord log;
+        log.severity        = payload.value(Protocol::Keys::SEVERITY).toString();
+        log.message         = payload.value(Protocol::Keys::MESSAGE).toString();
+        log.junk            = payload.value(Protocol::Keys::JUNK).toString();
+        record.payload = log;
+    } else {
+        // Редкие типы сообщений приводятся к тексту один раз при разборе
+        QStringList items;
+        for (auto it = payload.constBegin(); it != payload.constEnd(); ++it) {
+            items << QString("%1: %2").arg(it.key().toString(),
+                                           it.value().toVariant().toString());
+        }
+        record.payload = GenericPayload{items.join(", ")};
+    }
+    return record;
+}
+
+void TelemetryRecord::readEnvelope(const QCborMap &message) {
+    sequence = quint64(qMax<qint64>(0, message.value(Protocol::Keys::SEQUENCE).toInteger()));
+    // Время отправки передается в микросекундах
+    stages.sent = qMax<qint64>(0, message.value(Protocol::Keys::SENT_AT).toInteger()) * 1000;
+}
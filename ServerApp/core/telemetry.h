@@ -0,0 +1,102 @@
+/**
+ * @file telemetry.h
+ * @brief Определяет типизированные записи телеметрии, передаваемые от парсера в модель данных.
+ */
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <QCborMap>
+#include <QList>
+#include <QMetaType>
+#include <QString>
+
+#include <variant>
+
+/**
+ * @struct NetworkMetricsSample
+ * @brief Метрики сети (сообщение NetworkMetrics).
+ */
+struct NetworkMetricsSample {
+    double bandWidth = 0.0;     ///< Пропускная способность
+    double latency = 0.0;       ///< Задержка
+    double packetLoss = 0.0;    ///< Потеря пакетов
+};
+
+/**
+ * @struct DeviceStatusSample
+ * @brief Статус устройства (сообщение DeviceStatus).
+ */
+struct DeviceStatusSample {
+    qint64 upTime = 0;          ///< Время работы
+    double cpuUsage = 0.0;      ///< Загрузка процессора (%)
+    double memoryUsage = 0.0;   ///< Загрузка памяти (%)
+    double cpuTemp = 0.0;       ///< Температура процессора
+};
+
+/**
+ * @struct LogRecord
+ * @brief Лог-сообщение устройства (сообщение Log).
+ */
+struct LogRecord {
+    QString severity;           ///< Уровень критичности
+    QString message;            ///< Текст сообщения
+    QString junk;               ///< Дополнительные данные
+};
+
+/**
+ * @struct GenericPayload
+ * @brief Полезная нагрузка сообщений прочих типов, заранее приведенная к тексту.
+ */
+struct GenericPayload {
+    QString text;               ///< Текстовое представление полезной нагрузки
+};
+
+/**
+ * @struct TelemetryRecord
+ * @brief Одна запись таблицы данных: заголовок сообщения и типизированная нагрузка.
+ *
+ * Запись проходит путь от DataProcessing до DataTableModel без QVariant:
+ * QVariant создается только в DataTableModel::data() на границе с QML.
+ */
+struct TelemetryRecord {
+    /// @brief Типизированная полезная нагрузка.
+    using Payload = std::variant<NetworkMetricsSample, DeviceStatusSample, LogRecord, GenericPayload>;
+
+    qint64 timestamp = 0;       ///< Время получения сообщения сервером (мс от эпохи UTC)
+    QString clientId;           ///< ID клиента-отправителя
+    QString type;               ///< Тип сообщения (Protocol::MessageType)
+    Payload payload;            ///< Полезная нагрузка
+    quint64 sequence = 0;       ///< Номер сообщения у клиента (0 — не передан)
+
+    /**
+     * @struct StageTimes
+     * @brief Отметки прохождения этапов конвейера приема (MonotonicClock, нс).
+     */
+    struct StageTimes {
+        qint64 sent = 0;            ///< Отправка клиентом в часах сервера (0 — не передана)
+        qint64 received = 0;        ///< Чтение из сокета
+        qint64 parseStarted = 0;    ///< Начало разбора в рабочем потоке
+        qint64 parsed = 0;          ///< Конец разбора, запись добавлена в пакет
+        qint64 flushed = 0;         ///< Пакет забран для отправки в UI
+    };
+    StageTimes stages;          ///< Отметки этапов для статистики задержек
+
+    /**
+     * @brief Разбирает полезную нагрузку сообщения в типизированную запись.
+     *
+     * Числовые поля принимаются как числами, так и строками (старые клиенты).
+     * @param type Тип сообщения.
+     * @param payload Полезная нагрузка.
+     * @return Запись с заполненными полями type и payload.
+     */
+    static TelemetryRecord fromPayload(const QString &type, const QCborMap &payload);
+    /**
+     * @brief Заполняет номер сообщения и время отправки из заголовка сообщения.
+     * @param message Сообщение целиком (Keys::SEQUENCE и Keys::SENT_AT).
+     */
+    void readEnvelope(const QCborMap &message);
+};
+
+Q_DECLARE_METATYPE(TelemetryRecord)
+
+#endif // TELEMETRY_H
@@ -0,0 +1,52 @@
+#include "timingwheel.h"
+
+TimingWheel::TimingWheel(qint64 tickNs, int slotCount)
+    : m_tickNs(qMax<qint64>(1, tickNs)), m_slots(qMax(1, slotCount)) {}
+
+void TimingWheel::schedule(quintptr key, qint64 deadlineNs) {
+    cancel(key);
+
+    // Прошедший срок кладется в ближайшую необработанную ячейку
+    const qint64 tick = qMax(deadlineNs / m_tickNs, m_currentTick + 1);
+    slotFor(tick).insert(key);
+    m_deadlines.insert(key, deadlineNs);
+}
+
+void TimingWheel::cancel(quintptr key) {
+    const auto it = m_deadlines.constFind(key);
+    if (it == m_deadlines.constEnd())
+        return;
+    slotFor(qMax(it.value() / m_tickNs, m_currentTick + 1)).remove(key);
+    m_deadlines.erase(it);
+}
+
+void TimingWheel::clear() {
+    for (QSet<quintptr> &slot : m_slots) {
+        slot.clear();
+    }
+    m_deadlines.clear();
+}
+
+QList<quintptr> TimingWheel::advance(qint64 nowNs) {
+    QList<quintptr> expired;
+    const qint64 nowTick = nowNs / m_tickNs;
+    // После долгой паузы (и при первом вызове) достаточно одного оборота:
+    // каждая ячейка проверяется один раз
+    const qint64 firstTick = qMax(m_currentTick + 1, nowTick - m_slots.size() + 1);
+    for (qint64 tick = firstTick; tick <= nowTick; ++tick) {
+        QSet<quintptr> &slot = slotFor(tick);
+        for (auto it = slot.begin(); it != slot.end();) {
+            // В ячейке лежат и сроки следующих оборотов
+            const qint64 deadlineNs = m_deadlines.value(*it);
+            if (deadlineNs / m_tickNs <= nowTick) {
+                expired.append(*it);
+                m_deadlines.remove(*it);
+                it = slot.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    m_currentTick = qMax(m_currentTick, nowTick);
+    return expired;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file timingwheel.h
+ * @brief Определяет класс TimingWheel — хешированное колесо таймеров.
+ */
+#ifndef TIMINGWHEEL_H
+#define TIMINGWHEEL_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+
+/**
+ * @class TimingWheel
+ * @brief Хешированное колесо таймеров: сроки множества ключей без отдельного таймера на каждый.
+ *
+ * Срок попадает в ячейку (срок / шаг) % количество ячеек. Ячейка хранит
+ * ключи, а индекс ключ → срок позволяет назначить, перенести или отменить
+ * срок за O(1). advance() проходит ячейки, время которых наступило с
+ * прошлого вызова, и возвращает ключи с истекшим сроком; сроки дальше
+ * одного оборота колеса остаются в ячейке до своего оборота. Точность
+ * срока — один шаг. У ключа не больше одного срока.
+ *
+ * Не потокобезопасен: используется в потоке владельца.
+ */
+class TimingWheel {
+public:
+    /**
+     * @brief Конструктор класса TimingWheel.
+     * @param tickNs Шаг колеса (нс).
+     * @param slotCount Количество ячеек; оборот колеса — tickNs * slotCount.
+     */
+    TimingWheel(qint64 tickNs, int slotCount);
+
+    /**
+     * @brief Назначает или переносит срок ключа.
+     * @param key Ключ.
+     * @param deadlineNs Срок (MonotonicClock); прошедший срок истечет при следующем advance().
+     */
+    void schedule(quintptr key, qint64 deadlineNs);
+    /**
+     * @brief Отменяет срок ключа, если он назначен.
+     */
+    void cancel(quintptr key);
+    /**
+     * @brief Проверяет, назначен ли срок ключу.
+     */
+    bool contains(quintptr key) const { return m_deadlines.contains(key); }
+    /**
+     * @brief Возвращает количество назначенных сроков.
+     */
+    int size() const { return int(m_deadlines.size()); }
+    /**
+     * @brief Удаляет все сроки.
+     */
+    void clear();
+
+    /**
+     * @brief Продвигает колесо до указанного времени.
+     * @param nowNs Текущее время (MonotonicClock).
+     * @return Ключи, срок которых истек; их сроки удаляются.
+     */
+    QList<quintptr> advance(qint64 nowNs);
+
+private:
+    /**
+     * @brief Возвращает ячейку для номера шага.
+     */
+    QSet<quintptr> &slotFor(qint64 tick) { return m_slots[int(tick % m_slots.size())]; }
+
+    /// @brief Шаг колеса (нс).
+    qint64 m_tickNs;
+    /// @brief Ячейки с ключами.
+    QList<QSet<quintptr>> m_slots;
+    /// @brief Сроки ключей.
+    QHash<quintptr, qint64> m_deadlines;
+    /// @brief Последний обработанный шаг (-1 — колесо еще не продвигалось).
+    qint64 m_currentTick = -1;
+};
+
+#endif // TIMINGWHEEL_H
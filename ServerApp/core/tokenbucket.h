@@ -0,0 +1,94 @@
+/**
+ * @file tokenbucket.h
+ * @brief Определяет класс TokenBucket — ограничитель темпа по алгоритму корзины маркеров.
+ */
+#ifndef TOKENBUCKET_H
+#define TOKENBUCKET_H
+
+#include <QtGlobal>
+
+#include <cmath>
+
+/**
+ * @class TokenBucket
+ * @brief Корзина маркеров: не больше rate событий в секунду при всплеске до burst.
+ *
+ * Маркеры начисляются по монотонному времени при каждом обращении, поэтому
+ * таймер для пополнения не нужен. Нулевой темп означает отсутствие ограничения.
+ * Не потокобезопасен: используется в потоке владельца.
+ */
+class TokenBucket {
+public:
+    /**
+     * @brief Конструктор класса TokenBucket.
+     * @param ratePerSec Темп пополнения (маркеров в секунду, 0 — без ограничения).
+     * @param burst Емкость корзины; корзина создается полной.
+     */
+    explicit TokenBucket(double ratePerSec = 0.0, double burst = 1.0)
+        : m_rate(qMax(0.0, ratePerSec)), m_burst(qMax(1.0, burst)), m_tokens(m_burst) {}
+
+    /**
+     * @brief Возвращает true, если темп не ограничен.
+     */
+    bool isUnlimited() const { return m_rate <= 0.0; }
+
+    /**
+     * @brief Забирает маркеры, если их достаточно.
+     * @param nowNs Текущее время (MonotonicClock).
+     * @param count Количество маркеров.
+     * @return true, если маркеры забраны.
+     */
+    bool tryTake(qint64 nowNs, double count = 1.0) {
+        if (isUnlimited())
+            return true;
+        refill(nowNs);
+        if (m_tokens < count)
+            return false;
+        m_tokens -= count;
+        return true;
+    }
+
+    /**
+     * @brief Возвращает время до появления нужного количества маркеров (нс, 0 — уже есть).
+     * @param nowNs Текущее время (MonotonicClock).
+     * @param count Количество маркеров.
+     */
+    qint64 nsUntilAvailable(qint64 nowNs, double count = 1.0) {
+        if (isUnlimited())
+            return 0;
+        refill(nowNs);
+        if (m_tokens >= count)
+            return 0;
+        return qint64(std::ceil((count - m_tokens) / m_rate * 1e9));
+    }
+
+    /**
+     * @brief Возвращает текущее количество маркеров.
+     * @param nowNs Текущее время (MonotonicClock).
+     */
+    double tokens(qint64 nowNs) const {
+        if (m_lastNs == 0 || nowNs <= m_lastNs)
+            return m_tokens;
+        return qMin(m_burst, m_tokens + (nowNs - m_lastNs) * m_rate / 1e9);
+    }
+
+    double rate() const { return m_rate; }
+    double burst() const { return m_burst; }
+
+private:
+    /**
+     * @brief Начисляет маркеры за время с предыдущего обращения.
+     */
+    void refill(qint64 nowNs) {
+        if (m_lastNs != 0 && nowNs > m_lastNs)
+            m_tokens = qMin(m_burst, m_tokens + (nowNs - m_lastNs) * m_rate / 1e9);
+        m_lastNs = qMax(m_lastNs, nowNs);
+    }
+
+    double m_rate;
+    double m_burst;
+    double m_tokens;
+    qint64 m_lastNs = 0;
+};
+
+#endif // TOKENBUCKET_H
@@ -0,0 +1,72 @@
+#include "udpclient.h"
+#include "core/clientdescriptor.h"
+
+UdpClient::UdpClient(QUdpSocket *socket, const QHostAddress &address, quint16 port,
+                     QObject *parent)
+    : IClient(parent), m_socket(socket), m_address(address), m_port(port),
+    m_descriptor(ClientDescriptor::allocate()) {
+    m_id = QString::number(m_descriptor);
+}
+
+void UdpClient::sendData(const QByteArray &data) {
+    sendData(data, QString());
+}
+
+void UdpClient::sendData(const QByteArray &data, const QString &coalesceKey) {
+    Q_UNUSED(coalesceKey)
+    if (!m_connected || !m_socket)
+        return;
+
+    const QByteArray datagram =
+        m_framingMode == FramingMode::LengthPrefixed ? MessageFramer::encode(data) : data;
+    if (m_socket->writeDatagram(datagram, m_address, m_port) != datagram.size()) {
+        ++m_droppedMessages;
+    }
+}
+
+void UdpClient::setSlowConsumerPolicy(SlowConsumerPolicy policy, qint64 maxQueuedBytes) {
+    Q_UNUSED(policy)
+    Q_UNUSED(maxQueuedBytes)
+}
+
+void UdpClient::connectToHost(const QString &host, quint16 port) {
+    Q_UNUSED(host)
+    Q_UNUSED(port)
+    emit errorOccurred("UDP-клиент создается сервером и не подключается сам.");
+}
+
+void UdpClient::disconnect() {
+    if (m_connected) {
+        handleDisconnected();
+    }
+}
+
+void UdpClient::deliver(const QByteArray &datagram, qint64 receivedAtNs) {
+    m_lastSeenNs = receivedAtNs;
+
+    if (m_framingMode == FramingMode::Raw) {
+        emit dataReceived(datagram, receivedAtNs);
+        return;
+    }
+
+    // Кадры не переходят через границу датаграммы: остаток отбрасывается
+    m_framer.append(datagram);
+    QByteArray message;
+    while (m_framer.takeMessage(message)) {
+        emit dataReceived(message, receivedAtNs);
+    }
+    if (m_framer.hasError() || m_framer.pendingBytes() > 0) {
+        emit errorOccurred("Датаграмма содержит неполный или недопустимый кадр.");
+    }
+    m_framer.clear();
+}
+
+void UdpClient::handleConnected() {}
+
+void UdpClient::handleDisconnected() {
+    m_connected = false;
+    m_framingMode = FramingMode::Raw;
+    emit disconnected();
+}
+
+void UdpClient::handleReadyRead() {}
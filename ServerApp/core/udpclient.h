@@ -0,0 +1,157 @@
+/**
+ * @file udpclient.h
+ * @brief Определяет класс UdpClient — синтетического клиента UDP-сервера.
+ */
+#ifndef UDPCLIENT_H
+#define UDPCLIENT_H
+
+#include <QHostAddress>
+#include <QUdpSocket>
+
+#include <atomic>
+
+#include "../common/iclient.h"
+#include "../common/messageframer.h"
+
+/**
+ * @class UdpClient
+ * @brief Реализация интерфейса IClient для отправителя UDP-датаграмм.
+ *
+ * У UDP нет соединений, поэтому клиентом считается пара "адрес:порт"
+ * отправителя. Объект создается UdpServer при первой датаграмме от нового
+ * адреса и отправляет ответы через общий сокет сервера. Каждая датаграмма
+ * содержит целые сообщения: в режиме LengthPrefixed она может нести
+ * несколько кадров, но кадр не может продолжаться в следующей датаграмме.
+ *
+ * Очереди отправки нет: датаграмма, которую не удалось записать в сокет,
+ * отбрасывается и учитывается в droppedMessages(). Все методы вызываются в
+ * потоке сервера.
+ */
+class UdpClient : public IClient {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Конструктор класса UdpClient.
+     * @param socket Сокет сервера, через который отправляются ответы.
+     * @param address Адрес отправителя.
+     * @param port Порт отправителя.
+     * @param parent Родительский объект QObject.
+     */
+    UdpClient(QUdpSocket *socket, const QHostAddress &address, quint16 port,
+              QObject *parent = nullptr);
+
+    /**
+     * @brief Возвращает синтетический дескриптор, уникальный в пределах процесса.
+     */
+    quintptr descriptor() const override { return m_descriptor; }
+    /**
+     * @brief Возвращает IP-адрес отправителя.
+     */
+    QString address() const override { return m_address.toString(); }
+    /**
+     * @brief Возвращает порт отправителя.
+     */
+    quint16 port() const override { return m_port; }
+    /**
+     * @brief Возвращает ID клиента.
+     */
+    QString id() const override { return m_id; }
+    /**
+     * @brief Проверяет, считается ли отправитель активным.
+     */
+    bool isConnected() const override { return m_connected; }
+    /**
+     * @brief Возвращает текущий режим кадрирования.
+     */
+    FramingMode framingMode() const override { return m_framingMode; }
+
+    /**
+     * @brief Устанавливает ID клиента.
+     */
+    void setId(const QString &id) override { m_id = id; }
+    /**
+     * @brief Устанавливает режим кадрирования датаграмм.
+     */
+    void setFramingMode(FramingMode mode) override { m_framingMode = mode; }
+
+    /**
+     * @brief Отправляет данные одной датаграммой.
+     * @param data Данные для отправки.
+     */
+    void sendData(const QByteArray &data) override;
+    /**
+     * @brief Отправляет данные; ключ замещения не используется, так как очереди нет.
+     */
+    void sendData(const QByteArray &data, const QString &coalesceKey) override;
+    /**
+     * @brief Возвращает 0: датаграммы не копятся в очереди.
+     */
+    qint64 queuedBytes() const override { return 0; }
+    /**
+     * @brief Возвращает количество датаграмм, которые не удалось отправить.
+     */
+    quint64 droppedMessages() const override { return m_droppedMessages; }
+    /**
+     * @brief Не используется: у UDP-клиента нет очереди отправки.
+     */
+    void setSlowConsumerPolicy(SlowConsumerPolicy policy, qint64 maxQueuedBytes) override;
+
+    /**
+     * @brief Не поддерживается: клиент создается сервером по входящей датаграмме.
+     */
+    void connectToHost(const QString &host, quint16 port) override;
+    /**
+     * @brief Помечает отправителя как отключенного.
+     */
+    void disconnect() override;
+
+    /**
+     * @brief Передает клиенту содержимое полученной от него датаграммы.
+     * @param datagram Данные датаграммы.
+     * @param receivedAtNs Время чтения датаграммы из сокета.
+     */
+    void deliver(const QByteArray &datagram, qint64 receivedAtNs);
+    /**
+     * @brief Возвращает время последней датаграммы от отправителя (MonotonicClock::nowNs()).
+     */
+    qint64 lastSeenNs() const { return m_lastSeenNs; }
+
+private slots:
+    /**
+     * @brief Не используется: у UDP нет установления соединения.
+     */
+    void handleConnected() override;
+    /**
+     * @brief Помечает клиента отключенным и испускает disconnected().
+     */
+    void handleDisconnected() override;
+    /**
+     * @brief Не используется: датаграммы читает сервер и передает через deliver().
+     */
+    void handleReadyRead() override;
+
+private:
+    /// @brief Сокет сервера.
+    QUdpSocket *m_socket;
+    /// @brief Адрес отправителя.
+    QHostAddress m_address;
+    /// @brief Порт отправителя.
+    quint16 m_port;
+    /// @brief Синтетический дескриптор.
+    quintptr m_descriptor;
+    /// @brief Строковый идентификатор клиента.
+    QString m_id;
+    /// @brief Признак активного отправителя.
+    bool m_connected = true;
+    /// @brief Текущий режим кадрирования.
+    FramingMode m_framingMode = FramingMode::Raw;
+    /// @brief Буфер разбора кадров одной датаграммы.
+    MessageFramer m_framer;
+    /// @brief Время последней датаграммы.
+    qint64 m_lastSeenNs = 0;
+    /// @brief Количество неотправленных датаграмм.
+    std::atomic<quint64> m_droppedMessages{0};
+};
+
+#endif // UDPCLIENT_H
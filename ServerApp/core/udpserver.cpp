@@ -0,0 +1,266 @@
+#include "udpserver.h"
+#include "../common/monotonicclock.h"
+#include "core/logger.h"
+
+#include <QNetworkDatagram>
+
+#ifdef Q_OS_LINUX
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+UdpServer::UdpServer(const ServerSettings &settings, QObject *parent)
+    : IServer(parent), m_settings(settings), m_socket(nullptr),
+    m_idleTimer(new QTimer(this)) {
+    // Отправитель отключается не позже чем через полтора таймаута
+    m_idleTimer->setInterval(qBound(1, m_settings.udpIdleTimeoutMs / 2, IDLE_CHECK_INTERVAL_MS));
+    connect(m_idleTimer, &QTimer::timeout, this, &UdpServer::checkIdleClients);
+}
+
+UdpServer::~UdpServer() { m_idleTimer->stop(); }
+
+int UdpServer::clientCount() const { return m_clients.size(); }
+
+bool UdpServer::isListening() const {
+    return m_socket && m_socket->state() == QAbstractSocket::BoundState;
+}
+
+void UdpServer::startServer(quint16 port) {
+    if (isListening()) {
+        LOG_WARNING(AppEnums::LogCategory::Server, "Сервер уже запущен.");
+        return;
+    }
+
+    if (!m_socket) {
+        m_socket = new QUdpSocket(this);
+        connect(m_socket, &QUdpSocket::readyRead, this, &UdpServer::handleNewConnection);
+    }
+
+    if (!m_socket->bind(QHostAddress::Any, port)) {
+        LOG_ERROR(AppEnums::LogCategory::Server,
+                  QString("Ошибка запуска UDP-сервера: %1").arg(m_socket->errorString()));
+        m_socket->deleteLater();
+        m_socket = nullptr;
+        return;
+    }
+
+    if (m_settings.udpIdleTimeoutMs > 0) {
+        m_idleTimer->start();
+    }
+    LOG_INFO(AppEnums::LogCategory::Server, QString("UDP-сервер запущен на порту %1").arg(port));
+}
+
+void UdpServer::stopServer() {
+    if (!isListening()) {
+        LOG_WARNING(AppEnums::LogCategory::Server, "Сервер уже остановлен.");
+        return;
+    }
+
+    m_socket->close();
+    m_idleTimer->stop();
+    m_recvBuffer = QByteArray();
+
+    // Отключение клиента удаляет его из таблицы, поэтому обходится копия
+    const auto clients = std::exchange(m_clients, {});
+    for (UdpClient *client : clients) {
+        client->disconnect();
+    }
+
+    LOG_INFO(AppEnums::LogCategory::Server, "UDP-сервер остановлен.");
+}
+
+void UdpServer::handleNewConnection() {
+    if (!isListening())
+        return;
+
+    // Первая датаграмма читается средствами QUdpSocket: только так он снова
+    // включает уведомления о чтении после сигнала readyRead
+    const QNetworkDatagram first = m_socket->receiveDatagram();
+    if (first.isValid()) {
+        dispatchDatagram(first.senderAddress(), quint16(first.senderPort()), first.data(),
+                         MonotonicClock::nowNs());
+    }
+
+    if (readDatagramBatches())
+        return;
+
+    while (m_socket && m_socket->hasPendingDatagrams()) {
+        const QNetworkDatagram datagram = m_socket->receiveDatagram();
+        if (!datagram.isValid())
+            break;
+        dispatchDatagram(datagram.senderAddress(), quint16(datagram.senderPort()), datagram.data(),
+                         MonotonicClock::nowNs());
+    }
+}
+
+bool UdpServer::readDatagramBatches() {
+#ifdef Q_OS_LINUX
+    if (!isListening())
+        return true;
+
+    const int fd = int(m_socket->socketDescriptor());
+    if (m_recvBuffer.isEmpty()) {
+        m_recvBuffer.resize(qsizetype(RECV_BATCH_SIZE) * MAX_DATAGRAM_SIZE);
+    }
+    char *buffer = m_recvBuffer.data();
+
+    std::array<mmsghdr, RECV_BATCH_SIZE> headers;
+    std::array<iovec, RECV_BATCH_SIZE> vectors;
+    std::array<sockaddr_storage, RECV_BATCH_SIZE> senders;
+
+    // Полный пакет означает, что в сокете могут оставаться датаграммы
+    int received = RECV_BATCH_SIZE;
+    while (received == RECV_BATCH_SIZE && isListening()) {
+        for (int i = 0; i < RECV_BATCH_SIZE; ++i) {
+            vectors[i] = {buffer + qsizetype(i) * MAX_DATAGRAM_SIZE, size_t(MAX_DATAGRAM_SIZE)};
+            headers[i] = {};
+            headers[i].msg_hdr.msg_name = &senders[i];
+            headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+            headers[i].msg_hdr.msg_iov = &vectors[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        received = ::recvmmsg(fd, headers.data(), RECV_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+        if (received < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                LOG_WARNING(AppEnums::LogCategory::Network,
+                            QString("Ошибка чтения UDP-датаграмм: %1").arg(std::strerror(errno)));
+            }
+            break;
+        }
+
+        // Все датаграммы одного вызова получают общую отметку времени поступления
+        const qint64 receivedAtNs = MonotonicClock::nowNs();
+        for (int i = 0; i < received; ++i) {
+            if (headers[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                LOG_SAMPLED(AppEnums::LogLevel::Warning, AppEnums::LogCategory::Network, 100,
+                            QString("Датаграмма больше %1 байт отброшена.").arg(MAX_DATAGRAM_SIZE));
+                continue;
+            }
+
+            const auto *sender = reinterpret_cast<const sockaddr *>(&senders[i]);
+            const quint16 port = sender->sa_family == AF_INET6
+                ? ntohs(reinterpret_cast<const sockaddr_in6 *>(sender)->sin6_port)
+                : ntohs(reinterpret_cast<const sockaddr_in *>(sender)->sin_port);
+            dispatchDatagram(QHostAddress(sender), port,
+                             QByteArray(buffer + qsizetype(i) * MAX_DATAGRAM_SIZE,
+                                        qsizetype(headers[i].msg_len)),
+                             receivedAtNs);
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void UdpServer::dispatchDatagram(QHostAddress address, quint16 port, const QByteArray &datagram,
+                                 qint64 receivedAtNs) {
+    // Сокет двухстековый: IPv4-отправители приходят как ::ffff:a.b.c.d
+    bool isIpv4 = false;
+    const quint32 ipv4 = address.toIPv4Address(&isIpv4);
+    if (isIpv4) {
+        address = QHostAddress(ipv4);
+    }
+
+    const PeerKey key{address, port};
+    UdpClient *client = m_clients.value(key);
+    if (!client) {
+        if (m_settings.maxConnections > 0 && m_clients.size() >= m_settings.maxConnections) {
+            ++m_rejectedDatagrams;
+            LOG_SAMPLED(AppEnums::LogLevel::Warning, AppEnums::LogCategory::Network, 100,
+                        QString("Достигнут предел отправителей (%1): датаграмма от %2:%3 отброшена (всего %4)")
+                            .arg(m_settings.maxConnections)
+                            .arg(address.toString())
+                            .arg(port)
+                            .arg(m_rejectedDatagrams));
+            return;
+        }
+
+        client = new UdpClient(m_socket, address, port, this);
+        connect(client, &UdpClient::dataReceived, this, &UdpServer::handleDataReceived);
+        connect(client, &UdpClient::disconnected, this, &UdpServer::handleClientDisconnected);
+        connect(client, &UdpClient::errorOccurred, this, [client](const QString &message) {
+            LOG_SAMPLED(AppEnums::LogLevel::Warning, AppEnums::LogCategory::Network, 100,
+                        QString("Клиент %1: %2").arg(client->id(), message));
+        });
+        m_clients.insert(key, client);
+
+        emit clientConnected(client);
+        LOG_INFO(AppEnums::LogCategory::Network,
+                 QString("Новый UDP-отправитель: %1:%2").arg(address.toString()).arg(port));
+    }
+
+    client->deliver(datagram, receivedAtNs);
+}
+
+void UdpServer::handleDataReceived(const QByteArray &data, qint64 receivedAtNs) {
+    UdpClient *client = qobject_cast<UdpClient *>(sender());
+    if (!client) {
+        LOG_WARNING(AppEnums::LogCategory::Network, "Неизвестный отправитель сигнала.");
+        return;
+    }
+
+    emit dataReceived(client, data, receivedAtNs);
+    LOG_SAMPLED(AppEnums::LogLevel::Debug, AppEnums::LogCategory::Network, 100,
+                QString("Получена датаграмма от клиента %1").arg(client->id()));
+}
+
+void UdpServer::checkIdleClients() {
+    const qint64 idleSinceNs = MonotonicClock::nowNs() - qint64(m_settings.udpIdleTimeoutMs) * 1000000;
+
+    QList<UdpClient *> idleClients;
+    for (UdpClient *client : std::as_const(m_clients)) {
+        if (client->lastSeenNs() < idleSinceNs) {
+            idleClients.append(client);
+        }
+    }
+    for (UdpClient *client : std::as_const(idleClients)) {
+        client->disconnect();
+    }
+}
+
+void UdpServer::handleClientDisconnected() {
+    UdpClient *client = qobject_cast<UdpClient *>(sender());
+    if (!client) {
+        LOG_WARNING(AppEnums::LogCategory::Network, "Невозможно определить отключившегося клиента.");
+        return;
+    }
+
+    // Следующая датаграмма с того же адреса создаст нового клиента
+    const PeerKey key{QHostAddress(client->address()), client->port()};
+    auto it = m_clients.find(key);
+    if (it != m_clients.end() && it.value() == client) {
+        m_clients.erase(it);
+    }
+
+    emit clientDisconnected(client);
+    LOG_INFO(AppEnums::LogCategory::Network, QString("UDP-клиент отключен: %1").arg(client->id()));
+}
+
+void UdpServer::removeClient(IClient *client) {
+    if (!client)
+        return;
+
+    const PeerKey key{QHostAddress(client->address()), client->port()};
+    auto it = m_clients.find(key);
+    if (it != m_clients.end() && it.value() == client) {
+        m_clients.erase(it);
+    }
+    client->deleteLater();
+    LOG_DEBUG(AppEnums::LogCategory::Network,
+              QString("Объект UDP-клиента %1 удален.").arg(client->descriptor()));
+}
+
+void UdpServer::sendToClient(IClient *client, const QByteArray &data,
+                             const QString &coalesceKey) {
+    if (!client || !client->isConnected()) {
+        LOG_WARNING(AppEnums::LogCategory::Network, "Клиент не найден или не подключен.");
+        return;
+    }
+
+    client->sendData(data, coalesceKey);
+}
@@ -0,0 +1,147 @@
+/**
+ * @file udpserver.h
+ * @brief Определяет класс UdpServer, реализующий IServer для UDP-протокола.
+ */
+#ifndef UDPSERVER_H
+#define UDPSERVER_H
+
+#include <QHash>
+#include <QHostAddress>
+#include <QObject>
+#include <QTimer>
+#include <QUdpSocket>
+
+#include <utility>
+
+#include "core/iserver.h"
+#include "core/serversettings.h"
+#include "core/udpclient.h"
+
+/**
+ * @class UdpServer
+ * @brief Реализация интерфейса IServer для UDP-сервера.
+ *
+ * Принимает датаграммы на одном сокете и сопоставляет каждому адресу
+ * отправителя синтетического клиента UdpClient, который проходит ту же
+ * регистрацию и разбор сообщений в DataProcessing, что и TCP-клиенты.
+ *
+ * В Linux датаграммы читаются пакетами по RECV_BATCH_SIZE за один системный
+ * вызов recvmmsg; на других платформах — по одной через QUdpSocket.
+ * Отправитель, от которого не было датаграмм дольше
+ * ServerSettings::udpIdleTimeoutMs, считается отключенным. Отправителей не
+ * больше ServerSettings::maxConnections: датаграммы новых адресов сверх
+ * предела отбрасываются, пока кто-то из отправителей не отключится.
+ */
+class UdpServer : public IServer {
+    Q_OBJECT
+
+public:
+    /// @brief Максимальное количество датаграмм, читаемых одним вызовом recvmmsg.
+    static constexpr int RECV_BATCH_SIZE = 32;
+    /// @brief Максимальный размер принимаемой датаграммы (в байтах).
+    static constexpr int MAX_DATAGRAM_SIZE = 64 * 1024;
+    /// @brief Наибольший период проверки неактивных отправителей (мс).
+    static constexpr int IDLE_CHECK_INTERVAL_MS = 5000;
+
+    /**
+     * @brief Конструктор класса UdpServer.
+     * @param settings Параметры сервера.
+     * @param parent Родительский объект QObject.
+     */
+    explicit UdpServer(const ServerSettings &settings = ServerSettings(),
+                       QObject *parent = nullptr);
+    /**
+     * @brief Деструктор класса UdpServer.
+     */
+    ~UdpServer();
+
+    /**
+     * @brief Возвращает количество активных отправителей.
+     * @return Число клиентов.
+     */
+    int clientCount() const override;
+    /**
+     * @brief Проверяет, привязан ли сокет к порту.
+     * @return true, если сервер активен, иначе false.
+     */
+    bool isListening() const override;
+
+public slots:
+    /**
+     * @brief Привязывает UDP-сокет к указанному порту.
+     * @param port Номер порта.
+     */
+    void startServer(quint16 port) override;
+    /**
+     * @brief Закрывает сокет и отключает всех отправителей.
+     */
+    void stopServer() override;
+
+    /**
+     * @brief Отправляет датаграмму указанному клиенту.
+     * @param client Указатель на клиента (должен быть UdpClient).
+     * @param data Данные для отправки.
+     * @param coalesceKey Не используется: у UDP нет очереди отправки.
+     */
+    void sendToClient(IClient *client, const QByteArray &data,
+                      const QString &coalesceKey = QString()) override;
+    /**
+     * @brief Удаляет клиента с сервера.
+     * @param client Указатель на клиента для удаления.
+     */
+    void removeClient(IClient *client) override;
+
+private slots:
+    /**
+     * @brief Читает все ожидающие датаграммы; новые отправители регистрируются по первой из них.
+     */
+    void handleNewConnection() override;
+    /**
+     * @brief Обрабатывает отключение UDP-клиента (по таймауту или остановке сервера).
+     */
+    void handleClientDisconnected() override;
+    /**
+     * @brief Обрабатывает сообщение, выделенное клиентом из датаграммы.
+     * @param data Данные сообщения.
+     * @param receivedAtNs Время чтения датаграммы из сокета.
+     */
+    void handleDataReceived(const QByteArray &data, qint64 receivedAtNs) override;
+    /**
+     * @brief Отключает отправителей, от которых давно не было датаграмм.
+     */
+    void checkIdleClients();
+
+private:
+    /// @brief Ключ отправителя: адрес и порт.
+    using PeerKey = std::pair<QHostAddress, quint16>;
+
+    /**
+     * @brief Читает датаграммы пакетами через recvmmsg (только Linux).
+     * @return false, если пакетное чтение недоступно.
+     */
+    bool readDatagramBatches();
+    /**
+     * @brief Передает датаграмму клиенту отправителя, создавая его при необходимости.
+     * @param address Адрес отправителя.
+     * @param port Порт отправителя.
+     * @param datagram Данные датаграммы.
+     * @param receivedAtNs Время чтения датаграммы из сокета.
+     */
+    void dispatchDatagram(QHostAddress address, quint16 port, const QByteArray &datagram,
+                          qint64 receivedAtNs);
+
+    /// @brief Параметры сервера.
+    ServerSettings m_settings;
+    /// @brief UDP-сокет сервера.
+    QUdpSocket *m_socket;
+    /// @brief Таймер проверки неактивных отправителей.
+    QTimer *m_idleTimer;
+    /// @brief Клиенты по адресу отправителя.
+    QHash<PeerKey, UdpClient *> m_clients;
+    /// @brief Буфер пакетного чтения (RECV_BATCH_SIZE датаграмм).
+    QByteArray m_recvBuffer;
+    /// @brief Количество датаграмм, отброшенных из-за предела отправителей.
+    quint64 m_rejectedDatagrams = 0;
+};
+
+#endif // UDPSERVER_H
@@ -1,9 +1,11 @@
+#include <QDir>
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
 #include <QQuickStyle>
 #include <QQuickWindow>
 
+#include "core/logger.h"
 #include "models/serverviewmodel.h"
 
 int main(int argc, char *argv[]) {
@@ -12,6 +14,10 @@ int main(int argc, char *argv[]) {
 
     QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
 
+    // Журнал дублируется в файл рядом с исполняемым файлом
+    Logger::instance().setFileSink(
+        QDir(QCoreApplication::applicationDirPath()).filePath("server.log"));
+
     QQmlApplicationEngine engine;
 
     ServerViewModel serverViewModel(&app);
@@ -24,5 +30,7 @@ int main(int argc, char *argv[]) {
     if (engine.rootObjects().isEmpty())
         return -1;
 
-    return app.exec();
+    const int result = app.exec();
+    Logger::instance().shutdown();
+    return result;
 }
@@ -0,0 +1,140 @@
+#include "loglistmodel.h"
+
+#include <QDateTime>
+
+LogListModel::LogListModel(QObject *parent)
+    : QAbstractListModel(parent), m_entries(DEFAULT_CAPACITY) {}
+
+int LogListModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid())
+        return 0;
+    return m_entries.size();
+}
+
+QVariant LogListModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= m_entries.size())
+        return QVariant();
+
+    const LogEntry &entry = m_entries.at(index.row());
+
+    switch (role) {
+    case TimeRole:
+        return QDateTime::fromMSecsSinceEpoch(entry.timestamp).toString("hh:mm:ss.zzz");
+    case LevelRole:
+        return int(entry.level);
+    case LevelNameRole:
+        return AppEnums::logLevelToString(entry.level);
+    case CategoryRole:
+        return AppEnums::logCategoryToString(entry.category);
+    case Qt::DisplayRole:
+    case MessageRole:
+        return entry.message;
+    case ColorRole:
+        return levelColor(entry.level);
+    case LineRole:
+        return Logger::format(entry);
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> LogListModel::roleNames() const {
+    QHash<int, QByteArray> roles;
+    roles[TimeRole]         = "time";
+    roles[LevelRole]        = "level";
+    roles[LevelNameRole]    = "levelName";
+    roles[CategoryRole]     = "category";
+    roles[MessageRole]      = "message";
+    roles[ColorRole]        = "levelColor";
+    roles[LineRole]         = "line";
+    return roles;
+}
+
+void LogListModel::addEntries(const QList<LogEntry> &entries) {
+    if (entries.isEmpty() || capacity() == 0)
+        return;
+
+    // Из пакета больше емкости в журнал попадут только самые новые записи
+    const int insertCount = qMin(int(entries.size()), capacity());
+    const int evictCount = qMax(0, m_entries.size() + insertCount - capacity());
+
+    if (evictCount > 0) {
+        const int size = m_entries.size();
+        beginRemoveRows(QModelIndex(), size - evictCount, size - 1);
+        m_entries.popBack(evictCount);
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), 0, insertCount - 1);
+    for (auto it = entries.cend() - insertCount; it != entries.cend(); ++it) {
+        m_entries.pushFront(*it);
+    }
+    endInsertRows();
+}
+
+void LogListModel::clear() {
+    beginResetModel();
+    m_entries.clear();
+    endResetModel();
+}
+
+void LogListModel::setCapacity(int capacity) {
+    capacity = qMax(1, capacity);
+    if (capacity == m_entries.capacity())
+        return;
+
+    if (capacity < m_entries.size()) {
+        beginRemoveRows(QModelIndex(), capacity, m_entries.size() - 1);
+        m_entries.setCapacity(capacity);
+        endRemoveRows();
+    } else {
+        m_entries.setCapacity(capacity);
+    }
+    emit capacityChanged();
+}
+
+QString LogListModel::levelColor(AppEnums::LogLevel level) {
+    switch (level) {
+    case AppEnums::LogLevel::Debug:
+        return "#9e9e9e";
+    case AppEnums::LogLevel::Warning:
+        return "#ef6c00";
+    case AppEnums::LogLevel::Error:
+        return "#d32f2f";
+    default:
+        return "#333333";
+    }
+}
+
+LogFilterModel::LogFilterModel(LogListModel *source, QObject *parent)
+    : QSortFilterProxyModel(parent), m_source(source) {
+    setSourceModel(source);
+}
+
+void LogFilterModel::setMinLevel(int level) {
+    if (m_minLevel == level)
+        return;
+    m_minLevel = level;
+    invalidateFilter();
+    emit minLevelChanged();
+}
+
+void LogFilterModel::setFilterText(const QString &text) {
+    if (m_filterText == text)
+        return;
+    m_filterText = text;
+    invalidateFilter();
+    emit filterTextChanged();
+}
+
+bool LogFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const {
+    Q_UNUSED(sourceParent);
+    const LogEntry &entry = m_source->entryAt(sourceRow);
+
+    if (int(entry.level) < m_minLevel)
+        return false;
+    if (m_filterText.isEmpty())
+        return true;
+    return entry.message.contains(m_filterText, Qt::CaseInsensitive) ||
+           AppEnums::logCategoryToString(entry.category).contains(m_filterText, Qt::CaseInsensitive);
+}
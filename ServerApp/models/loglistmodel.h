@@ -0,0 +1,131 @@
+/**
+ * @file loglistmodel.h
+ * @brief Определяет модель журнала для QML и прокси-модель фильтрации.
+ */
+#ifndef LOGLISTMODEL_H
+#define LOGLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QSortFilterProxyModel>
+
+#include "core/appenums.h"
+#include "core/logger.h"
+#include "models/ringbuffer.h"
+
+/**
+ * @class LogListModel
+ * @brief Модель записей журнала в кольцевом буфере фиксированной емкости.
+ *
+ * Новые записи вставляются в начало, самые старые вытесняются одним диапазоном
+ * строк. Строки для отображения формируются только в data(), то есть только для
+ * видимых делегатов ListView.
+ */
+class LogListModel : public QAbstractListModel {
+    Q_OBJECT
+    /// @brief Свойство с максимальным количеством записей.
+    Q_PROPERTY(int capacity READ capacity WRITE setCapacity NOTIFY capacityChanged)
+
+public:
+    /**
+     * @enum LogRoles
+     * @brief Роли данных для доступа к записям из QML.
+     */
+    enum LogRoles {
+        TimeRole = Qt::UserRole + 1, // Время записи "hh:mm:ss.zzz"
+        LevelRole,                   // Уровень (AppEnums::LogLevel)
+        LevelNameRole,               // Название уровня
+        CategoryRole,                // Категория (источник)
+        MessageRole,                 // Текст сообщения
+        ColorRole,                   // Цвет строки по уровню
+        LineRole                     // Полная строка записи для копирования
+    };
+
+    /// @brief Емкость журнала по умолчанию.
+    static constexpr int DEFAULT_CAPACITY = 10000;
+
+    explicit LogListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    /**
+     * @brief Добавляет пакет записей в начало модели (последняя запись пакета — первая строка).
+     * @param entries Записи журнала в порядке поступления.
+     */
+    void addEntries(const QList<LogEntry> &entries);
+    /**
+     * @brief Возвращает запись по номеру строки.
+     */
+    const LogEntry &entryAt(int row) const { return m_entries.at(row); }
+    /**
+     * @brief Удаляет все записи.
+     */
+    void clear();
+
+    /**
+     * @brief Возвращает максимальное количество записей.
+     */
+    int capacity() const { return m_entries.capacity(); }
+    /**
+     * @brief Задает максимальное количество записей. Лишние старые записи удаляются.
+     * @param capacity Новая емкость (не меньше 1).
+     */
+    void setCapacity(int capacity);
+
+signals:
+    /**
+     * @brief Сигнал об изменении емкости журнала.
+     */
+    void capacityChanged();
+
+private:
+    /**
+     * @brief Возвращает цвет строки для уровня записи.
+     */
+    static QString levelColor(AppEnums::LogLevel level);
+
+    RingBuffer<LogEntry> m_entries;
+};
+
+/**
+ * @class LogFilterModel
+ * @brief Прокси-модель журнала с фильтрацией по минимальному уровню и тексту.
+ *
+ * Фильтр читает LogEntry напрямую из LogListModel, без создания QVariant.
+ */
+class LogFilterModel : public QSortFilterProxyModel {
+    Q_OBJECT
+    /// @brief Минимальный отображаемый уровень (AppEnums::LogLevel).
+    Q_PROPERTY(int minLevel READ minLevel WRITE setMinLevel NOTIFY minLevelChanged)
+    /// @brief Подстрока для поиска по сообщению и категории (без учета регистра).
+    Q_PROPERTY(QString filterText READ filterText WRITE setFilterText NOTIFY filterTextChanged)
+
+public:
+    /**
+     * @brief Конструктор.
+     * @param source Модель журнала.
+     * @param parent Родительский объект QObject.
+     */
+    explicit LogFilterModel(LogListModel *source, QObject *parent = nullptr);
+
+    int minLevel() const { return m_minLevel; }
+    void setMinLevel(int level);
+    QString filterText() const { return m_filterText; }
+    void setFilterText(const QString &text);
+
+signals:
+    void minLevelChanged();
+    void filterTextChanged();
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    LogListModel *m_source;
+    int m_minLevel = int(AppEnums::LogLevel::Debug);
+    QString m_filterText;
+};
+
+#endif // LOGLISTMODEL_H
@@ -0,0 +1,120 @@
+/**
+ * @file ringbuffer.h
+ * @brief Определяет шаблон RingBuffer — кольцевой буфер фиксированной емкости.
+ */
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <QList>
+#include <QtGlobal>
+
+#include <utility>
+
+/**
+ * @class RingBuffer
+ * @brief Кольцевой буфер с заранее выделенной памятью и вставкой в начало.
+ *
+ * Логический индекс 0 — самый новый элемент, size() - 1 — самый старый.
+ * Вставка в начало и вытеснение старейших элементов выполняются за O(1),
+ * память выделяется один раз при задании емкости.
+ * @tparam T Тип элемента.
+ */
+template <typename T>
+class RingBuffer {
+public:
+    /**
+     * @brief Конструктор.
+     * @param capacity Емкость буфера.
+     */
+    explicit RingBuffer(int capacity = 0) { setCapacity(capacity); }
+
+    int capacity() const { return int(m_items.size()); }
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    bool isFull() const { return m_size == capacity(); }
+
+    /**
+     * @brief Возвращает элемент по логическому индексу (0 — самый новый).
+     */
+    const T &at(int index) const { return m_items.at(physicalIndex(index)); }
+    T &operator[](int index) { return m_items[physicalIndex(index)]; }
+
+    /**
+     * @brief Добавляет элемент в начало. При заполненном буфере вытесняет самый старый.
+     * @param value Новый элемент.
+     */
+    void pushFront(T value) {
+        if (m_items.isEmpty())
+            return;
+        m_head = (m_head + capacity() - 1) % capacity();
+        m_items[m_head] = std::move(value);
+        if (m_size < capacity())
+            ++m_size;
+    }
+
+    /**
+     * @brief Удаляет самые старые элементы.
+     * @param count Количество удаляемых элементов.
+     */
+    void popBack(int count = 1) {
+        count = qBound(0, count, m_size);
+        for (int i = 0; i < count; ++i) {
+            // Освобождаем данные элемента, слот остается выделенным
+            m_items[physicalIndex(--m_size)] = T();
+        }
+    }
+
+    /**
+     * @brief Удаляет все элементы, сохраняя выделенную память.
+     */
+    void clear() { popBack(m_size); m_head = 0; }
+
+    /**
+     * @brief Изменяет емкость. Сохраняются самые новые элементы.
+     * @param capacity Новая емкость.
+     */
+    void setCapacity(int capacity) {
+        QList<T> items = takeAll();
+        m_items = QList<T>(qMax(0, capacity));
+        assign(std::move(items));
+    }
+
+    /**
+     * @brief Забирает все элементы в логическом порядке и очищает буфер.
+     */
+    QList<T> takeAll() {
+        QList<T> items;
+        items.reserve(m_size);
+        for (int i = 0; i < m_size; ++i) {
+            items.append(std::move(m_items[physicalIndex(i)]));
+        }
+        clear();
+        return items;
+    }
+
+    /**
+     * @brief Заменяет содержимое элементами в логическом порядке.
+     *
+     * Элементы, не поместившиеся в емкость, отбрасываются с конца (самые старые).
+     * @param items Новые элементы (0 — самый новый).
+     */
+    void assign(QList<T> items) {
+        clear();
+        m_size = qMin(int(items.size()), capacity());
+        for (int i = 0; i < m_size; ++i) {
+            m_items[i] = std::move(items[i]);
+        }
+    }
+
+private:
+    int physicalIndex(int index) const { return (m_head + index) % capacity(); }
+
+    /// @brief Выделенные слоты буфера.
+    QList<T> m_items;
+    /// @brief Физический индекс самого нового элемента.
+    int m_head = 0;
+    /// @brief Количество элементов в буфере.
+    int m_size = 0;
+};
+
+#endif // RINGBUFFER_H
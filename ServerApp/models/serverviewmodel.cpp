@@ -1,12 +1,27 @@
 #include "serverviewmodel.h"
+#include "../common/monotonicclock.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSet>
+#include <QTextStream>
 
 ServerViewModel::ServerViewModel(QObject *parent)
-    : QObject(parent), m_clientSortOrder(Qt::AscendingOrder),
-    m_dataSortOrder(Qt::AscendingOrder) {
+    : QObject(parent), m_ioThreadCount(ServerSettings().ioThreadCount),
+    m_slowConsumerPolicy(int(ServerSettings().slowConsumerPolicy)),
+    m_clientSortOrder(Qt::AscendingOrder), m_dataSortOrder(Qt::AscendingOrder) {
 
     m_clientTableModel  = new ClientTableModel(this);
     m_dataTableModel    = new DataTableModel(this);
     m_serverListModel   = new ServerListModel(this);
+    m_logListModel      = new LogListModel(this);
+    m_logFilterModel    = new LogFilterModel(m_logListModel, this);
+
+    m_clientLatencyTimer = new QTimer(this);
+    connect(m_clientLatencyTimer, &QTimer::timeout, this, &ServerViewModel::refreshClientLatency);
+    m_clientLatencyTimer->start(CLIENT_LATENCY_REFRESH_MS);
 
     // Настраиваем рабочий поток
     setupWorkerThread();
@@ -25,15 +40,11 @@ void ServerViewModel::setupWorkerThread() {
     m_serverWorker = new ServerWorker();
     m_serverWorker->moveToThread(m_workerThread);
 
-    // Подключаем сигналы от рабочего потока к UI
-    connect(m_serverWorker, &ServerWorker::clientBatchReady, this,
-            &ServerViewModel::handleClientBatchUpdate, Qt::QueuedConnection);
-    connect(m_serverWorker, &ServerWorker::dataBatchReady, this,
-            &ServerViewModel::handleDataBatchReceived, Qt::QueuedConnection);
-    connect(m_serverWorker, &ServerWorker::logBatchReady, this,
-            &ServerViewModel::handleLogBatch, Qt::QueuedConnection);
+    // Подключаем сигналы от рабочего потока к UI; пакеты передаются через буферы ServerWorker
     connect(m_serverWorker, &ServerWorker::serverStatusUpdate, this,
             &ServerViewModel::handleServerStatusUpdate, Qt::QueuedConnection);
+    connect(m_serverWorker, &ServerWorker::batchFlushed, this,
+            &ServerViewModel::handleBatchFlushed, Qt::QueuedConnection);
 
     // Подключаем сигналы от UI к рабочему потоку
     connect(this, &ServerViewModel::startServerRequested, m_serverWorker,
@@ -50,6 +61,12 @@ void ServerViewModel::setupWorkerThread() {
             &ServerWorker::removeDisconnectedClients, Qt::QueuedConnection);
     connect(this, &ServerViewModel::clearClientsRequested, m_serverWorker,
             &ServerWorker::clearClients, Qt::QueuedConnection);
+    connect(this, &ServerViewModel::ioThreadCountChangeRequested, m_serverWorker,
+            &ServerWorker::setIoThreadCount, Qt::QueuedConnection);
+    connect(this, &ServerViewModel::slowConsumerPolicyChangeRequested, m_serverWorker,
+            &ServerWorker::setSlowConsumerPolicy, Qt::QueuedConnection);
+    connect(this, &ServerViewModel::uiBatchApplied, m_serverWorker,
+            &ServerWorker::handleUiBatchApplied, Qt::QueuedConnection);
 
     // Очистка при завершении потока
     connect(m_workerThread, &QThread::finished, m_serverWorker,
@@ -92,18 +109,15 @@ void ServerViewModel::stopAllClients() {
 }
 
 void ServerViewModel::handleDataBatchReceived(
-    const QList<QVariantMap> &dataBatch) {
+    const QList<TelemetryRecord> &dataBatch) {
     if (m_dataTableModel) {
-        m_dataTableModel->addRows(dataBatch);
-
-        if (m_dataTableModel->rowCount() > MAX_DATA_TABLE_ROWS) {
-            int rowsToRemove = m_dataTableModel->rowCount() -
-                               (MAX_DATA_TABLE_ROWS - DATA_TABLE_TRIM_LENGTH);
-            if (rowsToRemove > 0) {
-                m_dataTableModel->removeRows(
-                    MAX_DATA_TABLE_ROWS - DATA_TABLE_TRIM_LENGTH, rowsToRemove);
-            }
-        }
+        const qint64 receivedNs = MonotonicClock::nowNs();
+        // Самые старые строки вытесняются кольцевым буфером модели
+        m_dataTableModel->addRecords(dataBatch);
+        const qint64 appliedNs = MonotonicClock::nowNs();
+
+        m_batchApplyNs += appliedNs - receivedNs;
+        m_latencyMonitor.recordBatch(dataBatch, receivedNs, appliedNs);
     }
 }
 
@@ -127,7 +141,28 @@ ServerListModel *ServerViewModel::serverListModel() const {
     return m_serverListModel;
 }
 
-QString ServerViewModel::logText() const { return m_logText; }
+LogFilterModel *ServerViewModel::logModel() const { return m_logFilterModel; }
+
+int ServerViewModel::ioThreadCount() const { return m_ioThreadCount; }
+
+void ServerViewModel::setIoThreadCount(int count) {
+    count = qBound(1, count, ServerSettings::MAX_IO_THREADS);
+    if (m_ioThreadCount == count)
+        return;
+    m_ioThreadCount = count;
+    emit ioThreadCountChangeRequested(count);
+    emit ioThreadCountChanged();
+}
+
+void ServerViewModel::setSlowConsumerPolicy(int policy) {
+    policy = qBound(int(IClient::SlowConsumerPolicy::Drop), policy,
+                    int(IClient::SlowConsumerPolicy::Disconnect));
+    if (m_slowConsumerPolicy == policy)
+        return;
+    m_slowConsumerPolicy = policy;
+    emit slowConsumerPolicyChangeRequested(policy);
+    emit slowConsumerPolicyChanged();
+}
 
 void ServerViewModel::sortClients(int columnIndex) {
     m_clientTableModel->sortByColumn(columnIndex, m_clientSortOrder);
@@ -143,21 +178,19 @@ void ServerViewModel::sortData(int columnIndex) {
                           : Qt::AscendingOrder;
 }
 
-void ServerViewModel::clearLog() {
-    m_logText.clear();
-    emit logTextChanged();
-}
+void ServerViewModel::clearLog() { m_logListModel->clear(); }
 
 void ServerViewModel::clearData() { m_dataTableModel->clear(); }
 
-void ServerViewModel::handleLogBatch(const QStringList &logBatch) {
+void ServerViewModel::handleLogBatch(const QList<LogEntry> &logBatch) {
     if (logBatch.isEmpty())
         return;
-    QStringList reversedLog = logBatch;
-    std::reverse(reversedLog.begin(), reversedLog.end());
+    QElapsedTimer timer;
+    timer.start();
 
-    m_logText.prepend(reversedLog.join(""));
-    emit logTextChanged();
+    // Строки для отображения формируются моделью только для видимых делегатов
+    m_logListModel->addEntries(logBatch);
+    m_batchApplyNs += timer.nsecsElapsed();
 }
 
 void ServerViewModel::handleServerStopped() {
@@ -166,49 +199,89 @@ void ServerViewModel::handleServerStopped() {
 }
 
 void ServerViewModel::handleClientBatchUpdate(const QList<QVariantMap> &clientBatch) {
-    if (clientBatch.isEmpty()) {
-        return;
-    }
-
-    // 1. Создаём карту обновлений для быстрого доступа по дескриптору
-    QHash<QString, QVariantMap> batchMap;
-    batchMap.reserve(clientBatch.size());
+    QElapsedTimer timer;
+    timer.start();
+    // Модель сама находит строки по дескриптору и сообщает только об изменившихся
+    m_clientTableModel->applyUpdates(clientBatch);
+
+    // Задержки хранятся по ID: они освобождаются, если ID не перешел к переподключившемуся клиенту
+    QSet<QString> deletedIds;
+    QSet<QString> aliveIds;
     for (const QVariantMap &clientData : clientBatch) {
-        batchMap.insert(clientData.value(Keys::DESCRIPTOR).toString(), clientData);
+        const QString id = clientData.value(Keys::ID).toString();
+        if (clientData.value(Keys::STATUS).toInt() == AppEnums::DELETED)
+            deletedIds.insert(id);
+        else
+            aliveIds.insert(id);
     }
+    for (const QString &id : std::as_const(deletedIds)) {
+        if (aliveIds.contains(id))
+            continue;
+        m_latencyMonitor.forgetClient(id);
+        m_clientTableModel->forgetLatency(id);
+    }
+    m_batchApplyNs += timer.nsecsElapsed();
+}
 
-    QList<QVariantMap> finalDataList;
-    finalDataList.reserve(m_clientTableModel->rowCount());
-
-    // 2. Проходим по текущим данным
-    for (int i = 0; i < m_clientTableModel->rowCount(); ++i) {
-        QVariantMap existingClient = m_clientTableModel->getRowData(i);
-        QString descriptor = existingClient.value(Keys::DESCRIPTOR).toString();
-        // Проверяем, есть ли текущий клиент в пакете обновлений
-        if (batchMap.contains(descriptor)) {
-            // Клиент есть в пакете
-            QVariantMap updatedClientData = batchMap.take(descriptor);
-            int status = updatedClientData.value(Keys::STATUS).toInt();
-
-            // Если статус не "DELETED", добавляем обновлённые данные в новый список.
-            if (status != AppEnums::DELETED) {
-                finalDataList.append(updatedClientData);
-            }
-        } else {
-            // Клиента не было в пакете обновлений, сохраняем его без изменений
-            finalDataList.append(existingClient);
-        }
+void ServerViewModel::handleBatchFlushed(quint64 sequence) {
+    // Забираем все, что записано в буферы, в том же порядке, что и раньше: данные, клиенты, журнал
+    QList<TelemetryRecord> dataBatch;
+    if (m_serverWorker->dataRing().drain(dataBatch) > 0)
+        handleDataBatchReceived(dataBatch);
+
+    QList<QVariantMap> clientBatch;
+    if (m_serverWorker->clientRing().drain(clientBatch) > 0)
+        handleClientBatchUpdate(clientBatch);
+
+    QList<LogEntry> logBatch;
+    if (m_serverWorker->logRing().drain(logBatch) > 0)
+        handleLogBatch(logBatch);
+
+    // Метрики читаются вместе с пакетом, отдельного события для них нет
+    m_flushMetrics = m_serverWorker->flushMetricsSnapshot();
+    emit flushMetricsChanged();
+
+    emit uiBatchApplied(sequence, m_batchApplyNs / 1000);
+    m_batchApplyNs = 0;
+}
+
+void ServerViewModel::refreshLatencyStats() {
+    m_latencyStats = m_latencyMonitor.stats();
+    emit latencyStatsChanged();
+}
+
+void ServerViewModel::resetLatencyStats() {
+    m_latencyMonitor.reset();
+    m_clientTableModel->clearLatency();
+    refreshLatencyStats();
+}
+
+void ServerViewModel::refreshClientLatency() {
+    m_clientTableModel->applyLatency(m_latencyMonitor.takeClientStats());
+}
+
+QString ServerViewModel::dumpLatencyStats(const QString &filePath) {
+    QString path = filePath;
+    if (path.isEmpty()) {
+        path = QDir(QCoreApplication::applicationDirPath())
+                   .filePath(QString("latency_%1.txt")
+                                 .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")));
     }
 
-    // 3. Все клиенты, оставшиеся в batchMap, являются новыми
-    for (const QVariantMap &newClientData : batchMap.values()) {
-        int status = newClientData.value(Keys::STATUS).toInt();
-        // Добавляем нового клиента, только если он не "DISCONNECTED" или "DELETED"
-        if (status != AppEnums::DISCONNECTED && status != AppEnums::DELETED) {
-            finalDataList.append(newClientData);
-        }
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        return QString();
     }
 
-    // 4. Атомарно обновляем модель новым списком данных
-    m_clientTableModel->setData(finalDataList);
+    QTextStream stream(&file);
+    stream << "Задержки этапов конвейера приема ("
+           << QDateTime::currentDateTime().toString("dd.MM.yy hh:mm:ss") << ")\n\n";
+    stream << m_latencyMonitor.report();
+
+    stream << "\nПланировщик отправки пакетов\n";
+    for (auto it = m_flushMetrics.constBegin(); it != m_flushMetrics.constEnd(); ++it) {
+        stream << it.key() << ": " << it.value().toString() << "\n";
+    }
+    return path;
 }
+
@@ -5,14 +5,18 @@
 #ifndef SERVERVIEWMODEL_H
 #define SERVERVIEWMODEL_H
 
+#include <QElapsedTimer>
 #include <QObject>
 #include <QSortFilterProxyModel>
+#include <QTimer>
 #include <QVariant>
 #include <QVariantList>
 #include <QVariantMap>
 
 #include "core/iserver.h"
+#include "core/latencymonitor.h"
 #include "core/serverworker.h"
+#include "models/loglistmodel.h"
 #include "models/tablemodel.h"
 #include "models/serverlistmodel.h"
 
@@ -32,15 +36,23 @@ class ServerViewModel : public QObject {
     Q_PROPERTY(DataTableModel *dataTableModel READ dataTableModel CONSTANT)
     /// @brief Свойство для доступа к модели списка серверов из QML.
     Q_PROPERTY(ServerListModel *serverListModel READ serverListModel CONSTANT)
-    /// @brief Свойство для доступа к тексту лога из QML.
-    Q_PROPERTY(QString logText READ logText NOTIFY logTextChanged)
+    /// @brief Свойство для доступа к отфильтрованной модели журнала из QML.
+    Q_PROPERTY(LogFilterModel *logModel READ logModel CONSTANT)
+    /// @brief Количество потоков ввода-вывода для вновь создаваемых серверов.
+    Q_PROPERTY(int ioThreadCount READ ioThreadCount WRITE setIoThreadCount NOTIFY ioThreadCountChanged)
+    /// @brief Максимально допустимое количество потоков ввода-вывода.
+    Q_PROPERTY(int maxIoThreadCount READ maxIoThreadCount CONSTANT)
+    /// @brief Политика для медленных получателей (IClient::SlowConsumerPolicy) для новых подключений.
+    Q_PROPERTY(int slowConsumerPolicy READ slowConsumerPolicy WRITE setSlowConsumerPolicy NOTIFY slowConsumerPolicyChanged)
+    /// @brief Метрики планировщика отправки пакетов (ключи Keys::FLUSH_*).
+    Q_PROPERTY(QVariantMap flushMetrics READ flushMetrics NOTIFY flushMetricsChanged)
+    /// @brief Статистика задержек этапов конвейера приема (обновляется refreshLatencyStats()).
+    Q_PROPERTY(QVariantList latencyStats READ latencyStats NOTIFY latencyStatsChanged)
 
     /// @brief Таймаут ожидания завершения рабочего потока (в миллисекундах).
     static constexpr int WORKER_THREAD_WAIT_TIMEOUT_MS = 5000;
-    /// @brief Максимальное количество строк в таблице данных.
-    static constexpr int MAX_DATA_TABLE_ROWS = 5000;
-    /// @brief Количество строк, которое остается после обрезки таблицы данных.
-    static constexpr int DATA_TABLE_TRIM_LENGTH = 2000;
+    /// @brief Период обновления задержек доставки в таблице клиентов (в миллисекундах).
+    static constexpr int CLIENT_LATENCY_REFRESH_MS = 1000;
 
 public:
     /**
@@ -70,10 +82,40 @@ public:
      */
     ServerListModel *serverListModel() const;
     /**
-     * @brief Возвращает текущий текст лога.
-     * @return Строка с логами.
+     * @brief Возвращает модель журнала с фильтрацией.
+     * @return Указатель на LogFilterModel.
      */
-    QString logText() const;
+    LogFilterModel *logModel() const;
+    /**
+     * @brief Возвращает количество потоков ввода-вывода для новых серверов.
+     */
+    int ioThreadCount() const;
+    /**
+     * @brief Задает количество потоков ввода-вывода для новых серверов.
+     * @param count Количество потоков.
+     */
+    void setIoThreadCount(int count);
+    /**
+     * @brief Возвращает максимально допустимое количество потоков ввода-вывода.
+     */
+    int maxIoThreadCount() const { return ServerSettings::MAX_IO_THREADS; }
+    /**
+     * @brief Возвращает политику для медленных получателей.
+     */
+    int slowConsumerPolicy() const { return m_slowConsumerPolicy; }
+    /**
+     * @brief Задает политику для медленных получателей.
+     * @param policy Значение IClient::SlowConsumerPolicy.
+     */
+    void setSlowConsumerPolicy(int policy);
+    /**
+     * @brief Возвращает последние метрики планировщика отправки пакетов.
+     */
+    QVariantMap flushMetrics() const { return m_flushMetrics; }
+    /**
+     * @brief Возвращает последнюю рассчитанную статистику задержек.
+     */
+    QVariantList latencyStats() const { return m_latencyStats; }
 
     // --- Методы, вызываемые из QML ---
     /**
@@ -128,31 +170,33 @@ public:
      */
     Q_INVOKABLE void sortData(int columnIndex);
     /**
-     * @brief Очищает текст лога.
+     * @brief Очищает журнал.
      */
     Q_INVOKABLE void clearLog();
     /**
      * @brief Очищает таблицу данных.
      */
     Q_INVOKABLE void clearData();
-
-public slots:
-    // --- Слоты для обработки сигналов от рабочего потока ---
     /**
-     * @brief Обрабатывает пакет обновлений по клиентам.
-     * @param clientBatch Список с данными клиентов для обновления.
+     * @brief Пересчитывает статистику задержек для отображения.
+     *
+     * Перцентили считаются только по запросу, чтобы не нагружать UI-поток,
+     * пока панель диагностики закрыта.
      */
-    void handleClientBatchUpdate(const QList<QVariantMap> &clientBatch);
+    Q_INVOKABLE void refreshLatencyStats();
     /**
-     * @brief Обрабатывает пакет полученных данных.
-     * @param dataBatch Список с полученными данными.
+     * @brief Сбрасывает накопленную статистику задержек.
      */
-    void handleDataBatchReceived(const QList<QVariantMap> &dataBatch);
+    Q_INVOKABLE void resetLatencyStats();
     /**
-     * @brief Обрабатывает пакет логов.
-     * @param logBatch Список строк лога.
+     * @brief Сохраняет отчет о задержках и метриках отправки в текстовый файл.
+     * @param filePath Путь к файлу; если пуст, файл создается в каталоге приложения.
+     * @return Путь к сохраненному файлу или пустая строка при ошибке.
      */
-    void handleLogBatch(const QStringList &logBatch);
+    Q_INVOKABLE QString dumpLatencyStats(const QString &filePath = QString());
+
+public slots:
+    // --- Слоты для обработки сигналов от рабочего потока ---
     /**
      * @brief Обрабатывает обновление статуса сервера.
      * @param type Тип сервера.
@@ -166,12 +210,30 @@ public slots:
      * @brief Обрабатывает полную остановку всех серверов.
      */
     void handleServerStopped();
+    /**
+     * @brief Забирает из буферов рабочего потока данные, обновления клиентов, журнал
+     * и метрики отправки, применяет их и сообщает рабочему потоку время применения.
+     * @param sequence Номер пакета.
+     */
+    void handleBatchFlushed(quint64 sequence);
 
 signals:
     /**
-     * @brief Сигнал об изменении текста лога.
+     * @brief Сигнал об изменении количества потоков ввода-вывода.
+     */
+    void ioThreadCountChanged();
+    /**
+     * @brief Сигнал об изменении политики для медленных получателей.
+     */
+    void slowConsumerPolicyChanged();
+    /**
+     * @brief Сигнал об обновлении метрик планировщика отправки.
+     */
+    void flushMetricsChanged();
+    /**
+     * @brief Сигнал об обновлении статистики задержек.
      */
-    void logTextChanged();
+    void latencyStatsChanged();
 
     // --- Сигналы для отправки команд в рабочий поток ---
     /**
@@ -202,18 +264,62 @@ signals:
      * @brief Запрос на полную очистку списка клиентов.
      */
     void clearClientsRequested();
+    /**
+     * @brief Запрос на изменение количества потоков ввода-вывода.
+     */
+    void ioThreadCountChangeRequested(int count);
+    /**
+     * @brief Запрос на изменение политики для медленных получателей.
+     */
+    void slowConsumerPolicyChangeRequested(int policy);
+    /**
+     * @brief Подтверждение применения пакета для планировщика отправки.
+     * @param sequence Номер пакета.
+     * @param applyTimeUs Время применения пакета (в микросекундах).
+     */
+    void uiBatchApplied(quint64 sequence, qint64 applyTimeUs);
 
 private:
     /**
      * @brief Настраивает и запускает рабочий поток.
      */
     void setupWorkerThread();
+    /**
+     * @brief Применяет пакет обновлений по клиентам.
+     * @param clientBatch Список с данными клиентов для обновления.
+     */
+    void handleClientBatchUpdate(const QList<QVariantMap> &clientBatch);
+    /**
+     * @brief Применяет пакет полученных данных.
+     * @param dataBatch Список с полученными данными.
+     */
+    void handleDataBatchReceived(const QList<TelemetryRecord> &dataBatch);
+    /**
+     * @brief Применяет пакет записей журнала.
+     * @param logBatch Записи журнала в порядке поступления.
+     */
+    void handleLogBatch(const QList<LogEntry> &logBatch);
+    /**
+     * @brief Переносит задержки доставки клиентов из монитора в таблицу клиентов.
+     */
+    void refreshClientLatency();
 
     // UI модели
     ClientTableModel *m_clientTableModel;
     DataTableModel *m_dataTableModel;
     ServerListModel *m_serverListModel;
-    QString m_logText;
+    LogListModel *m_logListModel;
+    LogFilterModel *m_logFilterModel;
+    int m_ioThreadCount;
+    int m_slowConsumerPolicy;
+    QVariantMap m_flushMetrics;
+    /// @brief Гистограммы задержек этапов конвейера приема.
+    LatencyMonitor m_latencyMonitor;
+    QVariantList m_latencyStats;
+    /// @brief Таймер обновления задержек в таблице клиентов (перцентили не считаются на каждый пакет).
+    QTimer *m_clientLatencyTimer;
+    /// @brief Суммарное время применения пакетов текущей отправки (в наносекундах).
+    qint64 m_batchApplyNs = 0;
 
     // Переменные для хранения порядка сортировки
     Qt::SortOrder m_clientSortOrder;
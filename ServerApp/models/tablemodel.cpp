@@ -1,29 +1,19 @@
 #include "tablemodel.h"
+#include "../common/tcpclient.h"
 
-BaseTableModel::BaseTableModel(QObject *parent) : QAbstractTableModel(parent) {}
+#include <QDateTime>
 
-int BaseTableModel::rowCount(const QModelIndex &parent) const {
-    Q_UNUSED(parent)
-    return m_data.size();
-}
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+BaseTableModel::BaseTableModel(QObject *parent) : QAbstractTableModel(parent) {}
 
 int BaseTableModel::columnCount(const QModelIndex &parent) const {
     Q_UNUSED(parent)
     return m_keys.size();
 }
 
-QVariant BaseTableModel::data(const QModelIndex &index, int role) const {
-    if (!index.isValid() || index.row() < 0 || index.row() >= m_data.size() ||
-        index.column() >= m_keys.size()) {
-        return QVariant();
-    }
-    // Базовая реализация возвращает только сырые данные
-    if (role == Qt::DisplayRole) {
-        return m_data.at(index.row()).value(m_keys.at(index.column()));
-    }
-    return QVariant();
-}
-
 QVariant BaseTableModel::headerData(int section, Qt::Orientation orientation,
                                     int role) const {
     if (orientation == Qt::Horizontal && role == Qt::DisplayRole &&
@@ -38,134 +28,285 @@ QHash<int, QByteArray> BaseTableModel::roleNames() const {
     return {{Qt::DisplayRole, "display"}};
 }
 
-void BaseTableModel::setData(const QList<QVariantMap> &data) {
+BaseTableModel::SortKey BaseTableModel::makeSortKey(const QString &key,
+                                                    const QVariant &value) {
+    SortKey sortKey;
+
+    if (key == Keys::TIME_STAMP || key == Keys::QUEUE_BYTES) {
+        sortKey.number = value.toLongLong();
+        return sortKey;
+    }
+
+    if (key == Keys::ID) {
+        const QString id = value.toString();
+        int underscorePos = id.lastIndexOf('_');
+        if (underscorePos == -1) {
+            // Если нет подчеркивания, используем весь текст и 0
+            sortKey.text = id.toLower();
+            return sortKey;
+        }
+
+        bool ok;
+        const int number = id.mid(underscorePos + 1).toInt(&ok);
+        sortKey.text = id.left(underscorePos).toLower();
+        // Если не удалось преобразовать в число, используем 0
+        sortKey.number = ok ? number : 0;
+        return sortKey;
+    }
+
+    // Обобщенная сортировка по строкам
+    sortKey.text = value.toString().toLower();
+    return sortKey;
+}
+
+QList<int> BaseTableModel::sortedOrder(const QList<SortKey> &keys, Qt::SortOrder order) {
+    QList<int> rows(keys.size());
+    std::iota(rows.begin(), rows.end(), 0);
+    std::stable_sort(rows.begin(), rows.end(), [&keys, order](int a, int b) {
+        return (order == Qt::AscendingOrder) ? keys.at(a) < keys.at(b)
+                                             : keys.at(b) < keys.at(a);
+    });
+    return rows;
+}
+
+ClientTableModel::ClientTableModel(QObject *parent) : BaseTableModel(parent) {
+    m_keys          = {Keys::ID,        Keys::ADDRESS,  Keys::STATUS,   Keys::ALLOW_SENDING,    Keys::QUEUE_BYTES,  Keys::RATE_TOKENS,  Keys::INGEST_LATENCY,   Keys::DISPLAY_LATENCY};
+    m_headers       = {"ID Клиента",    "Адрес",        "Статус",       "Отправка",             "Очередь",          "Маркеры",          "Прием, мс",            "Отображение, мс"};
+    m_columnWidths  = {0.14,            0.16,           0.11,           0.09,                   0.12,               0.12,               0.13,                   0.13};
+}
+
+int ClientTableModel::rowCount(const QModelIndex &parent) const {
+    Q_UNUSED(parent)
+    return m_data.size();
+}
+
+void ClientTableModel::setData(const QList<QVariantMap> &data) {
     beginResetModel();
     m_data = data;
+    m_rowByDescriptor.clear();
+    reindexRows(0, m_data.size() - 1);
+    m_sortColumn = -1;
     endResetModel();
     emit resetSorting();
 }
 
-void BaseTableModel::addRows(const QList<QVariantMap> &rowsData) {
-    if (rowsData.isEmpty())
+void ClientTableModel::applyUpdates(const QList<QVariantMap> &batch) {
+    if (batch.isEmpty())
         return;
-    beginInsertRows(QModelIndex(), 0, rowsData.size() - 1);
-    for (const auto &row : rowsData) {
-        m_data.prepend(row);
-    }
-    endInsertRows();
-    emit resetSorting();
-}
 
-void BaseTableModel::addRow(const QVariantMap &rowData) {
-    beginInsertRows(QModelIndex(), 0, 0);
-    m_data.prepend(rowData);
-    endInsertRows();
-}
+    // В пакете может быть несколько изменений одного клиента — важно последнее
+    QHash<quintptr, QVariantMap> latest;
+    QList<quintptr> order;
+    latest.reserve(batch.size());
+    for (const QVariantMap &clientData : batch) {
+        const quintptr descriptor = clientData.value(Keys::DESCRIPTOR).toULongLong();
+        if (!latest.contains(descriptor))
+            order.append(descriptor);
+        latest.insert(descriptor, clientData);
+    }
 
-void BaseTableModel::updateRow(int row, const QVariantMap &rowData) {
-    if (row >= 0 && row < m_data.size()) {
-        m_data[row] = rowData;
-        emit dataChanged(index(row, 0), index(row, m_keys.size() - 1));
+    // Удаления выполняются первыми, одним проходом по диапазонам
+    QList<int> removedRows;
+    for (quintptr descriptor : order) {
+        const QVariantMap &clientData = latest[descriptor];
+        auto it = m_rowByDescriptor.constFind(descriptor);
+        if (it != m_rowByDescriptor.constEnd() &&
+            clientData.value(Keys::STATUS).toInt() == AppEnums::DELETED) {
+            removedRows.append(it.value());
+        }
+    }
+    removeRowSet(removedRows);
+
+    for (quintptr descriptor : order) {
+        const QVariantMap &clientData = latest[descriptor];
+        const int status = clientData.value(Keys::STATUS).toInt();
+        auto it = m_rowByDescriptor.constFind(descriptor);
+
+        if (it != m_rowByDescriptor.constEnd()) {
+            replaceRow(it.value(), clientData);
+        } else if (status != AppEnums::DISCONNECTED && status != AppEnums::DELETED) {
+            // Новые клиенты показываются, только если они еще подключены
+            insertRow(clientData);
+        }
     }
 }
 
-void BaseTableModel::removeRows(int row, int count) {
-    if (row < 0 || row >= m_data.size() || count <= 0)
+void ClientTableModel::applyLatency(const QHash<QString, ClientLatencyStats> &stats) {
+    if (stats.isEmpty())
         return;
+    for (auto it = stats.constBegin(); it != stats.constEnd(); ++it) {
+        m_latencyById.insert(it.key(), it.value());
+    }
 
-    beginRemoveRows(QModelIndex(), row, row + count - 1);
-    m_data.erase(m_data.begin() + row, m_data.begin() + row + count);
-    endRemoveRows();
+    const int first = int(m_keys.indexOf(Keys::INGEST_LATENCY));
+    const int last = int(m_keys.indexOf(Keys::DISPLAY_LATENCY));
+    for (int row = 0; row < m_data.size(); ++row) {
+        if (stats.contains(m_data.at(row).value(Keys::ID).toString()))
+            emit dataChanged(index(row, first), index(row, last));
+    }
 }
 
-void BaseTableModel::removeRow(int row) {
-    if (row < 0 || row >= m_data.size())
+void ClientTableModel::clearLatency() {
+    if (m_latencyById.isEmpty())
         return;
-    beginRemoveRows(QModelIndex(), row, row);
-    m_data.removeAt(row);
-    endRemoveRows();
+    m_latencyById.clear();
+    if (!m_data.isEmpty()) {
+        emit dataChanged(index(0, int(m_keys.indexOf(Keys::INGEST_LATENCY))),
+                         index(m_data.size() - 1, int(m_keys.indexOf(Keys::DISPLAY_LATENCY))));
+    }
 }
 
-void BaseTableModel::clear() {
+QString ClientTableModel::latencyText(qint64 p50Us, qint64 p99Us, qint64 maxUs) {
+    return QString("%1 / %2 / %3")
+        .arg(p50Us / 1000.0, 0, 'f', 1)
+        .arg(p99Us / 1000.0, 0, 'f', 1)
+        .arg(maxUs / 1000.0, 0, 'f', 1);
+}
+
+void ClientTableModel::clear() {
     beginResetModel();
     m_data.clear();
+    m_rowByDescriptor.clear();
+    m_latencyById.clear();
+    m_sortColumn = -1;
     endResetModel();
     emit resetSorting();
 }
 
-void BaseTableModel::sortByColumn(int column, Qt::SortOrder order) {
+void ClientTableModel::sortByColumn(int column, Qt::SortOrder order) {
     if (column < 0 || column >= m_keys.size())
         return;
-    const QString &key = m_keys.at(column);
 
-    beginResetModel();
-    std::sort(
-        m_data.begin(), m_data.end(),
-        [key, order](const QVariantMap &a, const QVariantMap &b) {
-        QVariant valueA = a[key];
-        QVariant valueB = b[key];
-
-        if (key == Keys::TIME_STAMP) {
-            QTime timeA = QTime::fromString(valueA.toString(), "hh:mm:ss.zzz");
-            QTime timeB = QTime::fromString(valueB.toString(), "hh:mm:ss.zzz");
-            return (order == Qt::AscendingOrder) ? (timeA < timeB)
-                                                 : (timeA > timeB);
-        }
+    m_sortColumn = column;
+    m_sortOrder = order;
 
-        if (key == Keys::ID) {
-            auto parseId = [](const QString &id) -> std::pair<QString, int> {
-                int underscorePos = id.lastIndexOf('_');
-                if (underscorePos == -1) {
-                    // Если нет подчеркивания, возвращаем весь текст и 0
-                    return {id, 0};
-                }
-
-                QString textPart = id.left(underscorePos);
-                QString numberPart = id.mid(underscorePos + 1);
-
-                bool ok;
-                int number = numberPart.toInt(&ok);
-                if (!ok) {
-                    // Если не удалось преобразовать в число, возвращаем 0
-                    number = 0;
-                }
-
-                return {textPart, number};
-            };
-
-            auto [textA, numA] = parseId(valueA.toString());
-            auto [textB, numB] = parseId(valueB.toString());
-
-            // Сначала сравниваем текстовую часть
-            int textCompare = QString::compare(textA, textB, Qt::CaseInsensitive);
-            if (textCompare != 0) {
-            return (order == Qt::AscendingOrder) ? (textCompare < 0)
-                                                     : (textCompare > 0);
-            }
-
-            // Если текстовые части равны, сравниваем числовые части
-            return (order == Qt::AscendingOrder) ? (numA < numB) : (numA > numB);
-        }
-        // Обобщенная сортировка по строкам
-        return (order == Qt::AscendingOrder)
-            ? (valueA.toString().toLower() < valueB.toString().toLower())
-                   : (valueA.toString().toLower() >
-                      valueB.toString().toLower());
-        });
+    // Ключи извлекаются один раз на строку, а не при каждом сравнении
+    QList<SortKey> keys;
+    keys.reserve(m_data.size());
+    for (const QVariantMap &rowData : std::as_const(m_data)) {
+        keys.append(rowSortKey(rowData));
+    }
+    const QList<int> rows = sortedOrder(keys, order);
+
+    beginResetModel();
+    QList<QVariantMap> sorted;
+    sorted.reserve(m_data.size());
+    for (int row : rows) {
+        sorted.append(std::move(m_data[row]));
+    }
+    m_data = std::move(sorted);
+    reindexRows(0, m_data.size() - 1);
     endResetModel();
 }
 
-QVariantMap BaseTableModel::getRowData(int row) const {
+QVariantMap ClientTableModel::getRowData(int row) const {
     if (row >= 0 && row < m_data.size()) {
         return m_data.at(row);
     }
     return QVariantMap();
 }
 
-ClientTableModel::ClientTableModel(QObject *parent) : BaseTableModel(parent) {
-    m_keys          = {Keys::ID,        Keys::ADDRESS,  Keys::STATUS,   Keys::ALLOW_SENDING};
-    m_headers       = {"ID Клиента",    "Адрес",        "Статус",       "Отправка"};
-    m_columnWidths  = {0.25,            0.30,           0.25,           0.20};
+bool ClientTableModel::rowLessThan(const QVariantMap &a, const QVariantMap &b) const {
+    return (m_sortOrder == Qt::AscendingOrder) ? rowSortKey(a) < rowSortKey(b)
+                                               : rowSortKey(b) < rowSortKey(a);
+}
+
+BaseTableModel::SortKey ClientTableModel::rowSortKey(const QVariantMap &rowData) const {
+    const QString &key = m_keys.at(m_sortColumn);
+    if (key == Keys::INGEST_LATENCY || key == Keys::DISPLAY_LATENCY) {
+        // Задержки сортируются по p99; клиенты без замеров — в начале
+        const ClientLatencyStats stats = m_latencyById.value(rowData.value(Keys::ID).toString());
+        SortKey sortKey;
+        sortKey.number = stats.samples == 0 ? -1
+                         : key == Keys::INGEST_LATENCY ? stats.ingestP99 : stats.displayP99;
+        return sortKey;
+    }
+    if (key == Keys::RATE_TOKENS) {
+        // Клиенты, превышающие темп, важнее текущего уровня маркеров
+        SortKey sortKey;
+        sortKey.number = rowData.value(Keys::RATE_LIMITED).toLongLong();
+        return sortKey;
+    }
+    return makeSortKey(key, rowData.value(key));
+}
+
+void ClientTableModel::insertRow(const QVariantMap &rowData) {
+    int row = m_data.size();
+    if (m_sortColumn >= 0) {
+        auto pos = std::upper_bound(m_data.cbegin(), m_data.cend(), rowData,
+                                    [this](const QVariantMap &a, const QVariantMap &b) {
+            return rowLessThan(a, b);
+        });
+        row = int(pos - m_data.cbegin());
+    }
+
+    beginInsertRows(QModelIndex(), row, row);
+    m_data.insert(row, rowData);
+    endInsertRows();
+    reindexRows(row, m_data.size() - 1);
+}
+
+void ClientTableModel::replaceRow(int row, const QVariantMap &rowData) {
+    int target = row;
+    if (m_sortColumn >= 0) {
+        auto less = [this](const QVariantMap &a, const QVariantMap &b) {
+            return rowLessThan(a, b);
+        };
+        // Новое место ищется среди соседей слева или справа от текущей позиции
+        if (row > 0 && less(rowData, m_data.at(row - 1))) {
+            target = int(std::upper_bound(m_data.cbegin(), m_data.cbegin() + row,
+                                          rowData, less) - m_data.cbegin());
+        } else if (row + 1 < m_data.size() && less(m_data.at(row + 1), rowData)) {
+            target = int(std::upper_bound(m_data.cbegin() + row + 1, m_data.cend(),
+                                          rowData, less) - m_data.cbegin());
+        }
+    }
+
+    if (target == row) {
+        m_data[row] = rowData;
+        emit dataChanged(index(row, 0), index(row, m_keys.size() - 1));
+        return;
+    }
+
+    // target — позиция вставки до перемещения, как ожидает beginMoveRows
+    beginMoveRows(QModelIndex(), row, row, QModelIndex(), target);
+    const int newRow = target > row ? target - 1 : target;
+    m_data.move(row, newRow);
+    m_data[newRow] = rowData;
+    endMoveRows();
+    emit dataChanged(index(newRow, 0), index(newRow, m_keys.size() - 1));
+    reindexRows(qMin(row, newRow), qMax(row, newRow));
+}
+
+void ClientTableModel::removeRowSet(QList<int> rows) {
+    if (rows.isEmpty())
+        return;
+
+    // Удаляем с конца, чтобы индексы оставшихся диапазонов не сдвигались
+    std::sort(rows.begin(), rows.end(), std::greater<int>());
+    int i = 0;
+    while (i < rows.size()) {
+        const int last = rows.at(i);
+        int first = last;
+        while (i + 1 < rows.size() && rows.at(i + 1) == first - 1) {
+            first = rows.at(++i);
+        }
+        ++i;
+
+        for (int row = first; row <= last; ++row) {
+            m_rowByDescriptor.remove(m_data.at(row).value(Keys::DESCRIPTOR).toULongLong());
+        }
+        beginRemoveRows(QModelIndex(), first, last);
+        m_data.erase(m_data.begin() + first, m_data.begin() + last + 1);
+        endRemoveRows();
+    }
+    reindexRows(rows.last(), m_data.size() - 1);
+}
+
+void ClientTableModel::reindexRows(int first, int last) {
+    for (int row = qMax(first, 0); row <= last && row < m_data.size(); ++row) {
+        m_rowByDescriptor.insert(m_data.at(row).value(Keys::DESCRIPTOR).toULongLong(), row);
+    }
 }
 
 QHash<int, QByteArray> ClientTableModel::roleNames() const {
@@ -176,7 +317,8 @@ QHash<int, QByteArray> ClientTableModel::roleNames() const {
 }
 
 QVariant ClientTableModel::data(const QModelIndex &index, int role) const {
-    if (!index.isValid())
+    if (!index.isValid() || index.row() >= m_data.size() ||
+        index.column() >= m_keys.size())
         return QVariant();
 
     const QVariantMap &rowData = m_data.at(index.row());
@@ -192,6 +334,30 @@ QVariant ClientTableModel::data(const QModelIndex &index, int role) const {
         if (key == Keys::ALLOW_SENDING) {
             return value.toBool() ? "Да" : "Нет";
         }
+        if (key == Keys::QUEUE_BYTES) {
+            const QString queue = QString("%1 КБ").arg(value.toLongLong() / 1024);
+            const quint64 dropped = rowData.value(Keys::DROPPED).toULongLong();
+            return dropped > 0 ? QString("%1 (-%2)").arg(queue).arg(dropped) : queue;
+        }
+        if (key == Keys::RATE_TOKENS) {
+            // Без ключа емкости темп клиента не ограничен
+            const QString tokens = rowData.contains(Keys::RATE_BURST)
+                                       ? QString("%1 / %2").arg(value.toLongLong())
+                                             .arg(rowData.value(Keys::RATE_BURST).toLongLong())
+                                       : QString("—");
+            const quint64 limited = rowData.value(Keys::RATE_LIMITED).toULongLong();
+            return limited > 0 ? QString("%1 (-%2)").arg(tokens).arg(limited) : tokens;
+        }
+        if (key == Keys::INGEST_LATENCY || key == Keys::DISPLAY_LATENCY) {
+            const auto it = m_latencyById.constFind(rowData.value(Keys::ID).toString());
+            if (it == m_latencyById.constEnd() || it->samples == 0)
+                return QString("—");
+            if (key == Keys::INGEST_LATENCY)
+                return latencyText(it->ingestP50, it->ingestP99, it->ingestMax);
+            // Пропуски номеров показываются так же, как отброшенные сообщения очереди
+            const QString text = latencyText(it->displayP50, it->displayP99, it->displayMax);
+            return it->sequenceGaps > 0 ? QString("%1 (-%2)").arg(text).arg(it->sequenceGaps) : text;
+        }
         return value.toString();
     }
 
@@ -208,6 +374,17 @@ QVariant ClientTableModel::data(const QModelIndex &index, int role) const {
         if (key == Keys::ALLOW_SENDING) {
             return value.toBool() ? QColor("#4CAF50") : QColor("#f44336");
         }
+        if (key == Keys::QUEUE_BYTES && (rowData.value(Keys::DROPPED).toULongLong() > 0 ||
+                                         value.toLongLong() >= TcpClient::SOCKET_HIGH_WATERMARK)) {
+            return QColor("#FF9800");
+        }
+        if (key == Keys::RATE_TOKENS && rowData.value(Keys::RATE_LIMITED).toULongLong() > 0) {
+            return QColor("#FF9800");
+        }
+        if (key == Keys::DISPLAY_LATENCY &&
+            m_latencyById.value(rowData.value(Keys::ID).toString()).sequenceGaps > 0) {
+            return QColor("#FF9800");
+        }
         return QColor("#424242"); // Цвет по умолчанию
     }
 
@@ -222,7 +399,8 @@ QVariant ClientTableModel::data(const QModelIndex &index, int role) const {
     return QVariant();
 }
 
-DataTableModel::DataTableModel(QObject *parent) : BaseTableModel(parent) {
+DataTableModel::DataTableModel(QObject *parent)
+    : BaseTableModel(parent), m_records(DEFAULT_CAPACITY) {
     m_keys          = {Keys::TIME_STAMP,    Keys::ID,   Keys::TYPE, Keys::PAYLOAD};
     m_headers       = {"Время",             "ID",       "Тип",      "Сообщение"};
     m_columnWidths  = {0.15,                0.20,       0.15,       0.50};
@@ -234,53 +412,29 @@ QHash<int, QByteArray> DataTableModel::roleNames() const {
     return roles;
 }
 
+int DataTableModel::rowCount(const QModelIndex &parent) const {
+    Q_UNUSED(parent)
+    return m_records.size();
+}
+
 QVariant DataTableModel::data(const QModelIndex &index, int role) const {
-    if (!index.isValid())
+    if (!index.isValid() || index.row() >= m_records.size() ||
+        index.column() >= m_keys.size())
         return QVariant();
 
-    const QVariantMap &rowData = m_data.at(index.row());
-    const QString &key = m_keys.at(index.column());
-    QVariant value = rowData.value(key);
+    const TelemetryRecord &record = m_records.at(index.row());
 
     switch (role) {
-    case Qt::DisplayRole: {
-        if (key == Keys::PAYLOAD && value.typeId() == QMetaType::QVariantMap) {
-            QVariantMap payloadMap = value.toMap();
-            QStringList items;
-            auto it = payloadMap.constEnd();
-            while (it != payloadMap.constBegin()) {
-                --it;
-                QString valStr = it.value().toString();
-
-                if (it.key() == "severity") {
-                    QString color;
-                    if (valStr == "INFO")
-                        color = "blue";
-                    else if (valStr == "WARN")
-                        color = "orange";
-                    else if (valStr == "ERROR")
-                        color = "red";
-                    else if (valStr == "CRITICAL")
-                        color = "darkred";
-
-                    valStr = QString("<font color='%1'>%2</font>").arg(color, valStr);
-                }
-
-                items << QString("%1: %2").arg(it.key(), valStr);
-            }
-            return items.join(", ");
-        }
-        return value.toString();
-    }
+    case Qt::DisplayRole:
+        return columnValue(record, index.column());
 
     case TypeColorRole: {
-        if (key == Keys::TYPE) {
-            QString typeStr = value.toString();
-            if (typeStr == "NetworkMetrics")
+        if (m_keys.at(index.column()) == Keys::TYPE) {
+            if (record.type == "NetworkMetrics")
                 return QColor("#0891b2");
-            if (typeStr == "DeviceStatus")
+            if (record.type == "DeviceStatus")
                 return QColor("#2196F3");
-            if (typeStr == "Log")
+            if (record.type == "Log")
                 return QColor("#8f4cf6");
         }
         return QColor("#424242"); // Цвет по умолчанию
@@ -289,3 +443,143 @@ QVariant DataTableModel::data(const QModelIndex &index, int role) const {
 
     return QVariant();
 }
+
+void DataTableModel::addRecords(const QList<TelemetryRecord> &records) {
+    if (records.isEmpty() || capacity() == 0)
+        return;
+
+    // Из пакета больше емкости в таблицу попадут только самые новые записи
+    const int insertCount = qMin(int(records.size()), capacity());
+    const int evictCount = qMax(0, m_records.size() + insertCount - capacity());
+
+    if (evictCount > 0) {
+        const int size = m_records.size();
+        beginRemoveRows(QModelIndex(), size - evictCount, size - 1);
+        m_records.popBack(evictCount);
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), 0, insertCount - 1);
+    for (auto it = records.cend() - insertCount; it != records.cend(); ++it) {
+        m_records.pushFront(*it);
+    }
+    endInsertRows();
+    emit resetSorting();
+}
+
+void DataTableModel::setCapacity(int capacity) {
+    capacity = qMax(1, capacity);
+    if (capacity == m_records.capacity())
+        return;
+
+    if (capacity < m_records.size()) {
+        beginRemoveRows(QModelIndex(), capacity, m_records.size() - 1);
+        m_records.setCapacity(capacity);
+        endRemoveRows();
+    } else {
+        m_records.setCapacity(capacity);
+    }
+    emit capacityChanged();
+}
+
+void DataTableModel::clear() {
+    beginResetModel();
+    m_records.clear();
+    endResetModel();
+    emit resetSorting();
+}
+
+void DataTableModel::sortByColumn(int column, Qt::SortOrder order) {
+    if (column < 0 || column >= m_keys.size())
+        return;
+
+    // Ключи извлекаются один раз на строку, а не при каждом сравнении
+    QList<SortKey> keys;
+    keys.reserve(m_records.size());
+    for (int row = 0; row < m_records.size(); ++row) {
+        keys.append(recordSortKey(m_records.at(row), column));
+    }
+    const QList<int> rows = sortedOrder(keys, order);
+
+    beginResetModel();
+    QList<TelemetryRecord> records = m_records.takeAll();
+    QList<TelemetryRecord> sorted;
+    sorted.reserve(records.size());
+    for (int row : rows) {
+        sorted.append(std::move(records[row]));
+    }
+    m_records.assign(std::move(sorted));
+    endResetModel();
+}
+
+QVariantMap DataTableModel::getRowData(int row) const {
+    QVariantMap rowData;
+    if (row >= 0 && row < m_records.size()) {
+        for (int column = 0; column < m_keys.size(); ++column) {
+            rowData.insert(m_keys.at(column), columnValue(m_records.at(row), column));
+        }
+    }
+    return rowData;
+}
+
+QVariant DataTableModel::columnValue(const TelemetryRecord &record, int column) const {
+    const QString &key = m_keys.at(column);
+    if (key == Keys::TIME_STAMP)
+        return QDateTime::fromMSecsSinceEpoch(record.timestamp).toString("hh:mm:ss.zzz");
+    if (key == Keys::ID)
+        return record.clientId;
+    if (key == Keys::TYPE)
+        return record.type;
+    if (key == Keys::PAYLOAD)
+        return payloadText(record);
+    return QVariant();
+}
+
+BaseTableModel::SortKey DataTableModel::recordSortKey(const TelemetryRecord &record,
+                                                     int column) const {
+    const QString &key = m_keys.at(column);
+    if (key == Keys::TIME_STAMP) {
+        SortKey sortKey;
+        sortKey.number = record.timestamp;
+        return sortKey;
+    }
+    return makeSortKey(key, columnValue(record, column));
+}
+
+QString DataTableModel::payloadText(const TelemetryRecord &record) {
+    if (const auto *sample = std::get_if<NetworkMetricsSample>(&record.payload)) {
+        return QString("packetLoss: %1, latency: %2, bandWidth: %3")
+            .arg(QString::number(sample->packetLoss, 'f', 2),
+                 QString::number(sample->latency, 'f', 2),
+                 QString::number(sample->bandWidth, 'f', 2));
+    }
+
+    if (const auto *sample = std::get_if<DeviceStatusSample>(&record.payload)) {
+        return QString("upTime: %1, memoryUsage: %2, cpuUsage: %3, cpuTemp: %4")
+            .arg(QString::number(sample->upTime),
+                 QString::number(sample->memoryUsage),
+                 QString::number(sample->cpuUsage),
+                 QString::number(sample->cpuTemp));
+    }
+
+    if (const auto *log = std::get_if<LogRecord>(&record.payload)) {
+        QString color;
+        if (log->severity == "INFO")
+            color = "blue";
+        else if (log->severity == "WARN")
+            color = "orange";
+        else if (log->severity == "ERROR")
+            color = "red";
+        else if (log->severity == "CRITICAL")
+            color = "darkred";
+
+        QString text = QString("severity: <font color='%1'>%2</font>, message: %3")
+                           .arg(color, log->severity, log->message);
+        if (!log->junk.isEmpty()) {
+            text += QString(", junk: %1").arg(log->junk);
+        }
+        return text;
+    }
+
+    return std::get<GenericPayload>(record.payload).text;
+}
@@ -13,14 +13,17 @@
 #include <QVariantMap>
 
 #include "core/appenums.h"
+#include "core/latencymonitor.h"
 #include "core/sharedkeys.h"
+#include "core/telemetry.h"
+#include "models/ringbuffer.h"
 
 /**
  * @class BaseTableModel
  * @brief Базовый класс для всех табличных моделей в приложении.
  *
- * Реализует основную логику работы с данными (добавление, удаление, сортировка)
- * и предоставляет общий интерфейс для QML.
+ * Описывает колонки таблицы (ключи, заголовки, ширины) и общий интерфейс для QML.
+ * Хранение строк и сортировку реализуют наследники, так как типы строк различаются.
  */
 class BaseTableModel : public QAbstractTableModel {
     Q_OBJECT
@@ -32,61 +35,27 @@ public:
     explicit BaseTableModel(QObject *parent = nullptr);
 
     // --- Переопределяемые виртуальные функции ---
-    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
-    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
     QHash<int, QByteArray> roleNames() const override;
 
     // --- Общие методы для управления данными ---
-    /**
-     * @brief Полностью заменяет данные в модели.
-     * @param data Новый список данных.
-     */
-    void setData(const QList<QVariantMap> &data);
-    /**
-     * @brief Добавляет несколько строк в начало модели.
-     * @param rowsData Список строк для добавления.
-     */
-    void addRows(const QList<QVariantMap> &rowsData);
-    /**
-     * @brief Добавляет одну строку в начало модели.
-     * @param rowData Данные для новой строки.
-     */
-    void addRow(const QVariantMap &rowData);
-    /**
-     * @brief Обновляет данные в существующей строке.
-     * @param row Индекс строки.
-     * @param rowData Новые данные.
-     */
-    void updateRow(int row, const QVariantMap &rowData);
-    /**
-     * @brief Удаляет несколько строк.
-     * @param row Начальная строка для удаления.
-     * @param count Количество удаляемых строк.
-     */
-    void removeRows(int row, int count);
-    /**
-     * @brief Удаляет одну строку.
-     * @param row Индекс строки для удаления.
-     */
-    void removeRow(int row);
     /**
      * @brief Очищает все данные из модели.
      */
-    void clear();
+    virtual void clear() = 0;
     /**
      * @brief Сортирует модель по указанной колонке.
      * @param column Индекс колонки.
      * @param order Порядок сортировки.
      */
-    void sortByColumn(int column, Qt::SortOrder order);
+    virtual void sortByColumn(int column, Qt::SortOrder order) = 0;
 
     // --- Методы для QML ---
     /**
      * @brief Возвращает данные строки в виде QVariantMap.
      */
-    Q_INVOKABLE QVariantMap getRowData(int row) const;
+    Q_INVOKABLE virtual QVariantMap getRowData(int row) const = 0;
     /// @brief Свойство с заголовками колонок.
     Q_PROPERTY(QStringList columnHeaders READ columnHeaders CONSTANT)
     /// @brief Свойство с относительной шириной колонок.
@@ -102,10 +71,43 @@ signals:
     void resetSorting();
 
 protected:
+    /**
+     * @struct SortKey
+     * @brief Ключ сортировки, извлекаемый из значения ячейки один раз на строку.
+     *
+     * Сравнивается сначала текст, затем число. Время и очередь хранятся как число
+     * (мс от эпохи), ID — как текстовая часть и числовой суффикс "_N",
+     * остальные значения — как текст в нижнем регистре.
+     */
+    struct SortKey {
+        QString text;       ///< Текстовая часть ключа.
+        qint64 number = 0;  ///< Числовая часть ключа.
+
+        bool operator<(const SortKey &other) const {
+            const int textCompare = text.compare(other.text);
+            return textCompare != 0 ? textCompare < 0 : number < other.number;
+        }
+    };
+
+    /**
+     * @brief Извлекает ключ сортировки из значения колонки.
+     * @param key Ключ колонки.
+     * @param value Значение ячейки.
+     */
+    static SortKey makeSortKey(const QString &key, const QVariant &value);
+    /**
+     * @brief Вычисляет порядок строк по заранее извлеченным ключам.
+     *
+     * Сортировка устойчивая: строки с равными ключами сохраняют взаимный порядок.
+     * @param keys Ключи сортировки по строкам.
+     * @param order Порядок сортировки.
+     * @return Индексы строк в новом порядке.
+     */
+    static QList<int> sortedOrder(const QList<SortKey> &keys, Qt::SortOrder order);
+
     QStringList m_keys;
     QStringList m_headers;
     QList<qreal> m_columnWidths;
-    QList<QVariantMap> m_data;
 };
 
 /**
@@ -123,16 +125,104 @@ public:
 
     explicit ClientTableModel(QObject *parent = nullptr);
 
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QHash<int, QByteArray> roleNames() const override;
+
+    /**
+     * @brief Полностью заменяет данные в модели.
+     * @param data Новый список данных.
+     */
+    void setData(const QList<QVariantMap> &data);
+    /**
+     * @brief Применяет пакет изменений клиентов без сброса модели.
+     *
+     * Строки находятся по дескриптору через индекс. Для каждой строки
+     * генерируется только нужный сигнал: вставка, dataChanged или удаление.
+     * Если таблица отсортирована, новые и измененные строки встают на свое
+     * место в текущем порядке сортировки.
+     * @param batch Пакет состояний клиентов (DELETED — удалить строку).
+     */
+    void applyUpdates(const QList<QVariantMap> &batch);
+    /**
+     * @brief Обновляет задержки доставки клиентов (колонки "Прием" и "Отображение").
+     *
+     * Задержки хранятся отдельно от строк по ID клиента, поэтому обновления
+     * состояния клиента из рабочего потока их не затирают. Порядок строк при
+     * сортировке по задержке пересчитывается при следующей сортировке.
+     * @param stats Статистика по ID клиента.
+     */
+    void applyLatency(const QHash<QString, ClientLatencyStats> &stats);
+    /**
+     * @brief Очищает задержки доставки всех клиентов.
+     */
+    void clearLatency();
+    /**
+     * @brief Удаляет задержки доставки клиента, удаленного из реестра.
+     * @param clientId ID клиента.
+     */
+    void forgetLatency(const QString &clientId) { m_latencyById.remove(clientId); }
+
+    void clear() override;
+    void sortByColumn(int column, Qt::SortOrder order) override;
+    QVariantMap getRowData(int row) const override;
+
+private:
+    /**
+     * @brief Формирует текст ячейки задержки: "p50 / p99 / max" в миллисекундах.
+     */
+    static QString latencyText(qint64 p50Us, qint64 p99Us, qint64 maxUs);
+
+    /**
+     * @brief Сравнивает строки в текущем порядке сортировки.
+     */
+    bool rowLessThan(const QVariantMap &a, const QVariantMap &b) const;
+    /**
+     * @brief Возвращает ключ сортировки строки по текущей колонке.
+     */
+    SortKey rowSortKey(const QVariantMap &rowData) const;
+    /**
+     * @brief Вставляет строку с учетом текущей сортировки (иначе — в конец).
+     */
+    void insertRow(const QVariantMap &rowData);
+    /**
+     * @brief Заменяет строку и при необходимости перемещает ее на место по сортировке.
+     */
+    void replaceRow(int row, const QVariantMap &rowData);
+    /**
+     * @brief Удаляет строки, объединяя соседние индексы в диапазоны.
+     * @param rows Индексы удаляемых строк.
+     */
+    void removeRowSet(QList<int> rows);
+    /**
+     * @brief Обновляет индекс дескриптор → строка для диапазона строк.
+     */
+    void reindexRows(int first, int last);
+
+    QList<QVariantMap> m_data;
+    /// @brief Индекс строк по дескриптору клиента.
+    QHash<quintptr, int> m_rowByDescriptor;
+    /// @brief Задержки доставки по ID клиента.
+    QHash<QString, ClientLatencyStats> m_latencyById;
+    /// @brief Колонка текущей сортировки (-1 — без сортировки).
+    int m_sortColumn = -1;
+    /// @brief Порядок текущей сортировки.
+    Qt::SortOrder m_sortOrder = Qt::AscendingOrder;
 };
 
 /**
  * @class DataTableModel
  * @brief Модель для отображения таблицы данных (сообщений) от клиентов.
+ *
+ * Хранит типизированные записи TelemetryRecord в кольцевом буфере фиксированной
+ * емкости: новые записи вставляются в начало, самые старые вытесняются за O(1).
+ * QVariant для QML создается только в data().
  */
 class DataTableModel : public BaseTableModel {
     Q_OBJECT
+    /// @brief Свойство с максимальным количеством строк таблицы.
+    Q_PROPERTY(int capacity READ capacity WRITE setCapacity NOTIFY capacityChanged)
+
 public:
     /**
      * @enum Roles
@@ -140,10 +230,58 @@ public:
      */
     enum Roles { TypeColorRole = Qt::UserRole + 1 };
 
+    /// @brief Емкость таблицы данных по умолчанию.
+    static constexpr int DEFAULT_CAPACITY = 5000;
+
     explicit DataTableModel(QObject *parent = nullptr);
 
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QHash<int, QByteArray> roleNames() const override;
+
+    /**
+     * @brief Добавляет пакет записей в начало модели (последняя запись пакета — первая строка).
+     *
+     * При заполненном буфере самые старые строки удаляются одним диапазоном.
+     * @param records Записи телеметрии.
+     */
+    void addRecords(const QList<TelemetryRecord> &records);
+
+    /**
+     * @brief Возвращает максимальное количество строк.
+     */
+    int capacity() const { return m_records.capacity(); }
+    /**
+     * @brief Задает максимальное количество строк. Лишние старые строки удаляются.
+     * @param capacity Новая емкость (не меньше 1).
+     */
+    void setCapacity(int capacity);
+
+    void clear() override;
+    void sortByColumn(int column, Qt::SortOrder order) override;
+    QVariantMap getRowData(int row) const override;
+
+private:
+    /**
+     * @brief Возвращает значение колонки записи для отображения и сортировки.
+     */
+    QVariant columnValue(const TelemetryRecord &record, int column) const;
+    /**
+     * @brief Формирует текст полезной нагрузки для колонки "Сообщение".
+     */
+    static QString payloadText(const TelemetryRecord &record);
+    /**
+     * @brief Возвращает ключ сортировки записи по колонке.
+     */
+    SortKey recordSortKey(const TelemetryRecord &record, int column) const;
+
+    RingBuffer<TelemetryRecord> m_records;
+
+signals:
+    /**
+     * @brief Сигнал об изменении емкости таблицы.
+     */
+    void capacityChanged();
 };
 
 #endif // BASETABLEMODEL_H
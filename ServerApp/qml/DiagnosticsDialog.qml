@@ -0,0 +1,209 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+import ServerApp
+
+Dialog {
+    id:     diagnosticsDialog
+    title:  "Диагностика конвейера приема"
+    modal:  false
+    width:  860
+    height: 640
+    anchors.centerIn: parent
+    standardButtons: Dialog.Close
+
+    readonly property var metrics: viewModel ? viewModel.flushMetrics : ({})
+    readonly property var columnWidths: [150, 150, 90, 80, 80, 80, 80, 80]
+
+    function ringText(prefix) {
+        const depth = metrics[prefix + "Depth"]
+        return depth === undefined ? "-" : depth + " / " + metrics[prefix + "Overflow"]
+    }
+
+    // Статистика пересчитывается только пока диалог открыт
+    Timer {
+        interval: 1000
+        repeat: true
+        running: diagnosticsDialog.visible
+        triggeredOnStart: true
+        onTriggered: if (viewModel) viewModel.refreshLatencyStats()
+    }
+
+    contentItem: ColumnLayout {
+        spacing: 10
+
+        // Метрики планировщика отправки пакетов
+        GroupBox {
+            title: "Отправка пакетов в UI"
+            Layout.fillWidth: true
+            font.pixelSize: AppTheme.normalFontSize
+
+            GridLayout {
+                anchors.fill: parent
+                columns: 6
+                columnSpacing: 15
+                rowSpacing: 4
+
+                Label { text: "Интервал, мс:";          font.pixelSize: AppTheme.fontSize; color: AppTheme.secondaryText }
+                Label { text: diagnosticsDialog.metrics.flushInterval ?? "-";   font.pixelSize: AppTheme.fontSize }
+                Label { text: "Применение в UI, мкс:";  font.pixelSize: AppTheme.fontSize; color: AppTheme.secondaryText }
+                Label { text: diagnosticsDialog.metrics.uiApplyUs ?? "-";       font.pixelSize: AppTheme.fontSize }
+                Label { text: "Подтверждение, мс:";     font.pixelSize: AppTheme.fontSize; color: AppTheme.secondaryText }
+                Label { text: diagnosticsDialog.metrics.uiRoundTripMs ?? "-";   font.pixelSize: AppTheme.fontSize }
+
+                Label { text: "По таймеру:";            font.pixelSize: AppTheme.fontSize; color: AppTheme.secondaryText }
+                Label { text: diagnosticsDialog.metrics.timerFlushes ?? "-";    font.pixelSize: AppTheme.fontSize }
+                Label { text: "Досрочно:";              font.pixelSize: AppTheme.fontSize; color: AppTheme.secondaryText }
+                Label { text: diagnosticsDialog.metrics.earlyFlushes ?? "-";    font.pixelSize: AppTheme.fontSize }
+                Label { text: "Отложено:";              font.pixelSize: AppTheme.fontSize; color: AppTheme.secondaryText }
+                Label { text: diagnosticsDialog.metrics.deferredFlushes ?? "-"; font.pixelSize: AppTheme.fontSize }
+
+                // Наибольшая глубина буфера / отброшено при переполнении
+                Label { text: "Буфер данных:";          font.pixelSize: AppTheme.fontSize; color: AppTheme.secondaryText }
+                Label { text: diagnosticsDialog.ringText("dataRing");   font.pixelSize: AppTheme.fontSize }
+                Label { text: "Буфер клиентов:";        font.pixelSize: AppTheme.fontSize; color: AppTheme.secondaryText }
+                Label { text: diagnosticsDialog.ringText("clientRing"); font.pixelSize: AppTheme.fontSize }
+                Label { text: "Буфер журнала:";         font.pixelSize: AppTheme.fontSize; color: AppTheme.secondaryText }
+                Label { text: diagnosticsDialog.ringText("logRing");    font.pixelSize: AppTheme.fontSize }
+            }
+        }
+
+        // Последняя оценка нагрузки и темп, заданный клиентам
+        GroupBox {
+            title: "Управление темпом клиентов"
+            Layout.fillWidth: true
+            font.pixelSize: AppTheme.normalFontSize
+
+            GridLayout {
+                anchors.fill: parent
+                columns: 6
+                columnSpacing: 15
+                rowSpacing: 4
+
+                Label { text: "Уровень:";               font.pixelSize: AppTheme.fontSize; color: AppTheme.secondaryText }
+                Label { text: diagnosticsDialog.metrics.flowLevel ?? "-";        font.pixelSize: AppTheme.fontSize }
+                Label { text: "Очередь разбора:";       font.pixelSize: AppTheme.fontSize; color: AppTheme.secondaryText }
+                Label { text: diagnosticsDialog.metrics.flowBacklog ?? "-";      font.pixelSize: AppTheme.fontSize }
+                Label { text: "Процессор, %:";          font.pixelSize: AppTheme.fontSize; color: AppTheme.secondaryText }
+                Label { text: diagnosticsDialog.metrics.flowCpuPercent ?? "-";   font.pixelSize: AppTheme.fontSize }
+
+                Label { text: "Интервал отправки, мс:"; font.pixelSize: AppTheme.fontSize; color: AppTheme.secondaryText }
+                Label { text: diagnosticsDialog.metrics.flowSendInterval ?? "-"; font.pixelSize: AppTheme.fontSize }
+                Label { text: "Доля сообщений:";        font.pixelSize: AppTheme.fontSize; color: AppTheme.secondaryText }
+                Label { text: diagnosticsDialog.metrics.flowSampleRatio ?? "-";  font.pixelSize: AppTheme.fontSize }
+            }
+        }
+
+        // Перцентили задержек по этапам
+        GroupBox {
+            title: "Задержки по этапам, мкс"
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            font.pixelSize: AppTheme.normalFontSize
+
+            ColumnLayout {
+                anchors.fill: parent
+                spacing: 0
+
+                Row {
+                    Layout.fillWidth: true
+                    Repeater {
+                        model: ["Тип", "Этап", "Кол-во", "p50", "p90", "p99", "p99.9", "max"]
+                        delegate: Rectangle {
+                            width: diagnosticsDialog.columnWidths[index]
+                            height: AppTheme.headerHeight
+                            color: AppTheme.headerColor
+                            border.color: AppTheme.headerBorderColor
+
+                            Text {
+                                anchors.fill: parent
+                                anchors.leftMargin: 6
+                                text: modelData
+                                color: AppTheme.headerTextColor
+                                verticalAlignment: Text.AlignVCenter
+                                font.pixelSize: AppTheme.fontSize
+                                font.bold: true
+                            }
+                        }
+                    }
+                }
+
+                ListView {
+                    id: latencyView
+                    Layout.fillWidth: true
+                    Layout.fillHeight: true
+                    clip: true
+                    model: viewModel ? viewModel.latencyStats : []
+                    ScrollBar.vertical: ScrollBar {}
+
+                    delegate: Row {
+                        id: latencyRow
+                        readonly property int rowIndex: index
+                        readonly property var cells: [
+                            modelData.type, modelData.stage, modelData.count,
+                            modelData.p50, modelData.p90, modelData.p99,
+                            modelData.p999, modelData.max
+                        ]
+
+                        Repeater {
+                            model: latencyRow.cells
+                            delegate: Rectangle {
+                                width: diagnosticsDialog.columnWidths[index]
+                                height: AppTheme.rowHeight - 10
+                                color: latencyRow.rowIndex % 2 === 0 ? AppTheme.evenRowColor : AppTheme.oddRowColor
+                                border.color: AppTheme.borderColor
+
+                                Text {
+                                    anchors.fill: parent
+                                    anchors.leftMargin: 6
+                                    text: modelData
+                                    color: AppTheme.textColor
+                                    verticalAlignment: Text.AlignVCenter
+                                    font.family: AppTheme.monoFont
+                                    font.pixelSize: AppTheme.fontSize
+                                    elide: Text.ElideRight
+                                }
+                            }
+                        }
+                    }
+
+                    Label {
+                        anchors.centerIn: parent
+                        text: "Нет данных"
+                        color: AppTheme.placeholderText
+                        visible: latencyView.count === 0
+                        font.pixelSize: AppTheme.normalFontSize
+                    }
+                }
+            }
+        }
+
+        RowLayout {
+            Layout.fillWidth: true
+            spacing: 10
+
+            Button {
+                text: "Сбросить"
+                font.pixelSize: AppTheme.normalFontSize
+                onClicked: if (viewModel) viewModel.resetLatencyStats()
+            }
+            Button {
+                text: "Сохранить в файл"
+                highlighted: true
+                font.pixelSize: AppTheme.normalFontSize
+                onClicked: {
+                    if (!viewModel) return
+                    const path = viewModel.dumpLatencyStats()
+                    savedPathLabel.text = path ? "Сохранено: " + path : "Не удалось сохранить файл"
+                }
+            }
+            Label {
+                id: savedPathLabel
+                Layout.fillWidth: true
+                elide: Text.ElideMiddle
+                color: AppTheme.secondaryText
+                font.pixelSize: AppTheme.fontSize
+            }
+        }
+    }
+}
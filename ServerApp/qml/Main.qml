@@ -35,6 +35,11 @@ ApplicationWindow {
         model: root.hasViewModel ? viewModel.serverListModel : null
     }
 
+    DiagnosticsDialog {
+        id: diagnosticsDialog
+        anchors.centerIn: parent
+    }
+
     // Компоненты для переиспользования
     Component {
         id: clearButtonComponent
@@ -172,6 +177,16 @@ ApplicationWindow {
                 Item {
                     Layout.fillWidth: true
                 }
+
+                // Кнопка панели диагностики
+                ToolButton {
+                    text: "Диагностика"
+                    font.pixelSize: AppTheme.normalFontSize
+                    onClicked: diagnosticsDialog.open()
+
+                    ToolTip.visible: hovered
+                    ToolTip.text: "Задержки конвейера приема и метрики отправки"
+                }
             }
         }
 
@@ -280,33 +295,72 @@ ApplicationWindow {
                         anchors.fill: parent
                         spacing: 5
 
-                        Label {
-                            text: "Лог"
-                            font.bold: true
-                            font.pixelSize: AppTheme.normalFontSize
-                        }
-
-                        ScrollView {
+                        RowLayout {
                             Layout.fillWidth: true
-                            Layout.fillHeight: true
+                            Layout.rightMargin: 90
+                            spacing: 10
 
-                            TextArea {
-                                id: logArea
-                                text: root.hasViewModel ? viewModel.logText : ""
-                                readOnly: true
-                                wrapMode: TextArea.Wrap
-                                font.family: AppTheme.monoFont
+                            Label {
+                                text: "Лог"
+                                font.bold: true
+                                font.pixelSize: AppTheme.normalFontSize
+                            }
+
+                            ComboBox {
+                                id: logLevelCombo
+                                model: [
+                                    { text: "Все уровни",   value: AppEnums.Debug },
+                                    { text: "INFO и выше",  value: AppEnums.Info },
+                                    { text: "WARN и выше",  value: AppEnums.Warning },
+                                    { text: "Только ERROR", value: AppEnums.Error }
+                                ]
+                                textRole: "text"
+                                valueRole: "value"
+                                implicitWidth: 150
+                                font.pixelSize: AppTheme.smallFontSize
+                                onActivated: if (root.hasViewModel) viewModel.logModel.minLevel = currentValue
+                            }
+
+                            TextField {
+                                id: logFilterField
+                                Layout.fillWidth: true
+                                placeholderText: "Фильтр по тексту или категории"
                                 font.pixelSize: AppTheme.smallFontSize
-                                color: AppTheme.logText
                                 selectByMouse: true
+                                onTextChanged: if (root.hasViewModel) viewModel.logModel.filterText = text
+                            }
+                        }
 
-                                background: Rectangle {
-                                    color: AppTheme.logBackground
-                                    border.color: AppTheme.logBorder
+                        Rectangle {
+                            Layout.fillWidth: true
+                            Layout.fillHeight: true
+                            color: AppTheme.logBackground
+                            border.color: AppTheme.logBorder
+
+                            // Виртуализированный список: делегаты создаются только для видимых строк
+                            ListView {
+                                id: logView
+                                anchors.fill: parent
+                                anchors.margins: 1
+                                clip: true
+                                model: root.hasViewModel ? viewModel.logModel : null
+                                reuseItems: true
+                                boundsBehavior: Flickable.StopAtBounds
+                                ScrollBar.vertical: ScrollBar {}
+
+                                delegate: Text {
+                                    width: ListView.view.width
+                                    leftPadding: 4
+                                    rightPadding: 4
+                                    text: "[" + model.time + "] " + model.levelName + " [" + model.category + "] " + model.message
+                                    color: model.levelColor
+                                    font.family: AppTheme.monoFont
+                                    font.pixelSize: AppTheme.smallFontSize
+                                    wrapMode: Text.Wrap
                                 }
 
-                                // Автоскролл к началу при обновлении
-                                onTextChanged: cursorPosition = 0
+                                // Новые записи появляются сверху — остаемся в начале, если список не прокручен
+                                onCountChanged: if (atYBeginning) positionViewAtBeginning()
                             }
                         }
                     }
@@ -8,7 +8,7 @@ Dialog {
     title:  "Управление серверами"
     modal:  true
     width:  650
-    height: 500
+    height: 580
     anchors.centerIn: parent
     standardButtons: Dialog.Close
 
@@ -35,9 +35,10 @@ Dialog {
                     id: serverTypeCombo
                     model: [
                         { text: "TCP",          value: AppEnums.TCP },
-                        //{ text: "UDP",          value: AppEnums.UDP },
-                        //{ text: "MODBUS TCP",   value: AppEnums.MODBUS_TCP },
-                        //{ text: "MODBUS RTU",   value: AppEnums.MODBUS_RTU }
+                        { text: "UDP",          value: AppEnums.UDP },
+                        { text: "LOCAL",        value: AppEnums.LOCAL },
+                        { text: "MODBUS TCP",   value: AppEnums.MODBUS_TCP },
+                        { text: "MODBUS RTU",   value: AppEnums.MODBUS_RTU }
                     ]
                     textRole: "text"
                     valueRole: "value"
@@ -73,6 +74,54 @@ Dialog {
             }
         }
 
+        // Параметры, применяемые к вновь создаваемым серверам
+        GroupBox {
+            title: "Параметры новых серверов"
+            Layout.fillWidth: true
+            font.pixelSize: AppTheme.normalFontSize
+
+            RowLayout {
+                anchors.fill: parent
+                spacing: 10
+
+                Label {
+                    text: "Потоков ввода-вывода:"
+                    font.pixelSize: AppTheme.normalFontSize
+                }
+                SpinBox {
+                    id: ioThreadsSpinBox
+                    editable: true
+                    from: 1
+                    to: viewModel ? viewModel.maxIoThreadCount : 1
+                    value: viewModel ? viewModel.ioThreadCount : 1
+                    implicitWidth: 150
+                    font.pixelSize: AppTheme.normalFontSize
+                    onValueModified: viewModel.ioThreadCount = value
+                }
+
+                Label {
+                    text: "Медленный клиент:"
+                    font.pixelSize: AppTheme.normalFontSize
+                }
+                ComboBox {
+                    id: slowConsumerCombo
+                    // Порядок совпадает с IClient::SlowConsumerPolicy
+                    model: ["Отбрасывать", "Замещать", "Отключать"]
+                    currentIndex: viewModel ? viewModel.slowConsumerPolicy : 1
+                    implicitWidth: 150
+                    font.pixelSize: AppTheme.normalFontSize
+                    onActivated: viewModel.slowConsumerPolicy = currentIndex
+
+                    ToolTip.visible: hovered
+                    ToolTip.text: "Поведение при переполнении очереди отправки клиента"
+                }
+
+                Item {
+                    Layout.fillWidth: true
+                }
+            }
+        }
+
         // Список серверов
         GroupBox {
             title: "Конфигурация серверов"
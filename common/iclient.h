@@ -18,6 +18,25 @@ class IClient : public QObject {
     Q_OBJECT
 
 public:
+    /**
+     * @enum FramingMode
+     * @brief Режим разбиения потока байт на сообщения.
+     */
+    enum class FramingMode {
+        Raw,            ///< Без кадрирования: одно чтение считается одним сообщением
+        LengthPrefixed  ///< Каждое сообщение предваряется 4-байтной длиной
+    };
+
+    /**
+     * @enum SlowConsumerPolicy
+     * @brief Поведение при переполнении очереди отправки медленного получателя.
+     */
+    enum class SlowConsumerPolicy {
+        Drop,       ///< Новые сообщения отбрасываются
+        Coalesce,   ///< Сообщение с ключом заменяет ожидающее с тем же ключом, остальные отбрасываются
+        Disconnect  ///< Соединение разрывается
+    };
+
     /**
      * @brief Виртуальный деструктор по умолчанию.
      */
@@ -48,18 +67,50 @@ public:
      * @return true, если подключен, иначе false.
      */
     virtual bool isConnected() const = 0;
+    /**
+     * @brief Возвращает текущий режим кадрирования сообщений.
+     * @return Режим кадрирования.
+     */
+    virtual FramingMode framingMode() const = 0;
 
     /**
      * @brief Устанавливает строковый идентификатор клиента.
      * @param id Новый ID.
      */
     virtual void setId(const QString &id) = 0;
+    /**
+     * @brief Устанавливает режим кадрирования для входящих и исходящих сообщений.
+     * @param mode Новый режим.
+     */
+    virtual void setFramingMode(FramingMode mode) = 0;
 
     /**
      * @brief Отправляет данные клиенту.
      * @param data Данные для отправки.
      */
     virtual void sendData(const QByteArray &data) = 0;
+    /**
+     * @brief Отправляет данные, которые могут заменить еще не отправленное сообщение с тем же ключом.
+     *
+     * Используется для сообщений, где важно только последнее значение (например, конфигурация).
+     * @param data Данные для отправки.
+     * @param coalesceKey Ключ замещения; пустой ключ означает обычную отправку.
+     */
+    virtual void sendData(const QByteArray &data, const QString &coalesceKey) = 0;
+    /**
+     * @brief Возвращает объем данных, ожидающих отправки (в байтах). Потокобезопасен.
+     */
+    virtual qint64 queuedBytes() const = 0;
+    /**
+     * @brief Возвращает количество сообщений, отброшенных из-за переполнения очереди. Потокобезопасен.
+     */
+    virtual quint64 droppedMessages() const = 0;
+    /**
+     * @brief Задает поведение при переполнении очереди отправки. Потокобезопасен.
+     * @param policy Политика для медленного получателя.
+     * @param maxQueuedBytes Максимальный объем очереди (в байтах).
+     */
+    virtual void setSlowConsumerPolicy(SlowConsumerPolicy policy, qint64 maxQueuedBytes) = 0;
 
     /**
      * @brief Подключается к хосту.
@@ -96,10 +147,11 @@ signals:
      */
     void disconnected();
     /**
-     * @brief Сигнал, испускаемый при получении данных.
+     * @brief Сигнал, испускаемый при получении целого сообщения.
      * @param data Полученные данные.
+     * @param receivedAtNs Время чтения данных из сокета (MonotonicClock::nowNs()).
      */
-    void dataReceived(const QByteArray &data);
+    void dataReceived(const QByteArray &data, qint64 receivedAtNs);
     /**
      * @brief Сигнал, испускаемый при возникновении ошибки.
      * @param message Сообщение об ошибке.
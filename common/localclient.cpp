@@ -0,0 +1,124 @@
+#include "localclient.h"
+#include "monotonicclock.h"
+#include "protocol.h"
+
+LocalClient::LocalClient(QLocalSocket *socket, QObject *parent)
+    : IClient(parent), m_socket(socket), m_descriptor(quintptr(socket->socketDescriptor())),
+    m_serverName(socket->fullServerName()),
+    m_connected(socket->state() == QLocalSocket::ConnectedState) {
+    if (m_socket->parent() == nullptr) {
+        m_socket->setParent(this);
+    }
+
+    connect(m_socket, &QLocalSocket::connected, this, &LocalClient::handleConnected);
+    connect(m_socket, &QLocalSocket::disconnected, this, &LocalClient::handleDisconnected);
+    connect(m_socket, &QLocalSocket::readyRead, this, &LocalClient::handleReadyRead);
+    connect(m_socket, &QLocalSocket::errorOccurred, this, &LocalClient::handleError);
+    connect(m_socket, &QLocalSocket::bytesWritten, this, &LocalClient::handleBytesWritten);
+}
+
+void LocalClient::setFramingMode(FramingMode mode) {
+    m_framingMode = mode;
+    if (mode == FramingMode::Raw) {
+        m_framer.clear();
+    }
+}
+
+void LocalClient::connectToHost(const QString &host, quint16 port) {
+    Q_UNUSED(host)
+    if (m_socket->state() == QLocalSocket::UnconnectedState) {
+        m_port = port;
+        m_socket->connectToServer(Protocol::Local::SERVER_NAME_PREFIX + QString::number(port));
+    }
+}
+
+void LocalClient::disconnect() {
+    if (m_connected) {
+        m_socket->disconnectFromServer();
+    }
+}
+
+void LocalClient::sendData(const QByteArray &data) {
+    sendData(data, QString());
+}
+
+void LocalClient::sendData(const QByteArray &data, const QString &coalesceKey) {
+    if (m_connected) {
+        enqueue(m_framingMode == FramingMode::LengthPrefixed ? MessageFramer::encode(data) : data,
+                coalesceKey);
+    }
+}
+
+void LocalClient::setSlowConsumerPolicy(SlowConsumerPolicy policy, qint64 maxQueuedBytes) {
+    m_policy = policy;
+    m_maxQueuedBytes = qMax<qint64>(SendQueue::HIGH_WATERMARK, maxQueuedBytes);
+}
+
+void LocalClient::handleConnected() {
+    m_descriptor = quintptr(m_socket->socketDescriptor());
+    m_serverName = m_socket->fullServerName();
+    m_connected = true;
+    emit connected();
+}
+
+void LocalClient::handleDisconnected() {
+    m_connected = false;
+    m_sendQueue.clear();
+    // Режим кадрирования согласуется заново при каждом подключении
+    setFramingMode(FramingMode::Raw);
+    emit disconnected();
+}
+
+void LocalClient::handleReadyRead() {
+    const QByteArray data = m_socket->readAll();
+    const qint64 receivedAtNs = MonotonicClock::nowNs();
+
+    if (m_framingMode == FramingMode::Raw) {
+        emit dataReceived(data, receivedAtNs);
+        return;
+    }
+
+    m_framer.append(data);
+
+    QByteArray message;
+    while (m_framer.takeMessage(message)) {
+        emit dataReceived(message, receivedAtNs);
+    }
+
+    if (m_framer.hasError()) {
+        emit errorOccurred("Получен кадр недопустимого размера, соединение разорвано.");
+        m_framer.clear();
+        m_socket->abort();
+    }
+}
+
+void LocalClient::handleError(QLocalSocket::LocalSocketError socketError) {
+    Q_UNUSED(socketError)
+    emit errorOccurred(m_socket->errorString());
+}
+
+void LocalClient::handleBytesWritten() {
+    if (m_sendQueue.isEmpty() || m_socket->bytesToWrite() > SendQueue::LOW_WATERMARK)
+        return;
+    while (!m_sendQueue.isEmpty() && m_socket->bytesToWrite() < SendQueue::HIGH_WATERMARK) {
+        m_socket->write(m_sendQueue.takeChunk());
+    }
+}
+
+void LocalClient::enqueue(const QByteArray &data, const QString &coalesceKey) {
+    // Быстрый путь: очередь пуста и сокет успевает отдавать данные
+    if (m_sendQueue.isEmpty() && m_socket->bytesToWrite() < SendQueue::HIGH_WATERMARK) {
+        m_socket->write(data);
+        return;
+    }
+
+    if (m_sendQueue.push(data, coalesceKey, m_policy, m_maxQueuedBytes) == SendQueue::Result::Overflow) {
+        if (m_policy == SlowConsumerPolicy::Disconnect) {
+            emit errorOccurred("Получатель не успевает принимать данные, соединение разорвано.");
+            m_sendQueue.clear();
+            m_socket->abort();
+        } else {
+            ++m_droppedMessages;
+        }
+    }
+}
@@ -0,0 +1,146 @@
+/**
+ * @file localclient.h
+ * @brief Определяет класс LocalClient, реализующий IClient для локального сокета.
+ */
+#ifndef LOCALCLIENT_H
+#define LOCALCLIENT_H
+
+#include <QLocalSocket>
+
+#include "iclient.h"
+#include "messageframer.h"
+#include "sendqueue.h"
+
+/**
+ * @class LocalClient
+ * @brief Реализация интерфейса IClient поверх QLocalSocket.
+ *
+ * Локальный сокет (Unix domain socket, в Windows — именованный канал)
+ * используется агентами, запущенными на одном хосте с сервером: данные не
+ * проходят через стек TCP/IP loopback. Кадрирование, форматы сообщений и
+ * очередь отправки с политикой медленного получателя те же, что у TcpClient.
+ *
+ * Имя сокета строится из Protocol::Local::SERVER_NAME_PREFIX и номера
+ * "порта" сервера, поэтому connectToHost() игнорирует адрес. Все методы
+ * вызываются в потоке объекта.
+ */
+class LocalClient : public IClient {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Конструктор класса LocalClient.
+     * @param socket Указатель на существующий QLocalSocket.
+     * @param parent Родительский объект QObject.
+     */
+    explicit LocalClient(QLocalSocket *socket, QObject *parent = nullptr);
+
+    /**
+     * @brief Возвращает дескриптор сокета.
+     */
+    quintptr descriptor() const override { return m_descriptor; }
+    /**
+     * @brief Возвращает имя локального сервера.
+     */
+    QString address() const override { return m_serverName; }
+    /**
+     * @brief Возвращает номер, из которого построено имя сервера.
+     */
+    quint16 port() const override { return m_port; }
+    QString id() const override { return m_id; }
+    bool isConnected() const override { return m_connected; }
+    FramingMode framingMode() const override { return m_framingMode; }
+
+    void setId(const QString &id) override { m_id = id; }
+    /**
+     * @brief Устанавливает режим кадрирования.
+     *
+     * При переходе в режим Raw недочитанный остаток буфера сборки отбрасывается.
+     */
+    void setFramingMode(FramingMode mode) override;
+
+    /**
+     * @brief Подключается к локальному серверу с номером port; адрес не используется.
+     */
+    void connectToHost(const QString &host, quint16 port) override;
+    /**
+     * @brief Отключается от сервера.
+     */
+    void disconnect() override;
+
+    /**
+     * @brief Отправляет данные.
+     * @param data Данные для отправки.
+     */
+    void sendData(const QByteArray &data) override;
+    /**
+     * @brief Отправляет данные с ключом замещения (см. IClient::sendData).
+     */
+    void sendData(const QByteArray &data, const QString &coalesceKey) override;
+    /**
+     * @brief Возвращает объем очереди отправки и буфера сокета.
+     */
+    qint64 queuedBytes() const override { return m_sendQueue.bytes() + m_socket->bytesToWrite(); }
+    /**
+     * @brief Возвращает количество отброшенных сообщений.
+     */
+    quint64 droppedMessages() const override { return m_droppedMessages; }
+    /**
+     * @brief Задает политику для медленного получателя.
+     */
+    void setSlowConsumerPolicy(SlowConsumerPolicy policy, qint64 maxQueuedBytes) override;
+
+private slots:
+    /**
+     * @brief Обрабатывает сигнал connected от сокета.
+     */
+    void handleConnected() override;
+    /**
+     * @brief Обрабатывает сигнал disconnected от сокета.
+     */
+    void handleDisconnected() override;
+    /**
+     * @brief Обрабатывает сигнал readyRead от сокета.
+     */
+    void handleReadyRead() override;
+    /**
+     * @brief Обрабатывает ошибку сокета.
+     */
+    void handleError(QLocalSocket::LocalSocketError socketError);
+    /**
+     * @brief Дописывает очередь отправки, когда буфер сокета освободился.
+     */
+    void handleBytesWritten();
+
+private:
+    /**
+     * @brief Пишет данные в сокет или ставит их в очередь.
+     */
+    void enqueue(const QByteArray &data, const QString &coalesceKey);
+
+    /// @brief Указатель на QLocalSocket.
+    QLocalSocket *m_socket;
+    /// @brief Строковый идентификатор клиента.
+    QString m_id;
+    /// @brief Дескриптор сокета.
+    quintptr m_descriptor;
+    /// @brief Имя локального сервера.
+    QString m_serverName;
+    /// @brief Номер, из которого построено имя сервера.
+    quint16 m_port = 0;
+    /// @brief Признак установленного соединения.
+    bool m_connected;
+    /// @brief Текущий режим кадрирования.
+    FramingMode m_framingMode = FramingMode::Raw;
+    /// @brief Буфер сборки входящих кадров.
+    MessageFramer m_framer;
+
+    /// @brief Очередь отправки.
+    SendQueue m_sendQueue;
+    /// @brief Количество отброшенных сообщений.
+    quint64 m_droppedMessages = 0;
+    SlowConsumerPolicy m_policy = SlowConsumerPolicy::Coalesce;
+    qint64 m_maxQueuedBytes = SendQueue::DEFAULT_MAX_BYTES;
+};
+
+#endif // LOCALCLIENT_H
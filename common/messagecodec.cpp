@@ -0,0 +1,53 @@
+#include "messagecodec.h"
+#include "protocol.h"
+
+#include <QCborValue>
+#include <QJsonDocument>
+#include <QJsonParseError>
+
+QByteArray MessageCodec::encode(const QJsonObject &message, Encoding encoding) {
+    if (encoding == Encoding::Cbor) {
+        return QCborMap::fromJsonObject(message).toCborValue().toCbor();
+    }
+    return QJsonDocument(message).toJson(QJsonDocument::Compact);
+}
+
+bool MessageCodec::decode(const QByteArray &data, QCborMap &message,
+                          QString *errorString) {
+    if (data.startsWith('{')) {
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+        if (parseError.error != QJsonParseError::NoError) {
+            if (errorString)
+                *errorString = parseError.errorString();
+            return false;
+        }
+        if (!doc.isObject()) {
+            if (errorString)
+                *errorString = "JSON не является объектом";
+            return false;
+        }
+        message = QCborMap::fromJsonObject(doc.object());
+        return true;
+    }
+
+    QCborParserError parseError;
+    QCborValue value = QCborValue::fromCbor(data, &parseError);
+    if (parseError.error != QCborError::NoError) {
+        if (errorString)
+            *errorString = parseError.errorString();
+        return false;
+    }
+    if (!value.isMap()) {
+        if (errorString)
+            *errorString = "CBOR не является картой";
+        return false;
+    }
+    message = value.toMap();
+    return true;
+}
+
+QString MessageCodec::encodingName(Encoding encoding) {
+    return encoding == Encoding::Cbor ? Protocol::Encoding::CBOR
+                                      : Protocol::Encoding::JSON;
+}
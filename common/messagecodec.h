@@ -0,0 +1,56 @@
+/**
+ * @file messagecodec.h
+ * @brief Определяет класс MessageCodec для сериализации сообщений протокола.
+ */
+#ifndef MESSAGECODEC_H
+#define MESSAGECODEC_H
+
+#include <QByteArray>
+#include <QCborMap>
+#include <QJsonObject>
+#include <QString>
+
+/**
+ * @class MessageCodec
+ * @brief Кодирование и декодирование сообщений в JSON или CBOR.
+ *
+ * Сообщения формируются как QJsonObject, а разбираются в QCborMap: в Qt 6 объект
+ * JSON и карта CBOR используют общее внутреннее представление, поэтому
+ * преобразование QJsonObject -> QCborMap не копирует данные. Формат входящего
+ * сообщения определяется по первому байту: '{' — JSON, иначе — CBOR.
+ */
+class MessageCodec {
+public:
+    /**
+     * @enum Encoding
+     * @brief Формат сериализации сообщений на проводе.
+     */
+    enum class Encoding {
+        Json,   ///< Текстовый JSON (по умолчанию, совместим со всеми клиентами)
+        Cbor    ///< Двоичный CBOR, согласуется при регистрации
+    };
+
+    /**
+     * @brief Сериализует сообщение в заданном формате.
+     * @param message Сообщение.
+     * @param encoding Формат.
+     * @return Сериализованные данные.
+     */
+    static QByteArray encode(const QJsonObject &message, Encoding encoding);
+    /**
+     * @brief Разбирает сообщение в формате JSON или CBOR.
+     * @param data Данные одного сообщения.
+     * @param message Выходной параметр для разобранного сообщения.
+     * @param errorString Необязательный выходной параметр для текста ошибки.
+     * @return true, если данные содержат корректный объект (карту).
+     */
+    static bool decode(const QByteArray &data, QCborMap &message,
+                       QString *errorString = nullptr);
+
+    /**
+     * @brief Возвращает название формата для протокола.
+     */
+    static QString encodingName(Encoding encoding);
+};
+
+#endif // MESSAGECODEC_H
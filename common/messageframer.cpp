@@ -0,0 +1,66 @@
+#include "messageframer.h"
+#include "protocol.h"
+
+#include <QtEndian>
+
+QByteArray MessageFramer::encode(const QByteArray &message) {
+    QByteArray frame;
+    frame.reserve(Protocol::Framing::HEADER_SIZE + message.size());
+    frame.resize(Protocol::Framing::HEADER_SIZE);
+    qToBigEndian<quint32>(static_cast<quint32>(message.size()), frame.data());
+    frame.append(message);
+    return frame;
+}
+
+void MessageFramer::append(const QByteArray &data) {
+    // Сжимаем буфер, только когда прочитанная часть занимает его половину
+    if (m_readOffset > 0 && m_readOffset >= m_buffer.size() / 2) {
+        m_buffer.remove(0, m_readOffset);
+        m_readOffset = 0;
+    }
+    m_buffer.append(data);
+}
+
+bool MessageFramer::takeMessage(QByteArray &message) {
+    const qsizetype available = m_buffer.size() - m_readOffset;
+    if (m_error || available <= 0)
+        return false;
+
+    const char *head = m_buffer.constData() + m_readOffset;
+
+    // JSON без префикса длины — отдаем остаток буфера целиком
+    if (*head == '{') {
+        message = m_buffer.mid(m_readOffset);
+        m_buffer.resize(0);
+        m_readOffset = 0;
+        return true;
+    }
+
+    if (available < Protocol::Framing::HEADER_SIZE)
+        return false;
+
+    const quint32 length = qFromBigEndian<quint32>(head);
+    if (length > static_cast<quint32>(Protocol::Framing::MAX_FRAME_SIZE)) {
+        m_error = true;
+        return false;
+    }
+
+    const qsizetype frameSize = Protocol::Framing::HEADER_SIZE + length;
+    if (available < frameSize)
+        return false;
+
+    message = m_buffer.mid(m_readOffset + Protocol::Framing::HEADER_SIZE, length);
+    m_readOffset += frameSize;
+
+    if (m_readOffset == m_buffer.size()) {
+        m_buffer.resize(0);
+        m_readOffset = 0;
+    }
+    return true;
+}
+
+void MessageFramer::clear() {
+    m_buffer.clear();
+    m_readOffset = 0;
+    m_error = false;
+}
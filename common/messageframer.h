@@ -0,0 +1,67 @@
+/**
+ * @file messageframer.h
+ * @brief Определяет класс MessageFramer для кадрирования сообщений в потоке байт.
+ */
+#ifndef MESSAGEFRAMER_H
+#define MESSAGEFRAMER_H
+
+#include <QByteArray>
+
+/**
+ * @class MessageFramer
+ * @brief Буфер сборки кадров с 4-байтным префиксом длины (big-endian).
+ *
+ * TCP не сохраняет границы сообщений: одно чтение может содержать несколько
+ * сообщений или только часть одного. Класс накапливает входящие байты и
+ * выделяет из них целые кадры. Прочитанная часть буфера не копируется при
+ * каждом извлечении — сдвигается только смещение, а сжатие буфера выполняется
+ * не чаще, чем он заполняется наполовину.
+ *
+ * Сообщение, начинающееся с символа '{', считается JSON без кадрирования
+ * (устаревший режим): префикс длины с таким старшим байтом превышал бы
+ * Protocol::Framing::MAX_FRAME_SIZE и не может встретиться в корректном потоке.
+ */
+class MessageFramer {
+public:
+    /**
+     * @brief Формирует кадр: префикс длины и данные сообщения.
+     * @param message Данные сообщения.
+     * @return Готовый к отправке кадр.
+     */
+    static QByteArray encode(const QByteArray &message);
+
+    /**
+     * @brief Добавляет прочитанные из сокета байты в буфер.
+     * @param data Новые данные.
+     */
+    void append(const QByteArray &data);
+    /**
+     * @brief Извлекает очередное целое сообщение из буфера.
+     * @param message Выходной параметр для данных сообщения (без префикса).
+     * @return true, если сообщение извлечено; false, если данных недостаточно
+     * или поток поврежден (см. hasError()).
+     */
+    bool takeMessage(QByteArray &message);
+    /**
+     * @brief Проверяет, был ли получен кадр с недопустимой длиной.
+     */
+    bool hasError() const { return m_error; }
+    /**
+     * @brief Возвращает количество байт, ожидающих сборки.
+     */
+    qsizetype pendingBytes() const { return m_buffer.size() - m_readOffset; }
+    /**
+     * @brief Очищает буфер и сбрасывает ошибку.
+     */
+    void clear();
+
+private:
+    /// @brief Накопленные входящие данные.
+    QByteArray m_buffer;
+    /// @brief Смещение начала еще не разобранных данных в буфере.
+    qsizetype m_readOffset = 0;
+    /// @brief Признак поврежденного потока.
+    bool m_error = false;
+};
+
+#endif // MESSAGEFRAMER_H
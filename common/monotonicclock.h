@@ -0,0 +1,32 @@
+/**
+ * @file monotonicclock.h
+ * @brief Определяет функции монотонных часов для измерения задержек.
+ */
+#ifndef MONOTONICCLOCK_H
+#define MONOTONICCLOCK_H
+
+#include <QtGlobal>
+
+#include <chrono>
+
+/**
+ * @namespace MonotonicClock
+ * @brief Монотонные часы, общие для всех потоков процесса.
+ *
+ * Значения не связаны с календарным временем и пригодны только для вычисления
+ * интервалов, зато не скачут при переводе системных часов.
+ */
+namespace MonotonicClock {
+
+/**
+ * @brief Возвращает текущее значение монотонных часов в наносекундах.
+ */
+inline qint64 nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace MonotonicClock
+
+#endif // MONOTONICCLOCK_H
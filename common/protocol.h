@@ -23,11 +23,15 @@ const QString REGISTRATION      = "Registration";   ///< Регистрация
 const QString NETWORK_METRICS   = "NetworkMetrics"; ///< Отправка метрик сети.
 const QString DEVICE_STATUS     = "DeviceStatus";   ///< Отправка статуса устройства.
 const QString LOG               = "Log";            ///< Отправка логов.
+const QString REGISTERS         = "Registers";      ///< Значения регистров опрашиваемого Modbus-устройства.
+const QString PROBE             = "Probe";          ///< Замер задержки; сервер возвращает сообщение с Keys::SERVER_TIME.
 
 // --- От сервера к клиенту ---
 const QString CONFIRMATION      = "Confirmation";   ///< Подтверждение регистрации.
 const QString CONFIGURATION     = "Configuration";  ///< Отправка конфигурации клиенту.
 const QString COMMAND           = "Command";        ///< Отправка команды клиенту.
+const QString BUSY              = "Busy";           ///< Сервер перегружен: подключение закрывается, повторить через Keys::RETRY_AFTER.
+const QString FLOW_CONTROL      = "FlowControl";    ///< Темп отправки телеметрии (см. Protocol::FlowControl).
 } // namespace MessageType
 
 /**
@@ -39,8 +43,39 @@ const QString ID                = "id";             ///< Идентификат
 const QString TYPE              = "type";           ///< Тип сообщения (из MessageType).
 const QString PAYLOAD           = "payload";        ///< Полезная нагрузка (данные).
 const QString COMMAND           = "command";        ///< Текст команды.
+const QString FRAMING           = "framing";        ///< Запрашиваемый/подтвержденный режим кадрирования.
+const QString ENCODING          = "encoding";       ///< Запрашиваемый/подтвержденный формат сообщений.
+const QString SENT_AT           = "sentAt";         ///< Время отправки (мкс, см. Protocol::Timing).
+const QString SEQUENCE          = "seq";            ///< Номер сообщения клиента (с 1, растет на каждое сообщение).
+const QString SERVER_TIME       = "serverTime";     ///< Время сервера в ответе на Probe (мкс, монотонные часы).
+const QString RETRY_AFTER       = "retryAfter";     ///< Рекомендуемая пауза перед переподключением (мс).
+const QString SEND_INTERVAL     = "sendInterval";   ///< Наименьший интервал между сообщениями телеметрии (мс, 0 — без ограничения).
+const QString SAMPLE_RATIO      = "sampleRatio";    ///< Доля отправляемых сообщений телеметрии (от 0 до 1).
+
+// --- Ключи телеметрии (полезная нагрузка сообщений клиента) ---
+const QString BAND_WIDTH        = "bandWidth";      ///< Пропускная способность
+const QString LATENCY           = "latency";        ///< Задержка
+const QString PACKET_LOSS       = "packetLoss";     ///< Потеря пакетов
+const QString UP_TIME           = "upTime";         ///< Время работы устройства
+const QString CPU_USAGE         = "cpuUsage";       ///< Загрузка процессора
+const QString MEMORY_USAGE      = "memoryUsage";    ///< Загрузка памяти
+const QString CPU_TEMP          = "cpuTemp";        ///< Температура процессора
+const QString JUNK              = "junk";           ///< Дополнительные данные лога
+const QString SEVERITY          = "severity";       ///< Уровень критичности лога
+const QString MESSAGE           = "message";        ///< Текст лога
 } // namespace Keys
 
+/**
+ * @namespace Severity
+ * @brief Уровни критичности для лог-сообщений.
+ */
+namespace Severity {
+const QString INFO              = "INFO";
+const QString WARN              = "WARN";
+const QString ERROR             = "ERROR";
+const QString CRITICAL          = "CRITICAL";
+} // namespace Severity
+
 /**
  * @namespace Commands
  * @brief Команды, которые сервер может отправлять клиенту.
@@ -49,6 +84,86 @@ namespace Commands {
 const QString START             = "start";          ///< Команда на запуск
 const QString STOP              = "stop";           ///< Команда на остановку
 } // namespace Commands
+
+/**
+ * @namespace Framing
+ * @brief Параметры кадрирования сообщений в потоке TCP.
+ *
+ * Клиент запрашивает кадрирование ключом Keys::FRAMING в сообщении регистрации,
+ * сервер подтверждает его тем же ключом в Confirmation. Регистрация всегда
+ * отправляется без префикса, поэтому старые клиенты и серверы продолжают работать.
+ */
+namespace Framing {
+const QString LENGTH_PREFIXED   = "lengthPrefixed"; ///< Кадры с 4-байтным префиксом длины (big-endian)
+const int HEADER_SIZE           = 4;                ///< Размер префикса длины (байт)
+const int MAX_FRAME_SIZE        = 16 * 1024 * 1024; ///< Максимальный размер одного сообщения (байт)
+} // namespace Framing
+
+/**
+ * @namespace Encoding
+ * @brief Форматы сериализации сообщений.
+ *
+ * Клиент запрашивает формат ключом Keys::ENCODING при регистрации. Сервер
+ * подтверждает CBOR только вместе с кадрированием, так как двоичные сообщения
+ * нельзя передавать без префикса длины. Регистрация всегда отправляется в JSON.
+ */
+namespace Encoding {
+const QString JSON              = "json";           ///< Текстовый JSON
+const QString CBOR              = "cbor";           ///< Двоичный CBOR (RFC 8949)
+} // namespace Encoding
+
+/**
+ * @namespace Timing
+ * @brief Отметки времени для измерения задержки доставки.
+ *
+ * Клиент передает в сообщениях телеметрии Keys::SENT_AT в монотонных часах
+ * сервера: смещение своих часов он оценивает по обмену Probe. В Probe клиент
+ * передает Keys::SENT_AT по своим часам, сервер возвращает его без изменений
+ * вместе с Keys::SERVER_TIME — серединой между получением запроса и ответом.
+ * Смещение берется по замеру с наименьшим временем оборота, поэтому его
+ * погрешность не больше половины этого времени. Сообщения без Keys::SENT_AT
+ * (старые клиенты) в статистике доставки не учитываются.
+ *
+ * Probe служит и сердцебиением: TCP- и локальный сервер отключают клиента,
+ * от которого не было ни одного сообщения дольше IDLE_TIMEOUT_MS, так что
+ * полуоткрытые соединения не висят бесконечно.
+ */
+namespace Timing {
+const int PROBE_INTERVAL_MS     = 10000;            ///< Период замеров Probe у обычного клиента (мс)
+const int IDLE_TIMEOUT_MS       = 60000;            ///< Тишина, после которой сервер отключает клиента (мс)
+const int PROBE_HISTORY         = 8;                ///< Количество последних замеров для выбора смещения
+} // namespace Timing
+
+/**
+ * @namespace FlowControl
+ * @brief Управление темпом телеметрии клиентов со стороны сервера.
+ *
+ * При перегрузке сервер присылает клиенту FlowControl с наименьшим
+ * интервалом между сообщениями телеметрии (Keys::SEND_INTERVAL) и долей
+ * сообщений, которые следует отправлять (Keys::SAMPLE_RATIO). Сначала
+ * сервер увеличивает интервал и лишь затем уменьшает долю, так что поток
+ * снижается постепенно, а не прекращается. Сообщения о превышении порогов
+ * (Severity::CRITICAL) отправляются без прореживания. Значения действуют до
+ * следующего FlowControl или до переподключения; интервал 0 и доля 1
+ * снимают ограничение. Клиенты, не знающие этого типа, его игнорируют.
+ */
+namespace FlowControl {
+const int MAX_SEND_INTERVAL_MS  = 60000;            ///< Наибольший интервал, который принимает клиент (мс)
+const double MIN_SAMPLE_RATIO   = 0.01;             ///< Наименьшая доля, которую принимает клиент
+} // namespace FlowControl
+
+/**
+ * @namespace Local
+ * @brief Параметры подключения через локальный сокет (Unix domain socket / именованный канал).
+ *
+ * Сервер типа LOCAL слушает сокет с именем SERVER_NAME_PREFIX + номер порта,
+ * указанного при создании сервера, так что несколько серверов и их клиенты
+ * различаются тем же номером, что и при работе по TCP.
+ */
+namespace Local {
+const QString HOST              = "local";          ///< Адрес, при котором клиент подключается через локальный сокет
+const QString SERVER_NAME_PREFIX = "telemetry-";    ///< Префикс имени локального сервера
+} // namespace Local
 } // namespace Protocol
 
 #endif // PROTOCOL_H
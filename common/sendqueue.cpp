@@ -0,0 +1,63 @@
+#include "sendqueue.h"
+
+#include <utility>
+
+SendQueue::Result SendQueue::push(const QByteArray &data, const QString &coalesceKey,
+                                  IClient::SlowConsumerPolicy policy, qint64 maxBytes) {
+    if (policy == IClient::SlowConsumerPolicy::Coalesce && !coalesceKey.isEmpty()) {
+        const auto it = m_keyIndex.constFind(coalesceKey);
+        if (it != m_keyIndex.constEnd()) {
+            PendingMessage &pending = m_messages[it.value() - m_firstNumber];
+            if (m_bytes - pending.data.size() + data.size() > maxBytes)
+                return Result::Overflow;
+            // Получателю важно только последнее значение
+            m_bytes += data.size() - pending.data.size();
+            pending.data = data;
+            return Result::Coalesced;
+        }
+    }
+
+    if (m_bytes + data.size() > maxBytes)
+        return Result::Overflow;
+
+    if (!coalesceKey.isEmpty())
+        m_keyIndex.insert(coalesceKey, m_firstNumber + m_messages.size());
+    m_messages.append({data, coalesceKey});
+    m_bytes += data.size();
+    return Result::Queued;
+}
+
+QByteArray SendQueue::takeChunk() {
+    if (m_messages.isEmpty())
+        return QByteArray();
+
+    // Несколько мелких сообщений объединяются в одну запись
+    QByteArray chunk = takeFirst();
+    while (!m_messages.isEmpty() &&
+           chunk.size() + m_messages.first().data.size() <= COALESCED_WRITE_SIZE) {
+        chunk.append(takeFirst());
+    }
+    m_bytes -= chunk.size();
+    return chunk;
+}
+
+void SendQueue::clear() {
+    m_messages.clear();
+    m_keyIndex.clear();
+    m_bytes = 0;
+    m_firstNumber = 0;
+}
+
+QByteArray SendQueue::takeFirst() {
+    PendingMessage &first = m_messages.first();
+    if (!first.coalesceKey.isEmpty()) {
+        // Без замещения в очереди бывает несколько сообщений с одним ключом: индекс указывает на последнее
+        const auto it = m_keyIndex.find(first.coalesceKey);
+        if (it != m_keyIndex.end() && it.value() == m_firstNumber)
+            m_keyIndex.erase(it);
+    }
+    QByteArray data = std::move(first.data);
+    m_messages.removeFirst();
+    ++m_firstNumber;
+    return data;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file sendqueue.h
+ * @brief Определяет класс SendQueue — ограниченную очередь отправки потокового клиента.
+ */
+#ifndef SENDQUEUE_H
+#define SENDQUEUE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include "iclient.h"
+
+/**
+ * @class SendQueue
+ * @brief Очередь исходящих сообщений с ограничением объема и замещением по ключу.
+ *
+ * Используется потоковыми клиентами (TCP, локальный сокет), когда буфер
+ * сокета выше HIGH_WATERMARK. Сообщения хранятся уже в виде кадров и
+ * извлекаются объединенными записями до COALESCED_WRITE_SIZE байт. Что делать
+ * при переполнении, решает владелец по политике медленного получателя.
+ * Ожидающее сообщение с ключом находится по индексу за O(1), замена тоже
+ * не превышает ограничения объема. Класс не потокобезопасен.
+ */
+class SendQueue {
+public:
+    /// @brief Объем буфера сокета, выше которого данные копятся в очереди (в байтах).
+    static constexpr qint64 HIGH_WATERMARK = 256 * 1024;
+    /// @brief Объем буфера сокета, при котором очередь снова дописывается в сокет (в байтах).
+    static constexpr qint64 LOW_WATERMARK = 64 * 1024;
+    /// @brief Максимальный объем очереди по умолчанию (в байтах).
+    static constexpr qint64 DEFAULT_MAX_BYTES = 4 * 1024 * 1024;
+    /// @brief Максимальный размер записи, в которую объединяются сообщения (в байтах).
+    static constexpr qint64 COALESCED_WRITE_SIZE = 64 * 1024;
+
+    /**
+     * @enum Result
+     * @brief Результат постановки сообщения в очередь.
+     */
+    enum class Result {
+        Queued,     ///< Сообщение добавлено в конец очереди
+        Coalesced,  ///< Сообщение заменило ожидающее с тем же ключом
+        Overflow    ///< Сообщение (или замена) не помещается в очередь и не добавлено
+    };
+
+    /**
+     * @brief Ставит сообщение в очередь.
+     * @param data Кадр сообщения.
+     * @param coalesceKey Ключ замещения (пустой — без замещения).
+     * @param policy Политика медленного получателя (замещение только при Coalesce).
+     * @param maxBytes Максимальный объем очереди.
+     */
+    Result push(const QByteArray &data, const QString &coalesceKey,
+                IClient::SlowConsumerPolicy policy, qint64 maxBytes);
+    /**
+     * @brief Извлекает из начала очереди сообщения, объединенные в одну запись.
+     * @return Запись не больше COALESCED_WRITE_SIZE (или одно сообщение большего размера).
+     */
+    QByteArray takeChunk();
+    /**
+     * @brief Очищает очередь.
+     */
+    void clear();
+
+    bool isEmpty() const { return m_messages.isEmpty(); }
+    /**
+     * @brief Возвращает объем сообщений в очереди (в байтах).
+     */
+    qint64 bytes() const { return m_bytes; }
+
+private:
+    /**
+     * @struct PendingMessage
+     * @brief Сообщение (уже с префиксом длины), ожидающее отправки.
+     */
+    struct PendingMessage {
+        QByteArray data;
+        QString coalesceKey;
+    };
+
+    /**
+     * @brief Удаляет первое сообщение очереди вместе с его записью в индексе ключей.
+     * @return Данные удаленного сообщения.
+     */
+    QByteArray takeFirst();
+
+    QList<PendingMessage> m_messages;
+    qint64 m_bytes = 0;
+    /// @brief Сквозной номер первого сообщения очереди.
+    qint64 m_firstNumber = 0;
+    /// @brief Сквозной номер последнего ожидающего сообщения с каждым ключом.
+    QHash<QString, qint64> m_keyIndex;
+};
+
+#endif // SENDQUEUE_H
@@ -1,39 +1,58 @@
 #include "tcpclient.h"
+#include "monotonicclock.h"
+
+#include <QThread>
+#include <QTimer>
 
 // Конструктор
 TcpClient::TcpClient(QTcpSocket *socket, QObject *parent)
     : IClient(parent), m_socket(socket), m_id(""),
-    m_descriptor(socket->socketDescriptor()) {
+    m_descriptor(socket->socketDescriptor()), m_port(0),
+    m_connected(socket->state() == QAbstractSocket::ConnectedState),
+    m_framingMode(FramingMode::Raw) {
     if (!m_socket)
         return;
 
     if (m_socket->parent() == nullptr) {
         m_socket->setParent(this);
     }
+    if (m_connected) {
+        cachePeer();
+    }
 
     connect(m_socket, &QTcpSocket::connected, this, &TcpClient::handleConnected);
     connect(m_socket, &QTcpSocket::disconnected, this,
             &TcpClient::handleDisconnected);
     connect(m_socket, &QTcpSocket::readyRead, this, &TcpClient::handleReadyRead);
     connect(m_socket, &QTcpSocket::errorOccurred, this, &TcpClient::handleError);
+    connect(m_socket, &QTcpSocket::bytesWritten, this, &TcpClient::handleBytesWritten);
 }
 
 quintptr TcpClient::descriptor() const { return m_socket ? m_descriptor : 0; }
 
-bool TcpClient::isConnected() const {
-    return m_socket && m_socket->state() == QAbstractSocket::ConnectedState;
-}
+bool TcpClient::isConnected() const { return m_socket && m_connected; }
 
-QString TcpClient::address() const {
-    return m_socket
-               ? QHostAddress(m_socket->peerAddress().toIPv4Address()).toString()
-               : "0";
-}
+QString TcpClient::address() const { return m_socket ? m_address : "0"; }
 
-quint16 TcpClient::port() const { return m_socket ? m_socket->peerPort() : 0; }
+quint16 TcpClient::port() const { return m_socket ? m_port : 0; }
 
 void TcpClient::setId(const QString &id) { m_id = id; }
 
+IClient::FramingMode TcpClient::framingMode() const { return m_framingMode; }
+
+void TcpClient::setFramingMode(FramingMode mode) {
+    if (!isOwnerThread()) {
+        QMetaObject::invokeMethod(this, [this, mode] { setFramingMode(mode); },
+                                  Qt::QueuedConnection);
+        return;
+    }
+
+    m_framingMode = mode;
+    if (mode == FramingMode::Raw) {
+        m_framer.clear();
+    }
+}
+
 QString TcpClient::id() const { return m_id; }
 
 void TcpClient::connectToHost(const QString &host, quint16 port) {
@@ -43,31 +62,88 @@ void TcpClient::connectToHost(const QString &host, quint16 port) {
 }
 
 void TcpClient::disconnect() {
+    if (!isOwnerThread()) {
+        QMetaObject::invokeMethod(this, [this] { disconnect(); },
+                                  Qt::QueuedConnection);
+        return;
+    }
+
     if (isConnected()) {
         m_socket->disconnectFromHost();
+        if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+            QTimer::singleShot(DISCONNECT_TIMEOUT_MS, m_socket, [socket = m_socket] {
+                if (socket->state() != QAbstractSocket::UnconnectedState)
+                    socket->abort();
+            });
+        }
     }
 }
 
 void TcpClient::sendData(const QByteArray &data) {
+    sendData(data, QString());
+}
+
+void TcpClient::sendData(const QByteArray &data, const QString &coalesceKey) {
+    if (!isOwnerThread()) {
+        QMetaObject::invokeMethod(this, [this, data, coalesceKey] { sendData(data, coalesceKey); },
+                                  Qt::QueuedConnection);
+        return;
+    }
+
     if (isConnected()) {
-        m_socket->write(data);
+        // Кадр формируется сразу: режим кадрирования может смениться, пока сообщение в очереди
+        enqueue(m_framingMode == FramingMode::LengthPrefixed ? MessageFramer::encode(data) : data,
+                coalesceKey);
     }
 }
 
+void TcpClient::setSlowConsumerPolicy(SlowConsumerPolicy policy, qint64 maxQueuedBytes) {
+    m_policy = policy;
+    m_maxQueuedBytes = qMax<qint64>(SOCKET_HIGH_WATERMARK, maxQueuedBytes);
+}
+
 void TcpClient::sendData(const QJsonObject &json) {
-    if (isConnected()) {
-        QJsonDocument doc(json);
-        m_socket->write(doc.toJson(QJsonDocument::Compact));
-    }
+    sendData(QJsonDocument(json).toJson(QJsonDocument::Compact));
 }
 
-void TcpClient::handleConnected() { emit connected(); }
+void TcpClient::handleConnected() {
+    cachePeer();
+    m_descriptor = m_socket->socketDescriptor();
+    m_connected = true;
+    emit connected();
+}
 
-void TcpClient::handleDisconnected() { emit disconnected(); }
+void TcpClient::handleDisconnected() {
+    m_connected = false;
+    clearSendQueue();
+    // Режим кадрирования согласуется заново при каждом подключении
+    setFramingMode(FramingMode::Raw);
+    emit disconnected();
+}
 
 void TcpClient::handleReadyRead() {
-    QByteArray data = m_socket->readAll();
-    emit dataReceived(data);
+    const QByteArray data = m_socket->readAll();
+    // Все сообщения одного чтения получают общую отметку времени поступления
+    const qint64 receivedAtNs = MonotonicClock::nowNs();
+
+    if (m_framingMode == FramingMode::Raw) {
+        emit dataReceived(data, receivedAtNs);
+        return;
+    }
+
+    m_framer.append(data);
+
+    // За одно чтение может прийти ноль, одно или несколько целых сообщений
+    QByteArray message;
+    while (m_framer.takeMessage(message)) {
+        emit dataReceived(message, receivedAtNs);
+    }
+
+    if (m_framer.hasError()) {
+        emit errorOccurred("Получен кадр недопустимого размера, соединение разорвано.");
+        m_framer.clear();
+        m_socket->abort();
+    }
 }
 
 void TcpClient::handleError(QAbstractSocket::SocketError socketError) {
@@ -75,4 +151,55 @@ void TcpClient::handleError(QAbstractSocket::SocketError socketError) {
     emit errorOccurred(m_socket->errorString());
 }
 
+void TcpClient::handleBytesWritten() {
+    if (!m_sendQueue.isEmpty() && m_socket->bytesToWrite() <= SOCKET_LOW_WATERMARK) {
+        drainSendQueue();
+    }
+    updateQueuedBytes();
+}
 
+void TcpClient::enqueue(const QByteArray &data, const QString &coalesceKey) {
+    // Быстрый путь: очередь пуста и сокет успевает отдавать данные
+    if (m_sendQueue.isEmpty() && m_socket->bytesToWrite() < SOCKET_HIGH_WATERMARK) {
+        m_socket->write(data);
+        updateQueuedBytes();
+        return;
+    }
+
+    const SlowConsumerPolicy policy = m_policy;
+    if (m_sendQueue.push(data, coalesceKey, policy, m_maxQueuedBytes) == SendQueue::Result::Overflow) {
+        if (policy == SlowConsumerPolicy::Disconnect) {
+            emit errorOccurred("Получатель не успевает принимать данные, соединение разорвано.");
+            clearSendQueue();
+            m_socket->abort();
+        } else {
+            ++m_droppedMessages;
+        }
+        return;
+    }
+    updateQueuedBytes();
+}
+
+void TcpClient::drainSendQueue() {
+    while (!m_sendQueue.isEmpty() && m_socket->bytesToWrite() < SOCKET_HIGH_WATERMARK) {
+        m_socket->write(m_sendQueue.takeChunk());
+    }
+}
+
+void TcpClient::updateQueuedBytes() {
+    m_queuedBytes = m_sendQueue.bytes() + m_socket->bytesToWrite();
+}
+
+void TcpClient::clearSendQueue() {
+    m_sendQueue.clear();
+    updateQueuedBytes();
+}
+
+bool TcpClient::isOwnerThread() const {
+    return QThread::currentThread() == thread();
+}
+
+void TcpClient::cachePeer() {
+    m_address = QHostAddress(m_socket->peerAddress().toIPv4Address()).toString();
+    m_port = m_socket->peerPort();
+}
@@ -6,22 +6,45 @@
 #define TCPCLIENT_H
 
 #include "iclient.h"
+#include "messageframer.h"
+#include "sendqueue.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
+#include <QList>
 #include <QTcpSocket>
 
+#include <atomic>
+
 /**
  * @class TcpClient
  * @brief Реализация интерфейса IClient для TCP-клиента.
  *
  * Этот класс является оберткой над QTcpSocket, предоставляя
  * функциональность, определенную в интерфейсе IClient.
+ *
+ * Объект может жить в потоке ввода-вывода, отличном от потока обработки данных.
+ * Методы чтения состояния (descriptor, address, port, isConnected) потокобезопасны,
+ * а sendData, disconnect и setFramingMode, вызванные из чужого потока,
+ * выполняются в потоке объекта в порядке вызова.
+ *
+ * Исходящие данные пишутся в сокет, пока его буфер (bytesToWrite) ниже
+ * SOCKET_HIGH_WATERMARK; дальше они копятся в собственной очереди ограниченного
+ * объема и дописываются по сигналу bytesWritten, когда буфер опускается до
+ * SOCKET_LOW_WATERMARK. Мелкие сообщения из очереди объединяются в одну запись.
  */
 class TcpClient : public IClient {
     Q_OBJECT
 
 public:
+    /// @brief Объем буфера сокета, выше которого данные копятся в очереди (в байтах).
+    static constexpr qint64 SOCKET_HIGH_WATERMARK = SendQueue::HIGH_WATERMARK;
+    /// @brief Объем буфера сокета, при котором очередь снова дописывается в сокет (в байтах).
+    static constexpr qint64 SOCKET_LOW_WATERMARK = SendQueue::LOW_WATERMARK;
+    /// @brief Максимальный объем очереди отправки по умолчанию (в байтах).
+    static constexpr qint64 DEFAULT_MAX_QUEUED_BYTES = SendQueue::DEFAULT_MAX_BYTES;
+    /// @brief Время на корректное закрытие соединения, после которого сокет закрывается принудительно (мс).
+    static constexpr int DISCONNECT_TIMEOUT_MS = 5000;
 
     /**
      * @brief Конструктор класса TcpClient.
@@ -38,6 +61,10 @@ public:
      * @brief Проверяет, подключен ли сокет.
      */
     bool isConnected() const override;
+    /**
+     * @brief Возвращает текущий режим кадрирования.
+     */
+    FramingMode framingMode() const override;
 
     /**
      * @brief Возвращает дескриптор сокета.
@@ -56,6 +83,12 @@ public:
      * @brief Устанавливает ID клиента.
      */
     void setId(const QString &id) override;
+    /**
+     * @brief Устанавливает режим кадрирования.
+     *
+     * При переходе в режим Raw недочитанный остаток буфера сборки отбрасывается.
+     */
+    void setFramingMode(FramingMode mode) override;
 
     /**
      * @brief Подключается к хосту.
@@ -63,6 +96,10 @@ public:
     void connectToHost(const QString &host, quint16 port) override;
     /**
      * @brief Отключается от хоста.
+     *
+     * Неотправленные данные дописываются в сокет; если удаленная сторона не
+     * принимает их (полуоткрытое соединение) дольше DISCONNECT_TIMEOUT_MS,
+     * соединение разрывается без ожидания.
      */
     void disconnect() override;
 
@@ -76,6 +113,22 @@ public:
      * @param data Данные для отправки.
      */
     void sendData(const QByteArray &data) override;
+    /**
+     * @brief Отправляет данные с ключом замещения (см. IClient::sendData).
+     */
+    void sendData(const QByteArray &data, const QString &coalesceKey) override;
+    /**
+     * @brief Возвращает объем очереди отправки и буфера сокета.
+     */
+    qint64 queuedBytes() const override { return m_queuedBytes; }
+    /**
+     * @brief Возвращает количество отброшенных сообщений.
+     */
+    quint64 droppedMessages() const override { return m_droppedMessages; }
+    /**
+     * @brief Задает политику для медленного получателя.
+     */
+    void setSlowConsumerPolicy(SlowConsumerPolicy policy, qint64 maxQueuedBytes) override;
 
 private slots:
     /**
@@ -95,14 +148,62 @@ private slots:
      * @param socketError Код ошибки сокета.
      */
     void handleError(QAbstractSocket::SocketError socketError);
+    /**
+     * @brief Дописывает очередь отправки, когда буфер сокета освободился.
+     */
+    void handleBytesWritten();
 
 private:
+    /**
+     * @brief Проверяет, вызван ли метод из потока, которому принадлежит объект.
+     */
+    bool isOwnerThread() const;
+    /**
+     * @brief Запоминает адрес и порт удаленной стороны.
+     */
+    void cachePeer();
+    /**
+     * @brief Пишет данные в сокет или ставит их в очередь (в потоке объекта).
+     */
+    void enqueue(const QByteArray &data, const QString &coalesceKey);
+    /**
+     * @brief Переносит очередь в сокет, объединяя сообщения, пока буфер сокета ниже верхней границы.
+     */
+    void drainSendQueue();
+    /**
+     * @brief Обновляет публикуемый объем ожидающих отправки данных.
+     */
+    void updateQueuedBytes();
+    /**
+     * @brief Очищает очередь отправки.
+     */
+    void clearSendQueue();
+
     /// @brief Указатель на QTcpSocket.
     QTcpSocket *m_socket;
     /// @brief Строковый идентификатор клиента.
     QString m_id;
     /// @brief Дескриптор сокета.
     quintptr m_descriptor;
+    /// @brief IP-адрес удаленной стороны (кэшируется при подключении).
+    QString m_address;
+    /// @brief Порт удаленной стороны (кэшируется при подключении).
+    quint16 m_port;
+    /// @brief Признак установленного соединения.
+    std::atomic<bool> m_connected;
+    /// @brief Текущий режим кадрирования.
+    std::atomic<FramingMode> m_framingMode;
+    /// @brief Буфер сборки входящих кадров.
+    MessageFramer m_framer;
+
+    /// @brief Очередь отправки (используется только в потоке объекта).
+    SendQueue m_sendQueue;
+    /// @brief Объем очереди и буфера сокета для чтения из других потоков.
+    std::atomic<qint64> m_queuedBytes{0};
+    /// @brief Количество отброшенных сообщений.
+    std::atomic<quint64> m_droppedMessages{0};
+    std::atomic<SlowConsumerPolicy> m_policy{SlowConsumerPolicy::Coalesce};
+    std::atomic<qint64> m_maxQueuedBytes{DEFAULT_MAX_QUEUED_BYTES};
 };
 
 #endif // TCPCLIENT_H
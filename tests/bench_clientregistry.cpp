@@ -0,0 +1,222 @@
+/**
+ * @file bench_clientregistry.cpp
+ * @brief Замер регистрации и переподключения клиентов в ClientRegistry.
+ *
+ * Повторяет последовательность DataProcessing::registerClient без сети:
+ * поиск отключенного клиента с тем же ID, выдача уникального ID, назначение
+ * ID и перевод в CONNECTED. Время на одну регистрацию не должно зависеть от
+ * количества уже зарегистрированных клиентов.
+ */
+#include <QElapsedTimer>
+#include <QTest>
+
+#include <memory>
+#include <vector>
+
+#include "core/clientregistry.h"
+#include "fakeclient.h"
+
+namespace {
+/// @brief Наибольшее количество клиентов в замерах.
+constexpr int MAX_CLIENTS = 50000;
+/// @brief Количество регистраций, по которым сравнивается стоимость одной регистрации.
+constexpr int PROBE_REGISTRATIONS = 1000;
+/// @brief Количество повторов сравнения (берется наименьшее время).
+constexpr int PROBE_REPEATS = 5;
+/// @brief Допустимый рост стоимости регистрации между 1k и 50k клиентов (линейный поиск дал бы ~50).
+constexpr double MAX_COST_GROWTH = 8.0;
+
+/**
+ * @brief Пул клиентов с последовательными дескрипторами.
+ */
+class ClientPool {
+public:
+    IClient *at(int index) {
+        while (int(m_clients.size()) <= index)
+            m_clients.push_back(std::make_unique<FakeClient>(quintptr(m_clients.size() + 1)));
+        return m_clients[index].get();
+    }
+
+private:
+    std::vector<std::unique_ptr<FakeClient>> m_clients;
+};
+
+/**
+ * @brief Подключает и регистрирует клиента так же, как DataProcessing.
+ */
+void registerClient(ClientRegistry &registry, IClient *client, const QString &requestedId) {
+    ClientState connecting;
+    connecting.client = client;
+    connecting.status = AppEnums::AUTHORIZING;
+    registry.insert(connecting);
+
+    QString assignedId = requestedId;
+    if (const ClientState *oldState = registry.findDisconnected(requestedId)) {
+        registry.take(oldState->client->descriptor());
+    } else {
+        assignedId = registry.uniqueId(requestedId);
+    }
+
+    ClientState &state = *registry.find(client->descriptor());
+    registry.assignId(state, assignedId);
+    registry.setStatus(state, AppEnums::CONNECTED);
+}
+
+QString deviceId(int index) {
+    return QString("device-%1").arg(index);
+}
+
+/**
+ * @brief Возвращает время (нс) на одну регистрацию после count уже зарегистрированных.
+ */
+double registrationCostNs(ClientPool &pool, int count) {
+    double best = 0.0;
+    for (int repeat = 0; repeat < PROBE_REPEATS; ++repeat) {
+        ClientRegistry registry;
+        for (int i = 0; i < count; ++i)
+            registerClient(registry, pool.at(i), deviceId(i));
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = count; i < count + PROBE_REGISTRATIONS; ++i)
+            registerClient(registry, pool.at(i), deviceId(i));
+        const double cost = double(timer.nsecsElapsed()) / PROBE_REGISTRATIONS;
+        if (repeat == 0 || cost < best)
+            best = cost;
+    }
+    return best;
+}
+
+/**
+ * @brief Возвращает время (нс) на регистрацию при count клиентах с одним запрошенным ID,
+ * когда владелец базового ID постоянно отключается (как при вытеснении по простою).
+ */
+double sharedIdChurnCostNs(ClientPool &pool, int count) {
+    const QString sharedId = "device";
+    double best = 0.0;
+    for (int repeat = 0; repeat < PROBE_REPEATS; ++repeat) {
+        ClientRegistry registry;
+        for (int i = 0; i < count; ++i)
+            registerClient(registry, pool.at(i), sharedId);
+
+        // Базовый ID достается первому зарегистрированному клиенту
+        IClient *baseHolder = pool.at(0);
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = count; i < count + PROBE_REGISTRATIONS; i += 2) {
+            // Базовый ID освобождается: первый клиент получает его, второй — очередной суффикс
+            registry.take(baseHolder->descriptor());
+            baseHolder = pool.at(i);
+            registerClient(registry, baseHolder, sharedId);
+            registerClient(registry, pool.at(i + 1), sharedId);
+        }
+        const double cost = double(timer.nsecsElapsed()) / PROBE_REGISTRATIONS;
+        if (repeat == 0 || cost < best)
+            best = cost;
+    }
+    return best;
+}
+} // namespace
+
+class BenchClientRegistry : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {
+        // Создание объектов клиентов не входит в замеры
+        m_pool.at(MAX_CLIENTS * 2 + PROBE_REGISTRATIONS);
+    }
+
+    void registerNew_data() {
+        QTest::addColumn<int>("count");
+        QTest::addColumn<bool>("sameId");
+        for (int count : {1000, 10000, MAX_CLIENTS}) {
+            QTest::addRow("distinct-%d", count) << count << false;
+            QTest::addRow("same-id-%d", count) << count << true;
+        }
+    }
+
+    /**
+     * @brief Регистрация новых клиентов; "same-id" — все клиенты запрашивают один ID
+     * и получают суффиксы "_N".
+     */
+    void registerNew() {
+        QFETCH(int, count);
+        QFETCH(bool, sameId);
+
+        QStringList ids;
+        ids.reserve(count);
+        for (int i = 0; i < count; ++i)
+            ids.append(sameId ? QStringLiteral("device") : deviceId(i));
+
+        ClientRegistry registry;
+        QBENCHMARK_ONCE {
+            for (int i = 0; i < count; ++i)
+                registerClient(registry, m_pool.at(i), ids.at(i));
+        }
+
+        QCOMPARE(registry.size(), count);
+        QCOMPARE(registry.descriptorsWithStatus(AppEnums::CONNECTED).size(), count);
+        if (sameId)
+            QCOMPARE(m_pool.at(count - 1)->id(), QString("device_%1").arg(count - 1));
+    }
+
+    void reregister_data() {
+        QTest::addColumn<int>("count");
+        for (int count : {1000, 10000, MAX_CLIENTS})
+            QTest::addRow("%d", count) << count;
+    }
+
+    /**
+     * @brief Переподключение всех клиентов после отключения (шторм после перезапуска сети).
+     */
+    void reregister() {
+        QFETCH(int, count);
+
+        ClientRegistry registry;
+        for (int i = 0; i < count; ++i)
+            registerClient(registry, m_pool.at(i), deviceId(i));
+        for (int i = 0; i < count; ++i)
+            registry.setStatus(*registry.find(m_pool.at(i)->descriptor()), AppEnums::DISCONNECTED);
+
+        // Переподключившиеся клиенты приходят с новыми дескрипторами
+        QBENCHMARK_ONCE {
+            for (int i = 0; i < count; ++i)
+                registerClient(registry, m_pool.at(MAX_CLIENTS + i), deviceId(i));
+        }
+
+        QCOMPARE(registry.size(), count);
+        QVERIFY(registry.descriptorsWithStatus(AppEnums::DISCONNECTED).isEmpty());
+        QCOMPARE(m_pool.at(MAX_CLIENTS + count - 1)->id(), deviceId(count - 1));
+    }
+
+    /**
+     * @brief Стоимость регистрации при 50k клиентов сопоставима со стоимостью при 1k.
+     */
+    void registrationCostIsConstant() {
+        const double smallNs = registrationCostNs(m_pool, 1000);
+        const double largeNs = registrationCostNs(m_pool, MAX_CLIENTS);
+        qInfo("Регистрация: %.0f нс при 1000 клиентов, %.0f нс при %d клиентов",
+              smallNs, largeNs, MAX_CLIENTS);
+        QVERIFY2(largeNs < smallNs * MAX_COST_GROWTH,
+                 qPrintable(QString("%1 нс против %2 нс").arg(largeNs).arg(smallNs)));
+    }
+
+    /**
+     * @brief Освобождение базового ID не сбрасывает счетчик суффиксов: перебора живых клиентов нет.
+     */
+    void sharedIdRegistrationCostIsConstant() {
+        const double smallNs = sharedIdChurnCostNs(m_pool, 1000);
+        const double largeNs = sharedIdChurnCostNs(m_pool, MAX_CLIENTS);
+        qInfo("Регистрация с общим ID: %.0f нс при 1000 клиентов, %.0f нс при %d клиентов",
+              smallNs, largeNs, MAX_CLIENTS);
+        QVERIFY2(largeNs < smallNs * MAX_COST_GROWTH,
+                 qPrintable(QString("%1 нс против %2 нс").arg(largeNs).arg(smallNs)));
+    }
+
+private:
+    ClientPool m_pool;
+};
+
+QTEST_GUILESS_MAIN(BenchClientRegistry)
+#include "bench_clientregistry.moc"
@@ -0,0 +1,255 @@
+/**
+ * @file bench_localtransport.cpp
+ * @brief Замер пропускной способности и задержки TCP loopback и локального сокета.
+ *
+ * Клиент (TcpClient или LocalClient, как в ClientApp) отправляет серверу
+ * (TcpServer или LocalServer) смесь сообщений ClientApp — метрики сети,
+ * статус устройства и логи — в формате CBOR с префиксом длины. Задержка —
+ * время от вызова sendData до чтения сообщения сервером (отметка
+ * receivedAtNs), оба конца в одном процессе и на одних часах.
+ */
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTest>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "../common/localclient.h"
+#include "../common/messagecodec.h"
+#include "../common/monotonicclock.h"
+#include "../common/tcpclient.h"
+#include "clientlogic.h"
+#include "core/localserver.h"
+#include "core/tcpserver.h"
+
+namespace {
+/// @brief Количество сообщений в замере пропускной способности.
+constexpr int THROUGHPUT_MESSAGES = 50000;
+/// @brief Наибольшее количество отправленных, но еще не прочитанных сервером сообщений.
+constexpr int THROUGHPUT_WINDOW = 256;
+/// @brief Количество сообщений в замере задержки без нагрузки (по одному в пути).
+constexpr int LATENCY_MESSAGES = 5000;
+/// @brief Ожидание доставки всех сообщений замера (мс).
+constexpr int DELIVERY_TIMEOUT_MS = 60000;
+
+/**
+ * @enum Transport
+ * @brief Транспорт замера.
+ */
+enum class Transport { Tcp, Local };
+
+/**
+ * @brief Возвращает свободный TCP-порт; тот же номер задает имя локального сокета.
+ */
+quint16 freePort() {
+    QTcpServer probe;
+    if (!probe.listen(QHostAddress::LocalHost, 0))
+        return 0;
+    return probe.serverPort();
+}
+
+/**
+ * @brief Формирует смесь сообщений ClientApp в порядке ClientLogic::sendPeriodicData.
+ */
+QList<QByteArray> buildMessageMix(int count) {
+    QRandomGenerator random(42);
+    QList<QByteArray> messages;
+    messages.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        QJsonObject data;
+        switch (i % Protocol::Constants::DATA_TYPES_COUNT) {
+        case 0:
+            data = ClientLogic::generateNetworkMetrics(random);
+            break;
+        case 1:
+            data = ClientLogic::generateDeviceStatus(random);
+            break;
+        default:
+            data = ClientLogic::generateLog(random);
+            break;
+        }
+        data[Protocol::Keys::SEQUENCE] = i + 1;
+        messages.append(MessageCodec::encode(data, MessageCodec::Encoding::Cbor));
+    }
+    return messages;
+}
+
+/**
+ * @brief Возвращает значение перцентиля отсортированных задержек.
+ */
+qint64 percentile(const QList<qint64> &sorted, double percent) {
+    if (sorted.isEmpty())
+        return 0;
+    const qsizetype index = qsizetype(std::ceil(percent / 100.0 * sorted.size())) - 1;
+    return sorted.at(qBound<qsizetype>(0, index, sorted.size() - 1));
+}
+
+/**
+ * @class Session
+ * @brief Сервер и подключенный к нему клиент с согласованным кадрированием.
+ *
+ * Повторяет начало сеанса ClientApp: первое сообщение уходит без префикса,
+ * сервер переключает клиента на префикс длины и подтверждает, после чего на
+ * префикс переключается и клиент.
+ */
+class Session {
+public:
+    explicit Session(Transport transport) {
+        if (transport == Transport::Tcp) {
+            server = std::make_unique<TcpServer>();
+            client = std::make_unique<TcpClient>(new QTcpSocket());
+        } else {
+            server = std::make_unique<LocalServer>();
+            client = std::make_unique<LocalClient>(new QLocalSocket());
+        }
+    }
+
+    /**
+     * @brief Запускает сервер, подключает клиента и согласует кадрирование.
+     * @return true, если клиент готов к отправке.
+     */
+    bool open() {
+        const quint16 port = freePort();
+        if (port == 0)
+            return false;
+        server->startServer(port);
+        if (!server->isListening())
+            return false;
+
+        const QMetaObject::Connection handshake = QObject::connect(
+            server.get(), &IServer::dataReceived, server.get(),
+            [this](IClient *peer, const QByteArray &, qint64) {
+                peer->setFramingMode(IClient::FramingMode::LengthPrefixed);
+                server->sendToClient(peer, "ready");
+            });
+        QSignalSpy ready(client.get(), &IClient::dataReceived);
+        QSignalSpy connected(client.get(), &IClient::connected);
+        client->connectToHost("127.0.0.1", port);
+        if (!connected.wait(5000))
+            return false;
+        client->sendData("hello");
+        const bool confirmed = ready.wait(5000);
+        QObject::disconnect(handshake);
+        if (!confirmed)
+            return false;
+        client->setFramingMode(IClient::FramingMode::LengthPrefixed);
+        return true;
+    }
+
+    std::unique_ptr<IServer> server;
+    std::unique_ptr<IClient> client;
+};
+} // namespace
+
+class BenchLocalTransport : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {
+        m_messages = buildMessageMix(THROUGHPUT_MESSAGES);
+        qint64 bytes = 0;
+        for (const QByteArray &message : std::as_const(m_messages))
+            bytes += message.size();
+        qInfo("Смесь ClientApp: %lld сообщений, в среднем %lld байт",
+              qint64(m_messages.size()), bytes / m_messages.size());
+    }
+
+    void throughput_data() {
+        QTest::addColumn<int>("transport");
+        QTest::newRow("tcp") << int(Transport::Tcp);
+        QTest::newRow("local") << int(Transport::Local);
+    }
+
+    /**
+     * @brief Поток сообщений с ограниченным окном: сообщений в секунду и задержка под нагрузкой.
+     */
+    void throughput() {
+        QFETCH(int, transport);
+        Session session{Transport(transport)};
+        QVERIFY(session.open());
+
+        QList<qint64> sentAtNs(m_messages.size());
+        QList<qint64> latenciesNs;
+        latenciesNs.reserve(m_messages.size());
+        int sent = 0;
+        qint64 startedNs = 0;
+        qint64 finishedNs = 0;
+        const auto pump = [&] {
+            while (sent < m_messages.size() && sent - latenciesNs.size() < THROUGHPUT_WINDOW) {
+                sentAtNs[sent] = MonotonicClock::nowNs();
+                session.client->sendData(m_messages.at(sent++));
+            }
+        };
+        // Соединение одно, поэтому сообщения приходят в порядке отправки
+        QObject::connect(session.server.get(), &IServer::dataReceived, this,
+                         [&](IClient *, const QByteArray &, qint64 receivedAtNs) {
+                             latenciesNs.append(receivedAtNs - sentAtNs.at(latenciesNs.size()));
+                             finishedNs = receivedAtNs;
+                             pump();
+                         });
+
+        QBENCHMARK_ONCE {
+            startedNs = MonotonicClock::nowNs();
+            pump();
+            QTRY_COMPARE_WITH_TIMEOUT(latenciesNs.size(), m_messages.size(), DELIVERY_TIMEOUT_MS);
+        }
+        const double messagesPerSec = m_messages.size() / ((finishedNs - startedNs) / 1e9);
+
+        std::sort(latenciesNs.begin(), latenciesNs.end());
+        qInfo("%s: %.0f сообщений/с, задержка под нагрузкой p50 %lld мкс, p99 %lld мкс",
+              QTest::currentDataTag(), messagesPerSec,
+              percentile(latenciesNs, 50.0) / 1000, percentile(latenciesNs, 99.0) / 1000);
+        // Результат замера — сообщений в секунду
+        QTest::setBenchmarkResult(messagesPerSec, QTest::Events);
+        QCOMPARE(session.client->droppedMessages(), quint64(0));
+    }
+
+    void latency_data() {
+        throughput_data();
+    }
+
+    /**
+     * @brief Одно сообщение в пути: задержка доставки без очередей.
+     */
+    void latency() {
+        QFETCH(int, transport);
+        Session session{Transport(transport)};
+        QVERIFY(session.open());
+
+        QList<qint64> latenciesNs;
+        latenciesNs.reserve(LATENCY_MESSAGES);
+        qint64 sentAtNs = 0;
+        const auto sendNext = [&] {
+            sentAtNs = MonotonicClock::nowNs();
+            session.client->sendData(m_messages.at(latenciesNs.size()));
+        };
+        QObject::connect(session.server.get(), &IServer::dataReceived, this,
+                         [&](IClient *, const QByteArray &, qint64 receivedAtNs) {
+                             latenciesNs.append(receivedAtNs - sentAtNs);
+                             if (latenciesNs.size() < LATENCY_MESSAGES)
+                                 sendNext();
+                         });
+
+        QBENCHMARK_ONCE {
+            sendNext();
+            QTRY_COMPARE_WITH_TIMEOUT(latenciesNs.size(), LATENCY_MESSAGES, DELIVERY_TIMEOUT_MS);
+        }
+
+        std::sort(latenciesNs.begin(), latenciesNs.end());
+        const qint64 p50Ns = percentile(latenciesNs, 50.0);
+        qInfo("%s: задержка p50 %lld мкс, p99 %lld мкс, максимум %lld мкс",
+              QTest::currentDataTag(), p50Ns / 1000,
+              percentile(latenciesNs, 99.0) / 1000, latenciesNs.last() / 1000);
+        // Результат замера — медианная задержка
+        QTest::setBenchmarkResult(double(p50Ns), QTest::WalltimeNanoseconds);
+    }
+
+private:
+    /// @brief Сообщения замера, закодированные заранее.
+    QList<QByteArray> m_messages;
+};
+
+QTEST_GUILESS_MAIN(BenchLocalTransport)
+#include "bench_localtransport.moc"
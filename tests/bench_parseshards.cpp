@@ -0,0 +1,150 @@
+/**
+ * @file bench_parseshards.cpp
+ * @brief Замер масштабирования разбора сообщений по шардам ParseShard (1, 2, 4, 8 потоков).
+ *
+ * Сообщения клиентов распределяются между шардами так же, как в
+ * DataProcessing: по хешу дескриптора, вызовом parse() в потоке шарда.
+ * Все сообщения ставятся в очереди шардов до запуска потоков, поэтому замер
+ * показывает разбор, а не темп одного распределяющего потока; пакеты
+ * забираются, как при отправке в UI, пока разбор идет.
+ */
+#include <QTest>
+#include <QThread>
+
+#include <memory>
+#include <vector>
+
+#include "../common/messagecodec.h"
+#include "../common/monotonicclock.h"
+#include "clientlogic.h"
+#include "core/dataprocessing.h"
+#include "core/parseshard.h"
+
+namespace {
+/// @brief Количество сообщений в замере.
+constexpr int MESSAGES = 200000;
+/// @brief Количество клиентов, между которыми делятся сообщения.
+constexpr int CLIENTS = 1000;
+/// @brief Количество различных сообщений в смеси (сообщения повторяются по кругу).
+constexpr int DISTINCT_MESSAGES = 3000;
+/// @brief Наименьшее ускорение двух шардов относительно одного при достаточном числе ядер.
+constexpr double MIN_TWO_SHARD_SPEEDUP = 1.3;
+
+/**
+ * @brief Формирует смесь сообщений ClientApp (метрики сети, статус устройства, лог) в CBOR.
+ */
+QList<QByteArray> buildMessageMix() {
+    QRandomGenerator random(42);
+    QList<QByteArray> messages;
+    for (int i = 0; i < DISTINCT_MESSAGES; ++i) {
+        QJsonObject data;
+        switch (i % Protocol::Constants::DATA_TYPES_COUNT) {
+        case 0:
+            data = ClientLogic::generateNetworkMetrics(random);
+            break;
+        case 1:
+            data = ClientLogic::generateDeviceStatus(random);
+            break;
+        default:
+            data = ClientLogic::generateLog(random);
+            break;
+        }
+        data[Protocol::Keys::SEQUENCE] = i / CLIENTS + 1;
+        messages.append(MessageCodec::encode(data, MessageCodec::Encoding::Cbor));
+    }
+    return messages;
+}
+} // namespace
+
+class BenchParseShards : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {
+        m_messages = buildMessageMix();
+        for (int i = 0; i < CLIENTS; ++i)
+            m_clientIds.append(QString("Client_%1").arg(i + 1));
+    }
+
+    void ingest_data() {
+        QTest::addColumn<int>("shardCount");
+        for (int count = 1; count <= DataProcessing::MAX_PARSE_SHARDS; count *= 2)
+            QTest::addRow("%d shards", count) << count;
+    }
+
+    void ingest() {
+        QFETCH(int, shardCount);
+
+        std::vector<std::unique_ptr<QThread>> threads;
+        std::vector<std::unique_ptr<ParseShard>> shards;
+        for (int i = 0; i < shardCount; ++i) {
+            threads.push_back(std::make_unique<QThread>());
+            shards.push_back(std::make_unique<ParseShard>());
+            shards.back()->moveToThread(threads.back().get());
+        }
+
+        // Метка клиента шардом не разыменовывается, а типы телеметрии не ограничиваются
+        const qint64 receivedAtNs = MonotonicClock::nowNs();
+        for (int i = 0; i < MESSAGES; ++i) {
+            const quintptr descriptor = quintptr(i % CLIENTS + 1);
+            ParseShard *shard = shards[qHash(descriptor) % uint(shardCount)].get();
+            shard->messageQueued();
+            QMetaObject::invokeMethod(shard, [shard, descriptor, clientId = m_clientIds.at(i % CLIENTS),
+                                              data = m_messages.at(i % DISTINCT_MESSAGES), receivedAtNs] {
+                shard->parse(nullptr, descriptor, clientId, data, receivedAtNs);
+            });
+        }
+
+        int parsed = 0;
+        qint64 startedNs = 0;
+        qint64 elapsedNs = 0;
+        QBENCHMARK_ONCE {
+            startedNs = MonotonicClock::nowNs();
+            for (const auto &thread : threads)
+                thread->start();
+            // Как ServerWorker: пакеты забираются, пока шарды продолжают разбор
+            while (parsed < MESSAGES) {
+                for (const auto &shard : shards) {
+                    if (shard->pendingCount() > 0)
+                        parsed += int(shard->takeDataBatch().size());
+                }
+                QThread::usleep(500);
+            }
+            elapsedNs = MonotonicClock::nowNs() - startedNs;
+        }
+
+        for (const auto &thread : threads) {
+            thread->quit();
+            thread->wait();
+        }
+        for (const auto &shard : shards)
+            QCOMPARE(shard->backlog(), 0);
+        QCOMPARE(parsed, MESSAGES);
+
+        const double messagesPerSec = MESSAGES / (elapsedNs / 1e9);
+        if (shardCount == 1)
+            m_singleShardRate = messagesPerSec;
+        const double speedup = messagesPerSec / m_singleShardRate;
+        qInfo("%d шард(ов): %.0f сообщений/с, ускорение %.2f (эффективность %.0f%%), ядер: %d",
+              shardCount, messagesPerSec, speedup, 100.0 * speedup / shardCount,
+              QThread::idealThreadCount());
+        // Результат замера — сообщений в секунду
+        QTest::setBenchmarkResult(messagesPerSec, QTest::Events);
+
+        // Ядро остается читающему пакеты потоку; на малом числе ядер ускорение не проверяется
+        if (shardCount == 2 && QThread::idealThreadCount() > shardCount) {
+            QVERIFY2(speedup >= MIN_TWO_SHARD_SPEEDUP, qPrintable(QString::number(speedup)));
+        }
+    }
+
+private:
+    /// @brief Сообщения смеси, закодированные заранее.
+    QList<QByteArray> m_messages;
+    /// @brief ID клиентов по порядку дескрипторов.
+    QStringList m_clientIds;
+    /// @brief Темп разбора одним шардом — основа для ускорения.
+    double m_singleShardRate = 0.0;
+};
+
+QTEST_GUILESS_MAIN(BenchParseShards)
+#include "bench_parseshards.moc"
@@ -0,0 +1,68 @@
+/**
+ * @file fakeclient.h
+ * @brief Определяет класс FakeClient — клиент без сокета для тестов.
+ */
+#ifndef FAKECLIENT_H
+#define FAKECLIENT_H
+
+#include <QByteArrayList>
+
+#include "../common/iclient.h"
+
+/**
+ * @class FakeClient
+ * @brief Реализация IClient, запоминающая отправленные данные вместо записи в сокет.
+ *
+ * Позволяет проверять компоненты сервера (реестр клиентов, обработку данных)
+ * без сетевых подключений.
+ */
+class FakeClient : public IClient {
+public:
+    /**
+     * @brief Конструктор класса FakeClient.
+     * @param descriptor Дескриптор клиента.
+     * @param parent Родительский объект QObject.
+     */
+    explicit FakeClient(quintptr descriptor, QObject *parent = nullptr)
+        : IClient(parent), m_descriptor(descriptor) {}
+
+    quintptr descriptor() const override { return m_descriptor; }
+    QString address() const override { return QStringLiteral("127.0.0.1"); }
+    quint16 port() const override { return 0; }
+    QString id() const override { return m_id; }
+    bool isConnected() const override { return m_connected; }
+    FramingMode framingMode() const override { return m_framingMode; }
+
+    void setId(const QString &id) override { m_id = id; }
+    void setFramingMode(FramingMode mode) override { m_framingMode = mode; }
+
+    void sendData(const QByteArray &data) override { sent.append(data); }
+    void sendData(const QByteArray &data, const QString &) override { sent.append(data); }
+    qint64 queuedBytes() const override { return 0; }
+    quint64 droppedMessages() const override { return 0; }
+    void setSlowConsumerPolicy(SlowConsumerPolicy, qint64) override {}
+
+    void connectToHost(const QString &, quint16) override { m_connected = true; }
+    void disconnect() override {
+        ++disconnects;
+        m_connected = false;
+    }
+
+    /// @brief Данные, переданные в sendData(), в порядке отправки.
+    QByteArrayList sent;
+    /// @brief Количество вызовов disconnect().
+    int disconnects = 0;
+
+protected:
+    void handleConnected() override {}
+    void handleDisconnected() override {}
+    void handleReadyRead() override {}
+
+private:
+    quintptr m_descriptor;
+    QString m_id;
+    bool m_connected = true;
+    FramingMode m_framingMode = FramingMode::Raw;
+};
+
+#endif // FAKECLIENT_H
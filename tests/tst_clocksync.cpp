@@ -0,0 +1,96 @@
+/**
+ * @file tst_clocksync.cpp
+ * @brief Тесты оценки смещения часов клиента ClockSync.
+ */
+#include <QCborMap>
+#include <QTest>
+
+#include "clocksync.h"
+
+namespace {
+/**
+ * @brief Формирует ответ сервера на Probe (время в мкс).
+ */
+QCborMap probeReply(qint64 sentUs, qint64 serverUs) {
+    QCborMap reply;
+    reply.insert(Protocol::Keys::TYPE, Protocol::MessageType::PROBE);
+    reply.insert(Protocol::Keys::SENT_AT, sentUs);
+    reply.insert(Protocol::Keys::SERVER_TIME, serverUs);
+    return reply;
+}
+
+/**
+ * @brief Возвращает время отправки, которое ClockSync поставит в сообщение в момент localUs.
+ */
+qint64 stampedSentAt(const ClockSync &clock, qint64 localUs) {
+    QJsonObject message;
+    clock.stamp(message, 1, localUs * 1000);
+    return message.value(Protocol::Keys::SENT_AT).toInteger(-1);
+}
+} // namespace
+
+class TestClockSync : public QObject {
+    Q_OBJECT
+
+private slots:
+    void probeRequestCarriesClientTime() {
+        const QJsonObject probe = ClockSync::probeRequest(1234567890);
+        QCOMPARE(probe.value(Protocol::Keys::TYPE).toString(), Protocol::MessageType::PROBE);
+        QCOMPARE(probe.value(Protocol::Keys::SENT_AT).toInteger(), qint64(1234567));
+    }
+
+    void stampsSequenceBeforeSynchronization() {
+        ClockSync clock;
+        QVERIFY(!clock.isSynchronized());
+
+        QJsonObject message;
+        clock.stamp(message, 7, 5000000);
+        QCOMPARE(message.value(Protocol::Keys::SEQUENCE).toInteger(), qint64(7));
+        // До первого ответа время отправки по часам сервера неизвестно
+        QVERIFY(!message.contains(Protocol::Keys::SENT_AT));
+    }
+
+    void estimatesOffsetFromReply() {
+        ClockSync clock;
+        // Оборот 200 мкс, сервер ответил в 51000 мкс по своим часам: смещение 51000 - 1100
+        QCOMPARE(clock.handleReply(probeReply(1000, 51000), 1200000), qint64(200000));
+        QVERIFY(clock.isSynchronized());
+        QCOMPARE(stampedSentAt(clock, 2000), qint64(2000 + 49900));
+    }
+
+    void rejectsInvalidReplies() {
+        ClockSync clock;
+        QCOMPARE(clock.handleReply(QCborMap(), 1000000), qint64(-1));
+        QCOMPARE(clock.handleReply(probeReply(1000, 0), 1200000), qint64(-1));
+        // Ответ на Probe, отправленный "в будущем", — от другого процесса или после перезапуска
+        QCOMPARE(clock.handleReply(probeReply(5000, 51000), 1200000), qint64(-1));
+        QVERIFY(!clock.isSynchronized());
+    }
+
+    /**
+     * @brief Смещение берется по замеру с наименьшим временем оборота среди последних PROBE_HISTORY.
+     */
+    void prefersShortestRoundTrip() {
+        ClockSync clock;
+        clock.handleReply(probeReply(1000, 51000), 1200000);        // оборот 200 мкс, смещение 49900
+        clock.handleReply(probeReply(10000, 70000), 15000000);      // оборот 5000 мкс, смещение 57500
+        QCOMPARE(stampedSentAt(clock, 20000), qint64(20000 + 49900));
+
+        // Быстрый замер вытесняется из истории медленными
+        qint64 localUs = 100000;
+        for (int i = 0; i < Protocol::Timing::PROBE_HISTORY - 1; ++i, localUs += 10000)
+            clock.handleReply(probeReply(localUs, localUs + 2500 + 60000), (localUs + 5000) * 1000);
+        QCOMPARE(stampedSentAt(clock, 0), qint64(60000));
+    }
+
+    void resetForgetsSamples() {
+        ClockSync clock;
+        clock.handleReply(probeReply(1000, 51000), 1200000);
+        clock.reset();
+        QVERIFY(!clock.isSynchronized());
+        QCOMPARE(stampedSentAt(clock, 2000), qint64(-1));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestClockSync)
+#include "tst_clocksync.moc"
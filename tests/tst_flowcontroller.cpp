@@ -0,0 +1,166 @@
+/**
+ * @file tst_flowcontroller.cpp
+ * @brief Тесты выбора уровня ограничения темпа FlowController: рост, гистерезис, Target.
+ */
+#include <QElapsedTimer>
+#include <QTest>
+
+#include "core/flowcontroller.h"
+#include "core/sharedkeys.h"
+
+namespace {
+/// @brief Очередь разбора, вдвое превышающая порог перегрузки.
+constexpr int OVERLOADED_BACKLOG = 2 * FlowController::QUEUE_HIGH;
+/// @brief Очередь разбора с давлением ниже RELAX_PRESSURE.
+constexpr int CALM_BACKLOG = FlowController::QUEUE_HIGH / 10;
+/// @brief Очередь разбора с давлением между RELAX_PRESSURE и 1.
+constexpr int MODERATE_BACKLOG = FlowController::QUEUE_HIGH * 3 / 4;
+
+/**
+ * @brief Поднимает уровень контроллера до заданного оценками под перегрузкой.
+ */
+void raiseTo(FlowController &controller, int level) {
+    while (controller.level() < level)
+        controller.update(OVERLOADED_BACKLOG, 0.0);
+}
+} // namespace
+
+class TestFlowController : public QObject {
+    Q_OBJECT
+
+private slots:
+    void startsUnlimited() {
+        FlowController controller;
+        QCOMPARE(controller.level(), 0);
+        QCOMPARE(controller.update(0, 0.0), 0);
+        QCOMPARE(controller.update(MODERATE_BACKLOG, 0.5), 0);
+    }
+
+    /**
+     * @brief Под перегрузкой уровень растет на одну ступень за оценку до MAX_LEVEL.
+     */
+    void raisesOneLevelPerEvaluation() {
+        FlowController controller;
+        for (int expected = 1; expected <= FlowController::MAX_LEVEL; ++expected)
+            QCOMPARE(controller.update(OVERLOADED_BACKLOG, 0.0), expected);
+        QCOMPARE(controller.update(OVERLOADED_BACKLOG, 0.0), FlowController::MAX_LEVEL);
+
+        // Ровно на пороге сервер еще не перегружен
+        FlowController atThreshold;
+        QCOMPARE(atThreshold.update(FlowController::QUEUE_HIGH, 0.0), 0);
+    }
+
+    void cpuUsageRaisesLevel() {
+        FlowController controller;
+        QCOMPARE(controller.update(0, 0.9), 1);
+        QCOMPARE(controller.update(0, 0.9), 2);
+        QCOMPARE(controller.update(0, FlowController::CPU_HIGH), 2);
+    }
+
+    /**
+     * @brief Уровень снижается на ступень только после RELAX_EVALUATIONS спокойных оценок подряд.
+     */
+    void relaxesWithHysteresis() {
+        FlowController controller;
+        raiseTo(controller, 3);
+
+        for (int i = 1; i < FlowController::RELAX_EVALUATIONS; ++i)
+            QCOMPARE(controller.update(CALM_BACKLOG, 0.1), 3);
+        QCOMPARE(controller.update(CALM_BACKLOG, 0.1), 2);
+
+        // Счетчик начинается заново после каждого снижения
+        for (int i = 1; i < FlowController::RELAX_EVALUATIONS; ++i)
+            QCOMPARE(controller.update(CALM_BACKLOG, 0.1), 2);
+        QCOMPARE(controller.update(CALM_BACKLOG, 0.1), 1);
+    }
+
+    /**
+     * @brief Давление в полосе [RELAX_PRESSURE, 1] удерживает уровень и сбрасывает счетчик затишья.
+     */
+    void moderatePressureResetsCalmCount() {
+        FlowController controller;
+        raiseTo(controller, 2);
+
+        for (int round = 0; round < 3; ++round) {
+            for (int i = 1; i < FlowController::RELAX_EVALUATIONS; ++i)
+                QCOMPARE(controller.update(CALM_BACKLOG, 0.0), 2);
+            QCOMPARE(controller.update(MODERATE_BACKLOG, 0.0), 2);
+        }
+        // Кратковременная перегрузка тоже сбрасывает счетчик и поднимает уровень
+        for (int i = 1; i < FlowController::RELAX_EVALUATIONS; ++i)
+            controller.update(CALM_BACKLOG, 0.0);
+        QCOMPARE(controller.update(OVERLOADED_BACKLOG, 0.0), 3);
+        for (int i = 1; i < FlowController::RELAX_EVALUATIONS; ++i)
+            QCOMPARE(controller.update(CALM_BACKLOG, 0.0), 3);
+        QCOMPARE(controller.update(CALM_BACKLOG, 0.0), 2);
+    }
+
+    void relaxesToZeroAndStays() {
+        FlowController controller;
+        raiseTo(controller, 1);
+        for (int i = 0; i < FlowController::RELAX_EVALUATIONS; ++i)
+            controller.update(0, 0.0);
+        QCOMPARE(controller.level(), 0);
+        for (int i = 0; i < 3 * FlowController::RELAX_EVALUATIONS; ++i)
+            QCOMPARE(controller.update(0, 0.0), 0);
+    }
+
+    void targetForLevel() {
+        FlowController::Target target = FlowController::targetForLevel(0);
+        QCOMPARE(target.sendIntervalMs, 0);
+        QCOMPARE(target.sampleRatio, 1.0);
+        QCOMPARE(FlowController::targetForLevel(-3).sendIntervalMs, 0);
+
+        // Ступени 1..INTERVAL_LEVELS удваивают интервал
+        QCOMPARE(FlowController::targetForLevel(1).sendIntervalMs, FlowController::BASE_INTERVAL_MS);
+        QCOMPARE(FlowController::targetForLevel(2).sendIntervalMs, 2 * FlowController::BASE_INTERVAL_MS);
+        target = FlowController::targetForLevel(FlowController::INTERVAL_LEVELS);
+        QCOMPARE(target.sendIntervalMs, 4000);
+        QCOMPARE(target.sampleRatio, 1.0);
+
+        // Следующие вдвое уменьшают долю при наибольшем интервале
+        target = FlowController::targetForLevel(FlowController::INTERVAL_LEVELS + 1);
+        QCOMPARE(target.sendIntervalMs, 4000);
+        QCOMPARE(target.sampleRatio, 0.5);
+        target = FlowController::targetForLevel(FlowController::MAX_LEVEL);
+        QCOMPARE(target.sampleRatio, 0.125);
+        QCOMPARE(FlowController::targetForLevel(FlowController::MAX_LEVEL + 5).sampleRatio, 0.125);
+    }
+
+    void metricsReflectLastEvaluation() {
+        FlowController controller;
+        raiseTo(controller, FlowController::INTERVAL_LEVELS + 1);
+        controller.update(MODERATE_BACKLOG, 0.42);
+
+        const QVariantMap metrics = controller.metrics();
+        QCOMPARE(metrics.value(Keys::FLOW_LEVEL).toInt(), FlowController::INTERVAL_LEVELS + 1);
+        QCOMPARE(metrics.value(Keys::FLOW_BACKLOG).toInt(), MODERATE_BACKLOG);
+        QCOMPARE(metrics.value(Keys::FLOW_CPU_PERCENT).toInt(), 42);
+        QCOMPARE(metrics.value(Keys::FLOW_SEND_INTERVAL).toInt(), 4000);
+        QCOMPARE(metrics.value(Keys::FLOW_SAMPLE_RATIO).toDouble(), 0.5);
+    }
+
+    /**
+     * @brief Загрузка процессора: первый замер — 0, после вычислений — доля в (0, 1].
+     */
+    void samplesCpuUsage() {
+        FlowController controller;
+        QCOMPARE(controller.sampleCpuUsage(), 0.0);
+
+        QElapsedTimer timer;
+        timer.start();
+        volatile quint64 sink = 0;
+        while (timer.elapsed() < 200)
+            for (int i = 0; i < 10000; ++i)
+                sink = sink + quint64(i);
+
+        const double usage = controller.sampleCpuUsage();
+#if defined(Q_OS_WIN) || defined(Q_OS_UNIX)
+        QVERIFY2(usage > 0.0, qPrintable(QString::number(usage)));
+#endif
+        QVERIFY(usage <= 1.0);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestFlowController)
+#include "tst_flowcontroller.moc"
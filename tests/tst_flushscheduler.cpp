@@ -0,0 +1,155 @@
+/**
+ * @file tst_flushscheduler.cpp
+ * @brief Тесты адаптивного планировщика отправки пакетов FlushScheduler.
+ */
+#include <QTest>
+#include <QThread>
+
+#include "core/flushscheduler.h"
+#include "core/sharedkeys.h"
+
+namespace {
+/// @brief Время применения пакета, при котором бюджет UI ограничивает интервал 400 мс (в микросекундах).
+constexpr qint64 SLOW_APPLY_US = 100000;
+/// @brief Время применения пакета, не влияющее на интервал (в микросекундах).
+constexpr qint64 FAST_APPLY_US = 1000;
+
+/**
+ * @brief Отправляет пакет по таймеру и сразу подтверждает его.
+ */
+void flushAndAcknowledge(FlushScheduler &scheduler, qint64 applyTimeUs) {
+    const quint64 sequence = scheduler.flushStarted(FlushScheduler::Reason::Timer, 1, 1);
+    scheduler.flushAcknowledged(sequence, applyTimeUs);
+}
+} // namespace
+
+class TestFlushScheduler : public QObject {
+    Q_OBJECT
+
+private slots:
+    void startsAtTargetInterval() {
+        FlushScheduler scheduler;
+        QCOMPARE(scheduler.interval(), FlushScheduler::TARGET_INTERVAL_MS);
+        QVERIFY(scheduler.canFlush());
+    }
+
+    /**
+     * @brief Досрочная отправка — по порогу записей или байт, не чаще MIN_INTERVAL_MS.
+     */
+    void earlyFlushThresholds() {
+        FlushScheduler scheduler;
+        QVERIFY(!scheduler.shouldFlushEarly(FlushScheduler::EARLY_FLUSH_RECORDS - 1,
+                                            FlushScheduler::EARLY_FLUSH_BYTES - 1));
+        QVERIFY(scheduler.shouldFlushEarly(FlushScheduler::EARLY_FLUSH_RECORDS, 0));
+        QVERIFY(scheduler.shouldFlushEarly(0, FlushScheduler::EARLY_FLUSH_BYTES));
+
+        const quint64 sequence = scheduler.flushStarted(FlushScheduler::Reason::Threshold,
+                                                        FlushScheduler::EARLY_FLUSH_RECORDS, 0);
+        QCOMPARE(sequence, quint64(1));
+        // До подтверждения UI досрочной отправки нет
+        QVERIFY(!scheduler.canFlush());
+        QThread::msleep(FlushScheduler::MIN_INTERVAL_MS + 10);
+        QVERIFY(!scheduler.shouldFlushEarly(FlushScheduler::EARLY_FLUSH_RECORDS, 0));
+
+        scheduler.flushAcknowledged(sequence, FAST_APPLY_US);
+        QVERIFY(scheduler.shouldFlushEarly(FlushScheduler::EARLY_FLUSH_RECORDS, 0));
+
+        // Сразу после отправки порог не действует до MIN_INTERVAL_MS
+        flushAndAcknowledge(scheduler, FAST_APPLY_US);
+        QVERIFY(!scheduler.shouldFlushEarly(FlushScheduler::EARLY_FLUSH_RECORDS, 0));
+    }
+
+    /**
+     * @brief Медленное применение в UI ограничивает и интервал, и частоту досрочных отправок.
+     */
+    void uiBudgetBoundsInterval() {
+        FlushScheduler scheduler;
+        flushAndAcknowledge(scheduler, SLOW_APPLY_US);
+        // 100 мс применения при бюджете 25% — не чаще раза в 400 мс
+        QCOMPARE(scheduler.interval(), 400);
+
+        QThread::msleep(FlushScheduler::MIN_INTERVAL_MS + 10);
+        QVERIFY(!scheduler.shouldFlushEarly(FlushScheduler::EARLY_FLUSH_RECORDS, 0));
+
+        // Сглаженное время убывает постепенно, интервал — вместе с ним
+        flushAndAcknowledge(scheduler, 0);
+        QVERIFY(scheduler.interval() < 400);
+        QVERIFY(scheduler.interval() > FlushScheduler::TARGET_INTERVAL_MS);
+    }
+
+    /**
+     * @brief Пока UI не подтвердил пакет, каждая отсрочка удваивает интервал до MAX_INTERVAL_MS.
+     */
+    void backsOffWhileAcknowledgementIsLate() {
+        FlushScheduler scheduler;
+        scheduler.flushStarted(FlushScheduler::Reason::Timer, 10, 100);
+        QVERIFY(!scheduler.canFlush());
+
+        int expected = FlushScheduler::TARGET_INTERVAL_MS;
+        for (int i = 0; i < 5; ++i) {
+            scheduler.flushDeferred();
+            expected = qMin(expected * 2, FlushScheduler::MAX_INTERVAL_MS);
+            QCOMPARE(scheduler.interval(), expected);
+        }
+        QCOMPARE(scheduler.interval(), FlushScheduler::MAX_INTERVAL_MS);
+        QCOMPARE(scheduler.metrics().value(Keys::FLUSH_DEFERRED_COUNT).toULongLong(), quint64(5));
+        QCOMPARE(scheduler.metrics().value(Keys::FLUSH_LAST_DECISION).toString(), QString("deferred"));
+    }
+
+    void lostAcknowledgementExpires() {
+        FlushScheduler scheduler;
+        scheduler.flushStarted(FlushScheduler::Reason::Timer, 1, 1);
+        QVERIFY(!scheduler.canFlush());
+        // Подтверждение могло потеряться: через MAX_INTERVAL_MS отправка снова разрешена
+        QTRY_VERIFY_WITH_TIMEOUT(scheduler.canFlush(), FlushScheduler::MAX_INTERVAL_MS + 1000);
+    }
+
+    /**
+     * @brief После быстрого применения интервал возвращается к целевому постепенно, не ниже его.
+     */
+    void recoversAfterFastApply() {
+        FlushScheduler scheduler;
+        scheduler.flushStarted(FlushScheduler::Reason::Timer, 1, 1);
+        for (int i = 0; i < 4; ++i)
+            scheduler.flushDeferred();
+        QCOMPARE(scheduler.interval(), FlushScheduler::MAX_INTERVAL_MS);
+
+        scheduler.flushAcknowledged(1, FAST_APPLY_US);
+        int previous = scheduler.interval();
+        QCOMPARE(previous, (FlushScheduler::MAX_INTERVAL_MS + FlushScheduler::TARGET_INTERVAL_MS) / 2);
+
+        // Повторное или устаревшее подтверждение интервал не меняет
+        scheduler.flushAcknowledged(1, FAST_APPLY_US);
+        QCOMPARE(scheduler.interval(), previous);
+
+        for (int i = 0; i < 20 && previous > FlushScheduler::TARGET_INTERVAL_MS; ++i) {
+            flushAndAcknowledge(scheduler, FAST_APPLY_US);
+            QVERIFY(scheduler.interval() < previous);
+            QVERIFY(scheduler.interval() >= FlushScheduler::TARGET_INTERVAL_MS);
+            previous = scheduler.interval();
+        }
+        QCOMPARE(scheduler.interval(), FlushScheduler::TARGET_INTERVAL_MS);
+    }
+
+    void exportsMetrics() {
+        FlushScheduler scheduler;
+        const quint64 first = scheduler.flushStarted(FlushScheduler::Reason::Timer, 10, 1000);
+        scheduler.flushAcknowledged(first, 3000);
+        const quint64 second = scheduler.flushStarted(FlushScheduler::Reason::Threshold, 2500, 4096);
+        QCOMPARE(second, first + 1);
+
+        const QVariantMap metrics = scheduler.metrics();
+        QCOMPARE(metrics.value(Keys::FLUSH_INTERVAL).toInt(), scheduler.interval());
+        QCOMPARE(metrics.value(Keys::FLUSH_TIMER_COUNT).toULongLong(), quint64(1));
+        QCOMPARE(metrics.value(Keys::FLUSH_EARLY_COUNT).toULongLong(), quint64(1));
+        QCOMPARE(metrics.value(Keys::FLUSH_DEFERRED_COUNT).toULongLong(), quint64(0));
+        QCOMPARE(metrics.value(Keys::FLUSH_LAST_RECORDS).toInt(), 2500);
+        QCOMPARE(metrics.value(Keys::FLUSH_LAST_BYTES).toLongLong(), qint64(4096));
+        QCOMPARE(metrics.value(Keys::FLUSH_UI_APPLY_US).toLongLong(), qint64(3000));
+        QVERIFY(metrics.value(Keys::FLUSH_ROUND_TRIP_MS).toLongLong() >= 0);
+        QCOMPARE(metrics.value(Keys::FLUSH_LAST_DECISION).toString(), QString("threshold"));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestFlushScheduler)
+#include "tst_flushscheduler.moc"
@@ -0,0 +1,299 @@
+/**
+ * @file tst_latencymonitor.cpp
+ * @brief Тесты LatencyHistogram и LatencyMonitor.
+ */
+#include <QCborMap>
+#include <QTest>
+
+#include "../common/protocol.h"
+#include "core/latencymonitor.h"
+#include "core/sharedkeys.h"
+
+namespace {
+/// @brief Допустимая относительная погрешность корзины (32 корзины на порядок).
+constexpr double MAX_RELATIVE_ERROR = 1.0 / 32;
+
+/**
+ * @brief Возвращает строку статистики монитора для типа и этапа.
+ */
+QVariantMap statsRow(const LatencyMonitor &monitor, const QString &type, LatencyMonitor::Stage stage) {
+    for (const QVariant &value : monitor.stats()) {
+        const QVariantMap row = value.toMap();
+        if (row[Keys::TYPE].toString() == type &&
+            row[Keys::LATENCY_STAGE].toString() == LatencyMonitor::stageName(stage))
+            return row;
+    }
+    return {};
+}
+
+/**
+ * @brief Создает запись с отметками этапов через равные промежутки (мкс) от received.
+ */
+TelemetryRecord makeRecord(const QString &type, qint64 receivedNs, qint64 stepUs) {
+    TelemetryRecord record;
+    record.type = type;
+    record.clientId = "client";
+    record.stages.received = receivedNs;
+    record.stages.parseStarted = receivedNs + stepUs * 1000;
+    record.stages.parsed = receivedNs + stepUs * 2000;
+    record.stages.flushed = receivedNs + stepUs * 3000;
+    return record;
+}
+
+/**
+ * @brief Создает запись клиента с номером и временем отправки (0 — без отметки).
+ */
+TelemetryRecord makeClientRecord(const QString &clientId, quint64 sequence, qint64 sentNs, qint64 receivedNs) {
+    TelemetryRecord record = makeRecord("log", receivedNs, 1);
+    record.clientId = clientId;
+    record.sequence = sequence;
+    record.stages.sent = sentNs;
+    return record;
+}
+} // namespace
+
+class TestLatencyMonitor : public QObject {
+    Q_OBJECT
+
+private slots:
+    void histogramSmallValuesAreExact() {
+        LatencyHistogram histogram;
+        for (int value = 0; value < LatencyHistogram::SUB_BUCKET_COUNT; ++value)
+            histogram.record(value);
+
+        QCOMPARE(histogram.count(), quint64(LatencyHistogram::SUB_BUCKET_COUNT));
+        for (int value = 0; value < LatencyHistogram::SUB_BUCKET_COUNT; ++value) {
+            // Середина доли значения, чтобы округление перцентиля не попало на границу
+            const double percentile = 100.0 * (value + 0.5) / LatencyHistogram::SUB_BUCKET_COUNT;
+            QCOMPARE(histogram.valueAtPercentile(percentile), quint64(value));
+        }
+    }
+
+    void histogramRelativeError_data() {
+        QTest::addColumn<qint64>("value");
+        for (qint64 value : {64LL, 65LL, 100LL, 127LL, 128LL, 1000LL, 12345LL, 999999LL,
+                             123456789LL, 40000000000LL})
+            QTest::addRow("%lld", value) << value;
+    }
+
+    void histogramRelativeError() {
+        QFETCH(qint64, value);
+
+        // Второе значение больше, чтобы перцентиль не ограничивался максимумом
+        LatencyHistogram histogram;
+        histogram.record(value);
+        histogram.record(LatencyHistogram::MAX_VALUE_US);
+
+        const quint64 reported = histogram.valueAtPercentile(50.0);
+        QVERIFY(reported >= quint64(value));
+        QVERIFY2(reported <= quint64(value * (1.0 + MAX_RELATIVE_ERROR)),
+                 qPrintable(QString("%1 -> %2").arg(value).arg(reported)));
+    }
+
+    void histogramPercentiles() {
+        LatencyHistogram histogram;
+        for (int value = 1; value <= 10000; ++value)
+            histogram.record(value);
+
+        const auto check = [&histogram](double percentile, quint64 expected) {
+            const quint64 reported = histogram.valueAtPercentile(percentile);
+            QVERIFY2(reported >= expected && reported <= expected * (1.0 + MAX_RELATIVE_ERROR),
+                     qPrintable(QString("p%1: %2").arg(percentile).arg(reported)));
+        };
+        check(50.0, 5000);
+        check(90.0, 9000);
+        check(99.0, 9900);
+        QCOMPARE(histogram.valueAtPercentile(100.0), quint64(10000));
+        QCOMPARE(histogram.max(), quint64(10000));
+    }
+
+    void histogramClampsAndIgnoresNegative() {
+        LatencyHistogram histogram;
+        histogram.record(-5);
+        QCOMPARE(histogram.count(), quint64(0));
+        QCOMPARE(histogram.valueAtPercentile(50.0), quint64(0));
+
+        histogram.record(qint64(LatencyHistogram::MAX_VALUE_US) * 4);
+        QCOMPARE(histogram.count(), quint64(1));
+        QCOMPARE(histogram.max(), LatencyHistogram::MAX_VALUE_US);
+        QCOMPARE(histogram.valueAtPercentile(99.9), LatencyHistogram::MAX_VALUE_US);
+
+        histogram.reset();
+        QCOMPARE(histogram.count(), quint64(0));
+        QCOMPARE(histogram.max(), quint64(0));
+    }
+
+    void monitorRecordsStages() {
+        const qint64 receivedNs = 1000000000;
+        // Этапы по 10 мкс: разбор очереди, разбор, ожидание пакета
+        TelemetryRecord record = makeRecord("log", receivedNs, 10);
+        const qint64 uiReceivedNs = record.stages.flushed + 40000;
+        const qint64 appliedNs = uiReceivedNs + 5000;
+
+        LatencyMonitor monitor;
+        monitor.recordBatch({record}, uiReceivedNs, appliedNs);
+
+        const QList<QPair<LatencyMonitor::Stage, int>> expected = {
+            {LatencyMonitor::IoQueue, 10},  {LatencyMonitor::Parse, 10},
+            {LatencyMonitor::BatchWait, 10}, {LatencyMonitor::Dispatch, 40},
+            {LatencyMonitor::Apply, 5},     {LatencyMonitor::Total, 75},
+        };
+        for (const auto &[stage, valueUs] : expected) {
+            for (const QString &type : {QString("Все"), QString("log")}) {
+                const QVariantMap row = statsRow(monitor, type, stage);
+                QCOMPARE(row[Keys::LATENCY_COUNT].toULongLong(), 1ULL);
+                QCOMPARE(row[Keys::LATENCY_MAX].toULongLong(), quint64(valueUs));
+                QCOMPARE(row[Keys::LATENCY_P50].toULongLong(), quint64(valueUs));
+            }
+        }
+
+        // Без времени отправки этапы от клиента не учитываются
+        QCOMPARE(statsRow(monitor, "Все", LatencyMonitor::Network)[Keys::LATENCY_COUNT].toULongLong(), 0ULL);
+        QCOMPARE(statsRow(monitor, "Все", LatencyMonitor::EndToEnd)[Keys::LATENCY_COUNT].toULongLong(), 0ULL);
+    }
+
+    void monitorRecordsClientStages() {
+        const qint64 receivedNs = 1000000000;
+        TelemetryRecord record = makeRecord("network", receivedNs, 1);
+        record.stages.sent = receivedNs - 300000;
+        const qint64 appliedNs = record.stages.flushed + 1000;
+
+        LatencyMonitor monitor;
+        monitor.recordBatch({record}, appliedNs, appliedNs);
+
+        QCOMPARE(statsRow(monitor, "network", LatencyMonitor::Network)[Keys::LATENCY_MAX].toULongLong(), 300ULL);
+        QCOMPARE(statsRow(monitor, "network", LatencyMonitor::EndToEnd)[Keys::LATENCY_MAX].toULongLong(), 304ULL);
+
+        // Время отправки позже чтения (погрешность смещения часов) считается нулевой задержкой
+        record.stages.sent = receivedNs + 50000;
+        monitor.reset();
+        monitor.recordBatch({record}, appliedNs, appliedNs);
+        QCOMPARE(statsRow(monitor, "Все", LatencyMonitor::Network)[Keys::LATENCY_COUNT].toULongLong(), 1ULL);
+        QCOMPARE(statsRow(monitor, "Все", LatencyMonitor::Network)[Keys::LATENCY_MAX].toULongLong(), 0ULL);
+    }
+
+    void monitorGroupsByType() {
+        const qint64 receivedNs = 1000000000;
+        QList<TelemetryRecord> records;
+        for (int i = 0; i < 6; ++i)
+            records.append(makeRecord(i % 2 ? "log" : "deviceStatus", receivedNs, 1));
+        // Записи без отметки чтения (например, служебные) пропускаются
+        records.append(TelemetryRecord());
+
+        LatencyMonitor monitor;
+        const qint64 appliedNs = receivedNs + 10000;
+        monitor.recordBatch(records, appliedNs, appliedNs);
+
+        QCOMPARE(statsRow(monitor, "Все", LatencyMonitor::Total)[Keys::LATENCY_COUNT].toULongLong(), 6ULL);
+        QCOMPARE(statsRow(monitor, "log", LatencyMonitor::Total)[Keys::LATENCY_COUNT].toULongLong(), 3ULL);
+        QCOMPARE(statsRow(monitor, "deviceStatus", LatencyMonitor::Total)[Keys::LATENCY_COUNT].toULongLong(), 3ULL);
+
+        // Строки "Все" идут первыми, затем типы по алфавиту
+        const QVariantList rows = monitor.stats();
+        QCOMPARE(rows.size(), 3 * int(LatencyMonitor::StageCount));
+        QCOMPARE(rows.at(0).toMap()[Keys::TYPE].toString(), QString("Все"));
+        QCOMPARE(rows.at(LatencyMonitor::StageCount).toMap()[Keys::TYPE].toString(), QString("deviceStatus"));
+        QVERIFY(monitor.report().contains("deviceStatus"));
+
+        monitor.reset();
+        QCOMPARE(monitor.stats().size(), int(LatencyMonitor::StageCount));
+        QCOMPARE(statsRow(monitor, "Все", LatencyMonitor::Total)[Keys::LATENCY_COUNT].toULongLong(), 0ULL);
+    }
+
+    void envelopeCarriesSequenceAndSendTime() {
+        QCborMap message;
+        message.insert(Protocol::Keys::SEQUENCE, 42);
+        message.insert(Protocol::Keys::SENT_AT, 1500);
+        TelemetryRecord record;
+        record.readEnvelope(message);
+        QCOMPARE(record.sequence, quint64(42));
+        QCOMPARE(record.stages.sent, qint64(1500000));
+
+        // Старые клиенты не передают отметок; некорректные значения не учитываются
+        record.readEnvelope(QCborMap());
+        QCOMPARE(record.sequence, quint64(0));
+        QCOMPARE(record.stages.sent, qint64(0));
+        message.insert(Protocol::Keys::SENT_AT, -5);
+        record.readEnvelope(message);
+        QCOMPARE(record.stages.sent, qint64(0));
+    }
+
+    void clientStatsPercentiles() {
+        // Задержки сети 10, 20, ..., 1000 мкс; модель применила пакет через 2 мс после последнего чтения
+        const qint64 receivedNs = 1000000000;
+        QList<TelemetryRecord> records;
+        for (int i = 1; i <= 100; ++i)
+            records.append(makeClientRecord("a", quint64(i), receivedNs - i * 10000, receivedNs));
+        const qint64 appliedNs = receivedNs + 2000000;
+
+        LatencyMonitor monitor;
+        monitor.recordBatch(records, appliedNs, appliedNs);
+        const QHash<QString, ClientLatencyStats> stats = monitor.takeClientStats();
+        QCOMPARE(stats.size(), 1);
+
+        const ClientLatencyStats &a = stats["a"];
+        QCOMPARE(a.samples, 100);
+        QCOMPARE(a.sequenceGaps, 0ULL);
+        QCOMPARE(a.ingestP50, qint64(510));
+        QCOMPARE(a.ingestP99, qint64(1000));
+        QCOMPARE(a.ingestMax, qint64(1000));
+        QCOMPARE(a.displayP50, qint64(2510));
+        QCOMPARE(a.displayMax, qint64(3000));
+
+        // Без новых сообщений клиент не попадает в следующую выборку
+        QVERIFY(monitor.takeClientStats().isEmpty());
+    }
+
+    void clientStatsKeepLastWindow() {
+        const qint64 receivedNs = 1000000000;
+        QList<TelemetryRecord> records;
+        // Первые сообщения с большой задержкой вытесняются из окна последующими
+        for (int i = 1; i <= 2 * LatencyMonitor::CLIENT_WINDOW; ++i) {
+            const qint64 networkNs = i <= LatencyMonitor::CLIENT_WINDOW ? 5000000 : 100000;
+            records.append(makeClientRecord("a", quint64(i), receivedNs - networkNs, receivedNs));
+        }
+
+        LatencyMonitor monitor;
+        monitor.recordBatch(records, receivedNs, receivedNs);
+        const ClientLatencyStats stats = monitor.takeClientStats().value("a");
+        QCOMPARE(stats.samples, LatencyMonitor::CLIENT_WINDOW);
+        QCOMPARE(stats.ingestMax, qint64(100));
+    }
+
+    void clientSequenceGaps() {
+        const qint64 receivedNs = 1000000000;
+        LatencyMonitor monitor;
+        // Номера без времени отправки (часы еще не сверены) тоже учитываются
+        const auto deliver = [&](const QString &clientId, quint64 sequence) {
+            monitor.recordBatch({makeClientRecord(clientId, sequence, 0, receivedNs)}, receivedNs, receivedNs);
+        };
+        for (quint64 sequence : {1, 2, 5, 6, 10})
+            deliver("a", sequence);
+        deliver("b", 7);
+
+        QHash<QString, ClientLatencyStats> stats = monitor.takeClientStats();
+        QCOMPARE(stats["a"].sequenceGaps, 5ULL);
+        QCOMPARE(stats["a"].samples, 0);
+        // Первый принятый номер пропуском не считается
+        QCOMPARE(stats["b"].sequenceGaps, 0ULL);
+
+        // Перезапуск клиента (номер меньше ожидаемого) не увеличивает счетчик
+        deliver("a", 1);
+        deliver("a", 2);
+        QCOMPARE(monitor.takeClientStats()["a"].sequenceGaps, 5ULL);
+
+        monitor.forgetClient("a");
+        deliver("a", 4);
+        QCOMPARE(monitor.takeClientStats()["a"].sequenceGaps, 0ULL);
+    }
+
+    void clientStatsSkipRecordsWithoutEnvelope() {
+        // Записи Modbus и старых клиентов без номера и времени отправки окна не создают
+        LatencyMonitor monitor;
+        monitor.recordBatch({makeRecord("registers", 1000000000, 1)}, 1000100000, 1000100000);
+        QVERIFY(monitor.takeClientStats().isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(TestLatencyMonitor)
+#include "tst_latencymonitor.moc"
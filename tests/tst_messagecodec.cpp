@@ -0,0 +1,108 @@
+/**
+ * @file tst_messagecodec.cpp
+ * @brief Тесты кодирования сообщений MessageCodec в JSON и CBOR.
+ */
+#include <QCborArray>
+#include <QJsonArray>
+#include <QTest>
+
+#include "messagecodec.h"
+#include "messageframer.h"
+#include "protocol.h"
+
+namespace {
+/**
+ * @brief Сообщение телеметрии со значениями всех используемых в протоколе типов.
+ */
+QJsonObject sampleMessage() {
+    QJsonObject payload;
+    payload["text"] = QString("Температура в норме");
+    payload["count"] = 42;
+    payload["negative"] = -7;
+    payload["value"] = 21.5;
+    payload["enabled"] = true;
+    payload["samples"] = QJsonArray{1, 2, 3};
+    payload["nested"] = QJsonObject{{"level", 3}};
+
+    QJsonObject message;
+    message[Protocol::Keys::TYPE] = Protocol::MessageType::LOG;
+    message[Protocol::Keys::PAYLOAD] = payload;
+    return message;
+}
+} // namespace
+
+class TestMessageCodec : public QObject {
+    Q_OBJECT
+
+private slots:
+    void roundTrip_data() {
+        QTest::addColumn<MessageCodec::Encoding>("encoding");
+        QTest::newRow("json") << MessageCodec::Encoding::Json;
+        QTest::newRow("cbor") << MessageCodec::Encoding::Cbor;
+    }
+
+    void roundTrip() {
+        QFETCH(MessageCodec::Encoding, encoding);
+        const QJsonObject original = sampleMessage();
+        const QByteArray data = MessageCodec::encode(original, encoding);
+
+        // Формат определяется по первому байту
+        QCOMPARE(data.startsWith('{'), encoding == MessageCodec::Encoding::Json);
+
+        QCborMap decoded;
+        QString error;
+        QVERIFY2(MessageCodec::decode(data, decoded, &error), qPrintable(error));
+        QCOMPARE(decoded.toJsonObject(), original);
+        QCOMPARE(decoded.value(Protocol::Keys::TYPE).toString(), Protocol::MessageType::LOG);
+        QCOMPARE(decoded.value(Protocol::Keys::PAYLOAD).toMap().value(QString("count")).toInteger(), qint64(42));
+    }
+
+    /**
+     * @brief Сообщение в CBOR, переданное кадром, разбирается так же, как без кадрирования.
+     */
+    void roundTripThroughFramer() {
+        const QJsonObject original = sampleMessage();
+        const QByteArray frame = MessageFramer::encode(MessageCodec::encode(original, MessageCodec::Encoding::Cbor));
+
+        MessageFramer framer;
+        framer.append(frame.left(frame.size() / 2));
+        QByteArray data;
+        QVERIFY(!framer.takeMessage(data));
+        framer.append(frame.mid(frame.size() / 2));
+        QVERIFY(framer.takeMessage(data));
+
+        QCborMap decoded;
+        QVERIFY(MessageCodec::decode(data, decoded));
+        QCOMPARE(decoded.toJsonObject(), original);
+    }
+
+    void cborIsSmallerThanJson() {
+        const QJsonObject original = sampleMessage();
+        QVERIFY(MessageCodec::encode(original, MessageCodec::Encoding::Cbor).size() <
+                MessageCodec::encode(original, MessageCodec::Encoding::Json).size());
+    }
+
+    void rejectsMalformedData() {
+        QCborMap message;
+        QString error;
+        QVERIFY(!MessageCodec::decode("{\"type\":", message, &error));
+        QVERIFY(!error.isEmpty());
+
+        // Корректные данные, но не объект
+        error.clear();
+        QVERIFY(!MessageCodec::decode(QCborArray{1, 2}.toCborValue().toCbor(), message, &error));
+        QVERIFY(!error.isEmpty());
+
+        const QByteArray cbor = MessageCodec::encode(sampleMessage(), MessageCodec::Encoding::Cbor);
+        QVERIFY(!MessageCodec::decode(cbor.left(cbor.size() - 3), message));
+        QVERIFY(!MessageCodec::decode(QByteArray(), message));
+    }
+
+    void namesEncodings() {
+        QCOMPARE(MessageCodec::encodingName(MessageCodec::Encoding::Json), Protocol::Encoding::JSON);
+        QCOMPARE(MessageCodec::encodingName(MessageCodec::Encoding::Cbor), Protocol::Encoding::CBOR);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestMessageCodec)
+#include "tst_messagecodec.moc"
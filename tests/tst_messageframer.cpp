@@ -0,0 +1,175 @@
+/**
+ * @file tst_messageframer.cpp
+ * @brief Тесты сборки кадров с префиксом длины MessageFramer.
+ */
+#include <QRandomGenerator>
+#include <QTest>
+#include <QtEndian>
+
+#include "messageframer.h"
+#include "protocol.h"
+
+namespace {
+/**
+ * @brief Возвращает префикс длины без данных сообщения.
+ */
+QByteArray header(quint32 length) {
+    QByteArray prefix(Protocol::Framing::HEADER_SIZE, '\0');
+    qToBigEndian<quint32>(length, prefix.data());
+    return prefix;
+}
+
+/**
+ * @brief Извлекает из сборщика все целые сообщения.
+ */
+QList<QByteArray> takeAll(MessageFramer &framer) {
+    QList<QByteArray> messages;
+    QByteArray message;
+    while (framer.takeMessage(message))
+        messages.append(message);
+    return messages;
+}
+} // namespace
+
+class TestMessageFramer : public QObject {
+    Q_OBJECT
+
+private slots:
+    void encodesBigEndianPrefix() {
+        const QByteArray frame = MessageFramer::encode("hello");
+        QCOMPARE(frame.size(), qsizetype(Protocol::Framing::HEADER_SIZE + 5));
+        QCOMPARE(frame.left(Protocol::Framing::HEADER_SIZE), header(5));
+        QCOMPARE(frame.mid(Protocol::Framing::HEADER_SIZE), QByteArray("hello"));
+    }
+
+    /**
+     * @brief Кадр, пришедший по одному байту, собирается только после последнего байта.
+     */
+    void reassemblesFrameSplitAcrossReads() {
+        MessageFramer framer;
+        const QByteArray frame = MessageFramer::encode("split across reads");
+        QByteArray message;
+        for (qsizetype i = 0; i + 1 < frame.size(); ++i) {
+            framer.append(frame.mid(i, 1));
+            QVERIFY(!framer.takeMessage(message));
+            QCOMPARE(framer.pendingBytes(), i + 1);
+        }
+        framer.append(frame.right(1));
+        QVERIFY(framer.takeMessage(message));
+        QCOMPARE(message, QByteArray("split across reads"));
+        QCOMPARE(framer.pendingBytes(), qsizetype(0));
+        QVERIFY(!framer.hasError());
+    }
+
+    void splitsSeveralFramesFromOneRead() {
+        MessageFramer framer;
+        const QByteArray last = MessageFramer::encode("fourth");
+        // Пустое сообщение — тоже кадр
+        framer.append(MessageFramer::encode("first") + MessageFramer::encode("second") +
+                      MessageFramer::encode(QByteArray()) + last.left(6));
+
+        QCOMPARE(takeAll(framer), QList<QByteArray>({"first", "second", QByteArray()}));
+        QCOMPARE(framer.pendingBytes(), qsizetype(6));
+
+        framer.append(last.mid(6));
+        QCOMPARE(takeAll(framer), QList<QByteArray>({"fourth"}));
+        QCOMPARE(framer.pendingBytes(), qsizetype(0));
+    }
+
+    /**
+     * @brief Длина больше MAX_FRAME_SIZE означает поврежденный поток; разбор останавливается до clear().
+     */
+    void rejectsOversizeLength() {
+        MessageFramer framer;
+        framer.append(header(quint32(Protocol::Framing::MAX_FRAME_SIZE) + 1));
+        QByteArray message;
+        QVERIFY(!framer.takeMessage(message));
+        QVERIFY(framer.hasError());
+
+        framer.append(MessageFramer::encode("valid"));
+        QVERIFY(!framer.takeMessage(message));
+        QVERIFY(framer.hasError());
+
+        framer.clear();
+        QVERIFY(!framer.hasError());
+        QCOMPARE(framer.pendingBytes(), qsizetype(0));
+        framer.append(MessageFramer::encode("valid"));
+        QVERIFY(framer.takeMessage(message));
+        QCOMPARE(message, QByteArray("valid"));
+
+        // Наибольшая допустимая длина не ошибка: кадр просто ждет данных
+        MessageFramer largest;
+        largest.append(header(quint32(Protocol::Framing::MAX_FRAME_SIZE)));
+        QVERIFY(!largest.takeMessage(message));
+        QVERIFY(!largest.hasError());
+    }
+
+    /**
+     * @brief Данные, начинающиеся с '{', отдаются целиком как JSON без кадрирования.
+     */
+    void passesLegacyJsonThrough() {
+        MessageFramer framer;
+        const QByteArray json = R"({"type":"log","payload":{}})";
+        framer.append(json);
+        QByteArray message;
+        QVERIFY(framer.takeMessage(message));
+        QCOMPARE(message, json);
+        QCOMPARE(framer.pendingBytes(), qsizetype(0));
+        QVERIFY(!framer.takeMessage(message));
+
+        // Регистрация без префикса может прийти сразу за кадром
+        framer.append(MessageFramer::encode("framed") + json);
+        QCOMPARE(takeAll(framer), QList<QByteArray>({"framed", json}));
+        QVERIFY(!framer.hasError());
+    }
+
+    void compactsBufferBetweenReads() {
+        MessageFramer framer;
+        const QByteArray second = MessageFramer::encode(QByteArray(100, 's'));
+        framer.append(MessageFramer::encode(QByteArray(300, 'f')) + second.left(50));
+        QByteArray message;
+        QVERIFY(framer.takeMessage(message));
+        QCOMPARE(message, QByteArray(300, 'f'));
+
+        // Прочитанная часть уже больше половины буфера: следующее добавление сжимает его
+        framer.append(second.mid(50));
+        QCOMPARE(framer.pendingBytes(), second.size());
+        QVERIFY(framer.takeMessage(message));
+        QCOMPARE(message, QByteArray(100, 's'));
+        QCOMPARE(framer.pendingBytes(), qsizetype(0));
+    }
+
+    /**
+     * @brief Длинный поток кадров, нарезанный на чтения случайной длины, собирается без потерь.
+     */
+    void reassemblesLongStream() {
+        QRandomGenerator random(42);
+        QList<QByteArray> sent;
+        QByteArray stream;
+        for (int i = 0; i < 5000; ++i) {
+            QByteArray message(random.bounded(0, 2000), char('a' + i % 26));
+            message.append(QByteArray::number(i));
+            sent.append(message);
+            stream.append(MessageFramer::encode(message));
+        }
+
+        MessageFramer framer;
+        QList<QByteArray> received;
+        qsizetype offset = 0;
+        while (offset < stream.size()) {
+            const qsizetype chunk = qMin<qsizetype>(random.bounded(1, 8192), stream.size() - offset);
+            framer.append(stream.mid(offset, chunk));
+            offset += chunk;
+            received.append(takeAll(framer));
+            // Ожидает только незаконченный кадр
+            QVERIFY(framer.pendingBytes() < Protocol::Framing::HEADER_SIZE + 2010);
+        }
+        QCOMPARE(received.size(), sent.size());
+        QCOMPARE(received, sent);
+        QCOMPARE(framer.pendingBytes(), qsizetype(0));
+        QVERIFY(!framer.hasError());
+    }
+};
+
+QTEST_GUILESS_MAIN(TestMessageFramer)
+#include "tst_messageframer.moc"
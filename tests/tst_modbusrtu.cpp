@@ -0,0 +1,394 @@
+/**
+ * @file tst_modbusrtu.cpp
+ * @brief Тесты расписания шины Modbus RTU: время символа, пауза t3.5, опрос через пару pty.
+ *
+ * Шина открывает ведомую сторону псевдотерминала (как у пары, создаваемой
+ * socat pty,raw,echo=0), а ведущую сторону обслуживает PtySlave — имитация
+ * ведомого устройства. Псевдотерминал передает данные мгновенно, поэтому
+ * PtySlave отвечает с задержкой, равной времени передачи запроса и ответа на
+ * скорости шины: так загрузка шины близка к загрузке реальной линии.
+ */
+#include <QCborMap>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QSocketNotifier>
+#include <QTest>
+#include <QTimer>
+#include <QtEndian>
+
+#include <cmath>
+#include <limits>
+
+#include "../common/messagecodec.h"
+#include "../common/monotonicclock.h"
+#include "../common/protocol.h"
+#include "core/modbusrtubus.h"
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @class PtySlave
+ * @brief Ведомые устройства RTU на ведущей стороне псевдотерминала.
+ *
+ * Отвечает на чтение регистров значениями, равными адресу регистра, и
+ * запоминает время каждого запроса и ответа.
+ */
+class PtySlave : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @struct Exchange
+     * @brief Запрос и ответ на него.
+     */
+    struct Exchange {
+        quint8 unitId = 0;
+        quint16 start = 0;
+        quint16 count = 0;
+        qint64 requestNs = 0;   ///< Прием запроса
+        qint64 replyNs = 0;     ///< Отправка ответа (0 — без ответа)
+    };
+
+    ~PtySlave() override {
+#ifdef Q_OS_UNIX
+        if (m_fd >= 0)
+            ::close(m_fd);
+#endif
+    }
+
+    /**
+     * @brief Создает псевдотерминал.
+     * @return Путь к ведомой стороне или пустая строка.
+     */
+    QString open() {
+#ifdef Q_OS_UNIX
+        m_fd = ::posix_openpt(O_RDWR | O_NOCTTY);
+        if (m_fd < 0 || ::grantpt(m_fd) != 0 || ::unlockpt(m_fd) != 0)
+            return QString();
+        ::fcntl(m_fd, F_SETFL, ::fcntl(m_fd, F_GETFL) | O_NONBLOCK);
+        m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+        connect(m_notifier, &QSocketNotifier::activated, this, &PtySlave::handleActivated);
+        return QString::fromLocal8Bit(::ptsname(m_fd));
+#else
+        return QString();
+#endif
+    }
+
+    /// @brief Время передачи символа, имитируемое задержкой ответа (нс).
+    qint64 charTimeNs = 0;
+    /// @brief Адреса устройств, которые не отвечают.
+    QSet<quint8> silentUnits;
+    /// @brief Все запросы в порядке приема.
+    QList<Exchange> exchanges;
+    /// @brief Количество запросов с неверной CRC.
+    int crcErrors = 0;
+
+private slots:
+    void handleActivated() {
+#ifdef Q_OS_UNIX
+        char chunk[512];
+        for (;;) {
+            const ssize_t size = ::read(m_fd, chunk, sizeof(chunk));
+            if (size > 0) {
+                m_buffer.append(chunk, size);
+                continue;
+            }
+            // EIO — ведомая сторона закрыта
+            if (size < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+                m_notifier->setEnabled(false);
+            break;
+        }
+
+        // Запрос чтения регистров: адрес, функция, начало, количество, CRC — 8 байт
+        while (m_buffer.size() >= 8) {
+            const QByteArray frame = m_buffer.left(8);
+            m_buffer.remove(0, 8);
+            if (ModbusRtuBus::crc16(frame.constData(), 6) != qFromLittleEndian<quint16>(frame.constData() + 6)) {
+                ++crcErrors;
+                continue;
+            }
+
+            Exchange exchange;
+            exchange.unitId = quint8(frame[0]);
+            exchange.start = qFromBigEndian<quint16>(frame.constData() + 2);
+            exchange.count = qFromBigEndian<quint16>(frame.constData() + 4);
+            exchange.requestNs = MonotonicClock::nowNs();
+            exchanges.append(exchange);
+            if (silentUnits.contains(exchange.unitId))
+                continue;
+
+            const QByteArray reply = response(quint8(frame[1]), exchange);
+            const qint64 wireNs = (frame.size() + reply.size()) * charTimeNs;
+            const int index = int(exchanges.size()) - 1;
+            QTimer::singleShot(int((wireNs + 999999) / 1000000), Qt::PreciseTimer, this,
+                               [this, reply, index] {
+                                   exchanges[index].replyNs = MonotonicClock::nowNs();
+                                   ::write(m_fd, reply.constData(), size_t(reply.size()));
+                               });
+        }
+#endif
+    }
+
+private:
+    static QByteArray response(quint8 function, const Exchange &exchange) {
+        QByteArray frame;
+        frame.append(char(exchange.unitId));
+        frame.append(char(function));
+        frame.append(char(exchange.count * 2));
+        for (int i = 0; i < exchange.count; ++i) {
+            char word[2];
+            qToBigEndian<quint16>(quint16(exchange.start + i), word);
+            frame.append(word, 2);
+        }
+        char crc[2];
+        qToLittleEndian<quint16>(ModbusRtuBus::crc16(frame.constData(), frame.size()), crc);
+        frame.append(crc, 2);
+        return frame;
+    }
+
+    int m_fd = -1;
+    QSocketNotifier *m_notifier = nullptr;
+    QByteArray m_buffer;
+};
+
+namespace {
+/**
+ * @brief Создает устройство с регистрами UInt16 по адресам [start, start + count) каждого диапазона.
+ */
+ModbusDeviceConfig makeConfig(quint8 unitId, const QList<QPair<int, int>> &ranges, int pollIntervalMs) {
+    ModbusDeviceConfig config;
+    config.id = QString("rtu-%1").arg(unitId);
+    config.unitId = unitId;
+    config.pollIntervalMs = pollIntervalMs;
+    for (const auto &[start, count] : ranges) {
+        for (int address = start; address < start + count; ++address) {
+            ModbusRegister reg;
+            reg.name = QString("r%1").arg(address);
+            reg.address = quint16(address);
+            config.registers.append(reg);
+        }
+    }
+    config.blocks = ModbusRegisterMap::buildBlocks(config.registers, config.maxGap);
+    return config;
+}
+
+int registerMessages(const QSignalSpy &spy) {
+    int count = 0;
+    for (const QList<QVariant> &arguments : spy) {
+        QCborMap message;
+        if (MessageCodec::decode(arguments.at(0).toByteArray(), message) &&
+            message.value(Protocol::Keys::TYPE).toString() == Protocol::MessageType::REGISTERS)
+            ++count;
+    }
+    return count;
+}
+} // namespace
+
+class TestModbusRtu : public QObject {
+    Q_OBJECT
+
+private slots:
+    void frameTiming_data() {
+        QTest::addColumn<int>("baudRate");
+        QTest::addColumn<int>("dataBits");
+        QTest::addColumn<int>("parity");
+        QTest::addColumn<int>("stopBits");
+        QTest::addColumn<qint64>("charTimeNs");
+        QTest::addColumn<qint64>("interFrameNs");
+
+        // Символ 8N1 — 10 бит, 8E1 и 8N2 — 11 бит; выше 19200 бод t3.5 = 1.75 мс
+        QTest::newRow("9600 8N1") << 9600 << 8 << int(QSerialPort::NoParity) << 1
+                                  << qint64(1041666) << qint64(3645831);
+        QTest::newRow("9600 7E1") << 9600 << 7 << int(QSerialPort::EvenParity) << 1
+                                  << qint64(1041666) << qint64(3645831);
+        QTest::newRow("19200 8E1") << 19200 << 8 << int(QSerialPort::EvenParity) << 1
+                                   << qint64(572916) << qint64(2005206);
+        QTest::newRow("19200 8N2") << 19200 << 8 << int(QSerialPort::NoParity) << 2
+                                   << qint64(572916) << qint64(2005206);
+        QTest::newRow("38400 8E1") << 38400 << 8 << int(QSerialPort::EvenParity) << 1
+                                   << qint64(286458) << ModbusRtuBus::FIXED_GAP_NS;
+        QTest::newRow("115200 8N1") << 115200 << 8 << int(QSerialPort::NoParity) << 1
+                                    << qint64(86805) << ModbusRtuBus::FIXED_GAP_NS;
+    }
+
+    void frameTiming() {
+        QFETCH(int, baudRate);
+        QFETCH(int, dataBits);
+        QFETCH(int, parity);
+        QFETCH(int, stopBits);
+        QFETCH(qint64, charTimeNs);
+        QFETCH(qint64, interFrameNs);
+
+        ModbusRtuBus::Settings settings;
+        settings.baudRate = baudRate;
+        settings.dataBits = QSerialPort::DataBits(dataBits);
+        settings.parity = QSerialPort::Parity(parity);
+        settings.stopBits = stopBits == 1 ? QSerialPort::OneStop : QSerialPort::TwoStop;
+
+        const ModbusRtuBus bus(settings);
+        QCOMPARE(bus.charTimeNs(), charTimeNs);
+        QCOMPARE(bus.interFrameNs(), interFrameNs);
+        QCOMPARE(bus.utilization(), 0.0);
+    }
+
+    void crc16() {
+        // Пример из спецификации Modbus: чтение 10 регистров устройства 1
+        const QByteArray request = QByteArray::fromHex("01030000000a");
+        QCOMPARE(ModbusRtuBus::crc16(request.constData(), request.size()), quint16(0xCDC5));
+        const QByteArray empty;
+        QCOMPARE(ModbusRtuBus::crc16(empty.constData(), 0), quint16(0xFFFF));
+    }
+
+    void parseSettings() {
+        ModbusRtuBus::Settings settings;
+        QVERIFY(ModbusRtuBus::parseSettings(QJsonObject{{"port", "/dev/ttyUSB0"}}, settings));
+        QCOMPARE(settings.baudRate, 19200);
+        QCOMPARE(settings.parity, QSerialPort::EvenParity);
+        QCOMPARE(settings.stopBits, QSerialPort::OneStop);
+
+        QVERIFY(ModbusRtuBus::parseSettings(
+            QJsonObject{{"port", "COM3"}, {"baudRate", 9600}, {"parity", "none"}, {"stopBits", 2}},
+            settings));
+        QCOMPARE(settings.baudRate, 9600);
+        QCOMPARE(settings.parity, QSerialPort::NoParity);
+        QCOMPARE(settings.stopBits, QSerialPort::TwoStop);
+
+        QString error;
+        QVERIFY(!ModbusRtuBus::parseSettings(QJsonObject{}, settings, &error));
+        QVERIFY(!error.isEmpty());
+        QVERIFY(!ModbusRtuBus::parseSettings(QJsonObject{{"port", "COM3"}, {"parity", "mark"}}, settings));
+        QVERIFY(!ModbusRtuBus::parseSettings(QJsonObject{{"port", "COM3"}, {"dataBits", 9}}, settings));
+    }
+
+    /**
+     * @brief Устройства шины опрашиваются по очереди, между концом ответа и следующим
+     * запросом выдерживается пауза t3.5.
+     */
+    void pollsThroughPtyWithInterFrameGap() {
+        PtySlave slave;
+        ModbusRtuBus::Settings settings;
+        settings.portName = slave.open();
+        if (settings.portName.isEmpty())
+            QSKIP("Псевдотерминалы недоступны.");
+        settings.baudRate = 115200;
+        settings.parity = QSerialPort::NoParity;
+
+        ModbusRtuBus bus(settings);
+        slave.charTimeNs = bus.charTimeNs();
+        ModbusRtuDevice first(makeConfig(1, {{0, 10}, {100, 10}}, 50), settings.portName);
+        ModbusRtuDevice second(makeConfig(2, {{0, 20}}, 50), settings.portName);
+        QSignalSpy firstMessages(&first, &IClient::dataReceived);
+        QSignalSpy secondMessages(&second, &IClient::dataReceived);
+        bus.addDevice(&first);
+        bus.addDevice(&second);
+
+        QString error;
+        if (!bus.start(&error))
+            QSKIP(qPrintable(QString("Не удалось открыть %1: %2").arg(settings.portName, error)));
+
+        QTRY_VERIFY(registerMessages(firstMessages) >= 3 && registerMessages(secondMessages) >= 3);
+        bus.stop();
+
+        QCOMPARE(slave.crcErrors, 0);
+        QVERIFY(first.isConnected());
+        QCOMPARE(first.droppedMessages(), quint64(0));
+        QVERIFY(first.registersRead() >= 3 * 20);
+
+        // Следующий запрос уходит не раньше t3.5 после конца предыдущего ответа
+        qint64 shortestGapNs = std::numeric_limits<qint64>::max();
+        for (qsizetype i = 1; i < slave.exchanges.size(); ++i) {
+            const PtySlave::Exchange &previous = slave.exchanges.at(i - 1);
+            if (previous.replyNs != 0)
+                shortestGapNs = qMin(shortestGapNs, slave.exchanges.at(i).requestNs - previous.replyNs);
+        }
+        QVERIFY2(shortestGapNs >= bus.interFrameNs(),
+                 qPrintable(QString("пауза %1 нс короче t3.5 %2 нс").arg(shortestGapNs).arg(bus.interFrameNs())));
+    }
+
+    /**
+     * @brief После таймаута остальные запросы цикла к молчащему устройству снимаются.
+     */
+    void dropsRemainingRequestsOfSilentDevice() {
+        PtySlave slave;
+        ModbusRtuBus::Settings settings;
+        settings.portName = slave.open();
+        if (settings.portName.isEmpty())
+            QSKIP("Псевдотерминалы недоступны.");
+        settings.baudRate = 115200;
+        settings.responseTimeoutMs = 20;
+        slave.silentUnits.insert(3);
+
+        ModbusRtuBus bus(settings);
+        slave.charTimeNs = bus.charTimeNs();
+        ModbusRtuDevice silent(makeConfig(3, {{0, 5}, {100, 5}, {200, 5}}, 50), settings.portName);
+        ModbusRtuDevice alive(makeConfig(1, {{0, 5}}, 50), settings.portName);
+        QSignalSpy aliveMessages(&alive, &IClient::dataReceived);
+        bus.addDevice(&silent);
+        bus.addDevice(&alive);
+
+        QString error;
+        if (!bus.start(&error))
+            QSKIP(qPrintable(QString("Не удалось открыть %1: %2").arg(settings.portName, error)));
+
+        QTRY_VERIFY(silent.droppedMessages() >= 3 && registerMessages(aliveMessages) >= 3);
+        bus.stop();
+
+        for (const PtySlave::Exchange &exchange : std::as_const(slave.exchanges)) {
+            if (exchange.unitId == 3)
+                QCOMPARE(exchange.start, quint16(0));
+        }
+        QVERIFY(!silent.isConnected());
+        QVERIFY(alive.isConnected());
+    }
+
+    /**
+     * @brief Загрузка шины при непрерывном опросе блоков по 125 регистров.
+     *
+     * Ожидаемая загрузка — время передачи запроса и ответа (с округлением
+     * задержки PtySlave до миллисекунды) к нему же плюс пауза t3.5
+     * (таймер паузы округляется вверх до миллисекунды).
+     */
+    void busUtilization() {
+        PtySlave slave;
+        ModbusRtuBus::Settings settings;
+        settings.portName = slave.open();
+        if (settings.portName.isEmpty())
+            QSKIP("Псевдотерминалы недоступны.");
+        settings.baudRate = 115200;
+        settings.parity = QSerialPort::NoParity;
+
+        ModbusRtuBus bus(settings);
+        slave.charTimeNs = bus.charTimeNs();
+        // Период меньше времени цикла: устройство опрашивается без перерывов
+        ModbusRtuDevice device(makeConfig(1, {{0, 250}}, 10), settings.portName);
+        bus.addDevice(&device);
+
+        QString error;
+        if (!bus.start(&error))
+            QSKIP(qPrintable(QString("Не удалось открыть %1: %2").arg(settings.portName, error)));
+
+        QTest::qWait(1000);
+        const double measured = bus.utilization();
+        const quint64 registers = device.registersRead();
+        bus.stop();
+
+        const double wireMs = std::ceil((8 + 5 + 250) * bus.charTimeNs() / 1e6);
+        const double gapMs = std::ceil(bus.interFrameNs() / 1e6);
+        const double expected = wireMs / (wireMs + gapMs);
+        qInfo("Загрузка шины 115200 8N1: %.1f%% (расчетная %.1f%%), %llu регистров",
+              100.0 * measured, 100.0 * expected, registers);
+        QTest::setBenchmarkResult(100.0 * measured, QTest::Events);
+
+        QCOMPARE(slave.crcErrors, 0);
+        QVERIFY(registers > 0);
+        QVERIFY2(measured > 0.6 && measured <= 1.0, qPrintable(QString::number(measured)));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestModbusRtu)
+#include "tst_modbusrtu.moc"
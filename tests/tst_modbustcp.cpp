@@ -0,0 +1,410 @@
+/**
+ * @file tst_modbustcp.cpp
+ * @brief Тесты карты регистров Modbus и опроса ModbusTcpDevice с ведомым устройством в процессе теста.
+ */
+#include <QCborMap>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTest>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+#include "../common/messagecodec.h"
+#include "../common/protocol.h"
+#include "core/modbustcpdevice.h"
+
+/**
+ * @class ModbusSlaveStub
+ * @brief Ведомое устройство Modbus TCP на QTcpServer: отвечает на чтение регистров.
+ *
+ * Значение регистра равно его адресу (для входных регистров — адрес + INPUT_OFFSET),
+ * поэтому по ответу видно, какой блок был прочитан. Ответы можно задерживать
+ * (holdReplies) и отправлять в произвольном порядке, а запросы с указанными
+ * начальными адресами — оставлять без ответа.
+ */
+class ModbusSlaveStub : public QObject {
+    Q_OBJECT
+
+public:
+    /// @brief Смещение значений входных регистров относительно адреса.
+    static constexpr quint16 INPUT_OFFSET = 1000;
+
+    /**
+     * @struct Request
+     * @brief Принятый запрос чтения.
+     */
+    struct Request {
+        quint16 transactionId = 0;
+        quint8 unitId = 0;
+        quint8 function = 0;
+        quint16 start = 0;
+        quint16 count = 0;
+    };
+
+    bool listen() {
+        connect(&m_server, &QTcpServer::newConnection, this, &ModbusSlaveStub::handleNewConnection);
+        return m_server.listen(QHostAddress::LocalHost, 0);
+    }
+    quint16 port() const { return m_server.serverPort(); }
+
+    static quint16 valueAt(quint8 function, quint16 address) {
+        return function == Modbus::READ_INPUT_REGISTERS ? quint16(address + INPUT_OFFSET) : address;
+    }
+
+    /**
+     * @brief Отправляет задержанные ответы одной записью.
+     * @param reversed Отвечать в порядке, обратном порядку запросов.
+     */
+    void releasePending(bool reversed) {
+        QList<Request> requests = std::exchange(pending, {});
+        if (reversed)
+            std::reverse(requests.begin(), requests.end());
+        QByteArray replies;
+        for (const Request &request : std::as_const(requests))
+            replies.append(response(request));
+        m_socket->write(replies);
+    }
+
+    /// @brief Копить ответы в pending вместо немедленной отправки.
+    bool holdReplies = false;
+    /// @brief Начальные адреса блоков, запросы которых остаются без ответа.
+    QSet<quint16> ignoredStarts;
+    /// @brief Задержанные запросы (holdReplies).
+    QList<Request> pending;
+    /// @brief Все принятые запросы.
+    QList<Request> received;
+
+private slots:
+    void handleNewConnection() {
+        m_socket = m_server.nextPendingConnection();
+        m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        connect(m_socket, &QTcpSocket::readyRead, this, &ModbusSlaveStub::handleReadyRead);
+    }
+
+    void handleReadyRead() {
+        m_buffer.append(m_socket->readAll());
+
+        QByteArray replies;
+        while (m_buffer.size() >= ModbusTcpDevice::MBAP_HEADER_SIZE) {
+            const quint16 length = qFromBigEndian<quint16>(m_buffer.constData() + 4);
+            if (m_buffer.size() < 6 + length)
+                break;
+
+            const char *frame = m_buffer.constData();
+            Request request;
+            request.transactionId = qFromBigEndian<quint16>(frame);
+            request.unitId = quint8(frame[6]);
+            request.function = quint8(frame[7]);
+            request.start = qFromBigEndian<quint16>(frame + 8);
+            request.count = qFromBigEndian<quint16>(frame + 10);
+            m_buffer.remove(0, 6 + length);
+
+            received.append(request);
+            if (ignoredStarts.contains(request.start))
+                continue;
+            if (holdReplies)
+                pending.append(request);
+            else
+                replies.append(response(request));
+        }
+        if (!replies.isEmpty())
+            m_socket->write(replies);
+    }
+
+private:
+    static QByteArray response(const Request &request) {
+        const int pduSize = 2 + request.count * 2;
+        QByteArray frame(ModbusTcpDevice::MBAP_HEADER_SIZE + pduSize, Qt::Uninitialized);
+        char *data = frame.data();
+        qToBigEndian<quint16>(request.transactionId, data);
+        qToBigEndian<quint16>(0, data + 2);
+        qToBigEndian<quint16>(quint16(pduSize + 1), data + 4);
+        data[6] = char(request.unitId);
+        data[7] = char(request.function);
+        data[8] = char(request.count * 2);
+        for (int i = 0; i < request.count; ++i)
+            qToBigEndian<quint16>(valueAt(request.function, quint16(request.start + i)), data + 9 + i * 2);
+        return frame;
+    }
+
+    QTcpServer m_server;
+    QTcpSocket *m_socket = nullptr;
+    QByteArray m_buffer;
+};
+
+namespace {
+ModbusRegister makeRegister(const QString &name, quint16 address,
+                            ModbusRegister::Type type = ModbusRegister::Type::UInt16,
+                            ModbusRegister::Table table = ModbusRegister::Table::Holding) {
+    ModbusRegister reg;
+    reg.name = name;
+    reg.address = address;
+    reg.type = type;
+    reg.table = table;
+    return reg;
+}
+
+/**
+ * @brief Создает устройство с регистрами UInt16 по указанным адресам (имена "r<адрес>").
+ */
+ModbusDeviceConfig makeConfig(const QList<quint16> &addresses, int maxGap, int pollIntervalMs) {
+    ModbusDeviceConfig config;
+    config.id = "stub";
+    config.unitId = 7;
+    config.maxGap = maxGap;
+    config.pollIntervalMs = pollIntervalMs;
+    for (quint16 address : addresses)
+        config.registers.append(makeRegister(QString("r%1").arg(address), address));
+    config.blocks = ModbusRegisterMap::buildBlocks(config.registers, maxGap);
+    return config;
+}
+
+/**
+ * @brief Возвращает полезную нагрузку сообщений Registers из перехваченных dataReceived.
+ */
+QList<QCborMap> registerPayloads(const QSignalSpy &spy) {
+    QList<QCborMap> payloads;
+    for (const QList<QVariant> &arguments : spy) {
+        QCborMap message;
+        if (MessageCodec::decode(arguments.at(0).toByteArray(), message) &&
+            message.value(Protocol::Keys::TYPE).toString() == Protocol::MessageType::REGISTERS)
+            payloads.append(message.value(Protocol::Keys::PAYLOAD).toMap());
+    }
+    return payloads;
+}
+} // namespace
+
+class TestModbusTcp : public QObject {
+    Q_OBJECT
+
+private slots:
+    void blocksCoalesceAdjacentRanges() {
+        const QList<ModbusRegister> registers = {
+            makeRegister("c", 20, ModbusRegister::Type::UInt32),
+            makeRegister("a", 10),
+            makeRegister("b", 11),
+            makeRegister("far", 40),
+            makeRegister("in", 10, ModbusRegister::Type::UInt16, ModbusRegister::Table::Input),
+        };
+
+        // Разрыв 12..19 не больше maxGap: 10..21 читается одним запросом
+        const QList<ModbusReadBlock> blocks = ModbusRegisterMap::buildBlocks(registers, 8);
+        QCOMPARE(blocks.size(), 3);
+        QCOMPARE(blocks[0].start, quint16(10));
+        QCOMPARE(blocks[0].count, quint16(12));
+        QCOMPARE(blocks[0].registers, QList<int>({1, 2, 0}));
+        QCOMPARE(blocks[1].start, quint16(40));
+        QCOMPARE(blocks[1].count, quint16(1));
+        // Таблицы не смешиваются даже при совпадающих адресах
+        QCOMPARE(blocks[2].table, ModbusRegister::Table::Input);
+        QCOMPARE(blocks[2].start, quint16(10));
+
+        // Без допустимого разрыва объединяются только смежные регистры
+        QCOMPARE(ModbusRegisterMap::buildBlocks(registers, 0).size(), 4);
+    }
+
+    void blocksRespectRequestLimit() {
+        QList<ModbusRegister> registers;
+        for (int address = 0; address < 300; ++address)
+            registers.append(makeRegister(QString::number(address), quint16(address)));
+
+        const QList<ModbusReadBlock> blocks = ModbusRegisterMap::buildBlocks(registers, 8);
+        QCOMPARE(blocks.size(), 3);
+        QCOMPARE(blocks[0].count, quint16(Modbus::MAX_READ_REGISTERS));
+        QCOMPARE(blocks[1].start, quint16(Modbus::MAX_READ_REGISTERS));
+        QCOMPARE(blocks[2].count, quint16(300 - 2 * Modbus::MAX_READ_REGISTERS));
+
+        // 32-битное значение не разрывается между блоками
+        registers = {makeRegister("a", 0), makeRegister("b", 124, ModbusRegister::Type::Float32)};
+        QCOMPARE(ModbusRegisterMap::buildBlocks(registers, 200).size(), 2);
+    }
+
+    void decodesResponse() {
+        ModbusDeviceConfig config;
+        config.registers = {
+            makeRegister("u16", 0),
+            makeRegister("i16", 1, ModbusRegister::Type::Int16),
+            makeRegister("u32", 2, ModbusRegister::Type::UInt32),
+            makeRegister("swapped", 4, ModbusRegister::Type::Int32),
+            makeRegister("real", 6, ModbusRegister::Type::Float32),
+        };
+        config.registers[0].scale = 0.1;
+        config.registers[3].swapWords = true;
+        config.blocks = ModbusRegisterMap::buildBlocks(config.registers, 0);
+        QCOMPARE(config.blocks.size(), 1);
+        const ModbusReadBlock &block = config.blocks.first();
+
+        const QByteArray request = ModbusRegisterMap::readRequest(block);
+        QCOMPARE(request, QByteArray::fromHex("0300000008"));
+
+        float real = -2.5f;
+        quint32 realBits;
+        std::memcpy(&realBits, &real, sizeof(realBits));
+        QByteArray pdu = QByteArray::fromHex("0310" "0457" "fffe" "00010002" "fffffffe");
+        pdu.append(char(realBits >> 24)).append(char(realBits >> 16))
+           .append(char(realBits >> 8)).append(char(realBits));
+        QVERIFY(ModbusRegisterMap::checkReadResponse(pdu.constData(), pdu.size(), block));
+
+        QJsonObject values;
+        ModbusRegisterMap::decode(config, block, pdu.constData(), values);
+        QCOMPARE(values["u16"].toDouble(), 0x0457 * 0.1);
+        QCOMPARE(values["i16"].toDouble(), -2.0);
+        QCOMPARE(values["u32"].toDouble(), 65538.0);
+        // Младшее слово первым: 0xfffe'ffff
+        QCOMPARE(values["swapped"].toDouble(), double(qint32(0xfffeffff)));
+        QCOMPARE(values["real"].toDouble(), -2.5);
+
+        QString error;
+        const QByteArray exception = QByteArray::fromHex("8302");
+        QVERIFY(!ModbusRegisterMap::checkReadResponse(exception.constData(), exception.size(), block, &error));
+        QVERIFY(error.contains("2"));
+        QVERIFY(!ModbusRegisterMap::checkReadResponse(pdu.constData(), pdu.size() - 1, block));
+        const QByteArray wrongFunction = QByteArray::fromHex("0410") + pdu.mid(2);
+        QVERIFY(!ModbusRegisterMap::checkReadResponse(wrongFunction.constData(), wrongFunction.size(), block));
+    }
+
+    void pollsDeviceAndEmitsTelemetry() {
+        ModbusSlaveStub slave;
+        QVERIFY(slave.listen());
+
+        ModbusDeviceConfig config;
+        config.id = "plc-1";
+        config.unitId = 3;
+        config.pollIntervalMs = 100;
+        config.registers = {
+            makeRegister("a", 10),
+            makeRegister("b", 11, ModbusRegister::Type::Int16),
+            makeRegister("c", 20, ModbusRegister::Type::UInt32),
+            makeRegister("d", 5, ModbusRegister::Type::UInt16, ModbusRegister::Table::Input),
+        };
+        config.registers[3].scale = 0.5;
+        config.blocks = ModbusRegisterMap::buildBlocks(config.registers, config.maxGap);
+
+        ModbusTcpDevice device(config, "127.0.0.1", slave.port());
+        QSignalSpy messages(&device, &IClient::dataReceived);
+        device.start();
+
+        QTRY_VERIFY(!registerPayloads(messages).isEmpty());
+        QVERIFY(device.isConnected());
+
+        // Первым сообщением устройство регистрируется под своим ID
+        QCborMap registration;
+        QVERIFY(MessageCodec::decode(messages.at(0).at(0).toByteArray(), registration));
+        QCOMPARE(registration.value(Protocol::Keys::TYPE).toString(), Protocol::MessageType::REGISTRATION);
+        QCOMPARE(registration.value(Protocol::Keys::ID).toString(), QString("plc-1"));
+
+        const QCborMap payload = registerPayloads(messages).first();
+        QCOMPARE(payload.value(QString("a")).toDouble(), 10.0);
+        QCOMPARE(payload.value(QString("b")).toDouble(), 11.0);
+        QCOMPARE(payload.value(QString("c")).toDouble(), double((20u << 16) | 21u));
+        QCOMPARE(payload.value(QString("d")).toDouble(), (5 + ModbusSlaveStub::INPUT_OFFSET) * 0.5);
+
+        // Два блока на цикл: 10..21 из регистров хранения и 5 из входных
+        const ModbusSlaveStub::Request first = slave.received.at(0);
+        QCOMPARE(first.unitId, quint8(3));
+        QCOMPARE(first.start, quint16(10));
+        QCOMPARE(first.count, quint16(12));
+        QCOMPARE(slave.received.at(1).function, Modbus::READ_INPUT_REGISTERS);
+
+        device.disconnect();
+        QTRY_VERIFY(!device.isConnected());
+    }
+
+    /**
+     * @brief Конвейер заполняется до maxPipeline запросов, ответы в обратном порядке
+     * сопоставляются запросам по Transaction ID.
+     */
+    void pipelinesAndMatchesTransactions() {
+        ModbusSlaveStub slave;
+        QVERIFY(slave.listen());
+        slave.holdReplies = true;
+
+        const QList<quint16> addresses = {0, 10, 20, 30, 40, 50, 60, 70, 80, 90};
+        const int pipeline = 4;
+        ModbusTcpDevice device(makeConfig(addresses, 0, 60000), "127.0.0.1", slave.port(), pipeline);
+        QSignalSpy messages(&device, &IClient::dataReceived);
+        device.start();
+
+        QTRY_COMPARE(slave.pending.size(), pipeline);
+        QTest::qWait(50);
+        QCOMPARE(slave.pending.size(), pipeline);
+        QSet<quint16> transactionIds;
+        for (const ModbusSlaveStub::Request &request : std::as_const(slave.pending))
+            transactionIds.insert(request.transactionId);
+        QCOMPARE(transactionIds.size(), pipeline);
+
+        slave.releasePending(true);
+        QTRY_COMPARE(slave.pending.size(), pipeline);
+        slave.releasePending(true);
+        QTRY_COMPARE(slave.pending.size(), addresses.size() - 2 * pipeline);
+        slave.releasePending(true);
+
+        QTRY_COMPARE(registerPayloads(messages).size(), 1);
+        const QCborMap payload = registerPayloads(messages).first();
+        QCOMPARE(payload.size(), addresses.size());
+        for (quint16 address : addresses)
+            QCOMPARE(payload.value(QString("r%1").arg(address)).toDouble(), double(address));
+        QCOMPARE(device.registersRead(), quint64(addresses.size()));
+        QCOMPARE(device.droppedMessages(), quint64(0));
+    }
+
+    void expiresUnansweredTransactions() {
+        ModbusSlaveStub slave;
+        QVERIFY(slave.listen());
+        slave.ignoredStarts.insert(10);
+
+        ModbusTcpDevice device(makeConfig({0, 10, 20}, 0, 200), "127.0.0.1", slave.port());
+        QSignalSpy messages(&device, &IClient::dataReceived);
+        QSignalSpy errors(&device, &IClient::errorOccurred);
+        device.start();
+
+        // Цикл завершается после таймаута: значения остальных блоков не теряются
+        QTRY_VERIFY_WITH_TIMEOUT(!registerPayloads(messages).isEmpty(),
+                                 ModbusTcpDevice::REQUEST_TIMEOUT_MS * 3);
+        QVERIFY(device.droppedMessages() >= 1);
+        QVERIFY(!errors.isEmpty());
+        QVERIFY(errors.at(0).at(0).toString().contains("Таймаут"));
+
+        const QCborMap payload = registerPayloads(messages).first();
+        QCOMPARE(payload.value(QString("r0")).toDouble(), 0.0);
+        QCOMPARE(payload.value(QString("r20")).toDouble(), 20.0);
+        QVERIFY(!payload.contains(QString("r10")));
+        // Пока блок ждал ответа, новые циклы не накладывались на незавершенный
+        QVERIFY(device.skippedCycles() >= 1);
+    }
+
+    /**
+     * @brief Темп опроса одного устройства: 1000 регистров (8 блоков) с периодом 10 мс.
+     */
+    void pollRate() {
+        ModbusSlaveStub slave;
+        QVERIFY(slave.listen());
+
+        QList<quint16> addresses;
+        for (quint16 address = 0; address < 1000; ++address)
+            addresses.append(address);
+        ModbusTcpDevice device(makeConfig(addresses, 0, 10), "127.0.0.1", slave.port());
+        device.start();
+        QTRY_VERIFY(device.registersRead() > 0);
+
+        const quint64 readBefore = device.registersRead();
+        QElapsedTimer timer;
+        timer.start();
+        QTest::qWait(1000);
+        const double seconds = timer.nsecsElapsed() / 1e9;
+        const double registersPerSec = (device.registersRead() - readBefore) / seconds;
+
+        qInfo("Опрос Modbus TCP: %.0f регистров/с (%llu циклов пропущено)",
+              registersPerSec, device.skippedCycles());
+        // Результат замера — регистров в секунду
+        QTest::setBenchmarkResult(registersPerSec, QTest::Events);
+        QVERIFY2(registersPerSec >= 5000, qPrintable(QString::number(registersPerSec)));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestModbusTcp)
+#include "tst_modbustcp.moc"
@@ -0,0 +1,128 @@
+/**
+ * @file tst_parseshard.cpp
+ * @brief Тесты разбора сообщений и ограничения темпа по типам в ParseShard.
+ */
+#include <QSignalSpy>
+#include <QTest>
+
+#include "../common/messagecodec.h"
+#include "../common/protocol.h"
+#include "core/parseshard.h"
+#include "fakeclient.h"
+
+namespace {
+/// @brief Начальный момент замеров (MonotonicClock не бывает нулем).
+constexpr qint64 START_NS = 1000000000;
+
+/**
+ * @brief Кодирует сообщение заданного типа с пустой полезной нагрузкой.
+ */
+QByteArray message(const QString &type) {
+    QJsonObject json;
+    json[Protocol::Keys::TYPE] = type;
+    json[Protocol::Keys::PAYLOAD] = QJsonObject();
+    return MessageCodec::encode(json, MessageCodec::Encoding::Cbor);
+}
+} // namespace
+
+class TestParseShard : public QObject {
+    Q_OBJECT
+
+private slots:
+    void batchesTelemetry() {
+        ParseShard shard;
+        FakeClient client(1);
+        QSignalSpy queued(&shard, &ParseShard::dataQueued);
+
+        const QByteArray log = message(Protocol::MessageType::LOG);
+        for (int i = 0; i < ParseShard::NOTIFY_STEP_RECORDS; ++i) {
+            shard.messageQueued();
+            shard.parse(&client, 1, "Client_1", log, START_NS);
+        }
+        QCOMPARE(shard.backlog(), 0);
+        QCOMPARE(shard.pendingCount(), ParseShard::NOTIFY_STEP_RECORDS);
+        QCOMPARE(shard.pendingBytes(), qsizetype(log.size()) * ParseShard::NOTIFY_STEP_RECORDS);
+        // Уведомление о первой записи и о каждом полном шаге
+        QCOMPARE(queued.count(), 2);
+
+        const QList<TelemetryRecord> batch = shard.takeDataBatch();
+        QCOMPARE(batch.size(), ParseShard::NOTIFY_STEP_RECORDS);
+        QCOMPARE(batch.first().clientId, QString("Client_1"));
+        QCOMPARE(batch.first().stages.received, START_NS);
+        QVERIFY(batch.first().stages.flushed >= batch.first().stages.parsed);
+        QCOMPARE(shard.pendingCount(), 0);
+        QCOMPARE(shard.pendingBytes(), qsizetype(0));
+
+        // Некорректные данные отбрасываются без записи
+        shard.parse(&client, 1, "Client_1", "not a message", START_NS);
+        QCOMPARE(shard.pendingCount(), 0);
+    }
+
+    /**
+     * @brief Повторные регистрации ограничены корзиной своего типа, телеметрия — нет.
+     */
+    void limitsMessageTypes() {
+        RateLimits limits;
+        limits.perType = {{Protocol::MessageType::REGISTRATION, {1.0, 3.0}}};
+        ParseShard shard(limits);
+        FakeClient first(1);
+        FakeClient second(2);
+        QSignalSpy registrations(&shard, &ParseShard::registrationReceived);
+
+        const QByteArray registration = message(Protocol::MessageType::REGISTRATION);
+        const QByteArray log = message(Protocol::MessageType::LOG);
+        for (int i = 0; i < 10; ++i) {
+            shard.parse(&first, 1, "Client_1", registration, START_NS);
+            shard.parse(&first, 1, "Client_1", log, START_NS);
+        }
+        shard.parse(&second, 2, "Client_2", registration, START_NS);
+
+        QCOMPARE(registrations.count(), 3 + 1);
+        QCOMPARE(shard.pendingCount(), 10);
+        const QHash<quintptr, quint64> limited = shard.takeRateLimited();
+        QCOMPARE(limited.size(), 1);
+        QCOMPARE(limited.value(1), quint64(7));
+        QVERIFY(shard.takeRateLimited().isEmpty());
+
+        // Через секунду корзина пополняется на один маркер
+        shard.parse(&first, 1, "Client_1", registration, START_NS + 1000000000);
+        shard.parse(&first, 1, "Client_1", registration, START_NS + 1000000000);
+        QCOMPARE(registrations.count(), 5);
+        QCOMPARE(shard.takeRateLimited().value(1), quint64(1));
+    }
+
+    void newClientOnDescriptorGetsFreshBuckets() {
+        RateLimits limits;
+        limits.perType = {{Protocol::MessageType::REGISTRATION, {1.0, 1.0}}};
+        ParseShard shard(limits);
+        QSignalSpy registrations(&shard, &ParseShard::registrationReceived);
+        const QByteArray registration = message(Protocol::MessageType::REGISTRATION);
+
+        FakeClient before(1);
+        shard.parse(&before, 1, "Client_1", registration, START_NS);
+        shard.parse(&before, 1, "Client_1", registration, START_NS);
+        QCOMPARE(registrations.count(), 1);
+
+        // Дескриптор достался новому подключению раньше, чем шард узнал об отключении
+        FakeClient after(1);
+        shard.parse(&after, 1, "Client_2", registration, START_NS);
+        QCOMPARE(registrations.count(), 2);
+
+        // После forgetClient корзины создаются заново
+        shard.forgetClient(1);
+        shard.parse(&after, 1, "Client_2", registration, START_NS);
+        QCOMPARE(registrations.count(), 3);
+    }
+
+    void defaultLimitsCoverServiceMessages() {
+        const RateLimits limits;
+        QVERIFY(limits.perType.contains(Protocol::MessageType::REGISTRATION));
+        QVERIFY(limits.perType.contains(Protocol::MessageType::CONFIGURATION));
+        QVERIFY(limits.perType.contains(Protocol::MessageType::PROBE));
+        QVERIFY(!limits.perType.contains(Protocol::MessageType::LOG));
+        QVERIFY(limits.perClient.ratePerSec > 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestParseShard)
+#include "tst_parseshard.moc"
@@ -0,0 +1,129 @@
+/**
+ * @file tst_reconnectbackoff.cpp
+ * @brief Тесты пауз переподключения ReconnectBackoff (decorrelated jitter).
+ */
+#include <QTest>
+
+#include "reconnectbackoff.h"
+
+namespace {
+/// @brief Базовая пауза в проверках (мс).
+constexpr qint64 BASE_MS = 500;
+/// @brief Наибольшая пауза в проверках (мс).
+constexpr qint64 CAP_MS = 30000;
+/// @brief Количество клиентов (зерен генератора) в проверках разброса.
+constexpr int CLIENTS = 1000;
+} // namespace
+
+class TestReconnectBackoff : public QObject {
+    Q_OBJECT
+
+private slots:
+    void defaultsFromProtocol() {
+        ReconnectBackoff backoff;
+        QRandomGenerator random(1);
+        const qint64 delay = backoff.nextDelayMs(random);
+        QVERIFY(delay >= Protocol::Constants::RECONNECT_BASE_MS);
+        QVERIFY(delay <= 3 * Protocol::Constants::RECONNECT_BASE_MS);
+        QCOMPARE(backoff.failures(), 1);
+    }
+
+    /**
+     * @brief Каждая пауза лежит между базовой и утроенной предыдущей, но не выше предела.
+     */
+    void delaysStayWithinBounds() {
+        for (quint32 seed = 1; seed <= CLIENTS; ++seed) {
+            ReconnectBackoff backoff(BASE_MS, CAP_MS);
+            QRandomGenerator random(seed);
+            qint64 previous = BASE_MS;
+            for (int attempt = 1; attempt <= 30; ++attempt) {
+                const qint64 delay = backoff.nextDelayMs(random);
+                const qint64 upper = qMin(CAP_MS, qMax(BASE_MS, 3 * previous));
+                QVERIFY2(delay >= BASE_MS && delay <= upper,
+                         qPrintable(QString("seed %1, attempt %2: %3 ms").arg(seed).arg(attempt).arg(delay)));
+                previous = delay;
+            }
+            QCOMPARE(backoff.failures(), 30);
+        }
+    }
+
+    void delaysGrowTowardsCap() {
+        qint64 largest = 0;
+        for (quint32 seed = 1; seed <= 100; ++seed) {
+            ReconnectBackoff backoff(BASE_MS, CAP_MS);
+            QRandomGenerator random(seed);
+            for (int attempt = 0; attempt < 20; ++attempt)
+                largest = qMax(largest, backoff.nextDelayMs(random));
+        }
+        QVERIFY2(largest > CAP_MS / 2, qPrintable(QString::number(largest)));
+    }
+
+    /**
+     * @brief Клиенты, потерявшие сервер одновременно, расходятся уже на первой попытке.
+     */
+    void firstAttemptsAreSpread() {
+        QList<qint64> delays;
+        for (quint32 seed = 1; seed <= CLIENTS; ++seed) {
+            ReconnectBackoff backoff(BASE_MS, CAP_MS);
+            QRandomGenerator random(seed);
+            delays.append(backoff.nextDelayMs(random));
+        }
+
+        // Доли клиентов в трех равных интервалах [500, 1500] близки к трети
+        int buckets[3] = {};
+        for (qint64 delay : std::as_const(delays))
+            ++buckets[qMin<qint64>(2, (delay - BASE_MS) * 3 / (2 * BASE_MS + 1))];
+        for (int count : buckets)
+            QVERIFY2(count > CLIENTS / 5 && count < CLIENTS / 2, qPrintable(QString::number(count)));
+    }
+
+    void retryAfterIsLowerBoundOnce() {
+        ReconnectBackoff backoff(BASE_MS, CAP_MS);
+        QRandomGenerator random(7);
+        backoff.setRetryAfter(10000);
+        const qint64 delay = backoff.nextDelayMs(random);
+        // Пауза сервера плюс разброс до половины, чтобы отклоненные вместе не вернулись вместе
+        QVERIFY(delay >= 10000 && delay <= 15000);
+
+        // Подсказка действует на одну попытку; дальше рост от нее как от предыдущей паузы
+        const qint64 next = backoff.nextDelayMs(random);
+        QVERIFY(next >= BASE_MS && next <= CAP_MS);
+    }
+
+    void retryAfterMayExceedCap() {
+        ReconnectBackoff backoff(BASE_MS, CAP_MS);
+        QRandomGenerator random(7);
+        backoff.setRetryAfter(60000);
+        const qint64 delay = backoff.nextDelayMs(random);
+        QVERIFY(delay >= 60000 && delay <= 90000);
+
+        // Отрицательная подсказка игнорируется
+        backoff.reset();
+        backoff.setRetryAfter(-100);
+        QVERIFY(backoff.nextDelayMs(random) <= 3 * BASE_MS);
+    }
+
+    void resetRestartsGrowth() {
+        ReconnectBackoff backoff(BASE_MS, CAP_MS);
+        QRandomGenerator random(3);
+        for (int i = 0; i < 10; ++i)
+            backoff.nextDelayMs(random);
+        backoff.reset();
+        QCOMPARE(backoff.failures(), 0);
+        QVERIFY(backoff.nextDelayMs(random) <= 3 * BASE_MS);
+    }
+
+    void clampsConstructorArguments() {
+        QRandomGenerator random(5);
+        // Предел ниже базовой паузы поднимается до нее: пауза постоянна
+        ReconnectBackoff fixed(BASE_MS, 100);
+        for (int i = 0; i < 5; ++i)
+            QCOMPARE(fixed.nextDelayMs(random), BASE_MS);
+
+        ReconnectBackoff minimal(0, 0);
+        QCOMPARE(minimal.nextDelayMs(random), qint64(1));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestReconnectBackoff)
+#include "tst_reconnectbackoff.moc"
@@ -0,0 +1,233 @@
+/**
+ * @file tst_sendqueue.cpp
+ * @brief Тесты очереди отправки SendQueue и политик медленного получателя TcpClient.
+ */
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTest>
+
+#include <memory>
+
+#include "sendqueue.h"
+#include "tcpclient.h"
+
+namespace {
+using Policy = IClient::SlowConsumerPolicy;
+
+/// @brief Размер сообщения-заполнителя в проверках TcpClient (в байтах).
+constexpr int MESSAGE_SIZE = 1024;
+/// @brief Количество сообщений, уходящих в буфер сокета до верхней границы.
+constexpr int DIRECT_MESSAGES = int(TcpClient::SOCKET_HIGH_WATERMARK / MESSAGE_SIZE);
+} // namespace
+
+class TestSendQueue : public QObject {
+    Q_OBJECT
+
+private slots:
+    void queueAccountsBytes() {
+        SendQueue queue;
+        QVERIFY(queue.isEmpty());
+        QCOMPARE(queue.push("abc", QString(), Policy::Drop, 100), SendQueue::Result::Queued);
+        QCOMPARE(queue.push("defgh", QString(), Policy::Drop, 100), SendQueue::Result::Queued);
+        QCOMPARE(queue.bytes(), qint64(8));
+
+        QCOMPARE(queue.takeChunk(), QByteArray("abcdefgh"));
+        QVERIFY(queue.isEmpty());
+        QCOMPARE(queue.bytes(), qint64(0));
+        QVERIFY(queue.takeChunk().isEmpty());
+    }
+
+    void queueOverflowKeepsContents() {
+        SendQueue queue;
+        QCOMPARE(queue.push(QByteArray(60, 'a'), QString(), Policy::Drop, 100), SendQueue::Result::Queued);
+        QCOMPARE(queue.push(QByteArray(41, 'b'), QString(), Policy::Drop, 100), SendQueue::Result::Overflow);
+        QCOMPARE(queue.push(QByteArray(40, 'c'), QString(), Policy::Drop, 100), SendQueue::Result::Queued);
+        QCOMPARE(queue.bytes(), qint64(100));
+
+        queue.clear();
+        QVERIFY(queue.isEmpty());
+        QCOMPARE(queue.bytes(), qint64(0));
+    }
+
+    void queueCoalescesOnlyUnderCoalescePolicy() {
+        SendQueue dropQueue;
+        dropQueue.push("cfg-1", "config", Policy::Drop, 100);
+        QCOMPARE(dropQueue.push("cfg-2", "config", Policy::Drop, 100), SendQueue::Result::Queued);
+        QCOMPARE(dropQueue.takeChunk(), QByteArray("cfg-1cfg-2"));
+
+        // Замена сохраняет место в очереди и учитывает разницу размеров
+        SendQueue queue;
+        queue.push("cfg-1", "config", Policy::Coalesce, 100);
+        queue.push("data", QString(), Policy::Coalesce, 100);
+        QCOMPARE(queue.push("cfg-22", "config", Policy::Coalesce, 100), SendQueue::Result::Coalesced);
+        QCOMPARE(queue.bytes(), qint64(10));
+        QCOMPARE(queue.takeChunk(), QByteArray("cfg-22data"));
+
+        // Сообщения без ключа не замещают друг друга
+        queue.push("a", QString(), Policy::Coalesce, 100);
+        QCOMPARE(queue.push("b", QString(), Policy::Coalesce, 100), SendQueue::Result::Queued);
+    }
+
+    /**
+     * @brief Замена, с которой очередь превысила бы ограничение объема, отклоняется.
+     */
+    void queueCoalesceRespectsMaxBytes() {
+        SendQueue queue;
+        queue.push(QByteArray(10, 'c'), "config", Policy::Coalesce, 100);
+        queue.push(QByteArray(85, 'd'), QString(), Policy::Coalesce, 100);
+        QCOMPARE(queue.bytes(), qint64(95));
+
+        QCOMPARE(queue.push(QByteArray(16, 'C'), "config", Policy::Coalesce, 100), SendQueue::Result::Overflow);
+        QCOMPARE(queue.bytes(), qint64(95));
+        QCOMPARE(queue.push(QByteArray(15, 'C'), "config", Policy::Coalesce, 100), SendQueue::Result::Coalesced);
+        QCOMPARE(queue.bytes(), qint64(100));
+        QCOMPARE(queue.takeChunk(), QByteArray(15, 'C') + QByteArray(85, 'd'));
+    }
+
+    /**
+     * @brief Индекс ключей следует за очередью: отправленное сообщение больше не замещается.
+     */
+    void queueKeyIndexFollowsTakenMessages() {
+        SendQueue queue;
+        const qint64 maxBytes = 4 * SendQueue::COALESCED_WRITE_SIZE;
+        const QByteArray large(SendQueue::COALESCED_WRITE_SIZE, 'L');
+        queue.push(large, QString(), Policy::Coalesce, maxBytes);
+        queue.push("k-1", "key", Policy::Coalesce, maxBytes);
+
+        // Первая запись забирает только большое сообщение; ключ остается в очереди
+        QCOMPARE(queue.takeChunk(), large);
+        QCOMPARE(queue.push("k-2", "key", Policy::Coalesce, maxBytes), SendQueue::Result::Coalesced);
+        QCOMPARE(queue.takeChunk(), QByteArray("k-2"));
+
+        QCOMPARE(queue.push("k-3", "key", Policy::Coalesce, maxBytes), SendQueue::Result::Queued);
+        queue.clear();
+        QCOMPARE(queue.push("k-4", "key", Policy::Coalesce, maxBytes), SendQueue::Result::Queued);
+        QCOMPARE(queue.takeChunk(), QByteArray("k-4"));
+    }
+
+    void queueCoalescesLatestOfDuplicateKeys() {
+        SendQueue queue;
+        // При Drop сообщения с одним ключом копятся; замещается последнее из них
+        queue.push("a-1", "key", Policy::Drop, 100);
+        queue.push("a-2", "key", Policy::Drop, 100);
+        QCOMPARE(queue.push("a-3", "key", Policy::Coalesce, 100), SendQueue::Result::Coalesced);
+        QCOMPARE(queue.takeChunk(), QByteArray("a-1a-3"));
+        QCOMPARE(queue.push("a-4", "key", Policy::Coalesce, 100), SendQueue::Result::Queued);
+    }
+
+    void queueCoalescesManyKeys() {
+        SendQueue queue;
+        const qint64 maxBytes = SendQueue::DEFAULT_MAX_BYTES;
+        for (int i = 0; i < 1000; ++i)
+            queue.push(QByteArray::number(i).rightJustified(4, '0'), QString::number(i), Policy::Coalesce, maxBytes);
+        for (int i = 0; i < 1000; ++i) {
+            QCOMPARE(queue.push(QByteArray::number(i).rightJustified(5, '0'), QString::number(i),
+                                Policy::Coalesce, maxBytes),
+                     SendQueue::Result::Coalesced);
+        }
+        QCOMPARE(queue.bytes(), qint64(5000));
+        QCOMPARE(queue.takeChunk().left(10), QByteArray("0000000001"));
+        QVERIFY(queue.isEmpty());
+    }
+
+    void queueMergesSmallMessagesIntoChunks() {
+        SendQueue queue;
+        const qint64 maxBytes = 10 * SendQueue::COALESCED_WRITE_SIZE;
+        const QByteArray message(1000, 'm');
+        for (int i = 0; i < 100; ++i)
+            queue.push(message, QString(), Policy::Drop, maxBytes);
+        const QByteArray large(SendQueue::COALESCED_WRITE_SIZE * 2, 'L');
+        queue.push(large, QString(), Policy::Drop, maxBytes);
+
+        // 65 сообщений по 1000 байт помещаются в 64 КБ, оставшиеся 35 — во вторую запись
+        QCOMPARE(queue.takeChunk().size(), 65000);
+        QCOMPARE(queue.takeChunk().size(), 35000);
+        // Большое сообщение не делится и уходит целиком
+        QCOMPARE(queue.takeChunk(), large);
+        QVERIFY(queue.isEmpty());
+        QCOMPARE(queue.bytes(), qint64(0));
+    }
+
+    void init() {
+        QVERIFY(m_server.listen(QHostAddress::LocalHost));
+        m_peer = std::make_unique<QTcpSocket>();
+        m_peer->connectToHost(QHostAddress::LocalHost, m_server.serverPort());
+        QVERIFY(m_peer->waitForConnected(5000));
+        QVERIFY(m_server.waitForNewConnection(5000));
+        m_client = std::make_unique<TcpClient>(m_server.nextPendingConnection());
+        QVERIFY(m_client->isConnected());
+    }
+
+    void cleanup() {
+        m_client.reset();
+        m_peer.reset();
+        m_server.close();
+    }
+
+    /**
+     * @brief Получатель не читает: сверх буфера сокета и очереди сообщения отбрасываются,
+     * после начала чтения очередь доставляется полностью.
+     */
+    void clientDropsWhenPeerStalls() {
+        m_client->setSlowConsumerPolicy(Policy::Drop, TcpClient::SOCKET_HIGH_WATERMARK);
+
+        // Цикл событий не выполняется, поэтому данные остаются в буфере сокета
+        const int sentMessages = 4 * DIRECT_MESSAGES;
+        for (int i = 0; i < sentMessages; ++i)
+            m_client->sendData(QByteArray(MESSAGE_SIZE, 'x'));
+
+        const qint64 queuedLimit = 2 * TcpClient::SOCKET_HIGH_WATERMARK;
+        QCOMPARE(m_client->queuedBytes(), queuedLimit);
+        QCOMPARE(m_client->droppedMessages(), quint64(sentMessages - 2 * DIRECT_MESSAGES));
+        QVERIFY(m_client->isConnected());
+
+        qint64 received = 0;
+        connect(m_peer.get(), &QTcpSocket::readyRead, this,
+                [this, &received] { received += m_peer->readAll().size(); });
+        QTRY_COMPARE_WITH_TIMEOUT(received, queuedLimit, 10000);
+        QTRY_COMPARE(m_client->queuedBytes(), qint64(0));
+    }
+
+    void clientDisconnectsSlowConsumer() {
+        m_client->setSlowConsumerPolicy(Policy::Disconnect, 0);
+        QSignalSpy errors(m_client.get(), &IClient::errorOccurred);
+        QSignalSpy disconnects(m_client.get(), &IClient::disconnected);
+
+        for (int i = 0; i <= 2 * DIRECT_MESSAGES; ++i)
+            m_client->sendData(QByteArray(MESSAGE_SIZE, 'x'));
+
+        QCOMPARE(errors.count(), 1);
+        QTRY_COMPARE(disconnects.count(), 1);
+        QVERIFY(!m_client->isConnected());
+        QCOMPARE(m_client->queuedBytes(), qint64(0));
+    }
+
+    void clientCoalescesQueuedConfiguration() {
+        m_client->setSlowConsumerPolicy(Policy::Coalesce, TcpClient::SOCKET_HIGH_WATERMARK);
+        for (int i = 0; i < DIRECT_MESSAGES; ++i)
+            m_client->sendData(QByteArray(MESSAGE_SIZE, 'x'));
+
+        m_client->sendData("{cfg-1}", "config");
+        m_client->sendData(QByteArray(MESSAGE_SIZE, 'y'));
+        m_client->sendData("{cfg-2}", "config");
+        const qint64 expectedBytes = TcpClient::SOCKET_HIGH_WATERMARK + 7 + MESSAGE_SIZE;
+        QCOMPARE(m_client->queuedBytes(), expectedBytes);
+
+        QByteArray received;
+        connect(m_peer.get(), &QTcpSocket::readyRead, this,
+                [this, &received] { received += m_peer->readAll(); });
+        QTRY_COMPARE_WITH_TIMEOUT(qint64(received.size()), expectedBytes, 10000);
+        QVERIFY(!received.contains("{cfg-1}"));
+        // Замененная конфигурация сохраняет место в очереди: перед следующим сообщением
+        QVERIFY(received.endsWith("{cfg-2}" + QByteArray(MESSAGE_SIZE, 'y')));
+    }
+
+private:
+    QTcpServer m_server;
+    std::unique_ptr<QTcpSocket> m_peer;
+    std::unique_ptr<TcpClient> m_client;
+};
+
+QTEST_GUILESS_MAIN(TestSendQueue)
+#include "tst_sendqueue.moc"
@@ -0,0 +1,209 @@
+/**
+ * @file tst_spscring.cpp
+ * @brief Тесты кольцевого буфера SpscRing для одного писателя и одного читателя.
+ */
+#include <QElapsedTimer>
+#include <QTest>
+#include <QThread>
+
+#include <atomic>
+#include <memory>
+
+#include "core/spscring.h"
+
+namespace {
+/// @brief Количество элементов в проверках с двумя потоками.
+constexpr quint64 STRESS_ITEMS = 1000000;
+/// @brief Наибольшее время проверки с двумя потоками (в миллисекундах).
+constexpr qint64 STRESS_TIMEOUT_MS = 60000;
+
+/**
+ * @brief Возвращает список чисел first..last.
+ */
+QList<int> range(int first, int last) {
+    QList<int> values;
+    for (int i = first; i <= last; ++i)
+        values.append(i);
+    return values;
+}
+} // namespace
+
+class TestSpscRing : public QObject {
+    Q_OBJECT
+
+private slots:
+    void roundsCapacityUpToPowerOfTwo() {
+        QCOMPARE(SpscRing<int>(5).capacity(), qsizetype(8));
+        QCOMPARE(SpscRing<int>(8).capacity(), qsizetype(8));
+        QCOMPARE(SpscRing<int>(1).capacity(), qsizetype(2));
+    }
+
+    void pushFailsWhenFull() {
+        SpscRing<int> ring(4);
+        for (int i = 0; i < 4; ++i)
+            QVERIFY(ring.push(int(i)));
+        QVERIFY(!ring.push(4));
+        QVERIFY(!ring.push(5));
+        QCOMPARE(ring.overflowCount(), quint64(2));
+        QCOMPARE(ring.depth(), qsizetype(4));
+
+        // Забранные элементы добавляются в конец списка
+        QList<int> out{-1};
+        QCOMPARE(ring.drain(out), qsizetype(4));
+        QCOMPARE(out, QList<int>({-1, 0, 1, 2, 3}));
+        QCOMPARE(ring.depth(), qsizetype(0));
+        QCOMPARE(ring.drain(out), qsizetype(0));
+
+        // После чтения место освобождается, индексы продолжают расти через границу буфера
+        for (int i = 10; i < 13; ++i)
+            QVERIFY(ring.push(int(i)));
+        out.clear();
+        ring.drain(out);
+        QCOMPARE(out, range(10, 12));
+    }
+
+    /**
+     * @brief pushLatest отбрасывает самые старые элементы пакета и учитывает их как переполнение.
+     */
+    void pushLatestDropsOldest() {
+        SpscRing<int> ring(4);
+        QVERIFY(ring.push(0));
+
+        QList<int> batch = range(10, 15);
+        QCOMPARE(ring.pushLatest(batch), qsizetype(3));
+        QCOMPARE(ring.overflowCount(), quint64(3));
+
+        QList<int> out;
+        ring.drain(out);
+        QCOMPARE(out, QList<int>({0, 13, 14, 15}));
+
+        QList<int> empty;
+        QCOMPARE(ring.pushLatest(empty), qsizetype(0));
+        QList<int> fits = range(20, 21);
+        QCOMPARE(ring.pushLatest(fits), qsizetype(2));
+        QCOMPARE(ring.overflowCount(), quint64(3));
+
+        // В заполненный буфер пакет не записывается совсем
+        QList<int> fill = range(22, 23);
+        ring.pushLatest(fill);
+        QList<int> rejected = range(30, 31);
+        QCOMPARE(ring.pushLatest(rejected), qsizetype(0));
+        QCOMPARE(ring.overflowCount(), quint64(5));
+        out.clear();
+        ring.drain(out);
+        QCOMPARE(out, range(20, 23));
+    }
+
+    void tracksPeakDepth() {
+        SpscRing<int> ring(8);
+        QCOMPARE(ring.peakDepth(), qsizetype(0));
+        for (int i = 0; i < 3; ++i)
+            ring.push(int(i));
+        QList<int> out;
+        ring.drain(out);
+
+        QList<int> batch = range(0, 4);
+        ring.pushLatest(batch);
+        QCOMPARE(ring.peakDepth(), qsizetype(5));
+        ring.drain(out);
+        ring.push(1);
+        // Наибольшая глубина не уменьшается после чтения
+        QCOMPARE(ring.peakDepth(), qsizetype(5));
+
+        QList<int> overflow = range(0, 20);
+        ring.pushLatest(overflow);
+        QCOMPARE(ring.peakDepth(), ring.capacity());
+    }
+
+    /**
+     * @brief Писатель и читатель в разных потоках: push с повтором доставляет все элементы по порядку.
+     */
+    void stressPushAndDrain() {
+        SpscRing<quint64> ring(1024);
+        std::atomic<quint64> failedPushes{0};
+        std::atomic<bool> stop{false};
+        std::unique_ptr<QThread> producer(QThread::create([&ring, &failedPushes, &stop] {
+            for (quint64 value = 1; value <= STRESS_ITEMS; ++value) {
+                while (!ring.push(quint64(value))) {
+                    failedPushes.fetch_add(1, std::memory_order_relaxed);
+                    if (stop.load(std::memory_order_relaxed))
+                        return;
+                    QThread::yieldCurrentThread();
+                }
+            }
+        }));
+        producer->start();
+
+        QElapsedTimer timer;
+        timer.start();
+        QList<quint64> out;
+        quint64 expected = 1;
+        quint64 outOfOrder = 0;
+        while (expected <= STRESS_ITEMS && timer.elapsed() < STRESS_TIMEOUT_MS) {
+            out.clear();
+            if (ring.drain(out) == 0) {
+                QThread::yieldCurrentThread();
+                continue;
+            }
+            for (quint64 value : std::as_const(out)) {
+                if (value != expected)
+                    ++outOfOrder;
+                expected = value + 1;
+            }
+        }
+        // Писатель не должен остаться ждать места, если проверка прервана по времени
+        stop.store(true);
+        QVERIFY(producer->wait(STRESS_TIMEOUT_MS));
+
+        QCOMPARE(outOfOrder, quint64(0));
+        QCOMPARE(expected, STRESS_ITEMS + 1);
+        QCOMPARE(ring.overflowCount(), failedPushes.load());
+        QVERIFY(ring.peakDepth() <= ring.capacity());
+    }
+
+    /**
+     * @brief pushLatest из другого потока: читатель видит возрастающую последовательность,
+     * а полученные и отброшенные элементы в сумме дают все записанные.
+     */
+    void stressPushLatest() {
+        SpscRing<quint64> ring(256);
+        constexpr quint64 batchSize = 100;
+        std::unique_ptr<QThread> producer(QThread::create([&ring] {
+            QList<quint64> batch;
+            for (quint64 value = 1; value <= STRESS_ITEMS;) {
+                batch.clear();
+                for (quint64 i = 0; i < batchSize && value <= STRESS_ITEMS; ++i)
+                    batch.append(value++);
+                ring.pushLatest(batch);
+            }
+        }));
+        producer->start();
+
+        QList<quint64> out;
+        quint64 received = 0;
+        quint64 last = 0;
+        quint64 outOfOrder = 0;
+        const auto drainChecked = [&] {
+            out.clear();
+            ring.drain(out);
+            for (quint64 value : std::as_const(out)) {
+                if (value <= last)
+                    ++outOfOrder;
+                last = value;
+                ++received;
+            }
+        };
+        // Писатель не ждет читателя, поэтому завершается сам
+        while (!producer->isFinished())
+            drainChecked();
+        QVERIFY(producer->wait(STRESS_TIMEOUT_MS));
+        drainChecked();
+
+        QCOMPARE(outOfOrder, quint64(0));
+        QVERIFY(last <= STRESS_ITEMS);
+        QCOMPARE(received + ring.overflowCount(), STRESS_ITEMS);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestSpscRing)
+#include "tst_spscring.moc"
@@ -0,0 +1,277 @@
+/**
+ * @file tst_tablemodel.cpp
+ * @brief Тесты инкрементальных обновлений ClientTableModel и вытеснения строк DataTableModel.
+ */
+#include <QAbstractItemModelTester>
+#include <QSignalSpy>
+#include <QTest>
+
+#include "models/ringbuffer.h"
+#include "models/tablemodel.h"
+
+namespace {
+/// @brief Колонка ID в таблице клиентов.
+constexpr int ID_COLUMN = 0;
+/// @brief Колонка очереди отправки в таблице клиентов.
+constexpr int QUEUE_COLUMN = 4;
+
+/**
+ * @brief Формирует состояние клиента в том виде, в каком его передает DataProcessing.
+ */
+QVariantMap clientRow(quintptr descriptor, qint64 queueBytes = 0,
+                      AppEnums::ClientStatus status = AppEnums::CONNECTED) {
+    QVariantMap row;
+    row[Keys::DESCRIPTOR] = QVariant::fromValue(quint64(descriptor));
+    row[Keys::ID] = QString("Client_%1").arg(descriptor);
+    row[Keys::ADDRESS] = QString("127.0.0.1:%1").arg(40000 + descriptor);
+    row[Keys::STATUS] = int(status);
+    row[Keys::ALLOW_SENDING] = true;
+    row[Keys::QUEUE_BYTES] = queueBytes;
+    return row;
+}
+
+/**
+ * @brief Возвращает ID строк модели сверху вниз.
+ */
+QStringList rowIds(const BaseTableModel &model) {
+    QStringList ids;
+    for (int row = 0; row < model.rowCount(); ++row)
+        ids.append(model.getRowData(row).value(Keys::ID).toString());
+    return ids;
+}
+
+/**
+ * @brief Формирует записи телеметрии с номерами first..last (ID клиента — Client_N).
+ */
+QList<TelemetryRecord> records(int first, int last) {
+    QList<TelemetryRecord> batch;
+    for (int i = first; i <= last; ++i) {
+        TelemetryRecord record;
+        record.timestamp = 1700000000000 + i;
+        record.clientId = QString("Client_%1").arg(i);
+        record.type = "Log";
+        record.payload = GenericPayload{QString::number(i)};
+        batch.append(record);
+    }
+    return batch;
+}
+
+/**
+ * @brief Возвращает ожидаемые ID строк таблицы данных: от самой новой записи к старой.
+ */
+QStringList newestFirst(int newest, int oldest) {
+    QStringList ids;
+    for (int i = newest; i >= oldest; --i)
+        ids.append(QString("Client_%1").arg(i));
+    return ids;
+}
+} // namespace
+
+class TestTableModel : public QObject {
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief Пакет превращается во вставки, dataChanged и удаления без сброса модели.
+     */
+    void clientUpdatesAreIncremental() {
+        ClientTableModel model;
+        QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+        QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+        QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+        QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+        QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+
+        model.applyUpdates({clientRow(1), clientRow(2), clientRow(3)});
+        QCOMPARE(rowIds(model), QStringList({"Client_1", "Client_2", "Client_3"}));
+        QCOMPARE(inserted.count(), 3);
+
+        // Из нескольких изменений клиента в пакете применяется последнее
+        model.applyUpdates({clientRow(2, 100), clientRow(2, 200, AppEnums::DISCONNECTED)});
+        QCOMPARE(changed.count(), 1);
+        QCOMPARE(changed.first().at(0).toModelIndex().row(), 1);
+        QCOMPARE(model.getRowData(1).value(Keys::QUEUE_BYTES).toLongLong(), qint64(200));
+        QCOMPARE(model.getRowData(1).value(Keys::STATUS).toInt(), int(AppEnums::DISCONNECTED));
+
+        model.applyUpdates({clientRow(1, 0, AppEnums::DELETED), clientRow(4),
+                            clientRow(3, 0, AppEnums::DELETED),
+                            clientRow(5, 0, AppEnums::DISCONNECTED)});
+        QCOMPARE(rowIds(model), QStringList({"Client_2", "Client_4"}));
+        QCOMPARE(removed.count(), 2);
+        QCOMPARE(inserted.count(), 4);
+
+        // Индекс по дескриптору следует за сдвигом строк после удаления
+        model.applyUpdates({clientRow(4, 300)});
+        QCOMPARE(model.getRowData(1).value(Keys::QUEUE_BYTES).toLongLong(), qint64(300));
+        QCOMPARE(reset.count(), 0);
+    }
+
+    void adjacentDeletionsRemoveOneRange() {
+        ClientTableModel model;
+        QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+        QList<QVariantMap> batch;
+        for (quintptr descriptor = 1; descriptor <= 6; ++descriptor)
+            batch.append(clientRow(descriptor));
+        model.applyUpdates(batch);
+
+        QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+        model.applyUpdates({clientRow(2, 0, AppEnums::DELETED), clientRow(3, 0, AppEnums::DELETED),
+                            clientRow(4, 0, AppEnums::DELETED), clientRow(6, 0, AppEnums::DELETED)});
+        QCOMPARE(rowIds(model), QStringList({"Client_1", "Client_5"}));
+        QCOMPARE(removed.count(), 2);
+    }
+
+    /**
+     * @brief При активной сортировке новые строки вставляются на место, измененные — перемещаются.
+     */
+    void sortedUpdatesInsertAndMoveRows() {
+        ClientTableModel model;
+        QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+        model.applyUpdates({clientRow(1, 100), clientRow(2, 200), clientRow(3, 300)});
+        model.sortByColumn(QUEUE_COLUMN, Qt::AscendingOrder);
+
+        QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+        QSignalSpy moved(&model, &QAbstractItemModel::rowsMoved);
+        QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+        QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+
+        model.applyUpdates({clientRow(4, 250)});
+        QCOMPARE(rowIds(model), QStringList({"Client_1", "Client_2", "Client_4", "Client_3"}));
+        QCOMPARE(inserted.count(), 1);
+        QCOMPARE(inserted.first().at(1).toInt(), 2);
+
+        // Перемещение вверх: место ищется слева от строки
+        model.applyUpdates({clientRow(3, 50)});
+        QCOMPARE(rowIds(model), QStringList({"Client_3", "Client_1", "Client_2", "Client_4"}));
+        QCOMPARE(moved.count(), 1);
+        QCOMPARE(moved.last().at(1).toInt(), 3);
+        QCOMPARE(moved.last().at(4).toInt(), 0);
+
+        // Перемещение вниз: позиция назначения — до перемещения, как у beginMoveRows
+        model.applyUpdates({clientRow(3, 1000)});
+        QCOMPARE(rowIds(model), QStringList({"Client_1", "Client_2", "Client_4", "Client_3"}));
+        QCOMPARE(moved.count(), 2);
+        QCOMPARE(moved.last().at(1).toInt(), 0);
+        QCOMPARE(moved.last().at(4).toInt(), 4);
+
+        // Строка, оставшаяся на месте, только меняется
+        model.applyUpdates({clientRow(2, 240)});
+        QCOMPARE(moved.count(), 2);
+        QCOMPARE(changed.last().at(0).toModelIndex().row(), 1);
+
+        // После перемещений индекс по дескриптору указывает на верные строки
+        model.applyUpdates({clientRow(1, 0, AppEnums::DELETED), clientRow(4, 10)});
+        QCOMPARE(rowIds(model), QStringList({"Client_4", "Client_2", "Client_3"}));
+        QCOMPARE(model.getRowData(0).value(Keys::QUEUE_BYTES).toLongLong(), qint64(10));
+        QCOMPARE(reset.count(), 0);
+    }
+
+    void descendingSortKeepsOrder() {
+        ClientTableModel model;
+        QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+        model.applyUpdates({clientRow(5), clientRow(12), clientRow(1)});
+        model.sortByColumn(ID_COLUMN, Qt::DescendingOrder);
+        // Числовой суффикс ID сравнивается как число
+        QCOMPARE(rowIds(model), QStringList({"Client_12", "Client_5", "Client_1"}));
+
+        model.applyUpdates({clientRow(7), clientRow(20)});
+        QCOMPARE(rowIds(model), QStringList({"Client_20", "Client_12", "Client_7", "Client_5", "Client_1"}));
+    }
+
+    /**
+     * @brief Заполненная таблица данных удаляет самые старые строки одним диапазоном.
+     */
+    void dataModelEvictsOldestRows() {
+        DataTableModel model;
+        QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+        model.setCapacity(5);
+        QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+        QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+
+        model.addRecords(records(1, 3));
+        QCOMPARE(rowIds(model), newestFirst(3, 1));
+        QCOMPARE(removed.count(), 0);
+
+        model.addRecords(records(4, 6));
+        QCOMPARE(rowIds(model), newestFirst(6, 2));
+        QCOMPARE(removed.count(), 1);
+        QCOMPARE(removed.last().at(1).toInt(), 2);
+        QCOMPARE(removed.last().at(2).toInt(), 2);
+        QCOMPARE(inserted.last().at(1).toInt(), 0);
+        QCOMPARE(inserted.last().at(2).toInt(), 2);
+
+        // Из пакета больше емкости остаются только самые новые записи
+        model.addRecords(records(7, 20));
+        QCOMPARE(rowIds(model), newestFirst(20, 16));
+        QCOMPARE(removed.last().at(1).toInt(), 0);
+        QCOMPARE(removed.last().at(2).toInt(), 4);
+        QCOMPARE(inserted.last().at(2).toInt(), 4);
+    }
+
+    void dataModelCapacityChangeKeepsNewestRows() {
+        DataTableModel model;
+        QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+        QCOMPARE(model.capacity(), DataTableModel::DEFAULT_CAPACITY);
+        model.setCapacity(5);
+        model.addRecords(records(1, 5));
+
+        QSignalSpy capacityChanged(&model, &DataTableModel::capacityChanged);
+        model.setCapacity(3);
+        QCOMPARE(rowIds(model), newestFirst(5, 3));
+        model.setCapacity(3);
+        QCOMPARE(capacityChanged.count(), 1);
+
+        model.setCapacity(10);
+        model.addRecords(records(6, 7));
+        QCOMPARE(rowIds(model), newestFirst(7, 3));
+
+        model.setCapacity(0);
+        QCOMPARE(model.capacity(), 1);
+        QCOMPARE(rowIds(model), newestFirst(7, 7));
+    }
+
+    void dataModelSortIsResetByNewRecords() {
+        DataTableModel model;
+        QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+        model.setCapacity(4);
+        model.addRecords(records(1, 4));
+        model.sortByColumn(ID_COLUMN, Qt::AscendingOrder);
+        QCOMPARE(rowIds(model), QStringList({"Client_1", "Client_2", "Client_3", "Client_4"}));
+
+        // Новые записи встают в начало, вытесняя нижнюю строку отсортированной таблицы
+        QSignalSpy resetSorting(&model, &BaseTableModel::resetSorting);
+        model.addRecords(records(5, 5));
+        QCOMPARE(rowIds(model), QStringList({"Client_5", "Client_1", "Client_2", "Client_3"}));
+        QCOMPARE(resetSorting.count(), 1);
+    }
+
+    void ringBufferWrapsAndKeepsNewest() {
+        RingBuffer<int> ring(3);
+        QVERIFY(ring.isEmpty());
+        for (int i = 1; i <= 5; ++i)
+            ring.pushFront(i);
+        QVERIFY(ring.isFull());
+        QCOMPARE(ring.size(), 3);
+        QCOMPARE(ring.at(0), 5);
+        QCOMPARE(ring.at(2), 3);
+
+        ring.popBack();
+        QCOMPARE(ring.size(), 2);
+        ring.pushFront(6);
+        QCOMPARE(ring.takeAll(), QList<int>({6, 5, 4}));
+        QVERIFY(ring.isEmpty());
+
+        ring.assign({10, 9, 8, 7});
+        QCOMPARE(ring.size(), 3);
+        ring.setCapacity(2);
+        QCOMPARE(ring.takeAll(), QList<int>({10, 9}));
+
+        // Пустая емкость: элементы не сохраняются
+        RingBuffer<int> empty;
+        empty.pushFront(1);
+        QVERIFY(empty.isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(TestTableModel)
+#include "tst_tablemodel.moc"
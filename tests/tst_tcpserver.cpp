@@ -0,0 +1,163 @@
+/**
+ * @file tst_tcpserver.cpp
+ * @brief Тесты приема подключений TcpServer на интерфейсе loopback: темп приема и Busy.
+ */
+#include <QCborMap>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTest>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "../common/messagecodec.h"
+#include "../common/protocol.h"
+#include "core/tcpserver.h"
+
+namespace {
+/**
+ * @brief Возвращает свободный TCP-порт.
+ */
+quint16 freePort() {
+    QTcpServer probe;
+    if (!probe.listen(QHostAddress::LocalHost, 0))
+        return 0;
+    return probe.serverPort();
+}
+
+/**
+ * @class Peer
+ * @brief Подключение клиента, накапливающее все полученные от сервера данные.
+ */
+class Peer {
+public:
+    explicit Peer(quint16 port) : socket(std::make_unique<QTcpSocket>()) {
+        QObject::connect(socket.get(), &QTcpSocket::readyRead, socket.get(),
+                         [this] { received += socket->readAll(); });
+        socket->connectToHost(QHostAddress::LocalHost, port);
+    }
+
+    /**
+     * @brief Возвращает true, если сервер ответил Busy и закрыл подключение.
+     * @param retryAfterMs Выходной параметр для рекомендуемой паузы.
+     */
+    bool rejectedBusy(qint64 *retryAfterMs = nullptr) const {
+        QCborMap message;
+        if (socket->state() != QAbstractSocket::UnconnectedState || !MessageCodec::decode(received, message))
+            return false;
+        if (retryAfterMs)
+            *retryAfterMs = message.value(Protocol::Keys::RETRY_AFTER).toInteger();
+        return message.value(Protocol::Keys::TYPE).toString() == Protocol::MessageType::BUSY;
+    }
+
+    std::unique_ptr<QTcpSocket> socket;
+    QByteArray received;
+};
+} // namespace
+
+class TestTcpServer : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init() {
+        m_port = freePort();
+        QVERIFY(m_port != 0);
+    }
+
+    /**
+     * @brief Всплеск подключений: корзина пропускает burst сразу, остальные ждут
+     * в очереди по темпу, сверх очереди — Busy с паузой на ее разбор.
+     */
+    void smoothsConnectionStorm() {
+        ServerSettings settings;
+        settings.ioThreadCount = 1;
+        settings.acceptRatePerSec = 1;
+        settings.acceptBurst = 2;
+        settings.maxPendingAccepts = 3;
+        TcpServer server(settings);
+        server.startServer(m_port);
+        QVERIFY(server.isListening());
+        QSignalSpy connected(&server, &IServer::clientConnected);
+
+        std::vector<std::unique_ptr<Peer>> peers;
+        for (int i = 0; i < 8; ++i)
+            peers.push_back(std::make_unique<Peer>(m_port));
+
+        // Маркер пополняется раз в секунду: к этому времени всплеск уже разобран
+        const auto busyCount = [&peers] {
+            return int(std::count_if(peers.begin(), peers.end(),
+                                     [](const auto &peer) { return peer->rejectedBusy(); }));
+        };
+        QTRY_COMPARE(busyCount(), 8 - settings.acceptBurst - settings.maxPendingAccepts);
+        QCOMPARE(connected.count(), settings.acceptBurst);
+
+        for (const auto &peer : peers) {
+            qint64 retryAfterMs = 0;
+            if (peer->rejectedBusy(&retryAfterMs)) {
+                QVERIFY(retryAfterMs >= TcpServer::MIN_RETRY_AFTER_MS);
+                QVERIFY(retryAfterMs <= TcpServer::MAX_RETRY_AFTER_MS);
+            }
+        }
+
+        // Ожидающие в очереди принимаются по одному в секунду
+        QTRY_COMPARE_WITH_TIMEOUT(connected.count(), settings.acceptBurst + settings.maxPendingAccepts, 6000);
+        QCOMPARE(busyCount(), 8 - settings.acceptBurst - settings.maxPendingAccepts);
+        server.stopServer();
+    }
+
+    /**
+     * @brief Сверх maxConnections клиенты сразу получают Busy; отключение освобождает место.
+     */
+    void capsConnections() {
+        ServerSettings settings;
+        settings.ioThreadCount = 1;
+        settings.acceptRatePerSec = 0;
+        settings.maxConnections = 2;
+        TcpServer server(settings);
+        server.startServer(m_port);
+        QSignalSpy connected(&server, &IServer::clientConnected);
+        QSignalSpy disconnected(&server, &IServer::clientDisconnected);
+
+        Peer first(m_port);
+        Peer second(m_port);
+        QTRY_COMPARE(connected.count(), 2);
+
+        Peer third(m_port);
+        qint64 retryAfterMs = 0;
+        QTRY_VERIFY(third.rejectedBusy(&retryAfterMs));
+        QCOMPARE(retryAfterMs, TcpServer::FULL_RETRY_AFTER_MS);
+        QCOMPARE(connected.count(), 2);
+
+        first.socket->disconnectFromHost();
+        QTRY_COMPARE(disconnected.count(), 1);
+        Peer fourth(m_port);
+        QTRY_COMPARE(connected.count(), 3);
+        QVERIFY(!fourth.rejectedBusy());
+        server.stopServer();
+    }
+
+    void unlimitedAcceptRate() {
+        ServerSettings settings;
+        settings.ioThreadCount = 2;
+        settings.acceptRatePerSec = 0;
+        TcpServer server(settings);
+        server.startServer(m_port);
+        QSignalSpy connected(&server, &IServer::clientConnected);
+
+        std::vector<std::unique_ptr<Peer>> peers;
+        for (int i = 0; i < 50; ++i)
+            peers.push_back(std::make_unique<Peer>(m_port));
+        QTRY_COMPARE(connected.count(), 50);
+        for (const auto &peer : peers)
+            QVERIFY(!peer->rejectedBusy());
+        server.stopServer();
+    }
+
+private:
+    quint16 m_port = 0;
+};
+
+QTEST_GUILESS_MAIN(TestTcpServer)
+#include "tst_tcpserver.moc"
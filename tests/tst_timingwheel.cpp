@@ -0,0 +1,147 @@
+/**
+ * @file tst_timingwheel.cpp
+ * @brief Тесты хешированного колеса таймеров TimingWheel.
+ */
+#include <QTest>
+
+#include <algorithm>
+
+#include "core/timingwheel.h"
+
+namespace {
+/// @brief Миллисекунда в наносекундах.
+constexpr qint64 MS = 1000000;
+/// @brief Количество ячеек колеса в проверках: оборот — 8 мс.
+constexpr int SLOTS = 8;
+
+/**
+ * @brief Возвращает истекшие ключи по возрастанию.
+ */
+QList<quintptr> sorted(QList<quintptr> keys) {
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+} // namespace
+
+class TestTimingWheel : public QObject {
+    Q_OBJECT
+
+private slots:
+    void expiresInDeadlineTick() {
+        TimingWheel wheel(MS, SLOTS);
+        wheel.schedule(1, 5 * MS + MS / 2);
+        QVERIFY(wheel.contains(1));
+        QCOMPARE(wheel.size(), 1);
+
+        QVERIFY(wheel.advance(4 * MS + MS - 1).isEmpty());
+        // Точность — один шаг: срок истекает в начале своего шага
+        QCOMPARE(wheel.advance(5 * MS), QList<quintptr>{1});
+        QVERIFY(!wheel.contains(1));
+        QCOMPARE(wheel.size(), 0);
+        QVERIFY(wheel.advance(6 * MS).isEmpty());
+    }
+
+    void cancelAndReschedule() {
+        TimingWheel wheel(MS, SLOTS);
+        wheel.schedule(1, 3 * MS);
+        wheel.schedule(2, 3 * MS);
+        wheel.cancel(1);
+        wheel.cancel(42);
+        QVERIFY(!wheel.contains(1));
+        QCOMPARE(wheel.size(), 1);
+
+        // Перенос заменяет прежний срок: у ключа один срок
+        wheel.schedule(2, 6 * MS);
+        QCOMPARE(wheel.size(), 1);
+        QVERIFY(wheel.advance(3 * MS).isEmpty());
+        QCOMPARE(wheel.advance(6 * MS), QList<quintptr>{2});
+    }
+
+    void touchKeepsSingleDeadline() {
+        TimingWheel wheel(MS, SLOTS);
+        // Каждое сообщение клиента переносит срок вперед
+        for (qint64 t = 0; t < 100; ++t) {
+            QVERIFY(wheel.advance(t * MS).isEmpty());
+            wheel.schedule(7, (t + 5) * MS);
+        }
+        QCOMPARE(wheel.size(), 1);
+        QVERIFY(wheel.advance(103 * MS).isEmpty());
+        QCOMPARE(wheel.advance(104 * MS), QList<quintptr>{7});
+    }
+
+    /**
+     * @brief Срок дальше одного оборота переживает проход своей ячейки на ранних оборотах.
+     */
+    void deadlineBeyondOneRotation() {
+        TimingWheel wheel(MS, SLOTS);
+        wheel.schedule(9, 20 * MS);
+        // Ячейка 20 % 8 = 4 проходится на шагах 4 и 12
+        for (qint64 t = 0; t < 20; ++t)
+            QVERIFY2(wheel.advance(t * MS).isEmpty(), qPrintable(QString("шаг %1").arg(t)));
+        QVERIFY(wheel.contains(9));
+        QCOMPARE(wheel.advance(20 * MS), QList<quintptr>{9});
+    }
+
+    void deadlineBeyondRotationWithSparseAdvances() {
+        TimingWheel wheel(MS, SLOTS);
+        wheel.advance(0);
+        wheel.schedule(9, 20 * MS);
+        QVERIFY(wheel.advance(12 * MS).isEmpty());
+        QVERIFY(wheel.advance(19 * MS).isEmpty());
+        QCOMPARE(wheel.advance(20 * MS), QList<quintptr>{9});
+    }
+
+    /**
+     * @brief После паузы длиннее оборота истекают все прошедшие сроки, будущие остаются.
+     */
+    void longPauseExpiresAllDueKeys() {
+        TimingWheel wheel(MS, SLOTS);
+        QList<quintptr> due;
+        for (quintptr key = 1; key <= 20; ++key) {
+            wheel.schedule(key, qint64(key) * MS);
+            due.append(key);
+        }
+        wheel.schedule(100, 2000 * MS);
+
+        QCOMPARE(sorted(wheel.advance(1000 * MS)), due);
+        QCOMPARE(wheel.size(), 1);
+        QCOMPARE(wheel.advance(2000 * MS), QList<quintptr>{100});
+    }
+
+    /**
+     * @brief Прошедший срок кладется в ближайший необработанный шаг.
+     */
+    void pastDeadlineExpiresOnNextTick() {
+        TimingWheel wheel(MS, SLOTS);
+        wheel.advance(10 * MS);
+        wheel.schedule(1, 2 * MS);
+        QVERIFY(wheel.contains(1));
+        QCOMPARE(wheel.advance(11 * MS), QList<quintptr>{1});
+
+        // Отмена находит ключ в той же ячейке, куда его положило назначение
+        wheel.schedule(2, 1 * MS);
+        wheel.cancel(2);
+        QCOMPARE(wheel.size(), 0);
+        QVERIFY(wheel.advance(12 * MS).isEmpty());
+        QVERIFY(wheel.advance(40 * MS).isEmpty());
+    }
+
+    void clearRemovesEverything() {
+        TimingWheel wheel(MS, SLOTS);
+        for (quintptr key = 1; key <= 5; ++key)
+            wheel.schedule(key, qint64(key) * 3 * MS);
+        wheel.clear();
+        QCOMPARE(wheel.size(), 0);
+        QVERIFY(wheel.advance(100 * MS).isEmpty());
+    }
+
+    void clampsConstructorArguments() {
+        TimingWheel wheel(0, 0);
+        wheel.schedule(1, 5);
+        QVERIFY(wheel.advance(4).isEmpty());
+        QCOMPARE(wheel.advance(5), QList<quintptr>{1});
+    }
+};
+
+QTEST_GUILESS_MAIN(TestTimingWheel)
+#include "tst_timingwheel.moc"
@@ -0,0 +1,104 @@
+/**
+ * @file tst_tokenbucket.cpp
+ * @brief Тесты корзины маркеров TokenBucket.
+ */
+#include <QTest>
+
+#include "core/tokenbucket.h"
+
+namespace {
+/// @brief Начальный момент замеров (MonotonicClock не бывает нулем).
+constexpr qint64 START_NS = 1000000000;
+/// @brief Миллисекунда в наносекундах.
+constexpr qint64 MS = 1000000;
+} // namespace
+
+class TestTokenBucket : public QObject {
+    Q_OBJECT
+
+private slots:
+    void unlimitedBucketAlwaysAdmits() {
+        TokenBucket bucket;
+        QVERIFY(bucket.isUnlimited());
+        for (int i = 0; i < 1000; ++i)
+            QVERIFY(bucket.tryTake(START_NS));
+        QCOMPARE(bucket.nsUntilAvailable(START_NS, 100.0), qint64(0));
+
+        // Отрицательный темп тоже означает отсутствие ограничения
+        QVERIFY(TokenBucket(-5.0).isUnlimited());
+    }
+
+    void burstThenRefill() {
+        TokenBucket bucket(10.0, 5.0);
+        QCOMPARE(bucket.rate(), 10.0);
+        QCOMPARE(bucket.burst(), 5.0);
+
+        // Корзина создается полной: всплеск проходит сразу
+        for (int i = 0; i < 5; ++i)
+            QVERIFY(bucket.tryTake(START_NS));
+        QVERIFY(!bucket.tryTake(START_NS));
+
+        // 10 маркеров в секунду — один маркер за 100 мс
+        QVERIFY(bucket.tokens(START_NS + 99 * MS) < 1.0);
+        QVERIFY(bucket.tryTake(START_NS + 100 * MS));
+        QVERIFY(!bucket.tryTake(START_NS + 100 * MS));
+
+        // После долгого затишья маркеров не больше емкости
+        const qint64 laterNs = START_NS + 60000 * MS;
+        QCOMPARE(bucket.tokens(laterNs), 5.0);
+        for (int i = 0; i < 5; ++i)
+            QVERIFY(bucket.tryTake(laterNs));
+        QVERIFY(!bucket.tryTake(laterNs));
+    }
+
+    void takesSeveralTokens() {
+        TokenBucket bucket(100.0, 10.0);
+        QVERIFY(bucket.tryTake(START_NS, 8.0));
+        // Неудачная попытка маркеры не забирает
+        QVERIFY(!bucket.tryTake(START_NS, 3.0));
+        QVERIFY(bucket.tryTake(START_NS, 2.0));
+        QCOMPARE(bucket.tokens(START_NS), 0.0);
+    }
+
+    void reportsWaitUntilAvailable() {
+        TokenBucket bucket(10.0, 2.0);
+        QCOMPARE(bucket.nsUntilAvailable(START_NS), qint64(0));
+        bucket.tryTake(START_NS);
+        bucket.tryTake(START_NS);
+
+        QCOMPARE(bucket.nsUntilAvailable(START_NS), 100 * MS);
+        QCOMPARE(bucket.nsUntilAvailable(START_NS, 2.0), 200 * MS);
+        // Половина маркера уже начислена
+        QCOMPARE(bucket.nsUntilAvailable(START_NS + 50 * MS), 50 * MS);
+        QCOMPARE(bucket.nsUntilAvailable(START_NS + 100 * MS), qint64(0));
+    }
+
+    void tokensDoesNotChangeState() {
+        TokenBucket bucket(10.0, 1.0);
+        QVERIFY(bucket.tryTake(START_NS));
+        QCOMPARE(bucket.tokens(START_NS + 50 * MS), 0.5);
+        QCOMPARE(bucket.tokens(START_NS + 50 * MS), 0.5);
+        QCOMPARE(bucket.tokens(START_NS + 100 * MS), 1.0);
+        QVERIFY(bucket.tryTake(START_NS + 100 * MS));
+    }
+
+    void ignoresTimeGoingBackwards() {
+        TokenBucket bucket(10.0, 1.0);
+        QVERIFY(bucket.tryTake(START_NS + 100 * MS));
+        // Более раннее время (отметка другого потока) не начисляет и не сдвигает отсчет
+        QVERIFY(!bucket.tryTake(START_NS));
+        QCOMPARE(bucket.tokens(START_NS), 0.0);
+        QVERIFY(!bucket.tryTake(START_NS + 150 * MS));
+        QVERIFY(bucket.tryTake(START_NS + 200 * MS));
+    }
+
+    void clampsBurstToOneToken() {
+        TokenBucket bucket(10.0, 0.0);
+        QCOMPARE(bucket.burst(), 1.0);
+        QVERIFY(bucket.tryTake(START_NS));
+        QVERIFY(!bucket.tryTake(START_NS));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestTokenBucket)
+#include "tst_tokenbucket.moc"
@@ -0,0 +1,198 @@
+/**
+ * @file tst_udpserver.cpp
+ * @brief Тесты UdpServer и UdpClient на интерфейсе loopback.
+ */
+#include <QNetworkDatagram>
+#include <QSignalSpy>
+#include <QTest>
+#include <QUdpSocket>
+
+#include <memory>
+#include <vector>
+
+#include "core/udpserver.h"
+
+namespace {
+/**
+ * @brief Возвращает свободный UDP-порт интерфейса loopback.
+ */
+quint16 freeUdpPort() {
+    QUdpSocket probe;
+    if (!probe.bind(QHostAddress::LocalHost, 0))
+        return 0;
+    return probe.localPort();
+}
+
+/**
+ * @brief Создает сокет отправителя, привязанный к loopback.
+ */
+std::unique_ptr<QUdpSocket> makeSender() {
+    auto sender = std::make_unique<QUdpSocket>();
+    sender->bind(QHostAddress::LocalHost, 0);
+    return sender;
+}
+} // namespace
+
+class TestUdpServer : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init() {
+        m_port = freeUdpPort();
+        QVERIFY(m_port != 0);
+    }
+
+    void defaultSettings() {
+        const ServerSettings settings;
+        QCOMPARE(settings.udpIdleTimeoutMs, 30000);
+        QVERIFY(settings.maxConnections > 0);
+    }
+
+    /**
+     * @brief Пачка датаграмм больше RECV_BATCH_SIZE доставляется полностью и по порядку.
+     *
+     * Датаграммы отправляются до запуска цикла событий, поэтому сервер читает их
+     * одним обработчиком readyRead: первую через QUdpSocket, остальные — через
+     * recvmmsg (в Linux) несколькими пакетами.
+     */
+    void readsDatagramBatches() {
+        UdpServer server;
+        server.startServer(m_port);
+        QVERIFY(server.isListening());
+        QSignalSpy connected(&server, &IServer::clientConnected);
+        QSignalSpy received(&server, &IServer::dataReceived);
+
+        const int count = 3 * UdpServer::RECV_BATCH_SIZE + 5;
+        auto sender = makeSender();
+        for (int i = 0; i < count; ++i)
+            sender->writeDatagram(QByteArray::number(i), QHostAddress::LocalHost, m_port);
+
+        QTRY_COMPARE(received.count(), count);
+        QCOMPARE(connected.count(), 1);
+        QCOMPARE(server.clientCount(), 1);
+        for (int i = 0; i < count; ++i) {
+            const QList<QVariant> &arguments = received.at(i);
+            QCOMPARE(arguments.at(1).toByteArray(), QByteArray::number(i));
+            QVERIFY(arguments.at(2).toLongLong() > 0);
+        }
+
+        // Все сообщения пришли от одного синтетического клиента
+        IClient *client = connected.at(0).at(0).value<IClient *>();
+        for (const QList<QVariant> &arguments : std::as_const(received))
+            QCOMPARE(arguments.at(0).value<IClient *>(), client);
+    }
+
+    void mapsSendersToSyntheticClients() {
+        UdpServer server;
+        server.startServer(m_port);
+        QSignalSpy connected(&server, &IServer::clientConnected);
+        QSignalSpy received(&server, &IServer::dataReceived);
+
+        std::vector<std::unique_ptr<QUdpSocket>> senders;
+        for (int i = 0; i < 3; ++i) {
+            senders.push_back(makeSender());
+            senders.back()->writeDatagram("hello", QHostAddress::LocalHost, m_port);
+            senders.back()->writeDatagram("again", QHostAddress::LocalHost, m_port);
+        }
+
+        QTRY_COMPARE(received.count(), 6);
+        QCOMPARE(connected.count(), 3);
+        QCOMPARE(server.clientCount(), 3);
+
+        QSet<quint16> ports;
+        QSet<quintptr> descriptors;
+        for (const QList<QVariant> &arguments : std::as_const(connected)) {
+            IClient *client = arguments.at(0).value<IClient *>();
+            QCOMPARE(client->address(), QString("127.0.0.1"));
+            QVERIFY(client->isConnected());
+            ports.insert(client->port());
+            descriptors.insert(client->descriptor());
+        }
+        QCOMPARE(ports.size(), 3);
+        QCOMPARE(descriptors.size(), 3);
+
+        // Ответ уходит датаграммой на адрес отправителя
+        IClient *first = connected.at(0).at(0).value<IClient *>();
+        QUdpSocket *firstSender = nullptr;
+        for (const auto &sender : senders) {
+            if (sender->localPort() == first->port())
+                firstSender = sender.get();
+        }
+        QVERIFY(firstSender);
+        server.sendToClient(first, "reply");
+        QTRY_VERIFY(firstSender->hasPendingDatagrams());
+        QCOMPARE(firstSender->receiveDatagram().data(), QByteArray("reply"));
+
+        QSignalSpy disconnected(&server, &IServer::clientDisconnected);
+        server.stopServer();
+        QCOMPARE(disconnected.count(), 3);
+        QCOMPARE(server.clientCount(), 0);
+    }
+
+    void expiresIdleSenders() {
+        ServerSettings settings;
+        settings.udpIdleTimeoutMs = 200;
+        UdpServer server(settings);
+        server.startServer(m_port);
+        QSignalSpy connected(&server, &IServer::clientConnected);
+        QSignalSpy disconnected(&server, &IServer::clientDisconnected);
+
+        auto quiet = makeSender();
+        auto active = makeSender();
+        quiet->writeDatagram("quiet", QHostAddress::LocalHost, m_port);
+        active->writeDatagram("active", QHostAddress::LocalHost, m_port);
+        QTRY_COMPARE(server.clientCount(), 2);
+
+        // Активный отправитель продлевает срок каждой датаграммой
+        for (int i = 0; i < 10 && disconnected.isEmpty(); ++i) {
+            active->writeDatagram("tick", QHostAddress::LocalHost, m_port);
+            QTest::qWait(50);
+        }
+        QTRY_COMPARE(disconnected.count(), 1);
+        IClient *expired = disconnected.at(0).at(0).value<IClient *>();
+        QCOMPARE(expired->port(), quiet->localPort());
+        QCOMPARE(server.clientCount(), 1);
+
+        // Следующая датаграмма того же адреса создает нового клиента
+        quiet->writeDatagram("back", QHostAddress::LocalHost, m_port);
+        QTRY_COMPARE(connected.count(), 3);
+        QVERIFY(connected.at(2).at(0).value<IClient *>() != expired);
+    }
+
+    void limitsSyntheticClients() {
+        ServerSettings settings;
+        settings.maxConnections = 2;
+        UdpServer server(settings);
+        server.startServer(m_port);
+        QSignalSpy connected(&server, &IServer::clientConnected);
+        QSignalSpy received(&server, &IServer::dataReceived);
+
+        std::vector<std::unique_ptr<QUdpSocket>> senders;
+        for (int i = 0; i < 3; ++i)
+            senders.push_back(makeSender());
+        senders[0]->writeDatagram("first", QHostAddress::LocalHost, m_port);
+        senders[1]->writeDatagram("second", QHostAddress::LocalHost, m_port);
+        QTRY_COMPARE(received.count(), 2);
+
+        // Третий отправитель сверх предела: датаграмма отбрасывается
+        senders[2]->writeDatagram("third", QHostAddress::LocalHost, m_port);
+        senders[0]->writeDatagram("first-again", QHostAddress::LocalHost, m_port);
+        QTRY_COMPARE(received.count(), 3);
+        QCOMPARE(received.at(2).at(1).toByteArray(), QByteArray("first-again"));
+        QCOMPARE(connected.count(), 2);
+        QCOMPARE(server.clientCount(), 2);
+
+        // После отключения одного из отправителей место освобождается
+        connected.at(1).at(0).value<IClient *>()->disconnect();
+        QCOMPARE(server.clientCount(), 1);
+        senders[2]->writeDatagram("third-again", QHostAddress::LocalHost, m_port);
+        QTRY_COMPARE(connected.count(), 3);
+        QCOMPARE(connected.at(2).at(0).value<IClient *>()->port(), senders[2]->localPort());
+    }
+
+private:
+    quint16 m_port = 0;
+};
+
+QTEST_GUILESS_MAIN(TestUdpServer)
+#include "tst_udpserver.moc"